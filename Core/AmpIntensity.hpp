@@ -19,6 +19,7 @@
 #include "DataReader/Data.hpp"
 
 #include "Core/DataPoint.hpp"
+#include "Core/DataPointSet.hpp"
 #include "Core/Efficiency.hpp"
 #include "Core/Generator.hpp"
 
@@ -83,8 +84,8 @@ public:
   /// The sample toySample is used for normalization calculation for e.g.
   /// Resonacnes without efficiency.
   virtual void
-  setPhspSample(std::shared_ptr<std::vector<ComPWA::DataPoint>> phspSample,
-                std::shared_ptr<std::vector<ComPWA::DataPoint>> toySample) = 0;
+  setPhspSample(std::shared_ptr<ComPWA::DataPointSet> phspSample,
+                std::shared_ptr<ComPWA::DataPointSet> toySample) = 0;
 
   virtual std::shared_ptr<AmpIntensity> component(std::string name) = 0;
 
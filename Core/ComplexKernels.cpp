@@ -0,0 +1,597 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <atomic>
+
+#include "Core/ComplexKernels.hpp"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define COMPWA_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace ComPWA {
+namespace Kernels {
+
+SplitComplex::SplitComplex(const std::vector<std::complex<double>> &v)
+    : Re(v.size()), Im(v.size()) {
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    Re[i] = v[i].real();
+    Im[i] = v[i].imag();
+  }
+}
+
+void SplitComplex::toInterleaved(std::vector<std::complex<double>> &v) const {
+  v.resize(size());
+  for (std::size_t i = 0; i < size(); ++i)
+    v[i] = std::complex<double>(Re[i], Im[i]);
+}
+
+namespace {
+
+//========== Scalar implementation ==========
+// Also used for the remainder of the vectorized loops. The products are
+// written out explicitly since the operator of std::complex handles
+// infinities and NaN's in a way that can not be vectorized.
+namespace Scalar {
+
+inline double *ptr(std::complex<double> *a) {
+  return reinterpret_cast<double *>(a);
+}
+
+inline const double *ptr(const std::complex<double> *a) {
+  return reinterpret_cast<const double *>(a);
+}
+
+void multiply(std::complex<double> c, const std::complex<double> *a,
+              std::complex<double> *out, std::size_t begin, std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  for (std::size_t i = begin; i < n; ++i) {
+    double re = pa[2 * i], im = pa[2 * i + 1];
+    po[2 * i] = c.real() * re - c.imag() * im;
+    po[2 * i + 1] = c.real() * im + c.imag() * re;
+  }
+}
+
+void multiply(const std::complex<double> *a, const std::complex<double> *b,
+              std::complex<double> *out, std::size_t begin, std::size_t n) {
+  const double *pa = ptr(a), *pb = ptr(b);
+  double *po = ptr(out);
+  for (std::size_t i = begin; i < n; ++i) {
+    double are = pa[2 * i], aim = pa[2 * i + 1];
+    double bre = pb[2 * i], bim = pb[2 * i + 1];
+    po[2 * i] = are * bre - aim * bim;
+    po[2 * i + 1] = aim * bre + are * bim;
+  }
+}
+
+void multiply(const std::complex<double> *a, const double *b,
+              std::complex<double> *out, std::size_t begin, std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  for (std::size_t i = begin; i < n; ++i) {
+    po[2 * i] = pa[2 * i] * b[i];
+    po[2 * i + 1] = pa[2 * i + 1] * b[i];
+  }
+}
+
+void add(const std::complex<double> *a, std::complex<double> *out,
+         std::size_t begin, std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  for (std::size_t i = 2 * begin; i < 2 * n; ++i)
+    po[i] += pa[i];
+}
+
+void multiplyAccumulate(std::complex<double> c, const std::complex<double> *a,
+                        std::complex<double> *out, std::size_t begin,
+                        std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  for (std::size_t i = begin; i < n; ++i) {
+    double re = pa[2 * i], im = pa[2 * i + 1];
+    po[2 * i] += c.real() * re - c.imag() * im;
+    po[2 * i + 1] += c.real() * im + c.imag() * re;
+  }
+}
+
+void absSquare(const std::complex<double> *a, double *out, std::size_t begin,
+               std::size_t n) {
+  const double *pa = ptr(a);
+  for (std::size_t i = begin; i < n; ++i)
+    out[i] = pa[2 * i] * pa[2 * i] + pa[2 * i + 1] * pa[2 * i + 1];
+}
+
+void multiplyAccumulate(std::complex<double> c, const double *aRe,
+                        const double *aIm, double *outRe, double *outIm,
+                        std::size_t begin, std::size_t n) {
+  for (std::size_t i = begin; i < n; ++i) {
+    outRe[i] += c.real() * aRe[i] - c.imag() * aIm[i];
+    outIm[i] += c.real() * aIm[i] + c.imag() * aRe[i];
+  }
+}
+
+void absSquare(const double *aRe, const double *aIm, double *out,
+               std::size_t begin, std::size_t n) {
+  for (std::size_t i = begin; i < n; ++i)
+    out[i] = aRe[i] * aRe[i] + aIm[i] * aIm[i];
+}
+
+std::complex<double> sumConjugateProduct(const double *aRe, const double *aIm,
+                                         const double *bRe, const double *bIm,
+                                         std::size_t begin, std::size_t n) {
+  double re(0.), im(0.);
+  for (std::size_t i = begin; i < n; ++i) {
+    re += aRe[i] * bRe[i] + aIm[i] * bIm[i];
+    im += aIm[i] * bRe[i] - aRe[i] * bIm[i];
+  }
+  return std::complex<double>(re, im);
+}
+
+std::complex<double> sumConjugateProduct(const double *aRe, const double *aIm,
+                                         const double *bRe, const double *bIm,
+                                         const double *w, std::size_t begin,
+                                         std::size_t n) {
+  double re(0.), im(0.);
+  for (std::size_t i = begin; i < n; ++i) {
+    re += w[i] * (aRe[i] * bRe[i] + aIm[i] * bIm[i]);
+    im += w[i] * (aIm[i] * bRe[i] - aRe[i] * bIm[i]);
+  }
+  return std::complex<double>(re, im);
+}
+
+} // namespace Scalar
+
+#ifdef COMPWA_KERNELS_X86
+
+//========== AVX2 implementation ==========
+// A 256 bit register holds two interleaved complex numbers or four doubles.
+namespace Avx2 {
+
+#define COMPWA_AVX2 __attribute__((target("avx2,fma")))
+
+using Scalar::ptr;
+
+/// (a * b) for two pairs of interleaved complex numbers
+COMPWA_AVX2 inline __m256d mul(__m256d a, __m256d b) {
+  __m256d bRe = _mm256_movedup_pd(b);          // [br0, br0, br1, br1]
+  __m256d bIm = _mm256_permute_pd(b, 0xF);     // [bi0, bi0, bi1, bi1]
+  __m256d aSwap = _mm256_permute_pd(a, 0x5);   // [ai0, ar0, ai1, ar1]
+  return _mm256_fmaddsub_pd(a, bRe, _mm256_mul_pd(aSwap, bIm));
+}
+
+/// (c * a) for a pair of interleaved complex numbers. \p cRe and \p cIm
+/// contain the broadcasted real and imaginary part of c.
+COMPWA_AVX2 inline __m256d mul(__m256d cRe, __m256d cIm, __m256d a) {
+  __m256d aSwap = _mm256_permute_pd(a, 0x5);
+  return _mm256_fmaddsub_pd(a, cRe, _mm256_mul_pd(aSwap, cIm));
+}
+
+COMPWA_AVX2 inline double sum(__m256d a) {
+  __m128d s = _mm_add_pd(_mm256_castpd256_pd128(a),
+                         _mm256_extractf128_pd(a, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+COMPWA_AVX2 void multiply(std::complex<double> c,
+                          const std::complex<double> *a,
+                          std::complex<double> *out, std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  __m256d cRe = _mm256_set1_pd(c.real()), cIm = _mm256_set1_pd(c.imag());
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm256_storeu_pd(po + 2 * i, mul(cRe, cIm, _mm256_loadu_pd(pa + 2 * i)));
+  Scalar::multiply(c, a, out, i, n);
+}
+
+COMPWA_AVX2 void multiply(const std::complex<double> *a,
+                          const std::complex<double> *b,
+                          std::complex<double> *out, std::size_t n) {
+  const double *pa = ptr(a), *pb = ptr(b);
+  double *po = ptr(out);
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm256_storeu_pd(po + 2 * i, mul(_mm256_loadu_pd(pa + 2 * i),
+                                     _mm256_loadu_pd(pb + 2 * i)));
+  Scalar::multiply(a, b, out, i, n);
+}
+
+COMPWA_AVX2 void multiply(const std::complex<double> *a, const double *b,
+                          std::complex<double> *out, std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    // [b0, b0, b1, b1]
+    __m256d vb = _mm256_permute4x64_pd(
+        _mm256_castpd128_pd256(_mm_loadu_pd(b + i)), 0x50);
+    _mm256_storeu_pd(po + 2 * i,
+                     _mm256_mul_pd(_mm256_loadu_pd(pa + 2 * i), vb));
+  }
+  Scalar::multiply(a, b, out, i, n);
+}
+
+COMPWA_AVX2 void add(const std::complex<double> *a,
+                     std::complex<double> *out, std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm256_storeu_pd(po + 2 * i, _mm256_add_pd(_mm256_loadu_pd(po + 2 * i),
+                                               _mm256_loadu_pd(pa + 2 * i)));
+  Scalar::add(a, out, i, n);
+}
+
+COMPWA_AVX2 void multiplyAccumulate(std::complex<double> c,
+                                    const std::complex<double> *a,
+                                    std::complex<double> *out, std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  __m256d cRe = _mm256_set1_pd(c.real()), cIm = _mm256_set1_pd(c.imag());
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2)
+    _mm256_storeu_pd(po + 2 * i,
+                     _mm256_add_pd(_mm256_loadu_pd(po + 2 * i),
+                                   mul(cRe, cIm, _mm256_loadu_pd(pa + 2 * i))));
+  Scalar::multiplyAccumulate(c, a, out, i, n);
+}
+
+COMPWA_AVX2 void absSquare(const std::complex<double> *a, double *out,
+                           std::size_t n) {
+  const double *pa = ptr(a);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d x0 = _mm256_loadu_pd(pa + 2 * i);
+    __m256d x1 = _mm256_loadu_pd(pa + 2 * i + 4);
+    // [n0, n2, n1, n3]
+    __m256d h = _mm256_hadd_pd(_mm256_mul_pd(x0, x0), _mm256_mul_pd(x1, x1));
+    _mm256_storeu_pd(out + i, _mm256_permute4x64_pd(h, 0xD8));
+  }
+  Scalar::absSquare(a, out, i, n);
+}
+
+COMPWA_AVX2 void multiplyAccumulate(std::complex<double> c, const double *aRe,
+                                    const double *aIm, double *outRe,
+                                    double *outIm, std::size_t n) {
+  __m256d cRe = _mm256_set1_pd(c.real()), cIm = _mm256_set1_pd(c.imag());
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d re = _mm256_loadu_pd(aRe + i), im = _mm256_loadu_pd(aIm + i);
+    __m256d oRe = _mm256_loadu_pd(outRe + i), oIm = _mm256_loadu_pd(outIm + i);
+    oRe = _mm256_fnmadd_pd(cIm, im, _mm256_fmadd_pd(cRe, re, oRe));
+    oIm = _mm256_fmadd_pd(cIm, re, _mm256_fmadd_pd(cRe, im, oIm));
+    _mm256_storeu_pd(outRe + i, oRe);
+    _mm256_storeu_pd(outIm + i, oIm);
+  }
+  Scalar::multiplyAccumulate(c, aRe, aIm, outRe, outIm, i, n);
+}
+
+COMPWA_AVX2 void absSquare(const double *aRe, const double *aIm, double *out,
+                           std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d re = _mm256_loadu_pd(aRe + i), im = _mm256_loadu_pd(aIm + i);
+    _mm256_storeu_pd(out + i, _mm256_fmadd_pd(re, re, _mm256_mul_pd(im, im)));
+  }
+  Scalar::absSquare(aRe, aIm, out, i, n);
+}
+
+COMPWA_AVX2 std::complex<double>
+sumConjugateProduct(const double *aRe, const double *aIm, const double *bRe,
+                    const double *bIm, std::size_t n) {
+  __m256d sRe = _mm256_setzero_pd(), sIm = _mm256_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d ar = _mm256_loadu_pd(aRe + i), ai = _mm256_loadu_pd(aIm + i);
+    __m256d br = _mm256_loadu_pd(bRe + i), bi = _mm256_loadu_pd(bIm + i);
+    sRe = _mm256_fmadd_pd(ai, bi, _mm256_fmadd_pd(ar, br, sRe));
+    sIm = _mm256_fnmadd_pd(ar, bi, _mm256_fmadd_pd(ai, br, sIm));
+  }
+  return std::complex<double>(sum(sRe), sum(sIm)) +
+         Scalar::sumConjugateProduct(aRe, aIm, bRe, bIm, i, n);
+}
+
+COMPWA_AVX2 std::complex<double>
+sumConjugateProduct(const double *aRe, const double *aIm, const double *bRe,
+                    const double *bIm, const double *w, std::size_t n) {
+  __m256d sRe = _mm256_setzero_pd(), sIm = _mm256_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d vw = _mm256_loadu_pd(w + i);
+    __m256d ar = _mm256_mul_pd(vw, _mm256_loadu_pd(aRe + i));
+    __m256d ai = _mm256_mul_pd(vw, _mm256_loadu_pd(aIm + i));
+    __m256d br = _mm256_loadu_pd(bRe + i), bi = _mm256_loadu_pd(bIm + i);
+    sRe = _mm256_fmadd_pd(ai, bi, _mm256_fmadd_pd(ar, br, sRe));
+    sIm = _mm256_fnmadd_pd(ar, bi, _mm256_fmadd_pd(ai, br, sIm));
+  }
+  return std::complex<double>(sum(sRe), sum(sIm)) +
+         Scalar::sumConjugateProduct(aRe, aIm, bRe, bIm, w, i, n);
+}
+
+#undef COMPWA_AVX2
+
+} // namespace Avx2
+
+//========== AVX-512 implementation ==========
+// A 512 bit register holds four interleaved complex numbers or eight doubles.
+namespace Avx512 {
+
+#define COMPWA_AVX512 __attribute__((target("avx512f,avx2,fma")))
+
+// The unmasked permutations of GCC start from an undefined register, which
+// triggers warnings about uninitialized values. We use the zero-masked forms
+// with all lanes selected instead.
+const __mmask8 AllLanes = 0xFF;
+
+using Scalar::ptr;
+
+COMPWA_AVX512 inline __m512d mul(__m512d a, __m512d b) {
+  __m512d bRe = _mm512_maskz_movedup_pd(AllLanes, b);
+  __m512d bIm = _mm512_maskz_permute_pd(AllLanes, b, 0xFF);
+  __m512d aSwap = _mm512_maskz_permute_pd(AllLanes, a, 0x55);
+  return _mm512_fmaddsub_pd(a, bRe, _mm512_mul_pd(aSwap, bIm));
+}
+
+COMPWA_AVX512 inline __m512d mul(__m512d cRe, __m512d cIm, __m512d a) {
+  __m512d aSwap = _mm512_maskz_permute_pd(AllLanes, a, 0x55);
+  return _mm512_fmaddsub_pd(a, cRe, _mm512_mul_pd(aSwap, cIm));
+}
+
+COMPWA_AVX512 void multiply(std::complex<double> c,
+                            const std::complex<double> *a,
+                            std::complex<double> *out, std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  __m512d cRe = _mm512_set1_pd(c.real()), cIm = _mm512_set1_pd(c.imag());
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm512_storeu_pd(po + 2 * i, mul(cRe, cIm, _mm512_loadu_pd(pa + 2 * i)));
+  Scalar::multiply(c, a, out, i, n);
+}
+
+COMPWA_AVX512 void multiply(const std::complex<double> *a,
+                            const std::complex<double> *b,
+                            std::complex<double> *out, std::size_t n) {
+  const double *pa = ptr(a), *pb = ptr(b);
+  double *po = ptr(out);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm512_storeu_pd(po + 2 * i, mul(_mm512_loadu_pd(pa + 2 * i),
+                                     _mm512_loadu_pd(pb + 2 * i)));
+  Scalar::multiply(a, b, out, i, n);
+}
+
+COMPWA_AVX512 void multiply(const std::complex<double> *a, const double *b,
+                            std::complex<double> *out, std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  const __m512i idx = _mm512_set_epi64(3, 3, 2, 2, 1, 1, 0, 0);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    // [b0, b0, b1, b1, b2, b2, b3, b3]
+    __m512d vb = _mm512_maskz_permutexvar_pd(
+        AllLanes, idx, _mm512_maskz_loadu_pd(0x0F, b + i));
+    _mm512_storeu_pd(po + 2 * i,
+                     _mm512_mul_pd(_mm512_loadu_pd(pa + 2 * i), vb));
+  }
+  Scalar::multiply(a, b, out, i, n);
+}
+
+COMPWA_AVX512 void add(const std::complex<double> *a,
+                       std::complex<double> *out, std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm512_storeu_pd(po + 2 * i, _mm512_add_pd(_mm512_loadu_pd(po + 2 * i),
+                                               _mm512_loadu_pd(pa + 2 * i)));
+  Scalar::add(a, out, i, n);
+}
+
+COMPWA_AVX512 void multiplyAccumulate(std::complex<double> c,
+                                      const std::complex<double> *a,
+                                      std::complex<double> *out,
+                                      std::size_t n) {
+  const double *pa = ptr(a);
+  double *po = ptr(out);
+  __m512d cRe = _mm512_set1_pd(c.real()), cIm = _mm512_set1_pd(c.imag());
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm512_storeu_pd(po + 2 * i,
+                     _mm512_add_pd(_mm512_loadu_pd(po + 2 * i),
+                                   mul(cRe, cIm, _mm512_loadu_pd(pa + 2 * i))));
+  Scalar::multiplyAccumulate(c, a, out, i, n);
+}
+
+COMPWA_AVX512 void absSquare(const std::complex<double> *a, double *out,
+                             std::size_t n) {
+  const double *pa = ptr(a);
+  const __m512i idxRe = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+  const __m512i idxIm = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d x0 = _mm512_loadu_pd(pa + 2 * i);
+    __m512d x1 = _mm512_loadu_pd(pa + 2 * i + 8);
+    __m512d re = _mm512_permutex2var_pd(x0, idxRe, x1);
+    __m512d im = _mm512_permutex2var_pd(x0, idxIm, x1);
+    _mm512_storeu_pd(out + i, _mm512_fmadd_pd(re, re, _mm512_mul_pd(im, im)));
+  }
+  Scalar::absSquare(a, out, i, n);
+}
+
+COMPWA_AVX512 void multiplyAccumulate(std::complex<double> c,
+                                      const double *aRe, const double *aIm,
+                                      double *outRe, double *outIm,
+                                      std::size_t n) {
+  __m512d cRe = _mm512_set1_pd(c.real()), cIm = _mm512_set1_pd(c.imag());
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d re = _mm512_loadu_pd(aRe + i), im = _mm512_loadu_pd(aIm + i);
+    __m512d oRe = _mm512_loadu_pd(outRe + i), oIm = _mm512_loadu_pd(outIm + i);
+    oRe = _mm512_fnmadd_pd(cIm, im, _mm512_fmadd_pd(cRe, re, oRe));
+    oIm = _mm512_fmadd_pd(cIm, re, _mm512_fmadd_pd(cRe, im, oIm));
+    _mm512_storeu_pd(outRe + i, oRe);
+    _mm512_storeu_pd(outIm + i, oIm);
+  }
+  Scalar::multiplyAccumulate(c, aRe, aIm, outRe, outIm, i, n);
+}
+
+COMPWA_AVX512 void absSquare(const double *aRe, const double *aIm,
+                             double *out, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d re = _mm512_loadu_pd(aRe + i), im = _mm512_loadu_pd(aIm + i);
+    _mm512_storeu_pd(out + i, _mm512_fmadd_pd(re, re, _mm512_mul_pd(im, im)));
+  }
+  Scalar::absSquare(aRe, aIm, out, i, n);
+}
+
+/// Sum of the elements of \p v
+COMPWA_AVX512 inline double sum(__m512d v) {
+  __m256d s = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0x0F, v, 0),
+                            _mm512_maskz_extractf64x4_pd(0x0F, v, 1));
+  __m128d t = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(t, _mm_unpackhi_pd(t, t)));
+}
+
+COMPWA_AVX512 std::complex<double>
+sumConjugateProduct(const double *aRe, const double *aIm, const double *bRe,
+                    const double *bIm, std::size_t n) {
+  __m512d sRe = _mm512_setzero_pd(), sIm = _mm512_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d ar = _mm512_loadu_pd(aRe + i), ai = _mm512_loadu_pd(aIm + i);
+    __m512d br = _mm512_loadu_pd(bRe + i), bi = _mm512_loadu_pd(bIm + i);
+    sRe = _mm512_fmadd_pd(ai, bi, _mm512_fmadd_pd(ar, br, sRe));
+    sIm = _mm512_fnmadd_pd(ar, bi, _mm512_fmadd_pd(ai, br, sIm));
+  }
+  return std::complex<double>(sum(sRe), sum(sIm)) +
+         Scalar::sumConjugateProduct(aRe, aIm, bRe, bIm, i, n);
+}
+
+COMPWA_AVX512 std::complex<double>
+sumConjugateProduct(const double *aRe, const double *aIm, const double *bRe,
+                    const double *bIm, const double *w, std::size_t n) {
+  __m512d sRe = _mm512_setzero_pd(), sIm = _mm512_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d vw = _mm512_loadu_pd(w + i);
+    __m512d ar = _mm512_mul_pd(vw, _mm512_loadu_pd(aRe + i));
+    __m512d ai = _mm512_mul_pd(vw, _mm512_loadu_pd(aIm + i));
+    __m512d br = _mm512_loadu_pd(bRe + i), bi = _mm512_loadu_pd(bIm + i);
+    sRe = _mm512_fmadd_pd(ai, bi, _mm512_fmadd_pd(ar, br, sRe));
+    sIm = _mm512_fnmadd_pd(ar, bi, _mm512_fmadd_pd(ai, br, sIm));
+  }
+  return std::complex<double>(sum(sRe), sum(sIm)) +
+         Scalar::sumConjugateProduct(aRe, aIm, bRe, bIm, w, i, n);
+}
+
+#undef COMPWA_AVX512
+
+} // namespace Avx512
+
+#endif // COMPWA_KERNELS_X86
+
+std::atomic<int> &currentLevel() {
+  static std::atomic<int> level(static_cast<int>(supportedSimdLevel()));
+  return level;
+}
+
+} // namespace
+
+SimdLevel supportedSimdLevel() {
+#ifdef COMPWA_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return SimdLevel::AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return SimdLevel::AVX2;
+#endif
+  return SimdLevel::SCALAR;
+}
+
+SimdLevel simdLevel() { return static_cast<SimdLevel>(currentLevel().load()); }
+
+SimdLevel setSimdLevel(SimdLevel level) {
+  level = std::min(level, supportedSimdLevel());
+  currentLevel() = static_cast<int>(level);
+  return level;
+}
+
+// Call the implementation for the current instruction set. The arguments
+// are given without the array size n.
+#ifdef COMPWA_KERNELS_X86
+#define COMPWA_DISPATCH(function, ...)                                         \
+  switch (simdLevel()) {                                                       \
+  case SimdLevel::AVX512:                                                      \
+    return Avx512::function(__VA_ARGS__, n);                                      \
+  case SimdLevel::AVX2:                                                        \
+    return Avx2::function(__VA_ARGS__, n);                                        \
+  default:                                                                     \
+    return Scalar::function(__VA_ARGS__, 0, n);                                \
+  }
+#else
+#define COMPWA_DISPATCH(function, ...)                                         \
+  return Scalar::function(__VA_ARGS__, 0, n);
+#endif
+
+void multiply(std::complex<double> c, const std::complex<double> *a,
+              std::complex<double> *out, std::size_t n) {
+  COMPWA_DISPATCH(multiply, c, a, out);
+}
+
+void multiply(const std::complex<double> *a, const std::complex<double> *b,
+              std::complex<double> *out, std::size_t n) {
+  COMPWA_DISPATCH(multiply, a, b, out);
+}
+
+void multiply(const std::complex<double> *a, const double *b,
+              std::complex<double> *out, std::size_t n) {
+  COMPWA_DISPATCH(multiply, a, b, out);
+}
+
+void add(const std::complex<double> *a, std::complex<double> *out,
+         std::size_t n) {
+  COMPWA_DISPATCH(add, a, out);
+}
+
+void multiplyAccumulate(std::complex<double> c, const std::complex<double> *a,
+                        std::complex<double> *out, std::size_t n) {
+  COMPWA_DISPATCH(multiplyAccumulate, c, a, out);
+}
+
+void absSquare(const std::complex<double> *a, double *out, std::size_t n) {
+  COMPWA_DISPATCH(absSquare, a, out);
+}
+
+void multiplyAccumulate(std::complex<double> c, const double *aRe,
+                        const double *aIm, double *outRe, double *outIm,
+                        std::size_t n) {
+  COMPWA_DISPATCH(multiplyAccumulate, c, aRe, aIm, outRe, outIm);
+}
+
+void absSquare(const double *aRe, const double *aIm, double *out,
+               std::size_t n) {
+  COMPWA_DISPATCH(absSquare, aRe, aIm, out);
+}
+
+std::complex<double> sumConjugateProduct(const double *aRe, const double *aIm,
+                                         const double *bRe, const double *bIm,
+                                         std::size_t n) {
+  COMPWA_DISPATCH(sumConjugateProduct, aRe, aIm, bRe, bIm);
+}
+
+std::complex<double> sumConjugateProduct(const double *aRe, const double *aIm,
+                                         const double *bRe, const double *bIm,
+                                         const double *w, std::size_t n) {
+  COMPWA_DISPATCH(sumConjugateProduct, aRe, aIm, bRe, bIm, w);
+}
+
+#undef COMPWA_DISPATCH
+
+} // namespace Kernels
+} // namespace ComPWA
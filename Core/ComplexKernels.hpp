@@ -0,0 +1,126 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Vectorized kernels for arrays of complex numbers.
+///
+/// The kernels exist for two memory layouts: the interleaved layout of
+/// std::vector<std::complex<double>> (re, im, re, im, ...) which is used for
+/// multi complex values in the FunctionTree and a split layout
+/// (SplitComplex) in which real and imaginary parts are stored in separate
+/// arrays. The split layout does not need any shuffling of vector registers and
+/// is preferable for data that is owned by the caller, e.g. cached amplitudes.
+///
+/// The instruction set is selected at runtime. AVX-512 and AVX2 (+FMA) code
+/// paths are compiled via function attributes so that the library itself
+/// does not require a specific target architecture. Other platforms use the
+/// scalar implementation.
+///
+/// Note that the vectorized code paths use fused multiply-add. The results can
+/// differ from the scalar implementation in the last bit.
+///
+
+#ifndef _COMPLEXKERNELS_HPP_
+#define _COMPLEXKERNELS_HPP_
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace ComPWA {
+namespace Kernels {
+
+enum class SimdLevel { SCALAR = 0, AVX2 = 1, AVX512 = 2 };
+
+/// Best instruction set that is supported by the CPU
+SimdLevel supportedSimdLevel();
+
+/// Instruction set that is currently used by the kernels
+SimdLevel simdLevel();
+
+/// Select the instruction set. Levels that are not supported by the CPU are
+/// reduced to the best supported level. Returns the level that is used.
+SimdLevel setSimdLevel(SimdLevel level);
+
+///
+/// \struct SplitComplex
+/// Array of complex numbers with real and imaginary parts stored in separate
+/// arrays.
+///
+struct SplitComplex {
+  SplitComplex(std::size_t n = 0) : Re(n), Im(n) {}
+
+  SplitComplex(const std::vector<std::complex<double>> &v);
+
+  std::size_t size() const { return Re.size(); }
+
+  void resize(std::size_t n) {
+    Re.resize(n);
+    Im.resize(n);
+  }
+
+  std::complex<double> operator[](std::size_t i) const {
+    return std::complex<double>(Re[i], Im[i]);
+  }
+
+  /// Copy to interleaved layout
+  void toInterleaved(std::vector<std::complex<double>> &v) const;
+
+  std::vector<double> Re;
+
+  std::vector<double> Im;
+};
+
+//========== Interleaved layout ==========
+// The output may alias the inputs.
+
+/// out[i] = c * a[i]
+void multiply(std::complex<double> c, const std::complex<double> *a,
+              std::complex<double> *out, std::size_t n);
+
+/// out[i] = a[i] * b[i]
+void multiply(const std::complex<double> *a, const std::complex<double> *b,
+              std::complex<double> *out, std::size_t n);
+
+/// out[i] = a[i] * b[i]
+void multiply(const std::complex<double> *a, const double *b,
+              std::complex<double> *out, std::size_t n);
+
+/// out[i] += a[i]
+void add(const std::complex<double> *a, std::complex<double> *out,
+         std::size_t n);
+
+/// out[i] += c * a[i]
+void multiplyAccumulate(std::complex<double> c, const std::complex<double> *a,
+                        std::complex<double> *out, std::size_t n);
+
+/// out[i] = |a[i]|^2
+void absSquare(const std::complex<double> *a, double *out, std::size_t n);
+
+//========== Split layout ==========
+
+/// (outRe + i outIm)[i] += c * (aRe + i aIm)[i]
+void multiplyAccumulate(std::complex<double> c, const double *aRe,
+                        const double *aIm, double *outRe, double *outIm,
+                        std::size_t n);
+
+/// out[i] = aRe[i]^2 + aIm[i]^2
+void absSquare(const double *aRe, const double *aIm, double *out,
+               std::size_t n);
+
+/// Sum_i a[i] * conj(b[i])
+std::complex<double> sumConjugateProduct(const double *aRe, const double *aIm,
+                                         const double *bRe, const double *bIm,
+                                         std::size_t n);
+
+/// Sum_i w[i] * a[i] * conj(b[i])
+std::complex<double> sumConjugateProduct(const double *aRe, const double *aIm,
+                                         const double *bRe, const double *bIm,
+                                         const double *w, std::size_t n);
+
+} // namespace Kernels
+} // namespace ComPWA
+
+#endif
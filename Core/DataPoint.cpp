@@ -3,21 +3,41 @@
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
 #include <algorithm>
+#include <stdexcept>
 #include "Core/Exceptions.hpp"
 #include "Core/Kinematics.hpp"
 #include "Core/DataPoint.hpp"
 
 namespace ComPWA {
 
-DataPoint::DataPoint() : Weight(1.), Eff(1.) {
+DataPoint::DataPoint()
+    : View(nullptr), FloatView(nullptr), ViewSize(0), ViewIndex(0),
+      ViewEvents(0), ViewSample(0), Weight(1.), Eff(1.) {
   return;
 }
 
-void DataPoint::reset(unsigned int size) { Values = std::vector<double>(size); }
+void DataPoint::reset(unsigned int size) {
+  View = nullptr;
+  FloatView = nullptr;
+  ViewSize = 0;
+  Values = std::vector<double>(size);
+}
+
+std::vector<double> &DataPoint::values() {
+  if (isView()) {
+    Values.resize(ViewSize);
+    for (std::size_t k = 0; k < ViewSize; ++k)
+      Values[k] = View ? View[k][ViewIndex] : FloatView[k][ViewIndex];
+    View = nullptr;
+    FloatView = nullptr;
+    ViewSize = 0;
+  }
+  return Values;
+}
 
 void DataPoint::setValue(unsigned int pos, double val) {
   try {
-    Values.at(pos) = val;
+    values().at(pos) = val;
   } catch (...) {
     LOG(ERROR) << "dataPoint::setVal() | Can not access index " << pos << "!";
     throw;
@@ -26,15 +46,15 @@ void DataPoint::setValue(unsigned int pos, double val) {
 }
 
 double DataPoint::value(unsigned int num) const {
-  double rt;
-
-  try {
-    rt = Values.at(num);
-  } catch (...) {
+  if (num >= size()) {
     LOG(ERROR) << "dataPoint::getVal() | Can not access index " << num << "!";
-    throw;
+    throw std::out_of_range("DataPoint::value() | Index out of range!");
   }
-  return rt;
+  if (View)
+    return View[num][ViewIndex];
+  if (FloatView)
+    return FloatView[num][ViewIndex];
+  return Values[num];
 }
 
 std::ostream &operator<<(std::ostream &os, const DataPoint &p) {
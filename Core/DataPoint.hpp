@@ -10,6 +10,7 @@
 #ifndef DATAPOINT_HPP_
 #define DATAPOINT_HPP_
 
+#include <cstdint>
 #include <cstdlib>
 #include <math.h>
 #include <vector>
@@ -23,14 +24,36 @@ namespace ComPWA {
 /// In case of the HelicityFormalism is would be a triple (m,theta,phi) for
 /// each relevant SubSysyem.
 ///
+/// A DataPoint either owns its values or is a view of one event of columns
+/// that are stored elsewhere, e.g. in a DataPointSet. A view does not
+/// allocate memory and is cheap to copy. The columns have to outlive it.
+/// Modifying the values of a view via values() copies them first.
+///
 class DataPoint {
 
 public:
   DataPoint();
 
+  /// View of event \p index of the \p size columns \p columns. The
+  /// columns contain \p numEvents events, \p sample identifies their
+  /// contents (see sample()).
+  DataPoint(const double *const *columns, std::size_t size, std::size_t index,
+            std::size_t numEvents, std::uint64_t sample, double weight = 1.,
+            double eff = 1.)
+      : View(columns), FloatView(nullptr), ViewSize(size), ViewIndex(index),
+        ViewEvents(numEvents), ViewSample(sample), Weight(weight), Eff(eff) {}
+
+  /// View of event \p index of the \p size single precision columns
+  /// \p columns. The values are converted to double on access.
+  DataPoint(const float *const *columns, std::size_t size, std::size_t index,
+            std::size_t numEvents, std::uint64_t sample, double weight = 1.,
+            double eff = 1.)
+      : View(nullptr), FloatView(columns), ViewSize(size), ViewIndex(index),
+        ViewEvents(numEvents), ViewSample(sample), Weight(weight), Eff(eff) {}
+
   void reset(unsigned int size);
 
-  std::size_t size() const { return Values.size(); }
+  std::size_t size() const { return isView() ? ViewSize : Values.size(); }
 
   void setValue(unsigned int pos, double val);
   
@@ -44,15 +67,40 @@ public:
   
   double efficiency() const { return Eff; };
   
-  /// Reference to interval vector of values
-  std::vector<double>& values() { return Values; };
+  /// Reference to interval vector of values. A view is converted to a
+  /// DataPoint that owns its values.
+  std::vector<double>& values();
+
+  /// Is this DataPoint a view of values stored elsewhere?
+  bool isView() const { return View || FloatView; }
+
+  /// Identity of the viewed sample, zero if the values are owned. Views of
+  /// events of the same sample have the same identity. It is not reused for
+  /// other samples or after the sample was modified (see
+  /// DataPointSet::generation()). It can be used to cache quantities per
+  /// event, see HelicityDecay::evaluateNoNorm().
+  std::uint64_t sample() const { return isView() ? ViewSample : 0; }
+
+  /// Number of events in the viewed columns, zero if the values are owned
+  std::size_t sampleSize() const { return isView() ? ViewEvents : 0; }
+
+  /// Index of the event in the viewed columns
+  std::size_t index() const { return ViewIndex; }
 
-  std::vector<double>::iterator first() { return Values.begin(); }
+  std::vector<double>::iterator first() { return values().begin(); }
 
-  std::vector<double>::iterator last() { return Values.end(); }
+  std::vector<double>::iterator last() { return values().end(); }
 
 protected:
   std::vector<double> Values;
+  /// Columns of a view, null if the values are owned
+  const double *const *View;
+  /// Single precision columns of a view, null if the values are owned
+  const float *const *FloatView;
+  std::size_t ViewSize;
+  std::size_t ViewIndex;
+  std::size_t ViewEvents;
+  std::uint64_t ViewSample;
   double Weight;
   double Eff;
   friend std::ostream &operator<<(std::ostream &os, const DataPoint &p);
@@ -0,0 +1,240 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <stdexcept>
+#include <string>
+
+#include "Core/DataPointSet.hpp"
+#include "Core/Exceptions.hpp"
+
+namespace ComPWA {
+
+DataPointSet::DataPointSet(std::size_t numVariables)
+    : Efficiencies(MDouble("Efficiency", 0)), Weights(MDouble("Weight", 0)),
+      Prec(Precision::DOUBLE) {
+  for (std::size_t k = 0; k < numVariables; ++k)
+    Columns.push_back(MDouble("", 0));
+  updatePointers();
+}
+
+DataPointSet::DataPointSet(std::vector<std::vector<double>> &&columns,
+                           const std::vector<char> &mask,
+                           const double *weights, const double *efficiencies,
+                           Precision precision)
+    : Efficiencies(MDouble("Efficiency", 0)), Weights(MDouble("Weight", 0)),
+      Prec(Precision::DOUBLE) {
+  std::vector<EventColumn<double>> cols;
+  for (auto &column : columns)
+    cols.push_back(EventColumn<double>(std::move(column)));
+  init(cols, mask.data(), mask.size(), weights, efficiencies, precision);
+}
+
+DataPointSet::DataPointSet(std::vector<EventColumn<double>> &&columns,
+                           const EventColumn<char> &mask,
+                           const double *weights, const double *efficiencies,
+                           Precision precision)
+    : Efficiencies(MDouble("Efficiency", 0)), Weights(MDouble("Weight", 0)),
+      Prec(Precision::DOUBLE) {
+  init(columns, mask.data(), mask.size(), weights, efficiencies, precision);
+}
+
+void DataPointSet::init(std::vector<EventColumn<double>> &columns,
+                        const char *mask, std::size_t size,
+                        const double *weights, const double *efficiencies,
+                        Precision precision) {
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < size; ++i)
+    n += (mask[i] != 0);
+  auto &w = Weights->values();
+  auto &e = Efficiencies->values();
+  w.reserve(n);
+  e.reserve(n);
+  for (std::size_t i = 0; i < size; ++i) {
+    if (!mask[i])
+      continue;
+    w.push_back(weights ? weights[i] : 1.);
+    e.push_back(efficiencies ? efficiencies[i] : 1.);
+  }
+
+  for (auto &column : columns) {
+    if (column.size() != size)
+      throw BadParameter("DataPointSet::DataPointSet() | Column and mask "
+                         "have different sizes!");
+    const double *values = column.data();
+    if (precision == Precision::FLOAT) {
+      FloatColumns.push_back(std::vector<float>());
+      auto &f = FloatColumns.back();
+      f.reserve(n);
+      for (std::size_t i = 0; i < size; ++i)
+        if (mask[i])
+          f.push_back(values[i]);
+      column = EventColumn<double>();
+      continue;
+    }
+    Columns.push_back(MDouble("", 0));
+    auto &v = Columns.back()->values();
+    if (column.external()) {
+      v.reserve(n);
+      for (std::size_t i = 0; i < size; ++i)
+        if (mask[i])
+          v.push_back(values[i]);
+      column = EventColumn<double>();
+      continue;
+    }
+    // Events outside the phase space are removed in place, the column is
+    // not copied
+    v = column.release();
+    if (n != size) {
+      std::size_t k = 0;
+      for (std::size_t i = 0; i < size; ++i)
+        if (mask[i])
+          v[k++] = v[i];
+    }
+    v.resize(n);
+  }
+  Prec = precision;
+  updatePointers();
+}
+
+DataPointSet::DataPointSet(const DataPointSet &other)
+    : Efficiencies(MDouble("Efficiency", other.Efficiencies->values())),
+      Weights(MDouble("Weight", other.Weights->values())), Prec(other.Prec),
+      FloatColumns(other.FloatColumns) {
+  for (auto &column : other.Columns)
+    Columns.push_back(MDouble(column->name(), column->values()));
+  updatePointers();
+}
+
+DataPointSet &DataPointSet::operator=(const DataPointSet &other) {
+  if (this != &other)
+    *this = DataPointSet(other);
+  return *this;
+}
+
+void DataPointSet::updatePointers() {
+  ColumnPointers.clear();
+  for (auto &column : Columns)
+    ColumnPointers.push_back(column->values().data());
+  FloatColumnPointers.clear();
+  for (auto &column : FloatColumns)
+    FloatColumnPointers.push_back(column.data());
+  Generation = newGeneration();
+}
+
+void DataPointSet::setPrecision(Precision precision) {
+  if (precision == Prec)
+    return;
+  // The columns are converted one by one to limit the peak memory. Columns
+  // that are shared via dataList() are released but not modified.
+  if (precision == Precision::FLOAT) {
+    for (auto &column : Columns) {
+      FloatColumns.push_back(
+          std::vector<float>(column->values().begin(), column->values().end()));
+      column.reset();
+    }
+    Columns.clear();
+  } else {
+    for (auto &column : FloatColumns) {
+      Columns.push_back(MDouble("", 0));
+      Columns.back()->values().assign(column.begin(), column.end());
+      std::vector<float>().swap(column);
+    }
+    FloatColumns.clear();
+  }
+  Prec = precision;
+  updatePointers();
+}
+
+void DataPointSet::resize(std::size_t n) {
+  for (auto &column : Columns)
+    column->values().resize(n);
+  for (auto &column : FloatColumns)
+    column.resize(n);
+  Weights->values().resize(n, 1.);
+  Efficiencies->values().resize(n, 1.);
+  updatePointers();
+  modified();
+}
+
+void DataPointSet::reserve(std::size_t n) {
+  for (auto &column : Columns)
+    column->values().reserve(n);
+  for (auto &column : FloatColumns)
+    column.reserve(n);
+  Weights->values().reserve(n);
+  Efficiencies->values().reserve(n);
+  updatePointers();
+}
+
+void DataPointSet::add(const DataPoint &point) {
+  if (empty() && numVariables() == 0) {
+    for (std::size_t k = 0; k < point.size(); ++k) {
+      if (Prec == Precision::FLOAT)
+        FloatColumns.push_back(std::vector<float>());
+      else
+        Columns.push_back(MDouble("", 0));
+    }
+  }
+  if (point.size() != numVariables())
+    throw BadParameter("DataPointSet::add() | DataPoint has " +
+                       std::to_string(point.size()) + " values but the set "
+                       "has " + std::to_string(numVariables()) +
+                       " variables!");
+  // The point may be a view of this set, its values are read before any
+  // column is reallocated
+  std::vector<double> values(numVariables());
+  for (std::size_t k = 0; k < values.size(); ++k)
+    values[k] = point.value(k);
+  double weight = point.weight(), eff = point.efficiency();
+
+  for (std::size_t k = 0; k < values.size(); ++k) {
+    if (Prec == Precision::FLOAT)
+      FloatColumns[k].push_back((float)values[k]);
+    else
+      Columns[k]->values().push_back(values[k]);
+  }
+  Weights->values().push_back(weight);
+  Efficiencies->values().push_back(eff);
+  updatePointers();
+  modified();
+}
+
+DataPoint DataPointSet::at(std::size_t i) const {
+  if (i >= size())
+    throw std::out_of_range("DataPointSet::at() | Index " +
+                            std::to_string(i) + " out of range!");
+  return (*this)[i];
+}
+
+ParameterList DataPointSet::dataList() const {
+  if (Prec == Precision::FLOAT)
+    throw BadParameter("DataPointSet::dataList() | The FunctionTree requires "
+                       "double columns, convert the set with "
+                       "setPrecision(Precision::DOUBLE) first!");
+  ParameterList list;
+  for (auto &column : Columns)
+    list.addValue(column);
+  list.addValue(Efficiencies);
+  list.addValue(Weights);
+  return list;
+}
+
+std::size_t DataPointSet::memory() const {
+  std::size_t bytes = 0;
+  for (auto &column : Columns)
+    bytes += column->values().size() * sizeof(double);
+  for (auto &column : FloatColumns)
+    bytes += column.size() * sizeof(float);
+  return bytes;
+}
+
+void DataPointSet::modified() {
+  Generation = newGeneration();
+  for (auto &column : Columns)
+    column->modified();
+  Weights->modified();
+  Efficiencies->modified();
+}
+
+} // ns::ComPWA
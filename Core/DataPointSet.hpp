@@ -0,0 +1,324 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// DataPointSet class.
+///
+
+#ifndef DATAPOINTSET_HPP_
+#define DATAPOINTSET_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "Core/DataPoint.hpp"
+#include "Core/EventCollection.hpp"
+#include "Core/ParameterList.hpp"
+#include "Core/Value.hpp"
+
+namespace ComPWA {
+
+///
+/// \class DataPointSet
+/// Set of DataPoints with the same number of variables. The set is the
+/// single storage of a converted sample for both layouts that are used in
+/// ComPWA:
+///   - 'vertical': the elements are accessed as DataPoint views (see
+///     DataPoint), which neither allocate memory nor copy the values,
+///   - 'horizontal': dataList() returns a ParameterList with one
+///     MultiDouble per variable, followed by the efficiency and the weight
+///     columns. The MultiDoubles are the columns of the set, they are shared
+///     and not copied. This is the input of AmpIntensity::tree().
+///
+/// The set is usually shared via std::shared_ptr (see Data::dataPoints()).
+/// Copies of a set copy the columns. Views are invalidated if the size of the
+/// set changes. The columns must not be resized via dataList(). Setting the
+/// weight of a view does not modify the set, use setWeight() and
+/// setEfficiency() instead.
+///
+/// Modifications via setValue(), setWeight(), setEfficiency(), add() and
+/// resize() are announced to the tree leaves of the shared columns (see
+/// Value::modified()), the tree is recalculated on its next evaluation.
+/// Modifications via column(), weights() and efficiencies() have to be
+/// announced with modified(). A tree that was built from dataList() stores
+/// the number of events in some of its nodes and has to be rebuilt if the
+/// size of the set changes.
+///
+/// The variables can be stored in single precision (see setPrecision()) to
+/// halve the memory and the bandwidth of large phase space samples. Views
+/// and value() convert the variables to double, all sums over the set are
+/// accumulated in double. Weights and efficiencies are always stored in
+/// double precision. Since the FunctionTree requires double columns, a
+/// single precision set can only be evaluated via views, dataList() refuses
+/// it.
+///
+class DataPointSet {
+
+public:
+  /// Storage precision of the variables
+  enum class Precision { DOUBLE, FLOAT };
+
+  /// Iterator over views of the points
+  class const_iterator {
+  public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef DataPoint value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const DataPoint *pointer;
+    typedef DataPoint reference;
+
+    const_iterator(const DataPointSet *set = nullptr, std::size_t i = 0)
+        : Set(set), Index(i) {}
+
+    DataPoint operator*() const { return (*Set)[Index]; }
+
+    DataPoint operator[](std::ptrdiff_t n) const { return (*Set)[Index + n]; }
+
+    const_iterator &operator++() {
+      ++Index;
+      return *this;
+    }
+
+    const_iterator operator++(int) { return const_iterator(Set, Index++); }
+
+    const_iterator &operator--() {
+      --Index;
+      return *this;
+    }
+
+    const_iterator operator--(int) { return const_iterator(Set, Index--); }
+
+    const_iterator &operator+=(std::ptrdiff_t n) {
+      Index += n;
+      return *this;
+    }
+
+    const_iterator &operator-=(std::ptrdiff_t n) {
+      Index -= n;
+      return *this;
+    }
+
+    const_iterator operator+(std::ptrdiff_t n) const {
+      return const_iterator(Set, Index + n);
+    }
+
+    const_iterator operator-(std::ptrdiff_t n) const {
+      return const_iterator(Set, Index - n);
+    }
+
+    std::ptrdiff_t operator-(const const_iterator &other) const {
+      return (std::ptrdiff_t)Index - (std::ptrdiff_t)other.Index;
+    }
+
+    bool operator==(const const_iterator &other) const {
+      return Index == other.Index;
+    }
+
+    bool operator!=(const const_iterator &other) const {
+      return Index != other.Index;
+    }
+
+    bool operator<(const const_iterator &other) const {
+      return Index < other.Index;
+    }
+
+  private:
+    const DataPointSet *Set;
+    std::size_t Index;
+  };
+
+  /// Empty set of points with \p numVariables variables
+  DataPointSet(std::size_t numVariables = 0);
+
+  /// Points from columns of variables. Event i is added if \p mask.at(i) is
+  /// not zero. The format of \p columns and \p mask is the one of
+  /// Kinematics::convert(). The columns are moved to the set. Weights and
+  /// efficiencies of the events are taken from \p weights and
+  /// \p efficiencies if they are not null, otherwise they are one.
+  /// The variables are stored with \p precision.
+  DataPointSet(std::vector<std::vector<double>> &&columns,
+               const std::vector<char> &mask, const double *weights = nullptr,
+               const double *efficiencies = nullptr,
+               Precision precision = Precision::DOUBLE);
+
+  /// Points from columns of variables, see the constructor above. Columns
+  /// that own their values are moved to the set for double precision.
+  /// External columns (e.g. views of a VariableCache file) are copied once,
+  /// directly to the storage of the set.
+  DataPointSet(std::vector<EventColumn<double>> &&columns,
+               const EventColumn<char> &mask, const double *weights = nullptr,
+               const double *efficiencies = nullptr,
+               Precision precision = Precision::DOUBLE);
+
+  DataPointSet(const DataPointSet &other);
+
+  DataPointSet(DataPointSet &&other) = default;
+
+  DataPointSet &operator=(const DataPointSet &other);
+
+  DataPointSet &operator=(DataPointSet &&other) = default;
+
+  std::size_t size() const { return Weights->values().size(); }
+
+  bool empty() const { return Weights->values().empty(); }
+
+  std::size_t numVariables() const {
+    return Prec == Precision::FLOAT ? FloatColumns.size() : Columns.size();
+  }
+
+  Precision precision() const { return Prec; }
+
+  /// Convert the variables to \p precision. Views of the set are
+  /// invalidated. Lists returned by dataList() of a double set keep their
+  /// columns, which are no longer updated by the set. Trees that were built
+  /// from them have to be rebuilt after the conversion back to double.
+  /// Converting to single precision rounds the variables to the nearest
+  /// float.
+  void setPrecision(Precision precision);
+
+  /// Resize to \p n points. New points have zero values, weight one and
+  /// efficiency one.
+  void resize(std::size_t n);
+
+  void reserve(std::size_t n);
+
+  void clear() { resize(0); }
+
+  /// Append a copy of \p point. The first point of an empty set without
+  /// variables sets the number of variables. Throws BadParameter if the
+  /// number of values of \p point differs from numVariables().
+  void add(const DataPoint &point);
+
+  void push_back(const DataPoint &point) { add(point); }
+
+  /// View of point \p i
+  DataPoint operator[](std::size_t i) const {
+    if (Prec == Precision::FLOAT)
+      return DataPoint(FloatColumnPointers.data(), FloatColumnPointers.size(),
+                       i, size(), Generation, Weights->values()[i],
+                       Efficiencies->values()[i]);
+    return DataPoint(ColumnPointers.data(), ColumnPointers.size(), i, size(),
+                     Generation, Weights->values()[i],
+                     Efficiencies->values()[i]);
+  }
+
+  /// View of point \p i. Throws std::out_of_range if \p i is not valid.
+  DataPoint at(std::size_t i) const;
+
+  DataPoint front() const { return (*this)[0]; }
+
+  DataPoint back() const { return (*this)[size() - 1]; }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+
+  const_iterator end() const { return const_iterator(this, size()); }
+
+  /// Variable \p k of all points. Only valid for double precision.
+  /// Modifications via the returned pointer have to be announced with
+  /// modified().
+  double *column(std::size_t k) { return ColumnPointers[k]; }
+
+  const double *column(std::size_t k) const { return ColumnPointers[k]; }
+
+  /// Variable \p k of all points. Only valid for single precision.
+  const float *floatColumn(std::size_t k) const {
+    return FloatColumnPointers[k];
+  }
+
+  double value(std::size_t i, std::size_t k) const {
+    if (Prec == Precision::FLOAT)
+      return FloatColumnPointers[k][i];
+    return ColumnPointers[k][i];
+  }
+
+  void setValue(std::size_t i, std::size_t k, double v) {
+    Generation = newGeneration();
+    if (Prec == Precision::FLOAT) {
+      FloatColumnPointers[k][i] = (float)v;
+    } else {
+      ColumnPointers[k][i] = v;
+      Columns[k]->modified();
+    }
+  }
+
+  double weight(std::size_t i) const { return Weights->values()[i]; }
+
+  void setWeight(std::size_t i, double w) {
+    Weights->values()[i] = w;
+    Weights->modified();
+  }
+
+  double efficiency(std::size_t i) const { return Efficiencies->values()[i]; }
+
+  void setEfficiency(std::size_t i, double e) {
+    Efficiencies->values()[i] = e;
+    Efficiencies->modified();
+  }
+
+  double *weights() { return Weights->values().data(); }
+
+  const double *weights() const { return Weights->values().data(); }
+
+  double *efficiencies() { return Efficiencies->values().data(); }
+
+  const double *efficiencies() const {
+    return Efficiencies->values().data();
+  }
+
+  /// 'Horizontal' view of the set: one MultiDouble per variable followed by
+  /// the efficiencies and the weights. The MultiDoubles are shared with the
+  /// set. Throws BadParameter for single precision.
+  ParameterList dataList() const;
+
+  /// Announce modifications via column(), weights() or efficiencies():
+  /// assigns a new generation and notifies the tree leaves of the columns
+  void modified();
+
+  /// Identity of the contents of the set. A new value, which is unique
+  /// within the process, is assigned on construction, if the set is
+  /// resized or converted and by setValue() and modified(). Views carry the
+  /// generation of their set, see DataPoint::sample().
+  std::uint64_t generation() const { return Generation; }
+
+  /// Memory in bytes that is used to store the variables
+  std::size_t memory() const;
+
+protected:
+  /// Fill the set from \p columns with \p n events, see the constructors
+  void init(std::vector<EventColumn<double>> &columns, const char *mask,
+            std::size_t n, const double *weights, const double *efficiencies,
+            Precision precision);
+
+  /// Update ColumnPointers after the columns were reallocated. Assigns a
+  /// new generation.
+  void updatePointers();
+
+  std::vector<std::shared_ptr<Value<std::vector<double>>>> Columns;
+
+  std::shared_ptr<Value<std::vector<double>>> Efficiencies;
+
+  std::shared_ptr<Value<std::vector<double>>> Weights;
+
+  /// Pointers to the data of Columns
+  std::vector<double *> ColumnPointers;
+
+  Precision Prec;
+
+  /// Variables in single precision, Columns is empty in this case
+  std::vector<std::vector<float>> FloatColumns;
+
+  /// Pointers to the data of FloatColumns
+  std::vector<float *> FloatColumnPointers;
+
+  /// See generation()
+  std::uint64_t Generation;
+};
+
+} // ns::ComPWA
+
+#endif
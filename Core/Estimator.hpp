@@ -12,6 +12,7 @@
 
 #include <vector>
 #include <memory>
+#include <stdexcept>
 
 #include "Core/ParameterList.hpp"
 
@@ -40,6 +41,17 @@ public:
   /// Calculate value of Estimator given parameters \p par
   virtual double controlParameter(ParameterList &par) = 0;
 
+  /// Does the estimator provide the gradient?
+  virtual bool hasGradient() const { return false; }
+
+  /// Derivatives of the estimator with respect to the double parameters of
+  /// \p par. The derivatives with respect to fixed parameters are zero.
+  /// If the estimator does not provide a gradient an exception is thrown.
+  virtual std::vector<double> gradient(ParameterList &par) {
+    throw std::runtime_error(
+        "IEstimator::gradient() | Gradient is not implemented!");
+  }
+
   /// Get the FunctionTree.
   /// If no FunctionTree is available an exception is thrown.
   virtual std::shared_ptr<FunctionTree> tree() = 0;
@@ -0,0 +1,167 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <stdexcept>
+#include <string>
+
+#include "Core/EventCollection.hpp"
+#include "Core/Exceptions.hpp"
+
+using namespace ComPWA;
+
+EventCollection::EventCollection(std::size_t numParticles)
+    : Particles(numParticles) {}
+
+EventCollection::EventCollection(const ExternalColumns &columns)
+    : Particles(columns.Px.size()) {
+  std::size_t n = columns.NumEvents;
+  if (columns.Py.size() != numParticles() ||
+      columns.Pz.size() != numParticles() ||
+      columns.E.size() != numParticles() ||
+      columns.Pid.size() != numParticles() ||
+      columns.ParticleCharge.size() != numParticles())
+    throw BadParameter("EventCollection::EventCollection() | Number of "
+                       "columns does not match the number of particles!");
+
+  for (std::size_t j = 0; j < numParticles(); ++j) {
+    auto &p = Particles[j];
+    p.Px.setExternal(columns.Px[j], n, columns.Owner);
+    p.Py.setExternal(columns.Py[j], n, columns.Owner);
+    p.Pz.setExternal(columns.Pz[j], n, columns.Owner);
+    p.E.setExternal(columns.E[j], n, columns.Owner);
+    p.Pid.resize(n, columns.Pid[j]);
+    p.Charge.resize(n, columns.ParticleCharge[j]);
+  }
+  Weights.setExternal(columns.Weights, n, columns.Owner);
+  Efficiencies.setExternal(columns.Efficiencies, n, columns.Owner);
+  Charges.setExternal(columns.Charges, n, columns.Owner);
+}
+
+void EventCollection::reserve(std::size_t n) {
+  for (auto &p : Particles) {
+    p.Px.reserve(n);
+    p.Py.reserve(n);
+    p.Pz.reserve(n);
+    p.E.reserve(n);
+    p.Pid.reserve(n);
+    p.Charge.reserve(n);
+  }
+  Weights.reserve(n);
+  Efficiencies.reserve(n);
+  Charges.reserve(n);
+}
+
+void EventCollection::resize(std::size_t n) {
+  for (auto &p : Particles) {
+    p.Px.resize(n, 0.);
+    p.Py.resize(n, 0.);
+    p.Pz.resize(n, 0.);
+    p.E.resize(n, 0.);
+    p.Pid.resize(n, 0);
+    p.Charge.resize(n, 0);
+  }
+  Weights.resize(n, 1.);
+  Efficiencies.resize(n, 1.);
+  Charges.resize(n, 0);
+}
+
+void EventCollection::clear() { resize(0); }
+
+void EventCollection::checkNumParticles(const Event &ev) {
+  if (empty() && !numParticles())
+    Particles.resize(ev.numParticles());
+  if (ev.numParticles() != numParticles())
+    throw BadParameter("EventCollection::checkNumParticles() | Event has " +
+                       std::to_string(ev.numParticles()) +
+                       " particles but the collection expects " +
+                       std::to_string(numParticles()) + "!");
+}
+
+void EventCollection::add(const Event &ev) {
+  checkNumParticles(ev);
+  resize(size() + 1);
+  setEvent(size() - 1, ev);
+}
+
+void EventCollection::append(const EventCollection &other) {
+  append(other, 0, other.size());
+}
+
+void EventCollection::append(const EventCollection &other, std::size_t begin,
+                             std::size_t end) {
+  if (begin > end || end > other.size())
+    throw BadParameter("EventCollection::append() | Invalid range [" +
+                       std::to_string(begin) + ", " + std::to_string(end) +
+                       ")!");
+  if (begin == end)
+    return;
+  if (empty() && !numParticles())
+    Particles.resize(other.numParticles());
+  if (other.numParticles() != numParticles())
+    throw BadParameter("EventCollection::append() | Number of particles "
+                       "does not match!");
+
+  for (std::size_t j = 0; j < numParticles(); ++j) {
+    auto &p = Particles[j];
+    const auto &q = other.Particles[j];
+    p.Px.append(q.Px, begin, end);
+    p.Py.append(q.Py, begin, end);
+    p.Pz.append(q.Pz, begin, end);
+    p.E.append(q.E, begin, end);
+    p.Pid.append(q.Pid, begin, end);
+    p.Charge.append(q.Charge, begin, end);
+  }
+  Weights.append(other.Weights, begin, end);
+  Efficiencies.append(other.Efficiencies, begin, end);
+  Charges.append(other.Charges, begin, end);
+}
+
+void EventCollection::select(const std::vector<char> &mask) {
+  if (mask.size() != size())
+    throw BadParameter("EventCollection::select() | Size of mask does not "
+                       "match the number of events!");
+
+  for (auto &p : Particles) {
+    p.Px.compress(mask);
+    p.Py.compress(mask);
+    p.Pz.compress(mask);
+    p.E.compress(mask);
+    p.Pid.compress(mask);
+    p.Charge.compress(mask);
+  }
+  Weights.compress(mask);
+  Efficiencies.compress(mask);
+  Charges.compress(mask);
+}
+
+Event EventCollection::event(std::size_t i) const {
+  if (i >= size())
+    throw std::out_of_range("EventCollection::event() | Event " +
+                            std::to_string(i) + " out of range!");
+  Event ev;
+  for (std::size_t j = 0; j < numParticles(); ++j) {
+    const auto &p = Particles[j];
+    ev.addParticle(
+        Particle(p.Px[i], p.Py[i], p.Pz[i], p.E[i], p.Pid[i], p.Charge[i]));
+  }
+  ev.setWeight(Weights[i]);
+  ev.setEfficiency(Efficiencies[i]);
+  ev.setCharge(Charges[i]);
+  return ev;
+}
+
+void EventCollection::setEvent(std::size_t i, const Event &ev) {
+  if (i >= size())
+    throw std::out_of_range("EventCollection::setEvent() | Event " +
+                            std::to_string(i) + " out of range!");
+  checkNumParticles(ev);
+  for (std::size_t j = 0; j < numParticles(); ++j) {
+    Particle part = ev.particle(j);
+    setParticle(i, j, part.px(), part.py(), part.pz(), part.e(), part.pid(),
+                part.charge());
+  }
+  Weights[i] = ev.weight();
+  Efficiencies[i] = ev.efficiency();
+  Charges[i] = ev.charge();
+}
@@ -0,0 +1,324 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// EventCollection class
+///
+
+#ifndef _EVENTCOLLECTION_HPP_
+#define _EVENTCOLLECTION_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Core/Event.hpp"
+#include "Core/Particle.hpp"
+
+namespace ComPWA {
+
+///
+/// \class EventColumn
+/// Column of an EventCollection. The values are either stored in an own
+/// std::vector or in external memory (e.g. a memory-mapped file), which is
+/// kept alive by a shared owner. External memory has to be writable.
+/// Operations that increase the size copy external values to own storage
+/// first. Copies of a column always own their values.
+///
+template <class T> class EventColumn {
+public:
+  EventColumn() : Begin(nullptr), Size(0) {}
+
+  /// Column that owns \p values
+  explicit EventColumn(std::vector<T> &&values)
+      : Owned(std::move(values)), Begin(Owned.data()), Size(Owned.size()) {}
+
+  EventColumn(const EventColumn &that)
+      : Owned(that.Begin, that.Begin + that.Size), Begin(Owned.data()),
+        Size(that.Size) {}
+
+  EventColumn(EventColumn &&that)
+      : Owned(std::move(that.Owned)), Begin(that.Begin), Size(that.Size),
+        External(std::move(that.External)) {
+    that.Begin = nullptr;
+    that.Size = 0;
+  }
+
+  EventColumn &operator=(EventColumn that) {
+    std::swap(Owned, that.Owned);
+    std::swap(Begin, that.Begin);
+    std::swap(Size, that.Size);
+    std::swap(External, that.External);
+    return *this;
+  }
+
+  std::size_t size() const { return Size; }
+
+  /// Are the values stored in external memory?
+  bool external() const { return bool(External); }
+
+  T *data() { return Begin; }
+
+  const T *data() const { return Begin; }
+
+  T &operator[](std::size_t i) { return Begin[i]; }
+
+  const T &operator[](std::size_t i) const { return Begin[i]; }
+
+  void reserve(std::size_t n) {
+    if (External)
+      return;
+    Owned.reserve(n);
+    Begin = Owned.data();
+  }
+
+  /// Resize to \p n values. New values are set to \p value.
+  void resize(std::size_t n, T value) {
+    if (External && n <= Size) {
+      Size = n;
+      return;
+    }
+    detach();
+    Owned.resize(n, value);
+    Begin = Owned.data();
+    Size = n;
+  }
+
+  /// Append the values [\p begin, \p end) of \p other.
+  void append(const EventColumn &other, std::size_t begin, std::size_t end) {
+    std::vector<T> values(other.Begin + begin, other.Begin + end);
+    detach();
+    Owned.insert(Owned.end(), values.begin(), values.end());
+    Begin = Owned.data();
+    Size = Owned.size();
+  }
+
+  /// Keep the values for which \p mask is non-zero. External values are
+  /// compressed in place.
+  void compress(const std::vector<char> &mask) {
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < Size; ++i)
+      if (mask[i])
+        Begin[k++] = Begin[i];
+    Size = k;
+    if (!External)
+      Owned.resize(k);
+  }
+
+  /// Move the values to a std::vector. External values are copied. The
+  /// column is empty afterwards.
+  std::vector<T> release() {
+    detach();
+    std::vector<T> values;
+    values.swap(Owned);
+    Begin = nullptr;
+    Size = 0;
+    return values;
+  }
+
+  /// Use the \p n values at \p begin. The memory is kept alive by \p owner.
+  void setExternal(T *begin, std::size_t n, std::shared_ptr<void> owner) {
+    std::vector<T>().swap(Owned);
+    Begin = begin;
+    Size = n;
+    External = owner;
+  }
+
+private:
+  /// Copy external values to own storage
+  void detach() {
+    if (!External)
+      return;
+    Owned.assign(Begin, Begin + Size);
+    Begin = Owned.data();
+    External.reset();
+  }
+
+  std::vector<T> Owned;
+
+  T *Begin;
+
+  std::size_t Size;
+
+  std::shared_ptr<void> External;
+};
+
+///
+/// \class EventCollection
+/// Columnar storage of a sample of events. The components of the four
+/// momenta are stored in contiguous arrays for each final state particle
+/// (slot), event weight, efficiency and charge are stored as separate
+/// columns. In contrast to a std::vector<Event> no memory is allocated per
+/// event and loops over a single variable access contiguous memory.
+///
+/// All events of a collection have the same number of particles. The number
+/// is set by the constructor or by the first event that is added to an empty
+/// collection.
+///
+/// The columns can refer to external memory (see ExternalColumns), e.g. to
+/// a memory-mapped file. Such a collection is used without copying the
+/// events.
+///
+class EventCollection {
+public:
+  ///
+  /// \struct ExternalColumns
+  /// Columns in external memory. Pid and particle charge are the same for
+  /// all events.
+  ///
+  struct ExternalColumns {
+    std::size_t NumEvents;
+
+    /// \name Momentum columns of each particle
+    ///@{
+    std::vector<double *> Px, Py, Pz, E;
+    ///@}
+
+    /// Pid and charge of each particle
+    std::vector<int> Pid, ParticleCharge;
+
+    double *Weights;
+
+    double *Efficiencies;
+
+    int *Charges;
+
+    /// Keeps the memory alive
+    std::shared_ptr<void> Owner;
+  };
+
+  EventCollection(std::size_t numParticles = 0);
+
+  /// Collection that uses the external memory of \p columns. Only the pid
+  /// and particle charge columns are allocated.
+  EventCollection(const ExternalColumns &columns);
+
+  /// Number of events
+  std::size_t size() const { return Weights.size(); }
+
+  bool empty() const { return !Weights.size(); }
+
+  /// Number of particles per event
+  std::size_t numParticles() const { return Particles.size(); }
+
+  void reserve(std::size_t n);
+
+  /// Resize the collection to \p n events. New events have zero momenta and
+  /// weight and efficiency one.
+  void resize(std::size_t n);
+
+  /// Remove all events. The number of particles is kept.
+  void clear();
+
+  /// Append \p ev to the collection.
+  void add(const Event &ev);
+
+  /// Append all events of \p other to the collection.
+  void append(const EventCollection &other);
+
+  /// Append the events [\p begin, \p end) of \p other to the collection.
+  void append(const EventCollection &other, std::size_t begin,
+              std::size_t end);
+
+  /// Keep only those events for which \p mask is non-zero. The order of the
+  /// remaining events is preserved.
+  void select(const std::vector<char> &mask);
+
+  /// Create an Event from the columns of event \p i.
+  Event event(std::size_t i) const;
+
+  /// Overwrite event \p i with \p ev.
+  void setEvent(std::size_t i, const Event &ev);
+
+  FourMomentum fourMomentum(std::size_t i, std::size_t slot) const {
+    const auto &p = Particles[slot];
+    return FourMomentum(p.Px[i], p.Py[i], p.Pz[i], p.E[i]);
+  }
+
+  /// \name Momentum columns of particle \p slot
+  ///@{
+  const double *px(std::size_t slot) const { return Particles[slot].Px.data(); }
+  const double *py(std::size_t slot) const { return Particles[slot].Py.data(); }
+  const double *pz(std::size_t slot) const { return Particles[slot].Pz.data(); }
+  const double *e(std::size_t slot) const { return Particles[slot].E.data(); }
+  double *px(std::size_t slot) { return Particles[slot].Px.data(); }
+  double *py(std::size_t slot) { return Particles[slot].Py.data(); }
+  double *pz(std::size_t slot) { return Particles[slot].Pz.data(); }
+  double *e(std::size_t slot) { return Particles[slot].E.data(); }
+  ///@}
+
+  /// Set four momentum, particle id and charge of particle \p slot in event
+  /// \p i.
+  void setParticle(std::size_t i, std::size_t slot, double px, double py,
+                   double pz, double e, int pid = 0, int charge = 0) {
+    auto &p = Particles[slot];
+    p.Px[i] = px;
+    p.Py[i] = py;
+    p.Pz[i] = pz;
+    p.E[i] = e;
+    p.Pid[i] = pid;
+    p.Charge[i] = charge;
+  }
+
+  int pid(std::size_t i, std::size_t slot) const {
+    return Particles[slot].Pid[i];
+  }
+
+  int particleCharge(std::size_t i, std::size_t slot) const {
+    return Particles[slot].Charge[i];
+  }
+
+  double weight(std::size_t i) const { return Weights[i]; }
+
+  void setWeight(std::size_t i, double w) { Weights[i] = w; }
+
+  double efficiency(std::size_t i) const { return Efficiencies[i]; }
+
+  void setEfficiency(std::size_t i, double eff) { Efficiencies[i] = eff; }
+
+  int charge(std::size_t i) const { return Charges[i]; }
+
+  void setCharge(std::size_t i, int ch) { Charges[i] = ch; }
+
+  /// \name Event columns
+  ///@{
+  const double *weights() const { return Weights.data(); }
+
+  double *weights() { return Weights.data(); }
+
+  const double *efficiencies() const { return Efficiencies.data(); }
+
+  double *efficiencies() { return Efficiencies.data(); }
+
+  const int *charges() const { return Charges.data(); }
+
+  int *charges() { return Charges.data(); }
+  ///@}
+
+  /// Are the columns stored in external memory?
+  bool external() const { return Weights.external(); }
+
+private:
+  /// Columns of a single final state particle
+  struct ParticleColumns {
+    EventColumn<double> Px, Py, Pz, E;
+    EventColumn<int> Pid, Charge;
+  };
+
+  void checkNumParticles(const Event &ev);
+
+  std::vector<ParticleColumns> Particles;
+
+  EventColumn<double> Weights;
+
+  EventColumn<double> Efficiencies;
+
+  EventColumn<int> Charges;
+};
+
+} // namespace ComPWA
+
+#endif
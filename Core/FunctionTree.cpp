@@ -2,37 +2,194 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "Core/FunctionTree.hpp"
 #include "Core/Logging.hpp"
 
 using namespace ComPWA;
 
+namespace {
+
+/// Adjoint of \p par initialized to zero. The adjoint of a FitParameter is a
+/// free FitParameter so that it ends up in the same group of a ParameterList.
+std::shared_ptr<Parameter> zeroAdjoint(std::shared_ptr<Parameter> par) {
+  switch (par->type()) {
+  case ParType::MCOMPLEX: {
+    auto n = std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(
+                 par)->values().size();
+    return MComplex("", n);
+  }
+  case ParType::MDOUBLE: {
+    auto n = std::static_pointer_cast<Value<std::vector<double>>>(par)
+                 ->values().size();
+    return MDouble("", n);
+  }
+  case ParType::MINTEGER: {
+    auto n = std::static_pointer_cast<Value<std::vector<int>>>(par)
+                 ->values().size();
+    return std::make_shared<Value<std::vector<int>>>("", std::vector<int>(n));
+  }
+  case ParType::COMPLEX:
+    return std::make_shared<Value<std::complex<double>>>(
+        "", std::complex<double>(0., 0.));
+  case ParType::DOUBLE: {
+    if (!par->isParameter())
+      return std::make_shared<Value<double>>("", 0.);
+    auto adj = std::make_shared<FitParameter>("", 0.);
+    adj->fixParameter(false);
+    return adj;
+  }
+  case ParType::INTEGER:
+    return std::make_shared<Value<int>>("", 0);
+  default:
+    throw BadParameter("zeroAdjoint() | Parameter of type " +
+                       std::to_string(par->type()) + " can not be handelt");
+  }
+}
+
+/// Values of \p par as complex numbers
+std::vector<std::complex<double>> complexValues(std::shared_ptr<Parameter> par) {
+  switch (par->type()) {
+  case ParType::MCOMPLEX:
+    return std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(
+               par)->values();
+  case ParType::MDOUBLE: {
+    auto &v = std::static_pointer_cast<Value<std::vector<double>>>(par)
+                  ->values();
+    return std::vector<std::complex<double>>(v.begin(), v.end());
+  }
+  case ParType::MINTEGER: {
+    auto &v =
+        std::static_pointer_cast<Value<std::vector<int>>>(par)->values();
+    return std::vector<std::complex<double>>(v.begin(), v.end());
+  }
+  case ParType::COMPLEX:
+    return {std::static_pointer_cast<Value<std::complex<double>>>(par)
+                ->value()};
+  case ParType::DOUBLE: {
+    if (par->isParameter())
+      return {std::static_pointer_cast<FitParameter>(par)->value()};
+    return {std::static_pointer_cast<Value<double>>(par)->value()};
+  }
+  case ParType::INTEGER:
+    return {
+        std::complex<double>(std::static_pointer_cast<Value<int>>(par)->value())};
+  default:
+    throw BadParameter("complexValues() | Parameter of type " +
+                       std::to_string(par->type()) + " can not be handelt");
+  }
+}
+
+/// Set the elements of the multi value \p adj to zero. Returns false if the
+/// size of \p adj differs from the size of \p value.
+template <class T>
+bool zeroValues(std::shared_ptr<Parameter> adj, std::shared_ptr<Parameter> value) {
+  auto &a = std::static_pointer_cast<Value<std::vector<T>>>(adj)->values();
+  auto n = std::static_pointer_cast<Value<std::vector<T>>>(value)->values().size();
+  if (a.size() != n)
+    return false;
+  std::fill(a.begin(), a.end(), T(0));
+  return true;
+}
+
+/// Set the adjoint \p adj of \p value to zero. A new adjoint is created if
+/// \p adj does not exist or if its type or size does not match \p value.
+void resetAdjoint(std::shared_ptr<Parameter> &adj,
+                  std::shared_ptr<Parameter> value) {
+  bool reset = (adj && adj->type() == value->type() &&
+                adj->isParameter() == value->isParameter());
+  if (reset) {
+    switch (value->type()) {
+    case ParType::MCOMPLEX:
+      reset = zeroValues<std::complex<double>>(adj, value);
+      break;
+    case ParType::MDOUBLE:
+      reset = zeroValues<double>(adj, value);
+      break;
+    case ParType::MINTEGER:
+      reset = zeroValues<int>(adj, value);
+      break;
+    case ParType::COMPLEX:
+      std::static_pointer_cast<Value<std::complex<double>>>(adj)->setValue(
+          std::complex<double>(0., 0.));
+      break;
+    case ParType::DOUBLE:
+      if (adj->isParameter())
+        std::static_pointer_cast<FitParameter>(adj)->setValue(0.);
+      else
+        std::static_pointer_cast<Value<double>>(adj)->setValue(0.);
+      break;
+    case ParType::INTEGER:
+      std::static_pointer_cast<Value<int>>(adj)->setValue(0);
+      break;
+    default:
+      reset = false;
+    }
+  }
+  if (!reset)
+    adj = zeroAdjoint(value);
+}
+
+/// Real part of the single value \p par
+double realValue(std::shared_ptr<Parameter> par) {
+  switch (par->type()) {
+  case ParType::COMPLEX:
+    return std::static_pointer_cast<Value<std::complex<double>>>(par)
+        ->value()
+        .real();
+  case ParType::DOUBLE:
+    if (par->isParameter())
+      return std::static_pointer_cast<FitParameter>(par)->value();
+    return std::static_pointer_cast<Value<double>>(par)->value();
+  case ParType::INTEGER:
+    return std::static_pointer_cast<Value<int>>(par)->value();
+  default:
+    throw BadParameter("realValue() | Parameter of type " +
+                       std::to_string(par->type()) + " is not a single value");
+  }
+}
+
+} // namespace
+
 FunctionTree::FunctionTree(std::string name,
                            std::shared_ptr<ComPWA::Parameter> parameter,
-                           std::shared_ptr<ComPWA::Strategy> strategy) {
+                           std::shared_ptr<ComPWA::Strategy> strategy)
+    : Parallel(false), Compiled(false), PlanIsValid(false),
+      Arena(std::make_shared<ComPWA::OutputArena>()), ArenaIsSized(false) {
   createNode(name, parameter, strategy, "");
 }
 
 FunctionTree::FunctionTree(std::string name,
-                           std::shared_ptr<ComPWA::Parameter> parameter) {
+                           std::shared_ptr<ComPWA::Parameter> parameter)
+    : Parallel(false), Compiled(false), PlanIsValid(false),
+      Arena(std::make_shared<ComPWA::OutputArena>()), ArenaIsSized(false) {
   createLeaf(name, parameter, "");
 }
 
-FunctionTree::FunctionTree(std::string name, double value) {
+FunctionTree::FunctionTree(std::string name, double value)
+    : Parallel(false), Compiled(false), PlanIsValid(false),
+      Arena(std::make_shared<ComPWA::OutputArena>()), ArenaIsSized(false) {
   createLeaf(name, value, "");
 }
 
-FunctionTree::FunctionTree(std::string name, std::complex<double> value) {
+FunctionTree::FunctionTree(std::string name, std::complex<double> value)
+    : Parallel(false), Compiled(false), PlanIsValid(false),
+      Arena(std::make_shared<ComPWA::OutputArena>()), ArenaIsSized(false) {
   createLeaf(name, value, "");
 }
 
 FunctionTree::FunctionTree(std::shared_ptr<ComPWA::TreeNode> head)
-    : Head(head) {
+    : Head(head), Parallel(false), Compiled(false), PlanIsValid(false),
+      Arena(std::make_shared<ComPWA::OutputArena>()), ArenaIsSized(false) {
   Nodes.insert(std::pair<std::string, std::shared_ptr<ComPWA::TreeNode>>(
       head->name(), head));
 }
 
 FunctionTree::~FunctionTree() {
+  dropPlan();
   // We have to delete the links. Otherwise, we have a circular reference
   // on shared pointers and those can not be deleted.
   auto iter = Nodes.begin();
@@ -68,6 +225,7 @@ FunctionTree::~FunctionTree() {
 
 void FunctionTree::insertNode(std::shared_ptr<TreeNode> node,
                               std::string parent) {
+  dropPlan();
   std::string n = node->name();
   bool ret = Nodes
                  .insert(std::pair<std::string, std::shared_ptr<TreeNode>>(
@@ -90,6 +248,8 @@ void FunctionTree::insertNode(std::shared_ptr<TreeNode> node,
   // In case of an existing node, it is possible that this node
   // already have parents. Do need to consider this here?
   node->addParent(parentNode);
+  if (Parallel)
+    node->setParallel(true);
   //  inNode->linkParents();
   parentNode->update();
   // Subtree already linked, but need to be added to list of nodes
@@ -107,6 +267,7 @@ void FunctionTree::createNode(std::string name,
                               std::shared_ptr<ComPWA::Parameter> parameter,
                               std::shared_ptr<ComPWA::Strategy> strategy,
                               std::string parent) {
+  dropPlan();
 
   if (parent == "" && Head)
     throw std::runtime_error("FunctionTree::createNode() | "
@@ -120,9 +281,11 @@ void FunctionTree::createNode(std::string name,
 
   newNode = std::shared_ptr<TreeNode>(
       new TreeNode(name, parameter, strategy, parentNode));
+  newNode->Arena = Arena;
 
   Nodes.insert(
       std::pair<std::string, std::shared_ptr<TreeNode>>(name, newNode));
+  newNode->setParallel(Parallel);
   newNode->linkParents();
   if(parentNode)
     parentNode->update();
@@ -139,6 +302,8 @@ void FunctionTree::createNode(std::string name,
 void FunctionTree::createLeaf(std::string name,
                               std::shared_ptr<Parameter> parameter,
                               std::string parent) {
+  dropPlan();
+
   if (parent == "" && Head)
     throw std::runtime_error("FunctionTree::createNode() | "
                              "Head node already exists!");
@@ -189,6 +354,445 @@ void FunctionTree::createLeaf(std::string name,
              parent);
 }
 
+std::shared_ptr<ComPWA::Parameter> FunctionTree::parameter() {
+  if (!Compiled) {
+    if (HeadOutput) {
+      Head->Arena->give(HeadOutput);
+      HeadOutput.reset();
+    }
+    auto result = Head->parameter();
+    if (!Head->UseCache && Head->ChildNodes.size())
+      HeadOutput = result;
+    // The shapes of the outputs are known after the first evaluation
+    if (!ArenaIsSized)
+      sizeArena();
+    return result;
+  }
+
+  if (!PlanIsValid)
+    buildPlan();
+  else
+    executePlan();
+
+  // Head is a leaf
+  if (!Plan.size())
+    return Head->parameter();
+
+  return Plan.back().Output;
+}
+
+std::vector<double> FunctionTree::gradient(
+    const std::vector<std::shared_ptr<FitParameter>> &pars) {
+  if (parameter()->type() != ParType::DOUBLE)
+    throw BadParameter("FunctionTree::gradient() | Head of the tree has to be "
+                       "a double value!");
+
+  std::vector<double> grad(pars.size(), 0.);
+  std::map<Parameter *, std::size_t> index;
+  for (std::size_t i = 0; i < pars.size(); ++i)
+    if (!pars.at(i)->isFixed())
+      index[pars.at(i).get()] = i;
+
+  if (!GradientNodes.size()) {
+    std::map<TreeNode *, std::size_t> positions;
+    addGradientNode(Head, positions);
+  }
+
+  // Current values, adjoints and dependencies of all nodes. Nodes without
+  // cache are calculated once.
+  for (auto &gn : GradientNodes) {
+    auto node = gn.Node;
+    auto value = nodeValue(node);
+    auto adjoint = gn.Adjoint;
+    resetAdjoint(gn.Adjoint, value);
+    gn.Changed = (value != gn.Value || adjoint != gn.Adjoint);
+    gn.Value = value;
+    gn.Reached = false;
+    for (auto ch : gn.Children)
+      if (GradientNodes.at(ch).Changed)
+        gn.InputsValid = false;
+
+    gn.Dependencies.clear();
+    if (!node->ChildNodes.size()) {
+      auto idx = index.find(node->Parameter.get());
+      if (idx != index.end())
+        gn.Dependencies.push_back(idx->second);
+      continue;
+    }
+    for (auto ch : gn.Children) {
+      auto &chDeps = GradientNodes.at(ch).Dependencies;
+      gn.Dependencies.insert(gn.Dependencies.end(), chDeps.begin(),
+                             chDeps.end());
+    }
+    std::sort(gn.Dependencies.begin(), gn.Dependencies.end());
+    gn.Dependencies.erase(
+        std::unique(gn.Dependencies.begin(), gn.Dependencies.end()),
+        gn.Dependencies.end());
+  }
+
+  // Derivatives of the head value with respect to the node values
+  auto &head = GradientNodes.back();
+  if (head.Adjoint->isParameter())
+    std::static_pointer_cast<FitParameter>(head.Adjoint)->setValue(1.);
+  else
+    std::static_pointer_cast<Value<double>>(head.Adjoint)->setValue(1.);
+  head.Reached = true;
+
+  for (auto it = GradientNodes.rbegin(); it != GradientNodes.rend(); ++it) {
+    auto &gn = *it;
+    if (!gn.Reached || !gn.Dependencies.size())
+      continue;
+
+    if (!gn.Children.size()) {
+      grad.at(gn.Dependencies.front()) += realValue(gn.Adjoint);
+      continue;
+    }
+
+    // The input lists are only rebuilt if the value or the adjoint of a child
+    // node is a different parameter than before
+    if (!gn.InputsValid) {
+      gn.Inputs = ParameterList();
+      gn.InputAdjoints = ParameterList();
+      for (auto ch : gn.Children) {
+        auto &chNode = GradientNodes.at(ch);
+        if (chNode.Value->isParameter()) {
+          gn.Inputs.addParameter(chNode.Value);
+          gn.InputAdjoints.addParameter(chNode.Adjoint);
+        } else {
+          gn.Inputs.addValue(chNode.Value);
+          gn.InputAdjoints.addValue(chNode.Adjoint);
+        }
+      }
+      gn.InputsValid = true;
+    }
+
+    if (gn.Node->Strat->derivatives(gn.Inputs, gn.Value, gn.Adjoint,
+                                    gn.InputAdjoints)) {
+      for (auto ch : gn.Children)
+        GradientNodes.at(ch).Reached = true;
+      continue;
+    }
+
+    LOG(DEBUG) << "FunctionTree::gradient() | Strategy " << gn.Node->Strat
+               << " of node " << gn.Node->name()
+               << " does not provide derivatives. Using numerical "
+                  "derivatives instead.";
+    numericalDerivatives(gn.Node, gn.Adjoint, gn.Dependencies, pars, grad);
+  }
+
+  for (auto &gn : GradientNodes)
+    if (!Compiled && !gn.Node->UseCache && gn.Children.size())
+      gn.Node->Arena->give(gn.Value);
+  return grad;
+}
+
+std::shared_ptr<Parameter>
+FunctionTree::nodeValue(std::shared_ptr<TreeNode> node) const {
+  if (!node->ChildNodes.size())
+    return node->Parameter;
+  if (Compiled && PlanIsValid)
+    return Plan.at(PlanIndex.at(node.get())).Output;
+  if (node->UseCache)
+    return node->Parameter;
+  return node->parameter();
+}
+
+std::size_t
+FunctionTree::addGradientNode(std::shared_ptr<TreeNode> node,
+                              std::map<TreeNode *, std::size_t> &positions) {
+  auto pos = positions.find(node.get());
+  if (pos != positions.end())
+    return pos->second;
+
+  GradientNode gn;
+  gn.Node = node;
+  for (auto ch : node->ChildNodes)
+    gn.Children.push_back(addGradientNode(ch, positions));
+  GradientNodes.push_back(gn);
+  positions[node.get()] = GradientNodes.size() - 1;
+  return GradientNodes.size() - 1;
+}
+
+void FunctionTree::numericalDerivatives(
+    std::shared_ptr<TreeNode> node, std::shared_ptr<Parameter> adjoint,
+    const std::vector<std::size_t> &dependencies,
+    const std::vector<std::shared_ptr<FitParameter>> &pars,
+    std::vector<double> &grad) {
+  auto adj = complexValues(adjoint);
+  auto evaluate = [&]() {
+    std::shared_ptr<Parameter> value;
+    if (Compiled) {
+      parameter();
+      value = nodeValue(node);
+    } else {
+      value = node->parameter();
+    }
+    auto values = complexValues(value);
+    if (!Compiled && !node->UseCache)
+      node->Arena->give(value);
+    if (values.size() != adj.size())
+      throw std::runtime_error("FunctionTree::numericalDerivatives() | Size "
+                               "of node " + node->name() + " has changed!");
+    return values;
+  };
+
+  // Step size for central differences
+  double eps = std::cbrt(std::numeric_limits<double>::epsilon());
+  for (auto i : dependencies) {
+    auto par = pars.at(i);
+    double value = par->value();
+    double up = value + eps * std::max(1., std::abs(value));
+    double down = value - eps * std::max(1., std::abs(value));
+    if (par->hasBounds()) {
+      up = std::min(up, par->bounds().second);
+      down = std::max(down, par->bounds().first);
+    }
+    if (up == down)
+      continue;
+
+    par->setValue(up);
+    auto valuesUp = evaluate();
+    par->setValue(down);
+    auto valuesDown = evaluate();
+    par->setValue(value);
+
+    double d = 0.;
+    for (std::size_t e = 0; e < adj.size(); ++e)
+      d += (std::conj(adj[e]) * (valuesUp[e] - valuesDown[e])).real();
+    grad.at(i) += d / (up - down);
+  }
+
+  // Restore the values of all nodes
+  parameter();
+}
+
+void FunctionTree::compile() {
+  if (Compiled)
+    return;
+  Compiled = true;
+  dropPlan();
+  // In compiled mode each node keeps its output. The arenas are not used.
+  if (HeadOutput) {
+    Head->Arena->give(HeadOutput);
+    HeadOutput.reset();
+  }
+  std::map<OutputShape, std::size_t> inUse, maxInUse;
+  std::set<TreeNode *> visited;
+  countOutputs(Head, inUse, maxInUse, visited);
+  for (auto &shape : maxInUse)
+    std::get<0>(shape.first)->clear();
+}
+
+void FunctionTree::sizeArena() {
+  std::map<OutputShape, std::size_t> inUse, maxInUse;
+  std::set<TreeNode *> visited;
+  countOutputs(Head, inUse, maxInUse, visited);
+  for (auto &shape : maxInUse) {
+    // Single values are created when they are needed
+    auto type = std::get<1>(shape.first);
+    if (type == ParType::MCOMPLEX || type == ParType::MDOUBLE ||
+        type == ParType::MINTEGER)
+      std::get<0>(shape.first)
+          ->reserve(type, std::get<2>(shape.first), shape.second);
+  }
+  ArenaIsSized = true;
+}
+
+void FunctionTree::countOutputs(std::shared_ptr<TreeNode> node,
+                                std::map<OutputShape, std::size_t> &inUse,
+                                std::map<OutputShape, std::size_t> &maxInUse,
+                                std::set<TreeNode *> &visited) const {
+  if (!node->ChildNodes.size())
+    return;
+  // A node with cache is calculated once, a node without cache each time
+  // a parent needs it. Its output is taken from the arena before its child
+  // nodes are calculated and given back after its parent was calculated.
+  if (node->UseCache) {
+    if (!visited.insert(node.get()).second)
+      return;
+  } else if (node->OutputSize) {
+    auto shape = std::make_tuple(node->Arena.get(), node->OutputType,
+                                 node->OutputSize);
+    maxInUse[shape] = std::max(maxInUse[shape], ++inUse[shape]);
+  }
+  for (auto ch : node->ChildNodes)
+    countOutputs(ch, inUse, maxInUse, visited);
+  for (auto ch : node->ChildNodes)
+    if (!ch->UseCache && ch->ChildNodes.size() && ch->OutputSize)
+      --inUse[std::make_tuple(ch->Arena.get(), ch->OutputType,
+                              ch->OutputSize)];
+}
+
+void FunctionTree::decompile() {
+  Compiled = false;
+  dropPlan();
+}
+
+void FunctionTree::addToPlan(std::shared_ptr<TreeNode> node) {
+  if (PlanIndex.find(node.get()) != PlanIndex.end())
+    return;
+
+  if (!node->ChildNodes.size()) {
+    if (std::find(PlanLeafs.begin(), PlanLeafs.end(), node) == PlanLeafs.end())
+      PlanLeafs.push_back(node);
+    return;
+  }
+
+  for (auto ch : node->ChildNodes)
+    addToPlan(ch);
+
+  Instruction ins;
+  ins.Node = node;
+  ins.Output = node->Parameter;
+  PlanIndex[node.get()] = Plan.size();
+  Plan.push_back(ins);
+}
+
+void FunctionTree::buildPlan() {
+  dropPlan();
+
+  addToPlan(Head);
+  PlanDirty = std::make_shared<std::vector<char>>(Plan.size(), 1);
+
+  // Link instructions to the instructions and leafs they depend on
+  std::map<TreeNode *, std::vector<std::size_t>> leafConsumers;
+  for (std::size_t i = 0; i < Plan.size(); ++i) {
+    for (auto ch : Plan.at(i).Node->ChildNodes) {
+      auto idx = PlanIndex.find(ch.get());
+      auto &consumers = (idx == PlanIndex.end())
+                            ? leafConsumers[ch.get()]
+                            : Plan.at(idx->second).Consumers;
+      if (!consumers.size() || consumers.back() != i)
+        consumers.push_back(i);
+    }
+  }
+
+  // Collect for each instruction all instructions that depend on it. Since
+  // consumers are located after their inputs, we can go backwards through the
+  // plan.
+  std::vector<std::vector<std::size_t>> dependents(Plan.size());
+  for (std::size_t i = Plan.size(); i-- > 0;) {
+    auto &dep = dependents.at(i);
+    dep.push_back(i);
+    for (auto c : Plan.at(i).Consumers)
+      dep.insert(dep.end(), dependents.at(c).begin(), dependents.at(c).end());
+    std::sort(dep.begin(), dep.end());
+    dep.erase(std::unique(dep.begin(), dep.end()), dep.end());
+  }
+
+  for (auto leaf : PlanLeafs) {
+    if (leaf->PlanDirty || !leaf->Parameter) {
+      std::string name = leaf->name();
+      bool compiled = bool(leaf->PlanDirty);
+      Plan.clear();
+      PlanIndex.clear();
+      PlanLeafs.clear();
+      PlanDirty.reset();
+      if (compiled)
+        throw std::runtime_error("FunctionTree::buildPlan() | Leaf " + name +
+                                 " is already part of a compiled tree!");
+      throw std::runtime_error("FunctionTree::buildPlan() | Leaf " + name +
+                               " has no parameter!");
+    }
+  }
+
+  for (auto leaf : PlanLeafs) {
+    std::vector<std::size_t> dep;
+    for (auto c : leafConsumers[leaf.get()])
+      dep.insert(dep.end(), dependents.at(c).begin(), dependents.at(c).end());
+    std::sort(dep.begin(), dep.end());
+    dep.erase(std::unique(dep.begin(), dep.end()), dep.end());
+    leaf->PlanDependents = dep;
+    leaf->PlanDirty = PlanDirty;
+  }
+  PlanIsValid = true;
+
+  // Initial evaluation. The inputs of an instruction are available after all
+  // previous instructions are executed.
+  try {
+    for (std::size_t i = 0; i < Plan.size(); ++i) {
+      fillInputs(i);
+      execute(i);
+    }
+  } catch (std::exception &ex) {
+    dropPlan();
+    throw;
+  }
+}
+
+void FunctionTree::executePlan() {
+  auto &dirty = *PlanDirty;
+  for (std::size_t i = 0; i < Plan.size(); ++i) {
+    if (!dirty[i])
+      continue;
+    // The strategy has replaced its output parameter. We have to update the
+    // inputs of the following instructions.
+    if (execute(i))
+      for (auto c : Plan.at(i).Consumers)
+        fillInputs(c);
+  }
+}
+
+bool FunctionTree::execute(std::size_t i) {
+  auto &ins = Plan.at(i);
+  auto node = ins.Node;
+  auto old = ins.Output.get();
+  try {
+    node->Strat->execute(ins.Inputs, ins.Output);
+  } catch (std::exception &ex) {
+    LOG(INFO) << "FunctionTree::execute() | Strategy " << node->Strat
+              << " failed on node " << node->name() << ": " << ex.what();
+    throw;
+  }
+  if (node->UseCache) {
+    node->Parameter = ins.Output;
+    node->HasChanged = false;
+  }
+  (*PlanDirty)[i] = 0;
+  return (ins.Output.get() != old);
+}
+
+void FunctionTree::fillInputs(std::size_t i) {
+  auto &ins = Plan.at(i);
+  ins.Inputs = ParameterList();
+  for (auto ch : ins.Node->ChildNodes) {
+    std::shared_ptr<Parameter> p;
+    auto idx = PlanIndex.find(ch.get());
+    if (idx == PlanIndex.end())
+      p = ch->Parameter;
+    else
+      p = Plan.at(idx->second).Output;
+    if (p->isParameter())
+      ins.Inputs.addParameter(p);
+    else
+      ins.Inputs.addValue(p);
+  }
+}
+
+void FunctionTree::dropPlan() {
+  GradientNodes.clear();
+  ArenaIsSized = false;
+  if (!PlanIsValid)
+    return;
+
+  for (auto leaf : PlanLeafs) {
+    leaf->PlanDirty.reset();
+    leaf->PlanDependents.clear();
+  }
+
+  Plan.clear();
+  PlanIndex.clear();
+  PlanLeafs.clear();
+  PlanDirty.reset();
+  PlanIsValid = false;
+}
+
+void FunctionTree::setParallel(bool p) {
+  Parallel = p;
+  if (Head)
+    Head->setParallel(p);
+}
+
 bool FunctionTree::sanityCheck() {
   if (!Head)
     throw std::runtime_error("FunctionTree::sanityCheck() | "
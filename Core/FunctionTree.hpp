@@ -14,6 +14,8 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <set>
+#include <tuple>
 
 #include "Core/Functions.hpp"
 #include "Core/TreeNode.hpp"
@@ -29,6 +31,13 @@ namespace ComPWA {
 /// This class is mainly a container for TreeNode's. Most funtionality is
 /// implemented in TreeNode.
 ///
+/// In compiled mode (see compile()) the tree is not evaluated recursively.
+/// Instead, the nodes are arranged in a flat list of instructions in
+/// topological order. Each instruction has a fixed list of input parameters
+/// and an output parameter. A change of a leaf marks the dependent
+/// instructions as dirty and only those are executed on the next call to
+/// parameter().
+///
 class FunctionTree {
 public:
   //  FunctionTree(){};
@@ -92,10 +101,45 @@ public:
   /// Get the head of FunctionTree
   virtual std::shared_ptr<ComPWA::TreeNode> head() const { return Head; }
 
-  /// Recalculate those parts of the tree that have been changed.
-  virtual std::shared_ptr<ComPWA::Parameter> parameter() {
-    return Head->parameter();
-  }
+  /// Recalculate those parts of the tree that have been changed. If the head
+  /// node has no cache, its output is reused by the next call. After the
+  /// first call the arena holds the outputs that the nodes without cache
+  /// need for further calls.
+  virtual std::shared_ptr<ComPWA::Parameter> parameter();
+
+  /// Derivatives of the head value with respect to the parameters \p pars.
+  /// The head has to be a double value. The derivatives are propagated from
+  /// the head to the leafs in reverse mode (see Strategy::derivatives()).
+  /// For nodes whose strategy does not provide derivatives, the derivatives
+  /// with respect to the free parameters of their subtree are calculated
+  /// numerically. The derivatives with respect to fixed parameters and
+  /// parameters which are not part of the tree are zero.
+  virtual std::vector<double>
+  gradient(const std::vector<std::shared_ptr<ComPWA::FitParameter>> &pars);
+
+  /// Switch to compiled mode. The execution plan is build on the next call of
+  /// parameter() and is rebuild after each structural change of the tree.
+  /// In compiled mode each node keeps its output, also if it was created
+  /// without a parameter, and the outputs of the arena are released.
+  /// Independent subtrees are not evaluated in parallel (see setParallel()),
+  /// the strategies are still parallelized internally.
+  /// A node can only be part of one compiled tree. In particular, a tree that
+  /// was inserted into another tree via insertTree() must not be compiled
+  /// on its own.
+  virtual void compile();
+
+  /// Leave compiled mode
+  virtual void decompile();
+
+  virtual bool compiled() const { return Compiled; }
+
+  /// Evaluate independent subtrees in parallel. Child nodes that need to be
+  /// recalculated are scheduled on the ThreadPool. The number of threads is
+  /// set via ThreadPool::instance().setNumThreads(). Nodes which are added
+  /// to the tree later on inherit this setting.
+  virtual void setParallel(bool p);
+
+  virtual bool parallel() const { return Parallel; }
 
   /// Check if FunctionTree is properly linked and some further checks.
   virtual bool sanityCheck();
@@ -136,6 +180,151 @@ protected:
   // are not included here
   std::map<std::string, std::shared_ptr<ComPWA::TreeNode>> Nodes;
 
+  /// Evaluate subtrees in parallel
+  bool Parallel;
+
+  /// Use execution plan
+  bool Compiled;
+
+  ///
+  /// \struct Instruction
+  /// Element of the execution plan. Evaluates the strategy of \p Node on
+  /// \p Inputs and stores the result in \p Output.
+  ///
+  struct Instruction {
+    std::shared_ptr<ComPWA::TreeNode> Node;
+
+    ComPWA::ParameterList Inputs;
+
+    std::shared_ptr<ComPWA::Parameter> Output;
+
+    /// Instructions which use Output as input
+    std::vector<std::size_t> Consumers;
+  };
+
+  /// Execution plan in topological order. The head node is the last element.
+  std::vector<Instruction> Plan;
+
+  /// Position of each node in Plan
+  std::map<ComPWA::TreeNode *, std::size_t> PlanIndex;
+
+  /// Leafs of the tree. Their parameters are the inputs of the plan.
+  std::vector<std::shared_ptr<ComPWA::TreeNode>> PlanLeafs;
+
+  /// Instructions that need to be executed. Shared with PlanLeafs.
+  std::shared_ptr<std::vector<char>> PlanDirty;
+
+  bool PlanIsValid;
+
+  /// Outputs of the nodes without cache. Shared by all nodes of the tree.
+  std::shared_ptr<ComPWA::OutputArena> Arena;
+
+  /// Output of a head node without cache. The caller of parameter() uses it
+  /// until the next call, then it is given back to the arena.
+  std::shared_ptr<ComPWA::Parameter> HeadOutput;
+
+  /// The arenas of the nodes are sized for the current structure of the tree
+  bool ArenaIsSized;
+
+  ///
+  /// \struct GradientNode
+  /// Element of the workspace of gradient(). The workspace is built once and
+  /// reused until the structure of the tree changes.
+  ///
+  struct GradientNode {
+    GradientNode() : Changed(true), Reached(false), InputsValid(false) {}
+
+    std::shared_ptr<ComPWA::TreeNode> Node;
+
+    /// Positions of the child nodes in GradientNodes
+    std::vector<std::size_t> Children;
+
+    /// Positions of the parameters in the argument of gradient() that the
+    /// node depends on
+    std::vector<std::size_t> Dependencies;
+
+    /// Value of the node in the current call of gradient()
+    std::shared_ptr<ComPWA::Parameter> Value;
+
+    /// Derivatives of the head value with respect to Value
+    std::shared_ptr<ComPWA::Parameter> Adjoint;
+
+    /// Value or Adjoint is a different parameter than in the previous call
+    bool Changed;
+
+    /// Adjoint was set by a parent node
+    bool Reached;
+
+    /// Values and adjoints of the child nodes
+    ComPWA::ParameterList Inputs;
+    ComPWA::ParameterList InputAdjoints;
+
+    /// Inputs and InputAdjoints contain the current parameters
+    bool InputsValid;
+  };
+
+  /// Workspace of gradient() in topological order. The head node is the last
+  /// element.
+  std::vector<GradientNode> GradientNodes;
+
+  /// Build and execute the execution plan
+  virtual void buildPlan();
+
+  /// Execute dirty instructions of the plan
+  virtual void executePlan();
+
+  /// Delete execution plan and the workspace of gradient(). Reset links to
+  /// leafs.
+  virtual void dropPlan();
+
+  /// Reserve as many multi value outputs in the arenas as the nodes without
+  /// cache use at the same time during a serial evaluation of the tree
+  virtual void sizeArena();
+
+  /// Arena, type and number of elements of the output of a node
+  typedef std::tuple<ComPWA::OutputArena *, ComPWA::ParType, std::size_t>
+      OutputShape;
+
+  /// Helper function for sizeArena(). Counts the outputs of \p node and its
+  /// child nodes that are in use at the same time. Nodes with cache are only
+  /// visited once.
+  virtual void countOutputs(std::shared_ptr<ComPWA::TreeNode> node,
+                            std::map<OutputShape, std::size_t> &inUse,
+                            std::map<OutputShape, std::size_t> &maxInUse,
+                            std::set<ComPWA::TreeNode *> &visited) const;
+
+  /// Helper function to recursively add nodes to the execution plan
+  virtual void addToPlan(std::shared_ptr<ComPWA::TreeNode> node);
+
+  /// Set input list of instruction \p i from the outputs of its child nodes
+  virtual void fillInputs(std::size_t i);
+
+  /// Execute instruction \p i. Returns true if the output parameter was
+  /// replaced by the strategy.
+  virtual bool execute(std::size_t i);
+
+  /// Current value of \p node. A node without cache of a tree that is not
+  /// compiled is evaluated. Its output has to be given back to the arena.
+  virtual std::shared_ptr<ComPWA::Parameter>
+  nodeValue(std::shared_ptr<ComPWA::TreeNode> node) const;
+
+  /// Helper function for gradient(). Adds \p node and its child nodes to
+  /// GradientNodes (child nodes first). Returns the position of \p node.
+  virtual std::size_t
+  addGradientNode(std::shared_ptr<ComPWA::TreeNode> node,
+                  std::map<ComPWA::TreeNode *, std::size_t> &positions);
+
+  /// Helper function for gradient(). Adds the derivatives with respect to
+  /// \p pars with positions \p dependencies to \p grad. The derivatives of
+  /// the value of \p node are calculated by central differences and combined
+  /// with the derivatives \p adjoint of the head with respect to the node.
+  virtual void
+  numericalDerivatives(std::shared_ptr<ComPWA::TreeNode> node,
+                       std::shared_ptr<ComPWA::Parameter> adjoint,
+                       const std::vector<std::size_t> &dependencies,
+                       const std::vector<std::shared_ptr<ComPWA::FitParameter>> &pars,
+                       std::vector<double> &grad);
+
   /// Recursive function to get all used NodeNames
   void GetNamesDownward(std::shared_ptr<ComPWA::TreeNode> start,
                         std::vector<std::string> &childNames,
@@ -5,10 +5,207 @@
 #include <numeric>
 #include <functional>
 #include <cmath>
+#include "Core/ComplexKernels.hpp"
 #include "Core/Functions.hpp"
+#include "Core/Summation.hpp"
+#include "Core/ThreadPool.hpp"
 
 namespace ComPWA {
 
+namespace {
+
+///
+/// \struct Operand
+/// Input value of a strategy together with its adjoint. Single and multi
+/// values of all types are accessed as complex numbers. Contributions to the
+/// adjoint of a real value are projected onto the real axis and integer values
+/// do not have an adjoint. Contributions to the adjoint of a single value are
+/// accumulated and written by flush().
+///
+struct Operand {
+  Operand()
+      : Size(0), MC(nullptr), MD(nullptr), MI(nullptr), Single(0., 0.),
+        AdjMC(nullptr), AdjMD(nullptr), AdjC(nullptr), AdjD(nullptr),
+        AdjSum(0., 0.){};
+
+  bool multi() const { return (MC || MD || MI); }
+
+  std::complex<double> value(std::size_t e) const {
+    if (MC)
+      return MC[e];
+    if (MD)
+      return MD[e];
+    if (MI)
+      return MI[e];
+    return Single;
+  }
+
+  void addAdjoint(std::size_t e, std::complex<double> a) {
+    if (AdjMC)
+      AdjMC[e] += a;
+    else if (AdjMD)
+      AdjMD[e] += a.real();
+    else
+      AdjSum += a;
+  }
+
+  void flush() {
+    if (AdjC)
+      *AdjC += AdjSum;
+    if (AdjD)
+      *AdjD += AdjSum.real();
+    if (AdjPar)
+      AdjPar->setValue(AdjPar->value() + AdjSum.real());
+    AdjSum = std::complex<double>(0., 0.);
+  }
+
+  /// Number of elements of a multi value
+  std::size_t Size;
+
+  const std::complex<double> *MC;
+  const double *MD;
+  const int *MI;
+  std::complex<double> Single;
+
+  std::complex<double> *AdjMC;
+  double *AdjMD;
+  std::complex<double> *AdjC;
+  double *AdjD;
+  std::shared_ptr<FitParameter> AdjPar;
+  std::complex<double> AdjSum;
+};
+
+/// Operand without adjoint, e.g. the adjoint of the output of a strategy
+Operand operand(std::shared_ptr<Parameter> par) {
+  Operand op;
+  switch (par->type()) {
+  case ParType::MCOMPLEX: {
+    auto &v =
+        std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(par)
+            ->values();
+    op.Size = v.size();
+    op.MC = v.data();
+    break;
+  }
+  case ParType::MDOUBLE: {
+    auto &v = std::static_pointer_cast<Value<std::vector<double>>>(par)
+                  ->values();
+    op.Size = v.size();
+    op.MD = v.data();
+    break;
+  }
+  case ParType::MINTEGER: {
+    auto &v =
+        std::static_pointer_cast<Value<std::vector<int>>>(par)->values();
+    op.Size = v.size();
+    op.MI = v.data();
+    break;
+  }
+  case ParType::COMPLEX: {
+    op.Single =
+        std::static_pointer_cast<Value<std::complex<double>>>(par)->value();
+    break;
+  }
+  case ParType::DOUBLE: {
+    if (par->isParameter())
+      op.Single = std::static_pointer_cast<FitParameter>(par)->value();
+    else
+      op.Single = std::static_pointer_cast<Value<double>>(par)->value();
+    break;
+  }
+  case ParType::INTEGER: {
+    op.Single = std::static_pointer_cast<Value<int>>(par)->value();
+    break;
+  }
+  default: {
+    throw BadParameter("operand() | Parameter of type " +
+                       std::to_string(par->type()) + " can not be handelt");
+  }
+  }
+  return op;
+}
+
+/// Inputs \p paras and their \p adjoints in the order of the ParameterList
+/// groups.
+std::vector<Operand> operands(ParameterList &paras, ParameterList &adjoints) {
+  if (paras.mComplexValues().size() != adjoints.mComplexValues().size() ||
+      paras.mDoubleValues().size() != adjoints.mDoubleValues().size() ||
+      paras.mIntValues().size() != adjoints.mIntValues().size() ||
+      paras.complexValues().size() != adjoints.complexValues().size() ||
+      paras.doubleValues().size() != adjoints.doubleValues().size() ||
+      paras.doubleParameters().size() != adjoints.doubleParameters().size() ||
+      paras.intValues().size() != adjoints.intValues().size())
+    throw BadParameter("Strategy::derivatives() | Adjoints do not match the "
+                       "input parameters!");
+
+  std::vector<Operand> ops;
+  for (std::size_t i = 0; i < paras.mComplexValues().size(); ++i) {
+    Operand op = operand(paras.mComplexValue(i));
+    auto &adj = adjoints.mComplexValue(i)->values();
+    if (adj.size() != op.Size)
+      throw BadParameter("Strategy::derivatives() | Size of multi complex "
+                         "adjoint does not match!");
+    op.AdjMC = adj.data();
+    ops.push_back(op);
+  }
+  for (std::size_t i = 0; i < paras.mDoubleValues().size(); ++i) {
+    Operand op = operand(paras.mDoubleValue(i));
+    auto &adj = adjoints.mDoubleValue(i)->values();
+    if (adj.size() != op.Size)
+      throw BadParameter("Strategy::derivatives() | Size of multi double "
+                         "adjoint does not match!");
+    op.AdjMD = adj.data();
+    ops.push_back(op);
+  }
+  for (auto p : paras.mIntValues())
+    ops.push_back(operand(p));
+  for (std::size_t i = 0; i < paras.complexValues().size(); ++i) {
+    Operand op = operand(paras.complexValue(i));
+    op.AdjC = &adjoints.complexValue(i)->values();
+    ops.push_back(op);
+  }
+  for (std::size_t i = 0; i < paras.doubleValues().size(); ++i) {
+    Operand op = operand(paras.doubleValue(i));
+    op.AdjD = &adjoints.doubleValue(i)->values();
+    ops.push_back(op);
+  }
+  for (std::size_t i = 0; i < paras.doubleParameters().size(); ++i) {
+    Operand op = operand(paras.doubleParameter(i));
+    op.AdjPar = adjoints.doubleParameter(i);
+    ops.push_back(op);
+  }
+  for (auto p : paras.intValues())
+    ops.push_back(operand(p));
+  return ops;
+}
+
+/// Sum of multi integer values as double
+double sumOf(const std::vector<int> &values) {
+  return Summation::sum<double>(
+      values.size(), [&](std::size_t i) { return double(values[i]); });
+}
+
+/// Derivatives of an element-wise function of a single input. \p derivative
+/// returns the contribution to the adjoint of the input for a given adjoint
+/// a of the output and input value x. For a holomorphic function f this is
+/// a * conj(f'(x)).
+template <class F>
+bool unaryDerivatives(ParameterList &paras, std::shared_ptr<Parameter> adjoint,
+                      ParameterList &adjoints, F derivative) {
+  auto ops = operands(paras, adjoints);
+  if (ops.size() != 1)
+    throw BadParameter("unaryDerivatives() | Expecting a single input!");
+  Operand a = operand(adjoint);
+  auto &in = ops.front();
+  std::size_t n = (a.multi() ? a.Size : 1);
+  for (std::size_t e = 0; e < n; ++e)
+    in.addAdjoint(e, derivative(a.value(e), in.value(e)));
+  in.flush();
+  return true;
+}
+
+} // namespace
+
 void Inverse::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
   if (out && checkType != out->type())
     throw BadParameter("Inverse::execute() | Parameter type mismatch!");
@@ -47,6 +244,17 @@ void Inverse::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
   } // end switch
 } // end execute
 
+bool Inverse::derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                          std::shared_ptr<Parameter> adjoint,
+                          ParameterList &adjoints) {
+  // We follow execute() and set the derivative to zero for x = 0
+  return unaryDerivatives(
+      paras, adjoint, adjoints,
+      [](std::complex<double> a, std::complex<double> x) {
+        return (x == 0. ? std::complex<double>(0., 0.) : -a / std::conj(x * x));
+      });
+}
+
 void SquareRoot::execute(ParameterList &paras,
                          std::shared_ptr<Parameter> &out) {
   if (out && checkType != out->type())
@@ -82,21 +290,14 @@ void SquareRoot::execute(ParameterList &paras,
   } // end switch
 }
 
-struct KahanSummation {
-  double sum;
-  double correction;
-};
-
-/// KahanSummation keeps track of lost bits and reduced the uncertainty in the
-/// summation of many large/small numbers.
-/// See https://en.wikipedia.org/wiki/Kahan_summation_algorithm
-KahanSummation KahanSum(KahanSummation accumulation, double value) {
-  KahanSummation result;
-  double y = value - accumulation.correction;
-  double t = accumulation.sum + y;
-  result.correction = (t - accumulation.sum) - y;
-  result.sum = t;
-  return result;
+bool SquareRoot::derivatives(ParameterList &paras,
+                             std::shared_ptr<Parameter> out,
+                             std::shared_ptr<Parameter> adjoint,
+                             ParameterList &adjoints) {
+  return unaryDerivatives(paras, adjoint, adjoints,
+                          [](std::complex<double> a, std::complex<double> x) {
+                            return a / std::conj(2. * std::sqrt(x));
+                          });
 }
 
 void AddAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
@@ -112,44 +313,42 @@ void AddAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
       n = paras.mComplexValue(0)->values().size();
     else if (paras.mDoubleValues().size())
       n = paras.mDoubleValue(0)->values().size();
-    else if (paras.mDoubleValues().size())
+    else if (paras.mIntValues().size())
       n = paras.mIntValue(0)->values().size();
     else
       throw BadParameter(
           "AddAll::execute() | Expecting at least one multi value.");
 
-    if (!out)
-      out = MComplex("", n);
-
-    // fill MultiComplex parameter
-    auto par =
-        std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out);
-    auto &results = par->values(); // reference
-    std::fill(results.begin(), results.end(),
-              std::complex<double>(0., 0.)); // reset
-
-    for (auto dv : paras.mComplexValues()) {
+    for (auto dv : paras.mComplexValues())
       if (dv->values().size() != n)
         throw BadParameter(
             "AddAll::execute() | MCOMPLEX: Size of multi complex "
             "value does not match!");
-      std::transform(results.begin(), results.end(), dv->values().begin(),
-                     results.begin(), std::plus<std::complex<double>>());
-    }
-    for (auto dv : paras.mDoubleValues()) {
+    for (auto dv : paras.mDoubleValues())
       if (dv->values().size() != n)
         throw BadParameter("AddAll::execute() | MCOMPLEX: Size of multi double "
                            "value does not match!");
-      std::transform(results.begin(), results.end(), dv->values().begin(),
-                     results.begin(), std::plus<std::complex<double>>());
-    }
-    for (auto dv : paras.mIntValues()) {
+    for (auto dv : paras.mIntValues())
       if (dv->values().size() != n)
         throw BadParameter("AddAll::execute() | MCOMPLEX: Size of multi int "
                            "value does not match!");
-      std::transform(results.begin(), results.end(), dv->values().begin(),
-                     results.begin(), std::plus<std::complex<double>>());
-    }
+
+    // fill MultiComplex parameter
+    auto &results = multiOutput<std::complex<double>>(out, n);
+
+    ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+      auto res = results.begin();
+      std::fill(res + begin, res + end, std::complex<double>(0., 0.)); // reset
+      for (const auto &dv : paras.mComplexValues())
+        Kernels::add(dv->values().data() + begin, results.data() + begin,
+                     end - begin);
+      for (const auto &dv : paras.mDoubleValues())
+        std::transform(res + begin, res + end, dv->values().begin() + begin,
+                       res + begin, std::plus<std::complex<double>>());
+      for (const auto &dv : paras.mIntValues())
+        std::transform(res + begin, res + end, dv->values().begin() + begin,
+                       res + begin, std::plus<std::complex<double>>());
+    });
     break;
   } // end multi complex
   case ParType::MDOUBLE: {
@@ -159,32 +358,33 @@ void AddAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
                          "complex value was found!");
     else if (paras.mDoubleValues().size())
       n = paras.mDoubleValue(0)->values().size();
-    else if (paras.mDoubleValues().size())
+    else if (paras.mIntValues().size())
       n = paras.mIntValue(0)->values().size();
     else
       throw BadParameter(
           "AddAll::execute() | Expecting at least one multi value.");
     // Create parameter if not there
-    if (!out)
-      out = MDouble("", n);
-    auto par = std::static_pointer_cast<Value<std::vector<double>>>(out);
-    auto &results = par->values();                 // reference
-    std::fill(results.begin(), results.end(), 0.); // reset
+    auto &results = multiOutput<double>(out, n);
 
-    for (auto dv : paras.mDoubleValues()) {
+    for (auto dv : paras.mDoubleValues())
       if (dv->values().size() != results.size())
         throw BadParameter("AddAll::execute() | MDOUBLE: Size of multi double "
                            "value does not match!");
-      std::transform(results.begin(), results.end(), dv->values().begin(),
-                     results.begin(), std::plus<double>());
-    }
-    for (auto dv : paras.mIntValues()) {
+    for (auto dv : paras.mIntValues())
       if (dv->values().size() != results.size())
         throw BadParameter("AddAll::execute() | MDOUBLE: Size of multi double "
                            "value does not match!");
-      std::transform(results.begin(), results.end(), dv->values().begin(),
-                     results.begin(), std::plus<double>());
-    }
+
+    ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+      auto res = results.begin();
+      std::fill(res + begin, res + end, 0.); // reset
+      for (const auto &dv : paras.mDoubleValues())
+        std::transform(res + begin, res + end, dv->values().begin() + begin,
+                       res + begin, std::plus<double>());
+      for (const auto &dv : paras.mIntValues())
+        std::transform(res + begin, res + end, dv->values().begin() + begin,
+                       res + begin, std::plus<double>());
+    });
     break;
   } // end multi double
   case ParType::MINTEGER: {
@@ -195,27 +395,27 @@ void AddAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
     else if (paras.mDoubleValues().size())
       throw BadParameter("AddAll::execute() | Return type is int but "
                          "double value was found!");
-    else if (paras.mDoubleValues().size())
+    else if (paras.mIntValues().size())
       n = paras.mIntValue(0)->values().size();
     else
       throw BadParameter(
           "AddAll::execute() | Expecting at least one multi value.");
     // Create parameter if not there
-    if (!out)
-      out = MInteger("", n);
-
-    auto par = std::static_pointer_cast<Value<std::vector<int>>>(out);
-    auto &results = par->values();                // reference
-    std::fill(results.begin(), results.end(), 0); // reset
+    auto &results = multiOutput<int>(out, n);
 
-    // fill multi integer parameter
-    for (auto dv : paras.mIntValues()) {
+    for (auto dv : paras.mIntValues())
       if (dv->values().size() != results.size())
         throw BadParameter("AddAll::execute() | MDOUBLE: Size of multi double "
                            "value does not match!");
-      std::transform(results.begin(), results.end(), dv->values().begin(),
-                     results.begin(), std::plus<int>());
-    }
+
+    // fill multi integer parameter
+    ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+      auto res = results.begin();
+      std::fill(res + begin, res + end, 0); // reset
+      for (const auto &dv : paras.mIntValues())
+        std::transform(res + begin, res + end, dv->values().begin() + begin,
+                       res + begin, std::plus<int>());
+    });
     break;
   } // end multi double
 
@@ -242,15 +442,13 @@ void AddAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
 
     // collapse multi values
     for (auto dv : paras.mComplexValues())
-      result +=
-          std::accumulate(dv->values().begin(), dv->values().end(), result);
+      result += Summation::sum(dv->values());
 
     for (auto dv : paras.mDoubleValues())
-      result +=
-          std::accumulate(dv->values().begin(), dv->values().end(), result);
+      result += Summation::sum(dv->values());
 
     for (auto dv : paras.mIntValues())
-      result += std::accumulate(dv->values().begin(), dv->values().end(), 0);
+      result += sumOf(dv->values());
 
     break;
   } // end complex
@@ -271,18 +469,10 @@ void AddAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
       result += dv->value();
 
     // collapse multi values
-    for (auto dv : paras.mDoubleValues()) {
-      KahanSummation kaSum = {result};
-      auto kaResult = std::accumulate(dv->values().begin(), dv->values().end(),
-                                      kaSum, KahanSum);
-      result += kaResult.sum;
-    }
-    for (auto dv : paras.mIntValues()) {
-      KahanSummation kaSum = {result};
-      auto kaResult = std::accumulate(dv->values().begin(), dv->values().end(),
-                                      kaSum, KahanSum);
-      result += kaResult.sum;
-    }
+    for (auto dv : paras.mDoubleValues())
+      result += Summation::sum(dv->values());
+    for (auto dv : paras.mIntValues())
+      result += sumOf(dv->values());
     break;
   } // end double
 
@@ -297,12 +487,8 @@ void AddAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
       result += dv->value();
 
     // collapse multi values
-    for (auto dv : paras.mIntValues()) {
-      KahanSummation kaSum = {(double)result};
-      auto kaResult = std::accumulate(dv->values().begin(), dv->values().end(),
-                                      kaSum, KahanSum);
-      result += kaResult.sum;
-    }
+    for (auto dv : paras.mIntValues())
+      result += sumOf(dv->values());
     break;
   } // end int
   default: {
@@ -312,6 +498,30 @@ void AddAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
   } // end switch
 }
 
+bool AddAll::derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                         std::shared_ptr<Parameter> adjoint,
+                         ParameterList &adjoints) {
+  auto ops = operands(paras, adjoints);
+  Operand a = operand(adjoint);
+
+  // Single values are added to each element of a multi value output and
+  // multi values are collapsed for a single value output.
+  std::complex<double> total(0., 0.);
+  std::size_t n = (a.multi() ? a.Size : 1);
+  for (std::size_t e = 0; e < n; ++e)
+    total += a.value(e);
+
+  for (auto &op : ops) {
+    if (op.multi())
+      for (std::size_t e = 0; e < op.Size; ++e)
+        op.addAdjoint(e, (a.multi() ? a.value(e) : total));
+    else
+      op.addAdjoint(0, total);
+    op.flush();
+  }
+  return true;
+}
+
 void MultAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
   if (out && checkType != out->type())
     throw BadParameter("MultAll::execute() | Parameter type mismatch!");
@@ -342,25 +552,39 @@ void MultAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
     for (auto p : paras.intValues())
       result *= p->value();
 
-    if (!out)
-      out = MComplex("", paras.mComplexValue(0)->values().size());
-    auto par =
-        std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out);
-    auto &results = par->values();                     // reference
-    std::fill(results.begin(), results.end(), result); // reset
-
-    for (auto p : paras.mComplexValues()) {
-      std::transform(p->values().begin(), p->values().end(), results.begin(),
-                     results.begin(), std::multiplies<std::complex<double>>());
-    }
-    for (auto p : paras.mDoubleValues()) {
-      std::transform(p->values().begin(), p->values().end(), results.begin(),
-                     results.begin(), std::multiplies<std::complex<double>>());
-    }
-    for (auto p : paras.mIntValues()) {
-      std::transform(p->values().begin(), p->values().end(), results.begin(),
-                     results.begin(), std::multiplies<std::complex<double>>());
-    }
+    size_t n = paras.mComplexValue(0)->values().size();
+    for (auto p : paras.mComplexValues())
+      if (p->values().size() != n)
+        throw BadParameter("MultAll::execute() | MCOMPLEX: Size of multi "
+                           "complex value does not match!");
+    for (auto p : paras.mDoubleValues())
+      if (p->values().size() != n)
+        throw BadParameter("MultAll::execute() | MCOMPLEX: Size of multi "
+                           "double value does not match!");
+    for (auto p : paras.mIntValues())
+      if (p->values().size() != n)
+        throw BadParameter("MultAll::execute() | MCOMPLEX: Size of multi "
+                           "int value does not match!");
+
+    auto &results = multiOutput<std::complex<double>>(out, n);
+
+    ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+      auto res = results.begin();
+      auto mc = paras.mComplexValues().begin();
+      // result * first multi complex value, then multiply the remaining ones
+      Kernels::multiply(result, (*mc)->values().data() + begin,
+                        results.data() + begin, end - begin);
+      for (++mc; mc != paras.mComplexValues().end(); ++mc)
+        Kernels::multiply(results.data() + begin,
+                          (*mc)->values().data() + begin,
+                          results.data() + begin, end - begin);
+      for (const auto &p : paras.mDoubleValues())
+        Kernels::multiply(results.data() + begin, p->values().data() + begin,
+                          results.data() + begin, end - begin);
+      for (const auto &p : paras.mIntValues())
+        std::transform(res + begin, res + end, p->values().begin() + begin,
+                       res + begin, std::multiplies<std::complex<double>>());
+    });
     break;
   } // end multi complex
   case ParType::MDOUBLE: {
@@ -378,21 +602,28 @@ void MultAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
     for (auto p : paras.intValues())
       result *= p->value();
 
-    if (!out)
-      out = MDouble("", paras.mDoubleValue(0)->values().size());
-    // fill MultiComplex parameter
-    auto par = std::static_pointer_cast<Value<std::vector<double>>>(out);
-    auto &results = par->values();                     // reference
-    std::fill(results.begin(), results.end(), result); // reset
-
-    for (auto p : paras.mDoubleValues()) {
-      std::transform(p->values().begin(), p->values().end(), results.begin(),
-                     results.begin(), std::multiplies<double>());
-    }
-    for (auto p : paras.mIntValues()) {
-      std::transform(p->values().begin(), p->values().end(), results.begin(),
-                     results.begin(), std::multiplies<double>());
-    }
+    size_t n = paras.mDoubleValue(0)->values().size();
+    for (auto p : paras.mDoubleValues())
+      if (p->values().size() != n)
+        throw BadParameter("MultAll::execute() | MDOUBLE: Size of multi "
+                           "double value does not match!");
+    for (auto p : paras.mIntValues())
+      if (p->values().size() != n)
+        throw BadParameter("MultAll::execute() | MDOUBLE: Size of multi "
+                           "int value does not match!");
+
+    auto &results = multiOutput<double>(out, n);
+
+    ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+      auto res = results.begin();
+      std::fill(res + begin, res + end, result); // reset
+      for (const auto &p : paras.mDoubleValues())
+        std::transform(res + begin, res + end, p->values().begin() + begin,
+                       res + begin, std::multiplies<double>());
+      for (const auto &p : paras.mIntValues())
+        std::transform(res + begin, res + end, p->values().begin() + begin,
+                       res + begin, std::multiplies<double>());
+    });
     break;
   } // end multi double
 
@@ -407,18 +638,21 @@ void MultAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
     for (auto p : paras.intValues())
       result *= p->value();
 
-    if (!out)
-      out = MInteger("", paras.mIntValue(0)->values().size());
-
-    // fill MultiComplex parameter
-    auto par = std::static_pointer_cast<Value<std::vector<int>>>(out);
-    auto &results = par->values();                     // reference
-    std::fill(results.begin(), results.end(), result); // reset
-
-    for (auto p : paras.mIntValues()) {
-      std::transform(p->values().begin(), p->values().end(), results.begin(),
-                     results.begin(), std::multiplies<int>());
-    }
+    size_t n = paras.mIntValue(0)->values().size();
+    for (auto p : paras.mIntValues())
+      if (p->values().size() != n)
+        throw BadParameter("MultAll::execute() | MINTEGER: Size of multi "
+                           "int value does not match!");
+
+    auto &results = multiOutput<int>(out, n);
+
+    ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+      auto res = results.begin();
+      std::fill(res + begin, res + end, result); // reset
+      for (const auto &p : paras.mIntValues())
+        std::transform(res + begin, res + end, p->values().begin() + begin,
+                       res + begin, std::multiplies<int>());
+    });
     break;
   } // end multi int
 
@@ -484,6 +718,28 @@ void MultAll::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
   } // end switch
 }
 
+bool MultAll::derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                          std::shared_ptr<Parameter> adjoint,
+                          ParameterList &adjoints) {
+  auto ops = operands(paras, adjoints);
+  Operand a = operand(adjoint);
+
+  // The derivative with respect to an input is the product of all other
+  // inputs. Contributions to single values are summed over all elements.
+  std::size_t n = (a.multi() ? a.Size : 1);
+  for (std::size_t k = 0; k < ops.size(); ++k) {
+    for (std::size_t e = 0; e < n; ++e) {
+      std::complex<double> others(1., 0.);
+      for (std::size_t j = 0; j < ops.size(); ++j)
+        if (j != k)
+          others *= ops[j].value(e);
+      ops[k].addAdjoint(e, a.value(e) * std::conj(others));
+    }
+    ops[k].flush();
+  }
+  return true;
+}
+
 void LogOf::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
   if (out && checkType != out->type())
     throw BadParameter("LogOf::execute() | Parameter type mismatch!");
@@ -506,23 +762,24 @@ void LogOf::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
           "LogOf::execute() | MDOUBLE: Number and/or types do not match");
 
     if (nMD) {
-      if (!out)
-        out = MDouble("", paras.mDoubleValue(0)->values().size());
-      auto par = std::static_pointer_cast<Value<std::vector<double>>>(out);
-      auto &results = par->values();                 // reference
-      std::fill(results.begin(), results.end(), 0.); // reset
-      std::transform(paras.mDoubleValue(0)->operator()().begin(),
-                     paras.mDoubleValue(0)->operator()().end(), results.begin(),
-                     [](double x) { return std::log(x); });
+      auto &data = paras.mDoubleValue(0)->values();
+      auto &results = multiOutput<double>(out, data.size());
+      ThreadPool::instance().parallelFor(
+          data.size(), [&](size_t begin, size_t end) {
+            std::transform(data.begin() + begin, data.begin() + end,
+                           results.begin() + begin,
+                           [](double x) { return std::log(x); });
+          });
     }
     if (nMI) {
-      if (!out)
-        out = MDouble("", paras.mIntValue(0)->values().size());
-      auto par = std::static_pointer_cast<Value<std::vector<double>>>(out);
-      auto &results = par->values(); // reference
-      std::transform(paras.mIntValue(0)->operator()().begin(),
-                     paras.mIntValue(0)->operator()().end(), results.begin(),
-                     [](double x) { return std::log(x); });
+      auto &data = paras.mIntValue(0)->values();
+      auto &results = multiOutput<double>(out, data.size());
+      ThreadPool::instance().parallelFor(
+          data.size(), [&](size_t begin, size_t end) {
+            std::transform(data.begin() + begin, data.begin() + end,
+                           results.begin() + begin,
+                           [](double x) { return std::log(x); });
+          });
     }
     break;
   } // end multi double
@@ -556,6 +813,16 @@ void LogOf::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
   } // end switch
 };
 
+bool LogOf::derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                        std::shared_ptr<Parameter> adjoint,
+                        ParameterList &adjoints) {
+  return unaryDerivatives(
+      paras, adjoint, adjoints,
+      [](std::complex<double> a, std::complex<double> x) {
+        return a / std::conj(x);
+      });
+}
+
 void Complexify::execute(ParameterList &paras,
                          std::shared_ptr<Parameter> &out) {
   if (out && checkType != out->type())
@@ -574,19 +841,22 @@ void Complexify::execute(ParameterList &paras,
     if (nMD != 2 || nMC || nMI || nC || nD || nI)
       throw BadParameter(
           "Complexify::execute() | MCOMPLEX: Number and/or types do not match");
-    if (!out)
-      out = MComplex("", paras.mDoubleValue(0)->values().size());
-    auto par =
-        std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out);
-    auto &results = par->values(); // reference
-
     // We have to assume here that the magnitude is the first parameter and
     // the phase the second one. We cannot check that.
-    std::transform(
-        paras.mDoubleValue(0)->operator()().begin(),
-        paras.mDoubleValue(0)->operator()().end(),
-        paras.mDoubleValue(1)->operator()().begin(), results.begin(),
-        [](double r, double phi) { return std::polar(std::abs(r), phi); });
+    auto &mag = paras.mDoubleValue(0)->values();
+    auto &phase = paras.mDoubleValue(1)->values();
+    if (phase.size() != mag.size())
+      throw BadParameter("Complexify::execute() | MCOMPLEX: Size of multi "
+                         "double values does not match!");
+    auto &results = multiOutput<std::complex<double>>(out, mag.size());
+    ThreadPool::instance().parallelFor(
+        mag.size(), [&](size_t begin, size_t end) {
+          std::transform(mag.begin() + begin, mag.begin() + end,
+                         phase.begin() + begin, results.begin() + begin,
+                         [](double r, double phi) {
+                           return std::polar(std::abs(r), phi);
+                         });
+        });
     break;
   } // end multi complex
   case ParType::COMPLEX: {
@@ -619,6 +889,32 @@ void Complexify::execute(ParameterList &paras,
   } // end switch
 };
 
+bool Complexify::derivatives(ParameterList &paras,
+                             std::shared_ptr<Parameter> out,
+                             std::shared_ptr<Parameter> adjoint,
+                             ParameterList &adjoints) {
+  auto ops = operands(paras, adjoints);
+  if (ops.size() != 2)
+    throw BadParameter("Complexify::derivatives() | Expecting magnitude and "
+                       "phase!");
+  Operand a = operand(adjoint);
+  auto &mag = ops.at(0);
+  auto &phase = ops.at(1);
+
+  // w = |r| exp(i phi): dw/dr = sign(r) exp(i phi) and dw/dphi = i w
+  std::size_t n = (a.multi() ? a.Size : 1);
+  for (std::size_t e = 0; e < n; ++e) {
+    double r = mag.value(e).real();
+    std::complex<double> dir = std::polar(1., phase.value(e).real());
+    mag.addAdjoint(e, a.value(e) * std::conj(r < 0 ? -dir : dir));
+    phase.addAdjoint(e, a.value(e) * std::conj(std::complex<double>(0., 1.) *
+                                               std::abs(r) * dir));
+  }
+  mag.flush();
+  phase.flush();
+  return true;
+}
+
 void ComplexConjugate::execute(ParameterList &paras,
                                std::shared_ptr<Parameter> &out) {
   if (out && checkType != out->type())
@@ -643,15 +939,14 @@ void ComplexConjugate::execute(ParameterList &paras,
     if (nMC != 1 || nC)
       throw BadParameter("ComplexConjugate::execute() | MCOMPLEX: Number "
                          "and/or types do not match");
-    if (!out)
-      out = MComplex("", paras.mComplexValue(0)->values().size());
-    auto par =
-        std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out);
-    auto &results = par->values(); // reference
-
-    std::transform(paras.mComplexValue(0)->operator()().begin(),
-                   paras.mComplexValue(0)->operator()().end(), results.begin(),
-                   [](std::complex<double> c) { return std::conj(c); });
+    auto &data = paras.mComplexValue(0)->values();
+    auto &results = multiOutput<std::complex<double>>(out, data.size());
+    ThreadPool::instance().parallelFor(
+        data.size(), [&](size_t begin, size_t end) {
+          std::transform(
+              data.begin() + begin, data.begin() + end, results.begin() + begin,
+              [](std::complex<double> c) { return std::conj(c); });
+        });
     break;
   } // end multi complex
   case ParType::COMPLEX: {
@@ -673,6 +968,17 @@ void ComplexConjugate::execute(ParameterList &paras,
   } // end switch
 };
 
+bool ComplexConjugate::derivatives(ParameterList &paras,
+                                   std::shared_ptr<Parameter> out,
+                                   std::shared_ptr<Parameter> adjoint,
+                                   ParameterList &adjoints) {
+  return unaryDerivatives(
+      paras, adjoint, adjoints,
+      [](std::complex<double> a, std::complex<double> z) {
+        return std::conj(a);
+      });
+}
+
 void AbsSquare::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
   if (out && checkType != out->type())
     throw BadParameter("AbsSquare::SquareRoot() | Parameter type mismatch!");
@@ -692,29 +998,31 @@ void AbsSquare::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
 
   case ParType::MDOUBLE: {
     if (nMD == 1) {
-      if (!out)
-        out = MDouble("", paras.mDoubleValue(0)->values().size());
-      auto par = std::static_pointer_cast<Value<std::vector<double>>>(out);
-      auto &results = par->values(); // reference
-      std::transform(paras.mDoubleValue(0)->operator()().begin(),
-                     paras.mDoubleValue(0)->operator()().end(), results.begin(),
-                     [](double c) { return std::norm(c); });
+      auto &data = paras.mDoubleValue(0)->values();
+      auto &results = multiOutput<double>(out, data.size());
+      ThreadPool::instance().parallelFor(
+          data.size(), [&](size_t begin, size_t end) {
+            std::transform(data.begin() + begin, data.begin() + end,
+                           results.begin() + begin,
+                           [](double c) { return std::norm(c); });
+          });
     } else if (nMC == 1) {
-      if (!out)
-        out = MDouble("", paras.mComplexValue(0)->values().size());
-      auto par = std::static_pointer_cast<Value<std::vector<double>>>(out);
-      auto &results = par->values(); // reference
-      std::transform(paras.mComplexValue(0)->values().begin(),
-                     paras.mComplexValue(0)->values().end(), results.begin(),
-                     [](std::complex<double> c) { return std::norm(c); });
+      auto &data = paras.mComplexValue(0)->values();
+      auto &results = multiOutput<double>(out, data.size());
+      ThreadPool::instance().parallelFor(
+          data.size(), [&](size_t begin, size_t end) {
+            Kernels::absSquare(data.data() + begin, results.data() + begin,
+                               end - begin);
+          });
     } else if (nMI == 1) {
-      if (!out)
-        out = MDouble("", paras.mIntValue(0)->values().size());
-      auto par = std::static_pointer_cast<Value<std::vector<double>>>(out);
-      auto &results = par->values(); // reference
-      std::transform(paras.mIntValue(0)->operator()().begin(),
-                     paras.mIntValue(0)->operator()().end(), results.begin(),
-                     [](int c) { return std::norm(c); });
+      auto &data = paras.mIntValue(0)->values();
+      auto &results = multiOutput<double>(out, data.size());
+      ThreadPool::instance().parallelFor(
+          data.size(), [&](size_t begin, size_t end) {
+            std::transform(data.begin() + begin, data.begin() + end,
+                           results.begin() + begin,
+                           [](int c) { return std::norm(c); });
+          });
     } else {
       throw BadParameter("AbsSquare::execute() | MDOUBLE: Number and/or "
                          "types do not match");
@@ -725,32 +1033,33 @@ void AbsSquare::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
     if (nMI != 1)
       throw BadParameter("AbsSquare::execute() | MINTEGER: Number and/or "
                          "types do not match");
-    if (!out)
-      out = MInteger("", paras.mIntValue(0)->values().size());
-    auto par = std::static_pointer_cast<Value<std::vector<int>>>(out);
-    auto &results = par->values(); // reference
-
-    std::transform(paras.mDoubleValue(0)->operator()().begin(),
-                   paras.mDoubleValue(0)->operator()().end(), results.begin(),
-                   [](int c) { return std::norm(c); });
-  }
+    auto &data = paras.mIntValue(0)->values();
+    auto &results = multiOutput<int>(out, data.size());
+
+    ThreadPool::instance().parallelFor(
+        data.size(), [&](size_t begin, size_t end) {
+          std::transform(data.begin() + begin, data.begin() + end,
+                         results.begin() + begin, [](int c) { return c * c; });
+        });
+    break;
+  } // end multi int
   case ParType::INTEGER: {
     if (nI != 1)
       throw BadParameter("AbsSquare::execute() | INTEGER: Number and/or "
                          "types do not match");
-    out = std::shared_ptr<Parameter>(
-        new Value<int>(out->name(), std::norm(paras.intValue(0)->value())));
-  }
+    auto &result = singleOutput<int>(out);
+    int var = paras.intValue(0)->value();
+    result = var * var;
+    break;
+  } // end int
   case ParType::DOUBLE: {
+    auto &result = singleOutput<double>(out);
     if (paras.doubleValues().size()) {
-      out = std::shared_ptr<Parameter>(new Value<double>(
-          out->name(), std::norm(paras.doubleValue(0)->value())));
+      result = std::norm(paras.doubleValue(0)->value());
     } else if (paras.doubleParameters().size()) {
-      out = std::shared_ptr<Parameter>(new Value<double>(
-          out->name(), std::norm(paras.doubleParameter(0)->value())));
+      result = std::norm(paras.doubleParameter(0)->value());
     } else if (nC) {
-      out = std::shared_ptr<Parameter>(new Value<double>(
-          out->name(), std::norm(paras.complexValue(0)->value())));
+      result = std::norm(paras.complexValue(0)->value());
     } else {
       throw BadParameter("AbsSquare::execute() | DOUBLE: Number and/or "
                          "types do not match");
@@ -764,4 +1073,15 @@ void AbsSquare::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
   } // end switch
 };
 
+bool AbsSquare::derivatives(ParameterList &paras,
+                            std::shared_ptr<Parameter> out,
+                            std::shared_ptr<Parameter> adjoint,
+                            ParameterList &adjoints) {
+  // d|z|^2/dRe(z) = 2 Re(z) and d|z|^2/dIm(z) = 2 Im(z)
+  return unaryDerivatives(paras, adjoint, adjoints,
+                          [](std::complex<double> a, std::complex<double> z) {
+                            return 2. * a.real() * z;
+                          });
+}
+
 } // ns::ComPWA
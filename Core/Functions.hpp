@@ -41,6 +41,20 @@ public:
   virtual void execute(ParameterList &paras,
                        std::shared_ptr<Parameter> &out) = 0;
 
+  /// Derivatives of the strategy in reverse mode. \p adjoint contains the
+  /// derivatives of a real function L with respect to the output \p out of
+  /// execute(). For complex values the derivatives with respect to the real
+  /// and the imaginary part are stored as real and imaginary part. The
+  /// derivatives of L with respect to the inputs \p paras are added to
+  /// \p adjoints, which has the same layout as \p paras. Returns false if
+  /// the strategy does not provide derivatives.
+  virtual bool derivatives(ParameterList &paras,
+                           std::shared_ptr<Parameter> out,
+                           std::shared_ptr<Parameter> adjoint,
+                           ParameterList &adjoints) {
+    return false;
+  }
+
   std::string str() const { return Op; }
 
   friend std::ostream &operator<<(std::ostream &out,
@@ -53,6 +67,33 @@ public:
   }
 
 protected:
+  /// Output of a multi value strategy. In case \p out does not exist it is
+  /// created with \p n elements. Otherwise, the existing storage is used and
+  /// its size has to match \p n. Strategies write their results into this
+  /// storage and never resize or replace it.
+  template <class T>
+  std::vector<T> &multiOutput(std::shared_ptr<Parameter> &out,
+                              std::size_t n) const {
+    if (!out)
+      out = std::make_shared<Value<std::vector<T>>>("", std::vector<T>(n));
+    auto &results =
+        std::static_pointer_cast<Value<std::vector<T>>>(out)->values();
+    if (results.size() != n)
+      throw BadParameter("Strategy::multiOutput() | " + Op +
+                         ": Size of output (" + std::to_string(results.size()) +
+                         ") does not match the number of elements (" +
+                         std::to_string(n) + ")!");
+    return results;
+  }
+
+  /// Output of a single value strategy. In case \p out does not exist it is
+  /// created.
+  template <class T> T &singleOutput(std::shared_ptr<Parameter> &out) const {
+    if (!out)
+      out = std::make_shared<Value<T>>();
+    return std::static_pointer_cast<Value<T>>(out)->values();
+  }
+
   ParType checkType;
   const std::string Op;
 };
@@ -68,6 +109,10 @@ public:
   virtual ~Inverse(){};
 
   virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+  virtual bool derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                           std::shared_ptr<Parameter> adjoint,
+                           ParameterList &adjoints);
 };
 
 ///
@@ -82,6 +127,10 @@ public:
   virtual ~SquareRoot() {}
 
   virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+  virtual bool derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                           std::shared_ptr<Parameter> adjoint,
+                           ParameterList &adjoints);
 };
 
 ///
@@ -103,6 +152,10 @@ public:
 ///     each element.
 ///   - ParType::MDOUBLE: same ad MCOMPLEX except that complex 
   virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+  virtual bool derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                           std::shared_ptr<Parameter> adjoint,
+                           ParameterList &adjoints);
 };
 
 class MultAll : public Strategy {
@@ -112,6 +165,10 @@ public:
   virtual ~MultAll() {}
 
   virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+  virtual bool derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                           std::shared_ptr<Parameter> adjoint,
+                           ParameterList &adjoints);
 };
 
 class LogOf : public Strategy {
@@ -121,6 +178,10 @@ public:
   virtual ~LogOf(){};
 
   virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+  virtual bool derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                           std::shared_ptr<Parameter> adjoint,
+                           ParameterList &adjoints);
 };
 
 class Complexify : public Strategy {
@@ -130,6 +191,10 @@ public:
   virtual ~Complexify() {}
 
   virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+  virtual bool derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                           std::shared_ptr<Parameter> adjoint,
+                           ParameterList &adjoints);
 };
 
 class ComplexConjugate : public Strategy {
@@ -139,6 +204,10 @@ public:
   virtual ~ComplexConjugate() {}
   
   virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+  virtual bool derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                           std::shared_ptr<Parameter> adjoint,
+                           ParameterList &adjoints);
 };
 
 class AbsSquare : public Strategy {
@@ -148,6 +217,10 @@ public:
   virtual ~AbsSquare() {}
 
   virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+  virtual bool derivatives(ParameterList &paras, std::shared_ptr<Parameter> out,
+                           std::shared_ptr<Parameter> adjoint,
+                           ParameterList &adjoints);
 };
 
 } // ns::ComPWA
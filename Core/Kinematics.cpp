@@ -2,6 +2,9 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <sstream>
+#include <string>
+
 #include "Core/Kinematics.hpp"
 #include "Core/Exceptions.hpp"
 #include "Core/DataPoint.hpp"
@@ -17,6 +20,54 @@ double Kinematics::phspVolume() const {
   return PhspVolume;
 }
 
+void Kinematics::convert(const EventCollection &events, std::size_t i,
+                         DataPoint &point) const {
+  convert(events.event(i), point);
+}
+
+void Kinematics::convert(const EventCollection &events, std::size_t begin,
+                         std::size_t end,
+                         std::vector<std::vector<double>> &values,
+                         std::vector<char> &mask) const {
+  if (begin > end || end > events.size())
+    throw BadParameter("Kinematics::convert() | Range [" +
+                       std::to_string(begin) + ", " + std::to_string(end) +
+                       ") exceeds the number of events (" +
+                       std::to_string(events.size()) + ")!");
+  std::size_t n = end - begin;
+  values.resize(numVariables());
+  for (auto &v : values)
+    v.resize(n);
+  mask.assign(n, 1);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    DataPoint point;
+    try {
+      convert(events, begin + i, point);
+    } catch (BeyondPhsp &ex) {
+      mask[i] = 0;
+      continue;
+    }
+    for (std::size_t k = 0; k < values.size(); ++k)
+      values[k][i] = point.value(k);
+  }
+}
+
+std::string Kinematics::configuration() const {
+  std::stringstream stream;
+  stream << "InitialState:";
+  for (auto i : InitialState)
+    stream << " " << i;
+  stream << "\nFinalState:";
+  for (auto i : FinalState)
+    stream << " " << i;
+  stream << "\nVariables:";
+  for (auto const &i : VariableNames)
+    stream << " " << i;
+  stream << "\n";
+  return stream.str();
+}
+
 void Kinematics::setPhspVolume(double vol) {
   PhspVolume = vol;
   HasPhspVolume = true;
@@ -16,6 +16,7 @@
 
 #include "Core/DataPoint.hpp"
 #include "Core/Event.hpp"
+#include "Core/EventCollection.hpp"
 #include "Core/Particle.hpp"
 #include "Core/Properties.hpp"
 #include "Core/Spin.hpp"
@@ -42,6 +43,23 @@ public:
   /// Convert Event to dataPoint
   virtual void convert(const ComPWA::Event &ev, DataPoint &point) const = 0;
 
+  /// Convert event \p i of \p events to dataPoint. The default
+  /// implementation creates an Event from the columns, derived classes
+  /// should read the columns directly.
+  virtual void convert(const ComPWA::EventCollection &events, std::size_t i,
+                       DataPoint &point) const;
+
+  /// Convert the events [\p begin, \p end) of \p events to columns of
+  /// variables. On return \p values.at(k).at(i) contains variable k of event
+  /// \p begin + i and \p mask.at(i) is zero if that event is outside the
+  /// phase space boundaries (its values are undefined then). No BeyondPhsp
+  /// exception is thrown. The default implementation converts event by
+  /// event.
+  virtual void convert(const ComPWA::EventCollection &events,
+                       std::size_t begin, std::size_t end,
+                       std::vector<std::vector<double>> &values,
+                       std::vector<char> &mask) const;
+
   /// Check if dataPoint is within phase space boundaries
   virtual bool isWithinPhsp(const DataPoint &point) const = 0;
 
@@ -69,6 +87,12 @@ public:
     return VariableTitles;
   }
 
+  /// String that identifies the configuration of the kinematic variables.
+  /// Two Kinematics objects with equal configuration calculate the same
+  /// variables from the same events. It is used as part of the key of
+  /// cached variables.
+  virtual std::string configuration() const;
+
 protected:
   std::vector<pid> InitialState;
 
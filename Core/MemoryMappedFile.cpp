@@ -0,0 +1,56 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Core/Exceptions.hpp"
+#include "Core/MemoryMappedFile.hpp"
+
+using namespace ComPWA;
+
+MemoryMappedFile::MemoryMappedFile(const std::string &fileName,
+                                   bool copyOnWrite)
+    : FileName(fileName), Data(nullptr), Size(0), CopyOnWrite(copyOnWrite) {
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw BadConfig("MemoryMappedFile::MemoryMappedFile() | Can not open " +
+                    fileName + ": " + std::strerror(errno));
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    int error = errno;
+    close(fd);
+    throw BadConfig("MemoryMappedFile::MemoryMappedFile() | Can not stat " +
+                    fileName + ": " + std::strerror(error));
+  }
+  Size = info.st_size;
+
+  // A mapping of length zero is not allowed
+  if (Size) {
+    void *address =
+        CopyOnWrite ? mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                           fd, 0)
+                    : mmap(nullptr, Size, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+      int error = errno;
+      close(fd);
+      throw BadConfig("MemoryMappedFile::MemoryMappedFile() | Can not map " +
+                      fileName + ": " + std::strerror(error));
+    }
+    Data = static_cast<char *>(address);
+  }
+  // The mapping stays valid after the file descriptor is closed
+  close(fd);
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+  if (Data)
+    munmap(Data, Size);
+}
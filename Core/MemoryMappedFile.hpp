@@ -0,0 +1,66 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// MemoryMappedFile class
+///
+
+#ifndef _MEMORYMAPPEDFILE_HPP_
+#define _MEMORYMAPPEDFILE_HPP_
+
+#include <cstddef>
+#include <string>
+
+namespace ComPWA {
+
+///
+/// \class MemoryMappedFile
+/// Read-only memory map of a complete file. The file is mapped by the
+/// constructor and unmapped by the destructor. Pages are loaded by the
+/// operating system on first access, therefore opening a large file is
+/// cheap.
+///
+/// A copy-on-write mapping can be modified. The modifications are private
+/// to the process and are not written to the file.
+///
+class MemoryMappedFile {
+public:
+  /// Map \p fileName. Throws a BadConfig exception if the file can not be
+  /// opened or mapped.
+  MemoryMappedFile(const std::string &fileName, bool copyOnWrite = false);
+
+  ~MemoryMappedFile();
+
+  MemoryMappedFile(const MemoryMappedFile &that) = delete;
+
+  MemoryMappedFile &operator=(const MemoryMappedFile &that) = delete;
+
+  /// Start of the mapped file. The address is aligned to a page boundary.
+  const char *data() const { return Data; }
+
+  /// Writable start of the mapped file. Must only be written if the file is
+  /// mapped copy-on-write.
+  char *data() { return Data; }
+
+  bool copyOnWrite() const { return CopyOnWrite; }
+
+  /// Size of the file in bytes
+  std::size_t size() const { return Size; }
+
+  const std::string &fileName() const { return FileName; }
+
+private:
+  std::string FileName;
+
+  char *Data;
+
+  std::size_t Size;
+
+  bool CopyOnWrite;
+};
+
+} // namespace ComPWA
+
+#endif
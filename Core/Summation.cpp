@@ -0,0 +1,24 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <atomic>
+
+#include "Core/Summation.hpp"
+
+namespace ComPWA {
+namespace Summation {
+
+namespace {
+std::atomic<int> &currentMode() {
+  static std::atomic<int> m(static_cast<int>(Mode::KAHAN));
+  return m;
+}
+} // namespace
+
+Mode mode() { return static_cast<Mode>(currentMode().load()); }
+
+void setMode(Mode m) { currentMode() = static_cast<int>(m); }
+
+} // namespace Summation
+} // namespace ComPWA
@@ -0,0 +1,116 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Reproducible parallel summation.
+///
+/// Sums over events are split into chunks of a fixed size (ChunkSize). The
+/// chunks are summed in parallel on the ThreadPool and the partial sums are
+/// combined in a fixed order. The chunk boundaries do not depend on the
+/// number of threads, therefore the result is bit-identical for any number of
+/// threads.
+///
+/// The summation algorithm is selected at runtime via setMode():
+///   - NAIVE: sequential summation within a chunk
+///   - KAHAN: compensated (Kahan) summation, the default
+///   - PAIRWISE: recursive pairwise summation
+///
+
+#ifndef _SUMMATION_HPP_
+#define _SUMMATION_HPP_
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "Core/ThreadPool.hpp"
+
+namespace ComPWA {
+namespace Summation {
+
+enum class Mode { NAIVE = 0, KAHAN = 1, PAIRWISE = 2 };
+
+/// Summation algorithm that is currently used
+Mode mode();
+
+/// Select the summation algorithm
+void setMode(Mode m);
+
+/// Number of elements per chunk
+const std::size_t ChunkSize = 4096;
+
+/// Maximum number of chunks whose partial sums are stored on the stack
+const std::size_t MaxStackChunks = 256;
+
+/// Number of elements below which pairwise summation adds sequentially
+const std::size_t PairwiseBlockSize = 8;
+
+/// Sum of \p value(i) for i in [\p begin, \p end) in the calling thread
+template <class T, class Function>
+T sumRange(std::size_t begin, std::size_t end, Function value, Mode m) {
+  switch (m) {
+  case Mode::KAHAN: {
+    T sum(0.), correction(0.);
+    for (std::size_t i = begin; i < end; ++i) {
+      T y = value(i) - correction;
+      T t = sum + y;
+      correction = (t - sum) - y;
+      sum = t;
+    }
+    return sum;
+  }
+  case Mode::PAIRWISE: {
+    if (end - begin > PairwiseBlockSize) {
+      std::size_t middle = begin + (end - begin) / 2;
+      return sumRange<T>(begin, middle, value, m) +
+             sumRange<T>(middle, end, value, m);
+    }
+    return sumRange<T>(begin, end, value, Mode::NAIVE);
+  }
+  default: {
+    T sum(0.);
+    for (std::size_t i = begin; i < end; ++i)
+      sum += value(i);
+    return sum;
+  }
+  }
+}
+
+/// Sum of \p value(i) for i in [0, \p n). The chunks are evaluated in
+/// parallel, therefore \p value has to be thread-safe.
+template <class T, class Function> T sum(std::size_t n, Function value) {
+  Mode m = mode();
+  if (n <= ChunkSize)
+    return sumRange<T>(0, n, value, m);
+
+  // The partial sums are stored on the stack for up to MaxStackChunks chunks
+  // so that the summation does not allocate memory.
+  std::size_t nChunks = (n + ChunkSize - 1) / ChunkSize;
+  T stackSums[MaxStackChunks];
+  std::vector<T> heapSums;
+  T *partialSums = stackSums;
+  if (nChunks > MaxStackChunks) {
+    heapSums.resize(nChunks);
+    partialSums = heapSums.data();
+  }
+  ThreadPool::instance().parallelFor(
+      n,
+      [&](std::size_t begin, std::size_t end) {
+        partialSums[begin / ChunkSize] = sumRange<T>(begin, end, value, m);
+      },
+      ChunkSize);
+  return sumRange<T>(0, nChunks,
+                     [&](std::size_t i) { return partialSums[i]; }, m);
+}
+
+/// Sum of all elements of \p values
+template <class T> T sum(const std::vector<T> &values) {
+  return sum<T>(values.size(), [&](std::size_t i) { return values[i]; });
+}
+
+} // namespace Summation
+} // namespace ComPWA
+
+#endif
@@ -0,0 +1,169 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include "Core/ThreadPool.hpp"
+#include "Core/Logging.hpp"
+
+using namespace ComPWA;
+
+thread_local unsigned int ThreadPool::CurrentQueue = 0;
+
+ThreadPool &ThreadPool::instance() {
+  static ThreadPool pool;
+  return pool;
+}
+
+ThreadPool::ThreadPool() : Stop(false), NumQueued(0), GrainSize(16384) {
+  unsigned int n = std::thread::hardware_concurrency();
+  start(n > 1 ? n - 1 : 0);
+}
+
+ThreadPool::~ThreadPool() { stop(); }
+
+void ThreadPool::setNumThreads(unsigned int n) {
+  if (n == numThreads())
+    return;
+  stop();
+  start(n > 1 ? n - 1 : 0);
+  LOG(DEBUG) << "ThreadPool::setNumThreads() | Using " << numThreads()
+             << " threads.";
+}
+
+void ThreadPool::start(unsigned int numWorkers) {
+  Stop = false;
+  Queues.clear();
+  for (unsigned int i = 0; i < numWorkers + 1; ++i)
+    Queues.push_back(std::unique_ptr<Queue>(new Queue));
+  for (unsigned int i = 0; i < numWorkers; ++i)
+    Workers.push_back(std::thread(&ThreadPool::work, this, i + 1));
+}
+
+void ThreadPool::stop() {
+  {
+    std::lock_guard<std::mutex> lock(SleepMutex);
+    Stop = true;
+  }
+  WakeUp.notify_all();
+  for (auto &w : Workers)
+    w.join();
+  Workers.clear();
+}
+
+void ThreadPool::submit(TaskGroup &group, std::function<void()> task) {
+  Task t;
+  t.Function = std::move(task);
+  submitTask(group, std::move(t));
+}
+
+void ThreadPool::submitTask(TaskGroup &group, Task task) {
+  ++group.Pending;
+  task.Group = &group;
+  auto &q = *Queues.at(CurrentQueue);
+  {
+    std::lock_guard<std::mutex> lock(q.Mutex);
+    q.Tasks.push_back(std::move(task));
+  }
+  ++NumQueued;
+  if (Workers.size()) {
+    // Lock and release the mutex so that a worker which is about to sleep
+    // can not miss the notification.
+    { std::lock_guard<std::mutex> lock(SleepMutex); }
+    WakeUp.notify_one();
+  }
+}
+
+void ThreadPool::wait(TaskGroup &group) {
+  Task task;
+  while (group.Pending > 0) {
+    if (popGroup(CurrentQueue, &group, task)) {
+      run(task);
+      continue;
+    }
+    // All remaining tasks of this group are executed by other threads
+    std::unique_lock<std::mutex> lock(group.Mutex);
+    group.Done.wait(lock, [&group]() { return group.Pending == 0; });
+  }
+
+  // The last task releases the mutex after it has finished with the group.
+  // We have to acquire it once more before the group can be destroyed.
+  std::lock_guard<std::mutex> lock(group.Mutex);
+  if (group.Error) {
+    std::exception_ptr err = group.Error;
+    group.Error = std::exception_ptr();
+    std::rethrow_exception(err);
+  }
+}
+
+void ThreadPool::work(unsigned int id) {
+  CurrentQueue = id;
+  Task task;
+  while (true) {
+    if (pop(id, task) || steal(id, task)) {
+      run(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(SleepMutex);
+    WakeUp.wait(lock, [this]() { return Stop || NumQueued > 0; });
+    if (Stop)
+      return;
+  }
+}
+
+void ThreadPool::run(Task &task) {
+  TaskGroup *group = task.Group;
+  try {
+    if (task.Chunk)
+      task.Chunk(task.Context, task.Begin, task.End);
+    else
+      task.Function();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(group->Mutex);
+    if (!group->Error)
+      group->Error = std::current_exception();
+  }
+  task.Function = std::function<void()>();
+
+  std::lock_guard<std::mutex> lock(group->Mutex);
+  if (--group->Pending == 0)
+    group->Done.notify_all();
+}
+
+bool ThreadPool::pop(unsigned int id, Task &task) {
+  auto &q = *Queues.at(id);
+  std::lock_guard<std::mutex> lock(q.Mutex);
+  if (q.Tasks.empty())
+    return false;
+  task = std::move(q.Tasks.back());
+  q.Tasks.pop_back();
+  --NumQueued;
+  return true;
+}
+
+bool ThreadPool::steal(unsigned int id, Task &task) {
+  for (unsigned int i = 1; i < Queues.size(); ++i) {
+    auto &q = *Queues.at((id + i) % Queues.size());
+    std::lock_guard<std::mutex> lock(q.Mutex);
+    if (q.Tasks.empty())
+      continue;
+    task = std::move(q.Tasks.front());
+    q.Tasks.erase(q.Tasks.begin());
+    --NumQueued;
+    return true;
+  }
+  return false;
+}
+
+bool ThreadPool::popGroup(unsigned int id, TaskGroup *group, Task &task) {
+  auto &q = *Queues.at(id);
+  std::lock_guard<std::mutex> lock(q.Mutex);
+  for (auto it = q.Tasks.rbegin(); it != q.Tasks.rend(); ++it) {
+    if (it->Group != group)
+      continue;
+    task = std::move(*it);
+    q.Tasks.erase(std::next(it).base());
+    --NumQueued;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,229 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// ThreadPool class
+///
+
+#ifndef _THREADPOOL_HPP_
+#define _THREADPOOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ComPWA {
+
+///
+/// \class ThreadPool
+/// Work-stealing thread pool. Each worker owns a task queue. Tasks are
+/// submitted to the queue of the calling thread (threads that do not belong to
+/// the pool share a common queue). A worker takes tasks from the back of its
+/// own queue and steals from the front of other queues if its own queue is
+/// empty.
+///
+/// Tasks are organized in TaskGroup's. A thread that waits for a group
+/// executes the pending tasks of this group itself. It does not pick up
+/// unrelated work while waiting. Therefore, nested use of the pool (a task
+/// that submits tasks and waits for them) can not deadlock as long as the
+/// dependencies between tasks form a directed acyclic graph.
+///
+/// The pool is a singleton. The number of threads can be changed via
+/// setNumThreads(). A pool with a single thread executes all tasks in the
+/// thread that waits for them.
+///
+/// Data-parallel loops are provided by parallelFor(). The index range is split
+/// into chunks of a fixed size (grain size). The chunk boundaries do not
+/// depend on the number of threads. The chunks are stored in the queues as a
+/// function pointer with a context. Once the queues have reached their
+/// maximal size a parallelFor() does not allocate memory.
+///
+class ThreadPool {
+public:
+  ///
+  /// \class TaskGroup
+  /// Set of tasks that can be waited for. A group has to be used only by the
+  /// thread that created it.
+  ///
+  class TaskGroup {
+  public:
+    TaskGroup() : Pending(0) {}
+
+  private:
+    friend class ThreadPool;
+
+    std::atomic<int> Pending;
+
+    std::mutex Mutex;
+
+    std::condition_variable Done;
+
+    /// First exception that was thrown by one of the tasks
+    std::exception_ptr Error;
+  };
+
+  ///
+  /// \class ScopedSettings
+  /// Stores the number of threads and the grain size of the pool and
+  /// restores them when it goes out of scope.
+  ///
+  class ScopedSettings {
+  public:
+    ScopedSettings()
+        : NumThreads(instance().numThreads()),
+          GrainSize(instance().grainSize()) {}
+
+    ~ScopedSettings() {
+      instance().setNumThreads(NumThreads);
+      instance().setGrainSize(GrainSize);
+    }
+
+  private:
+    ScopedSettings(const ScopedSettings &);
+    ScopedSettings &operator=(const ScopedSettings &);
+
+    unsigned int NumThreads;
+    std::size_t GrainSize;
+  };
+
+  /// Obtain the pool instance. The pool is created on first use with one
+  /// thread per hardware core.
+  static ThreadPool &instance();
+
+  virtual ~ThreadPool();
+
+  /// Set total number of threads that execute tasks. The calling thread
+  /// is included in this number since it participates via wait(). Must not be
+  /// called while tasks are executed.
+  virtual void setNumThreads(unsigned int n);
+
+  virtual unsigned int numThreads() const { return Workers.size() + 1; }
+
+  /// Add \p task to \p group. The task is scheduled for execution immediately.
+  virtual void submit(TaskGroup &group, std::function<void()> task);
+
+  /// Wait until all tasks of \p group are finished. If a task has thrown an
+  /// exception it is rethrown here.
+  virtual void wait(TaskGroup &group);
+
+  /// Default number of elements per chunk in parallelFor()
+  virtual void setGrainSize(std::size_t grain) {
+    GrainSize = std::max<std::size_t>(grain, 1);
+  }
+
+  virtual std::size_t grainSize() const { return GrainSize; }
+
+  /// Call \p function(begin, end) for consecutive chunks of the range
+  /// [0, \p n). The chunks are executed in parallel. A chunk contains \p grain
+  /// elements. If \p grain is zero the default grain size is used. Ranges
+  /// that consist of a single chunk are executed in the calling thread.
+  template <class Function>
+  void parallelFor(std::size_t n, Function function, std::size_t grain = 0) {
+    if (!grain)
+      grain = GrainSize;
+    if (n <= grain) {
+      function(std::size_t(0), n);
+      return;
+    }
+    // No worker threads: run the chunks directly without creating tasks
+    if (Workers.empty()) {
+      for (std::size_t begin = 0; begin < n; begin += grain)
+        function(begin, std::min(n, begin + grain));
+      return;
+    }
+    TaskGroup group;
+    for (std::size_t begin = 0; begin < n; begin += grain)
+      submitTask(group, Task(&callChunk<Function>, &function, begin,
+                             std::min(n, begin + grain)));
+    wait(group);
+  }
+
+protected:
+  ThreadPool();
+
+  struct Task {
+    Task() : Chunk(nullptr), Context(nullptr), Begin(0), End(0), Group(nullptr) {}
+
+    Task(void (*chunk)(void *, std::size_t, std::size_t), void *context,
+         std::size_t begin, std::size_t end)
+        : Chunk(chunk), Context(context), Begin(begin), End(end), Group(nullptr) {}
+
+    /// General task, used if Chunk is not set
+    std::function<void()> Function;
+
+    /// Chunk [Begin, End) of a parallelFor(): Chunk(Context, Begin, End)
+    void (*Chunk)(void *, std::size_t, std::size_t);
+    void *Context;
+    std::size_t Begin;
+    std::size_t End;
+
+    TaskGroup *Group;
+  };
+
+  /// Call the function of a parallelFor() for the chunk [\p begin, \p end)
+  template <class Function>
+  static void callChunk(void *function, std::size_t begin, std::size_t end) {
+    (*static_cast<Function *>(function))(begin, end);
+  }
+
+  /// Add \p task to \p group
+  void submitTask(TaskGroup &group, Task task);
+
+  struct Queue {
+    /// A vector keeps its capacity if tasks are removed. Queues are short,
+    /// therefore removal from the front is cheap.
+    std::vector<Task> Tasks;
+    std::mutex Mutex;
+  };
+
+  /// Main loop of worker thread \p id
+  void work(unsigned int id);
+
+  /// Execute \p task and update its group
+  void run(Task &task);
+
+  /// Take a task from the back of queue \p id
+  bool pop(unsigned int id, Task &task);
+
+  /// Take a task from the front of any queue except \p id
+  bool steal(unsigned int id, Task &task);
+
+  /// Take the most recently submitted task of \p group from queue \p id
+  bool popGroup(unsigned int id, TaskGroup *group, Task &task);
+
+  void start(unsigned int numWorkers);
+
+  void stop();
+
+  /// Queue 0 is shared by all threads that do not belong to the pool. Worker
+  /// i uses queue i+1.
+  std::vector<std::unique_ptr<Queue>> Queues;
+
+  std::vector<std::thread> Workers;
+
+  std::atomic<bool> Stop;
+
+  /// Number of tasks waiting in all queues
+  std::atomic<int> NumQueued;
+
+  std::mutex SleepMutex;
+
+  std::condition_variable WakeUp;
+
+  std::size_t GrainSize;
+
+  /// Queue index of the current thread
+  static thread_local unsigned int CurrentQueue;
+};
+
+} // namespace ComPWA
+
+#endif
@@ -8,15 +8,97 @@
 
 #include "Core/TreeNode.hpp"
 #include "Core/Functions.hpp"
+#include "Core/ThreadPool.hpp"
 
 using namespace ComPWA;
 
+std::shared_ptr<Parameter> OutputArena::take(ParType type, std::size_t size) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  auto &outputs = Pool[std::make_pair(type, size)];
+  outputs.MaxInUse = std::max(outputs.MaxInUse, ++outputs.InUse);
+  if (outputs.Free.empty())
+    return std::shared_ptr<Parameter>();
+  auto out = outputs.Free.back();
+  outputs.Free.pop_back();
+  return out;
+}
+
+void OutputArena::add(std::shared_ptr<Parameter> output) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  auto &outputs = Pool[std::make_pair(output->type(), size(output))];
+  outputs.MaxInUse = std::max(outputs.MaxInUse, ++outputs.InUse);
+}
+
+void OutputArena::give(std::shared_ptr<Parameter> output) {
+  if (!output)
+    return;
+  std::lock_guard<std::mutex> lock(Mutex);
+  auto &outputs = Pool[std::make_pair(output->type(), size(output))];
+  if (outputs.InUse)
+    --outputs.InUse;
+  // Outputs that are not needed at the same time as the others are released
+  if (!output->isParameter() &&
+      outputs.Free.size() + outputs.InUse < outputs.MaxInUse)
+    outputs.Free.push_back(output);
+}
+
+void OutputArena::reserve(ParType type, std::size_t size, std::size_t count) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  auto &outputs = Pool[std::make_pair(type, size)];
+  outputs.MaxInUse = std::max(count, outputs.InUse);
+  while (outputs.Free.size() + outputs.InUse > outputs.MaxInUse)
+    outputs.Free.pop_back();
+  while (outputs.Free.size() + outputs.InUse < outputs.MaxInUse) {
+    switch (type) {
+    case ParType::MCOMPLEX:
+      outputs.Free.push_back(MComplex("", size));
+      break;
+    case ParType::MDOUBLE:
+      outputs.Free.push_back(MDouble("", size));
+      break;
+    case ParType::MINTEGER:
+      outputs.Free.push_back(MInteger("", size));
+      break;
+    default:
+      throw BadParameter("OutputArena::reserve() | Type " +
+                         std::string(ParNames[type]) +
+                         " is not a multi value type!");
+    }
+  }
+}
+
+void OutputArena::clear() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  for (auto &p : Pool) {
+    p.second.Free.clear();
+    p.second.MaxInUse = p.second.InUse;
+  }
+}
+
+std::size_t OutputArena::size(std::shared_ptr<Parameter> par) {
+  switch (par->type()) {
+  case ParType::MCOMPLEX:
+    return std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(
+               par)->values().size();
+  case ParType::MDOUBLE:
+    return std::static_pointer_cast<Value<std::vector<double>>>(par)
+        ->values().size();
+  case ParType::MINTEGER:
+    return std::static_pointer_cast<Value<std::vector<int>>>(par)
+        ->values().size();
+  default:
+    return 1;
+  }
+}
+
 TreeNode::TreeNode(std::string name,
                    std::shared_ptr<ComPWA::Parameter> parameter,
                    std::shared_ptr<Strategy> strategy,
                    std::shared_ptr<TreeNode> parent)
     : Name(name), Parameter(parameter), HasChanged(true), UseCache(true),
-      Strat(strategy) {
+      Parallel(false), Strat(strategy),
+      Arena(std::make_shared<ComPWA::OutputArena>()),
+      OutputType(ParType::UNDEFINED), OutputSize(0) {
   if (!parameter)
     UseCache = false;
   if (!parameter && !strategy)
@@ -31,7 +113,9 @@ TreeNode::TreeNode(std::string name,
 TreeNode::TreeNode(std::string name, std::shared_ptr<Strategy> strategy,
                    std::shared_ptr<TreeNode> parent)
     : Name(name), Parameter(std::shared_ptr<ComPWA::Parameter>()),
-      HasChanged(true), UseCache(false), Strat(strategy) {
+      HasChanged(true), UseCache(false), Parallel(false), Strat(strategy),
+      Arena(std::make_shared<ComPWA::OutputArena>()),
+      OutputType(ParType::UNDEFINED), OutputSize(0) {
 
   if (!strategy)
     throw std::runtime_error(
@@ -44,7 +128,22 @@ TreeNode::TreeNode(std::string name, std::shared_ptr<Strategy> strategy,
 
 TreeNode::~TreeNode() {}
 
+void TreeNode::useCache(bool c) {
+  UseCache = c;
+  if (!UseCache && Strat)
+    Parameter.reset();
+  HasChanged = true;
+}
+
 void TreeNode::update() {
+  // Leaf of a compiled FunctionTree: mark the dependent instructions. The
+  // parent nodes are flagged as well, so that they are up to date if they
+  // are evaluated directly (e.g. via FunctionTree::head()).
+  if (PlanDirty) {
+    auto &dirty = *PlanDirty;
+    for (auto i : PlanDependents)
+      dirty[i] = 1;
+  }
   for (unsigned int i = 0; i < Parents.size(); i++)
     Parents.at(i)->update();
   HasChanged = true;
@@ -63,6 +162,14 @@ std::shared_ptr<ComPWA::Parameter> TreeNode::parameter() {
   if (Parameter && (!HasChanged || !ChildNodes.size()))
     return Parameter;
 
+  std::unique_lock<std::mutex> lock(Mutex, std::defer_lock);
+  if (Parallel) {
+    lock.lock();
+    // Node was calculated by a different thread in the meantime
+    if (UseCache && !HasChanged)
+      return Parameter;
+  }
+
   auto result = recalculate();
   
   if(UseCache){
@@ -79,28 +186,111 @@ std::shared_ptr<ComPWA::Parameter> TreeNode::recalculate() const {
     return Parameter;
 
   std::shared_ptr<ComPWA::Parameter> result;
-  if (Parameter)
+  bool taken = false;
+  if (UseCache) {
     result = Parameter;
-
-  ParameterList newVals;
-  for (auto ch : ChildNodes) {
-    auto p = ch->parameter();
-    if (p->isParameter())
-      newVals.addParameter(p);
-    else
-      newVals.addValue(p);
+  } else if (OutputSize) {
+    result = Arena->take(OutputType, OutputSize);
+    taken = true;
   }
+
+  // In parallel mode all child nodes that need to be recalculated are
+  // scheduled on the ThreadPool. The last one is calculated in the current
+  // thread.
+  auto &childPars = ChildParameters;
+  childPars.resize(ChildNodes.size());
   try {
-    Strat->execute(newVals, result);
-  } catch (std::exception &ex) {
-    LOG(INFO) << "TreeNode::Recalculate() | Strategy " << Strat
-               << " failed on node " << name() << ": " << ex.what();
+    if (Parallel) {
+      std::vector<size_t> dirty;
+      for (size_t i = 0; i < ChildNodes.size(); ++i) {
+        auto &ch = ChildNodes[i];
+        if (ch->ChildNodes.size() && (ch->HasChanged || !ch->UseCache))
+          dirty.push_back(i);
+      }
+      if (dirty.size() > 1) {
+        auto &pool = ThreadPool::instance();
+        ThreadPool::TaskGroup group;
+        for (size_t i = 0; i < dirty.size() - 1; ++i) {
+          auto ch = ChildNodes.at(dirty.at(i));
+          auto &p = childPars.at(dirty.at(i));
+          pool.submit(group, [ch, &p]() { p = ch->parameter(); });
+        }
+        try {
+          childPars.at(dirty.back()) =
+              ChildNodes.at(dirty.back())->parameter();
+        } catch (...) {
+          // Do not leave the scheduled tasks behind
+          pool.wait(group);
+          throw;
+        }
+        pool.wait(group);
+      }
+    }
+
+    // Rebuild the input list only if one of the child parameters has been
+    // replaced (e.g. by a strategy that creates a new output parameter).
+    bool rebuild = (InputParameters.size() != ChildNodes.size());
+    for (size_t i = 0; i < ChildNodes.size(); ++i) {
+      if (!childPars[i])
+        childPars[i] = ChildNodes[i]->parameter();
+      if (!rebuild && childPars[i] != InputParameters[i])
+        rebuild = true;
+    }
+    if (rebuild) {
+      Inputs = ParameterList();
+      for (auto &p : childPars) {
+        if (p->isParameter())
+          Inputs.addParameter(p);
+        else
+          Inputs.addValue(p);
+      }
+      InputParameters = childPars;
+    }
+
+    try {
+      Strat->execute(Inputs, result);
+    } catch (std::exception &ex) {
+      LOG(INFO) << "TreeNode::Recalculate() | Strategy " << Strat
+                << " failed on node " << name() << ": " << ex.what();
+      throw;
+    }
+  } catch (...) {
+    // Otherwise the arenas count the outputs as in use
+    for (size_t i = 0; i < ChildNodes.size(); ++i) {
+      auto &ch = ChildNodes[i];
+      if (!ch->UseCache && ch->ChildNodes.size())
+        ch->Arena->give(childPars[i]);
+      childPars[i].reset();
+    }
+    if (taken)
+      Arena->give(result);
     throw;
   }
+  for (auto &p : childPars)
+    p.reset();
+
+  // The outputs of child nodes without cache are not needed anymore
+  for (size_t i = 0; i < ChildNodes.size(); ++i) {
+    auto &ch = ChildNodes[i];
+    if (!ch->UseCache && ch->ChildNodes.size())
+      ch->Arena->give(InputParameters[i]);
+  }
+  if (!UseCache) {
+    if (!taken)
+      Arena->add(result);
+    OutputType = result->type();
+    OutputSize = OutputArena::size(result);
+  }
 
   return result;
 }
 
+void TreeNode::setParallel(bool p) {
+  Parallel = p;
+  for (auto ch : ChildNodes)
+    ch->setParallel(p);
+}
+
 void TreeNode::fillParameters(ComPWA::ParameterList &list) {
   for (auto ch : ChildNodes) {
     ch->fillParameters(list);
@@ -127,7 +317,10 @@ std::string TreeNode::print(int level, std::string prefix) const {
   std::stringstream oss;
   oss << prefix << Name;
 
+  // recalculate() modifies the input lists of the node
+  std::unique_lock<std::mutex> lock(Mutex);
   auto p = recalculate();
+  lock.unlock();
   if (!ChildNodes.size()) { // Print leaf nodes
     if ( p->name() != "" )
       oss << " [" << p->name() << "]";
@@ -142,6 +335,8 @@ std::string TreeNode::print(int level, std::string prefix) const {
     else
       oss << " = " << p->val_to_str() << std::endl;
   }
+  if (!UseCache && ChildNodes.size())
+    Arena->give(p);
 
   // Abort recursion
   if (level == 0)
@@ -176,6 +371,8 @@ void TreeNode::linkParents() {
 void TreeNode::deleteLinks() {
   ChildNodes.clear();
   Parents.clear();
+  Inputs = ParameterList();
+  InputParameters.clear();
   if (Parameter)
     this->parameter()->Detach(shared_from_this());
 }
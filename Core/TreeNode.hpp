@@ -13,6 +13,10 @@
 #include <string>
 #include <complex>
 #include <memory>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
 
 #include "Core/Functions.hpp"
 #include "Core/ParameterList.hpp"
@@ -24,6 +28,57 @@ namespace ComPWA {
 // Forward decalaration since we want both classes to be friends
 class FunctionTree;
 
+///
+/// \class OutputArena
+/// Storage for the outputs of tree nodes without cache. A node takes an output
+/// from the arena before it executes its strategy and its parent gives it back
+/// once the parent has been calculated. Outputs of the same type and size are
+/// shared between nodes. The arena keeps only as many outputs as have been in
+/// use at the same time. Therefore, only the outputs that are needed at the
+/// same time occupy memory. A FunctionTree uses one arena for all its nodes.
+///
+class OutputArena {
+public:
+  /// Take an output of type \p type with \p size elements. An empty pointer
+  /// is returned if no such output is available. In this case the caller
+  /// creates the output.
+  std::shared_ptr<ComPWA::Parameter> take(ComPWA::ParType type,
+                                          std::size_t size);
+
+  /// Count \p output as in use. For outputs that were created without take().
+  void add(std::shared_ptr<ComPWA::Parameter> output);
+
+  /// Give \p output back to the arena. FitParameters are not stored.
+  void give(std::shared_ptr<ComPWA::Parameter> output);
+
+  /// Keep \p count multi value outputs of type \p type with \p size
+  /// elements. Missing outputs are created now and outputs beyond \p count
+  /// that are not in use are released.
+  void reserve(ComPWA::ParType type, std::size_t size, std::size_t count);
+
+  /// Release all outputs that are not in use
+  void clear();
+
+  /// Number of elements of \p par (one for single values)
+  static std::size_t size(std::shared_ptr<ComPWA::Parameter> par);
+
+protected:
+  struct Outputs {
+    Outputs() : InUse(0), MaxInUse(0) {}
+
+    std::vector<std::shared_ptr<ComPWA::Parameter>> Free;
+
+    std::size_t InUse;
+
+    std::size_t MaxInUse;
+  };
+
+  /// Outputs for each type and size
+  std::map<std::pair<ComPWA::ParType, std::size_t>, Outputs> Pool;
+
+  std::mutex Mutex;
+};
+
 ///
 /// \class TreeNode is the interface for elements of the FunctionTree
 /// This class acts as a container for a parameter in a function tree. It has a
@@ -45,7 +100,8 @@ public:
   /// Constructor for tree using a \p name, a \p strategy and
   /// an identifier for the parent node. Since no parameter is passed the
   /// values of this node are not cached and are recalculated every time
-  /// parameter() is called.
+  /// parameter() is called. The storage for the result is taken from the
+  /// OutputArena of the node.
   TreeNode(std::string name, std::shared_ptr<ComPWA::Strategy> strategy,
            std::shared_ptr<ComPWA::TreeNode> parent);
 
@@ -57,8 +113,15 @@ public:
 
   /// Shall we store the node value or recalculate it every time parameter() is
   /// called?. The default is to use the cache but is could be beneficial to
-  /// switch it of in case that memory is short.
-  virtual void useCache(bool c) { UseCache = c; }
+  /// switch it of in case that memory is short. A node without cache releases
+  /// its parameter and takes its output from the OutputArena on each call.
+  virtual void useCache(bool c);
+
+  /// Evaluate child nodes which need to be recalculated in parallel using the
+  /// ThreadPool. The setting is applied to all downstream nodes.
+  virtual void setParallel(bool p);
+
+  virtual bool parallel() const { return Parallel; }
 
   /// Obtain parameter of node. In case child nodes have changed, child nodes
   /// are recalculated and Parameter is updated
@@ -116,15 +179,50 @@ protected:
   std::shared_ptr<ComPWA::Parameter> Parameter;
 
   /// Node has changed and needs to call recalculate()
-  bool HasChanged;
+  std::atomic<bool> HasChanged;
 
   /// Node has changed and needs to call recalculate()
   bool UseCache;
 
+  /// Recalculate child nodes in parallel
+  bool Parallel;
+
+  /// In parallel mode the node can be reached from different threads if
+  /// it has more than one parent. The mutex ensures that it is calculated
+  /// only once and that only one thread at a time uses the input lists of
+  /// recalculate().
+  mutable std::mutex Mutex;
+
+  /// Dirty flags of the execution plan of a compiled FunctionTree. Only set
+  /// for leafs of a compiled tree.
+  std::shared_ptr<std::vector<char>> PlanDirty;
+
+  /// Instructions of the execution plan that depend on this leaf
+  std::vector<std::size_t> PlanDependents;
+
   /// Node strategy. Strategy defines how the node value calculated given its
   /// child nodes and child leafs.
   std::shared_ptr<ComPWA::Strategy> Strat;
 
+  /// Input list for Strat. The list is kept and only rebuilt if a child
+  /// node provides a different parameter object than in the previous call.
+  mutable ComPWA::ParameterList Inputs;
+
+  /// Child parameters that were used to build Inputs
+  mutable std::vector<std::shared_ptr<ComPWA::Parameter>> InputParameters;
+
+  /// Child parameters of the current call
+  mutable std::vector<std::shared_ptr<ComPWA::Parameter>> ChildParameters;
+
+  /// Storage of outputs if the node is not cached. Each call takes its own
+  /// output, so that the output of a previous call is not overwritten while a
+  /// parent still uses it. In parallel mode the calls are serialized by Mutex.
+  std::shared_ptr<ComPWA::OutputArena> Arena;
+
+  /// Type and size of the output of the previous call of a node without cache
+  mutable ComPWA::ParType OutputType;
+  mutable std::size_t OutputSize;
+
   /// Add this node to parents children-list
   virtual void linkParents();
 
@@ -136,8 +234,8 @@ protected:
 
   /// Fill list with names of children nodes
   virtual void fillChildNames(std::vector<std::string> &names) const;
-  
-    /// Obtain parameter of node. In case child nodes have changed, child nodes
+
+  /// Obtain parameter of node. In case child nodes have changed, child nodes
   /// are recalculated and Parameter is updated
   virtual std::shared_ptr<ComPWA::Parameter> recalculate() const;
 };
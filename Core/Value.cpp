@@ -2,10 +2,17 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <atomic>
+
 #include "Core/Value.hpp"
 
 using namespace ComPWA;
 
+std::uint64_t ComPWA::newGeneration() {
+  static std::atomic<std::uint64_t> counter(0);
+  return ++counter;
+}
+
 template class ComPWA::Value<std::complex<double>>;
 template class ComPWA::Value<double>;
 template class ComPWA::Value<int>;
@@ -10,6 +10,7 @@
 #ifndef ParameterT_hpp
 #define ParameterT_hpp
 
+#include <cstdint>
 #include <iterator>
 #include "Core/FitParameter.hpp"
 namespace ComPWA {
@@ -30,23 +31,47 @@ template<class T>
     return stream;
 }
 
+/// Next value of the process-wide generation counter, see Value::generation()
+std::uint64_t newGeneration();
+
 template <class T> class Value : public ComPWA::Parameter {
 public:
-  Value(std::string name = "") : Parameter(name) { Type = typeName<T>(); }
+  Value(std::string name = "") : Parameter(name), Generation(newGeneration()) {
+    Type = typeName<T>();
+  }
 
-  Value(T val) : Parameter(""), Val(val) { Type = typeName<T>(); }
+  Value(T val) : Parameter(""), Val(val), Generation(newGeneration()) {
+    Type = typeName<T>();
+  }
 
-  Value(std::string name, T val) : Parameter(name), Val(val) {
+  Value(std::string name, T val)
+      : Parameter(name), Val(val), Generation(newGeneration()) {
     Type = typeName<T>();
   }
 
   virtual T value() const { return Val; }
 
   /// Reference on the value. In case of T = std::vector<T2> a reference to the
-  /// vector is returned.
+  /// vector is returned. Changes via the reference have to be announced by
+  /// modified().
   virtual T &values() { return Val; }
 
-  virtual void setValue(T inVal) { Val = inVal; };
+  virtual void setValue(T inVal) {
+    Val = inVal;
+    Generation = newGeneration();
+  };
+
+  /// Identity of the value. A number which is unique within the process is
+  /// assigned on construction, by setValue() and by modified(). Strategies
+  /// that keep quantities derived from a value compare its generation.
+  std::uint64_t generation() const { return Generation; }
+
+  /// Announce that the value was changed in place via values(). Assigns a
+  /// new generation and notifies the observing tree nodes.
+  void modified() {
+    Generation = newGeneration();
+    Notify();
+  }
 
   /// Conversion operator for internal type
   operator T() const { return Val; };
@@ -72,6 +97,9 @@ protected:
   }
 
   T Val;
+
+  /// See generation()
+  std::uint64_t Generation;
 };
 
 inline std::shared_ptr<Parameter> ValueFactory(ParType t,
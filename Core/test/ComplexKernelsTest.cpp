@@ -0,0 +1,121 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the vectorized complex kernels. All instruction sets that are
+/// supported by the CPU are compared to a reference calculation.
+///
+
+#define BOOST_TEST_MODULE Core
+
+#include <complex>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/ComplexKernels.hpp"
+#include "Core/Logging.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Kernels;
+
+BOOST_AUTO_TEST_SUITE(ComplexKernelsTest);
+
+std::vector<std::complex<double>> sample(size_t n, double phase) {
+  std::vector<std::complex<double>> v;
+  for (size_t i = 0; i < n; ++i)
+    v.push_back(std::polar(0.5 + 0.01 * i, phase + 0.3 * i));
+  return v;
+}
+
+void checkClose(std::complex<double> a, std::complex<double> b) {
+  BOOST_CHECK_SMALL(std::abs(a - b), 1e-12 * (1. + std::abs(b)));
+}
+
+BOOST_AUTO_TEST_CASE(CompareToReference) {
+  ComPWA::Logging log("", "info");
+  SimdLevel supported = supportedSimdLevel();
+  LOG(INFO) << "Supported SIMD level: " << static_cast<int>(supported);
+
+  std::complex<double> c(0.7, -1.3);
+  for (int l = 0; l <= static_cast<int>(supported); ++l) {
+    BOOST_CHECK(setSimdLevel(static_cast<SimdLevel>(l)) ==
+                static_cast<SimdLevel>(l));
+    // All sizes up to a few vector lengths to cover the remainder loops
+    for (size_t n = 0; n < 37; ++n) {
+      auto a = sample(n, 0.1);
+      auto b = sample(n, 1.2);
+      std::vector<double> d(n);
+      for (size_t i = 0; i < n; ++i)
+        d[i] = 1. - 0.05 * i;
+
+      std::vector<std::complex<double>> out(n);
+      multiply(c, a.data(), out.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        checkClose(out[i], c * a[i]);
+
+      // In place
+      out = a;
+      multiply(out.data(), b.data(), out.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        checkClose(out[i], a[i] * b[i]);
+
+      multiply(a.data(), d.data(), out.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        checkClose(out[i], a[i] * d[i]);
+
+      out = b;
+      add(a.data(), out.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        checkClose(out[i], a[i] + b[i]);
+
+      out = b;
+      multiplyAccumulate(c, a.data(), out.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        checkClose(out[i], b[i] + c * a[i]);
+
+      std::vector<double> norm(n);
+      absSquare(a.data(), norm.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        checkClose(norm[i], std::norm(a[i]));
+
+      // Split layout
+      SplitComplex sa(a), sb(b);
+      BOOST_CHECK_EQUAL(sa.size(), n);
+      multiplyAccumulate(c, sa.Re.data(), sa.Im.data(), sb.Re.data(),
+                         sb.Im.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        checkClose(sb[i], b[i] + c * a[i]);
+
+      absSquare(sa.Re.data(), sa.Im.data(), norm.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        checkClose(norm[i], std::norm(a[i]));
+
+      std::complex<double> sum(0., 0.);
+      for (size_t i = 0; i < n; ++i)
+        sum += b[i] * std::conj(a[i]);
+      SplitComplex sb2(b);
+      checkClose(sumConjugateProduct(sb2.Re.data(), sb2.Im.data(),
+                                     sa.Re.data(), sa.Im.data(), n),
+                 sum);
+
+      // Negative weights are allowed
+      sum = std::complex<double>(0., 0.);
+      for (size_t i = 0; i < n; ++i)
+        sum += (d[i] - 1.) * b[i] * std::conj(a[i]);
+      for (auto &x : d)
+        x -= 1.;
+      checkClose(sumConjugateProduct(sb2.Re.data(), sb2.Im.data(),
+                                     sa.Re.data(), sa.Im.data(), d.data(), n),
+                 sum);
+
+      sb2.toInterleaved(out);
+      BOOST_CHECK(out == b);
+    }
+  }
+  setSimdLevel(supported);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
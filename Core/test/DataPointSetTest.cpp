@@ -0,0 +1,190 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the flat DataPointSet and of DataPoint views.
+///
+
+#define BOOST_TEST_MODULE Core
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/DataPoint.hpp"
+#include "Core/DataPointSet.hpp"
+#include "Core/Exceptions.hpp"
+#include "Core/FunctionTree.hpp"
+#include "Core/Functions.hpp"
+#include "Core/Logging.hpp"
+
+using namespace ComPWA;
+
+BOOST_AUTO_TEST_SUITE(DataPointSetTest);
+
+BOOST_AUTO_TEST_CASE(ColumnsAndViews) {
+  ComPWA::Logging log("", "error");
+  std::vector<std::vector<double>> columns = {{1., 2., 3., 4.},
+                                              {10., 20., 30., 40.}};
+  std::vector<char> mask = {1, 0, 1, 1};
+  std::vector<double> weights = {2., 3., 4., 5.};
+  DataPointSet set(std::move(columns), mask, weights.data());
+  BOOST_REQUIRE_EQUAL(set.size(), 3);
+  BOOST_CHECK_EQUAL(set.weight(2), 5.);
+  BOOST_CHECK_EQUAL(set.numVariables(), 2);
+  BOOST_CHECK_EQUAL(set.value(1, 0), 3.);
+  BOOST_CHECK_EQUAL(set.value(2, 1), 40.);
+
+  // Views refer to the columns of the set
+  set.setWeight(1, 0.5);
+  DataPoint point = set[1];
+  BOOST_CHECK(point.isView());
+  set.setValue(1, 0, 3.5);
+  BOOST_CHECK_EQUAL(point.value(0), 3.5);
+  BOOST_CHECK_EQUAL(point.size(), 2);
+  BOOST_CHECK_EQUAL(point.value(1), 30.);
+  BOOST_CHECK_EQUAL(point.weight(), 0.5);
+  BOOST_CHECK_EQUAL(point.efficiency(), 1.);
+  BOOST_CHECK_THROW(point.value(2), std::out_of_range);
+  BOOST_CHECK_THROW(set.at(3), std::out_of_range);
+
+  // Modification of a view copies the values
+  point.values()[1] = 7.;
+  BOOST_CHECK(!point.isView());
+  BOOST_CHECK_EQUAL(point.value(1), 7.);
+  BOOST_CHECK_EQUAL(set.value(1, 1), 30.);
+
+  double sum = 0;
+  for (const auto &p : set)
+    sum += p.value(0) * p.weight();
+  BOOST_CHECK_EQUAL(sum, 2. + 0.5 * 3.5 + 4. * 5.);
+  BOOST_CHECK_EQUAL(set.end() - set.begin(), 3);
+
+  // The 'horizontal' list shares the columns
+  ParameterList list = set.dataList();
+  BOOST_REQUIRE_EQUAL(list.mDoubleValues().size(), 4);
+  BOOST_CHECK_EQUAL(list.mDoubleValue(1)->values().data(), set.column(1));
+  BOOST_CHECK_EQUAL(list.mDoubleValue(2)->name(), "Efficiency");
+  BOOST_CHECK_EQUAL(list.mDoubleValue(3)->values().data(), set.weights());
+
+  // Copies own their columns
+  DataPointSet copy(set);
+  copy.setValue(0, 0, 9.);
+  BOOST_CHECK_EQUAL(set.value(0, 0), 1.);
+  BOOST_CHECK_EQUAL(copy.value(2, 1), 40.);
+}
+
+BOOST_AUTO_TEST_CASE(AddPoints) {
+  ComPWA::Logging log("", "error");
+  DataPointSet set;
+  DataPoint point;
+  point.values() = {1., 2., 3.};
+  point.setEfficiency(0.25);
+  set.add(point);
+  set.add(set[0]);
+  BOOST_REQUIRE_EQUAL(set.size(), 2);
+  BOOST_CHECK_EQUAL(set.numVariables(), 3);
+  BOOST_CHECK_EQUAL(set.value(1, 2), 3.);
+  BOOST_CHECK_EQUAL(set.efficiency(1), 0.25);
+
+  DataPoint other;
+  other.values() = {1., 2.};
+  BOOST_CHECK_THROW(set.add(other), BadParameter);
+
+  set.resize(4);
+  BOOST_CHECK_EQUAL(set.value(3, 0), 0.);
+  BOOST_CHECK_EQUAL(set.weight(3), 1.);
+  BOOST_CHECK_EQUAL(
+      std::accumulate(set.weights(), set.weights() + set.size(), 0.), 4.);
+
+  // Views identify the contents of the set
+  auto generation = set.generation();
+  BOOST_CHECK_EQUAL(set[1].sample(), generation);
+  BOOST_CHECK_EQUAL(point.sample(), 0);
+  BOOST_CHECK(DataPointSet(set).generation() != generation);
+  set.setWeight(1, 2.);
+  BOOST_CHECK_EQUAL(set.generation(), generation);
+  set.setValue(1, 0, 5.);
+  BOOST_CHECK(set.generation() != generation);
+}
+
+BOOST_AUTO_TEST_CASE(SinglePrecision) {
+  ComPWA::Logging log("", "error");
+  std::vector<std::vector<double>> columns = {{0.1, 1. / 3., 2.5},
+                                              {1e-9, -0.7, 4.}};
+  std::vector<char> mask = {1, 1, 1};
+  DataPointSet set(std::move(columns), mask, nullptr, nullptr,
+                   DataPointSet::Precision::FLOAT);
+  BOOST_CHECK(set.precision() == DataPointSet::Precision::FLOAT);
+  BOOST_REQUIRE_EQUAL(set.size(), 3);
+  BOOST_CHECK_EQUAL(set.numVariables(), 2);
+  BOOST_CHECK_EQUAL(set.value(1, 0), (double)(float)(1. / 3.));
+  BOOST_CHECK_EQUAL(set.floatColumn(1)[0], 1e-9f);
+
+  DataPoint point = set[1];
+  BOOST_CHECK(point.isView());
+  BOOST_CHECK_EQUAL(point.value(1), (double)-0.7f);
+  point.values();
+  BOOST_CHECK(!point.isView());
+  BOOST_CHECK_EQUAL(point.value(0), (double)(float)(1. / 3.));
+
+  // The FunctionTree requires double columns
+  BOOST_CHECK_THROW(set.dataList(), BadParameter);
+  BOOST_CHECK_EQUAL(set.memory(), 2 * 3 * sizeof(float));
+
+  set.setValue(2, 1, 0.3);
+  BOOST_CHECK_EQUAL(set.value(2, 1), (double)0.3f);
+  set.add(point);
+  BOOST_REQUIRE_EQUAL(set.size(), 4);
+  BOOST_CHECK_EQUAL(set.value(3, 1), (double)-0.7f);
+  DataPointSet copy(set);
+  BOOST_CHECK_EQUAL(copy.value(3, 0), set.value(3, 0));
+  BOOST_CHECK_EQUAL(copy.memory(), 2 * 4 * sizeof(float));
+
+  // Conversion back to double keeps the rounded values
+  set.setPrecision(DataPointSet::Precision::DOUBLE);
+  BOOST_CHECK_EQUAL(set.column(0)[2], 2.5);
+  BOOST_CHECK_EQUAL(set.value(0, 0), (double)0.1f);
+  BOOST_CHECK_EQUAL(set.memory(), 2 * 4 * sizeof(double));
+  ParameterList list = set.dataList();
+  BOOST_CHECK_EQUAL(list.mDoubleValue(1)->values().at(3), (double)-0.7f);
+}
+
+BOOST_AUTO_TEST_CASE(TreeLeaves) {
+  ComPWA::Logging log("", "error");
+  std::vector<std::vector<double>> columns = {{1., 2., 3.}};
+  std::vector<char> mask = {1, 1, 1};
+  DataPointSet set(std::move(columns), mask);
+  ParameterList list = set.dataList();
+
+  // Sum of the variable and of the weights
+  FunctionTree tree("sum", std::make_shared<Value<double>>(),
+                    std::make_shared<AddAll>(ParType::DOUBLE));
+  tree.createLeaf("x", list.mDoubleValue(0), "sum");
+  tree.createLeaf("w", list.mDoubleValues().back(), "sum");
+  auto sum = std::dynamic_pointer_cast<Value<double>>(tree.parameter());
+  BOOST_CHECK_EQUAL(sum->value(), 6. + 3.);
+
+  // Modifications of the set are propagated to the tree
+  set.setValue(1, 0, 5.);
+  sum = std::dynamic_pointer_cast<Value<double>>(tree.parameter());
+  BOOST_CHECK_EQUAL(sum->value(), 9. + 3.);
+  set.setWeight(0, 2.);
+  sum = std::dynamic_pointer_cast<Value<double>>(tree.parameter());
+  BOOST_CHECK_EQUAL(sum->value(), 9. + 4.);
+
+  // Modifications via the columns are announced with modified()
+  set.column(0)[2] = 4.;
+  set.weights()[2] = 0.;
+  auto generation = set.generation();
+  set.modified();
+  BOOST_CHECK(set.generation() != generation);
+  sum = std::dynamic_pointer_cast<Value<double>>(tree.parameter());
+  BOOST_CHECK_EQUAL(sum->value(), 10. + 3.);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,100 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the columnar event storage.
+///
+
+#define BOOST_TEST_MODULE Core
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/Event.hpp"
+#include "Core/EventCollection.hpp"
+#include "Core/Exceptions.hpp"
+
+using namespace ComPWA;
+
+BOOST_AUTO_TEST_SUITE(EventCollectionTest);
+
+Event makeEvent(int i) {
+  Event ev;
+  ev.addParticle(Particle(0.1 * i, 0.2, 0.3, 1.0 + i, 211, 1));
+  ev.addParticle(Particle(-0.1 * i, -0.2, -0.3, 2.0 + i, -211, -1));
+  ev.addParticle(Particle(0., 0., 0.5 * i, 3.0, 111, 0));
+  ev.setWeight(0.5 + i);
+  ev.setEfficiency(0.25 * i);
+  ev.setCharge(i % 2);
+  return ev;
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip) {
+  EventCollection events;
+  for (int i = 0; i < 10; ++i)
+    events.add(makeEvent(i));
+
+  BOOST_CHECK_EQUAL(events.size(), 10);
+  BOOST_CHECK_EQUAL(events.numParticles(), 3);
+
+  for (int i = 0; i < 10; ++i) {
+    Event ref = makeEvent(i);
+    Event ev = events.event(i);
+    BOOST_CHECK_EQUAL(ev.weight(), ref.weight());
+    BOOST_CHECK_EQUAL(ev.efficiency(), ref.efficiency());
+    BOOST_CHECK_EQUAL(ev.charge(), ref.charge());
+    for (int j = 0; j < 3; ++j) {
+      BOOST_CHECK_EQUAL(ev.particle(j).fourMomentum(),
+                        ref.particle(j).fourMomentum());
+      BOOST_CHECK_EQUAL(ev.particle(j).pid(), ref.particle(j).pid());
+      BOOST_CHECK_EQUAL(ev.particle(j).charge(), ref.particle(j).charge());
+      BOOST_CHECK_EQUAL(events.fourMomentum(i, j),
+                        ref.particle(j).fourMomentum());
+    }
+  }
+
+  // Columns are contiguous
+  BOOST_CHECK_EQUAL(events.px(0)[3], 0.1 * 3);
+  BOOST_CHECK_EQUAL(events.e(1)[9], 11.);
+  BOOST_CHECK_EQUAL(events.pz(2)[4], 2.);
+
+  BOOST_CHECK_THROW(events.add(Event()), BadParameter);
+  BOOST_CHECK_THROW(events.event(10), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(SelectAndAppend) {
+  EventCollection events(3);
+  for (int i = 0; i < 6; ++i)
+    events.add(makeEvent(i));
+
+  EventCollection other;
+  other.append(events);
+  BOOST_CHECK_EQUAL(other.size(), 6);
+
+  std::vector<char> mask = {1, 0, 0, 1, 1, 0};
+  events.select(mask);
+  BOOST_CHECK_EQUAL(events.size(), 3);
+  BOOST_CHECK_EQUAL(events.weight(0), 0.5);
+  BOOST_CHECK_EQUAL(events.weight(1), 3.5);
+  BOOST_CHECK_EQUAL(events.weight(2), 4.5);
+  BOOST_CHECK_EQUAL(events.fourMomentum(2, 2),
+                    makeEvent(4).particle(2).fourMomentum());
+
+  other.append(events);
+  BOOST_CHECK_EQUAL(other.size(), 9);
+  BOOST_CHECK_EQUAL(other.charge(7), 1);
+
+  events.setEvent(1, makeEvent(8));
+  BOOST_CHECK_EQUAL(events.weight(1), 8.5);
+  BOOST_CHECK_EQUAL(events.px(0)[1], 0.1 * 8);
+
+  events.clear();
+  BOOST_CHECK(events.empty());
+  BOOST_CHECK_EQUAL(events.numParticles(), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,120 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the reproducible summation. The sums have to be bit-identical for
+/// different numbers of threads.
+///
+
+#define BOOST_TEST_MODULE Core
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/FunctionTree.hpp"
+#include "Core/Logging.hpp"
+#include "Core/Summation.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Core/Value.hpp"
+
+using namespace ComPWA;
+
+BOOST_AUTO_TEST_SUITE(SummationTest);
+
+const std::vector<Summation::Mode> Modes = {
+    Summation::Mode::NAIVE, Summation::Mode::KAHAN, Summation::Mode::PAIRWISE};
+
+const std::vector<unsigned int> NumThreads = {1, 2, 8, 32};
+
+/// Values of very different magnitude so that the result depends on the order
+/// of the summation
+std::vector<double> sample(size_t n) {
+  std::vector<double> v;
+  for (size_t i = 0; i < n; ++i)
+    v.push_back(std::pow(10., (i % 13) - 6.) * std::sin(0.1 * i));
+  return v;
+}
+
+BOOST_AUTO_TEST_CASE(ThreadIndependence) {
+  ComPWA::Logging log("", "info");
+  auto &pool = ThreadPool::instance();
+  unsigned int threads = pool.numThreads();
+
+  auto values = sample(100003);
+  std::vector<std::complex<double>> cValues;
+  for (size_t i = 0; i < values.size(); ++i)
+    cValues.push_back(std::complex<double>(values[i], 1e-3 * values[i] + i));
+
+  for (auto m : Modes) {
+    Summation::setMode(m);
+    BOOST_CHECK(Summation::mode() == m);
+    pool.setNumThreads(1);
+    double ref = Summation::sum(values);
+    std::complex<double> cRef = Summation::sum(cValues);
+    for (auto n : NumThreads) {
+      pool.setNumThreads(n);
+      BOOST_CHECK_EQUAL(Summation::sum(values), ref);
+      BOOST_CHECK(Summation::sum(cValues) == cRef);
+    }
+  }
+  Summation::setMode(Summation::Mode::KAHAN);
+  pool.setNumThreads(threads);
+}
+
+BOOST_AUTO_TEST_CASE(Accuracy) {
+  size_t n = 1000001;
+  std::vector<double> values(n, 0.1);
+  long double exact = (long double)values.front() * n;
+
+  Summation::setMode(Summation::Mode::KAHAN);
+  BOOST_CHECK_CLOSE(Summation::sum(values), (double)exact, 1e-13);
+  Summation::setMode(Summation::Mode::PAIRWISE);
+  BOOST_CHECK_CLOSE(Summation::sum(values), (double)exact, 1e-12);
+  Summation::setMode(Summation::Mode::NAIVE);
+  BOOST_CHECK_CLOSE(Summation::sum(values), (double)exact, 1e-8);
+  Summation::setMode(Summation::Mode::KAHAN);
+}
+
+BOOST_AUTO_TEST_CASE(FunctionTreeSum) {
+  auto &pool = ThreadPool::instance();
+  unsigned int threads = pool.numThreads();
+
+  auto values = sample(50001);
+  auto result = std::make_shared<Value<double>>();
+  auto myTree = std::make_shared<FunctionTree>(
+      "sum", result, std::make_shared<AddAll>(ParType::DOUBLE));
+  myTree->createLeaf("x", std::make_shared<Value<std::vector<double>>>(values),
+                     "sum");
+  auto par = std::make_shared<FitParameter>("par", 1.);
+  par->fixParameter(false);
+  myTree->createLeaf("par", par, "sum");
+
+  // Modify the parameter so that the sum is recalculated
+  auto evaluate = [&]() {
+    par->setValue(1.);
+    par->setValue(2.);
+    myTree->parameter();
+    return result->value();
+  };
+
+  for (auto m : Modes) {
+    Summation::setMode(m);
+    pool.setNumThreads(1);
+    double ref = evaluate();
+    BOOST_CHECK_CLOSE(ref, Summation::sum(values) + 2., 1e-10);
+    for (auto n : NumThreads) {
+      pool.setNumThreads(n);
+      BOOST_CHECK_EQUAL(evaluate(), ref);
+    }
+  }
+  Summation::setMode(Summation::Mode::KAHAN);
+  pool.setNumThreads(threads);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
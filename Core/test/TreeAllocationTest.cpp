@@ -0,0 +1,143 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Micro-benchmark for the evaluation of a FunctionTree. The global operator
+/// new is replaced to count heap allocations. Once the tree was evaluated, a
+/// further evaluation after a parameter change must not allocate memory. This
+/// holds for a serial pool as well as for the chunks of parallelFor() that
+/// are executed by several threads.
+///
+
+#define BOOST_TEST_MODULE Core
+
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/Functions.hpp"
+#include "Core/FunctionTree.hpp"
+#include "Core/FitParameter.hpp"
+#include "Core/Logging.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Core/Value.hpp"
+
+namespace {
+std::atomic<bool> CountAllocations(false);
+std::atomic<std::size_t> NumAllocations(0);
+}
+
+void *operator new(std::size_t size) {
+  if (CountAllocations)
+    ++NumAllocations;
+  void *p = std::malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using namespace ComPWA;
+
+BOOST_AUTO_TEST_SUITE(FunctionTreeTest);
+
+/// Build R = Sum[ |Sum_k c_k * f_k|^2 ] with nAmp amplitudes f_k of size
+/// nEvents. The node for the sum of amplitudes is not cached.
+std::shared_ptr<FunctionTree>
+buildTree(size_t nAmp, size_t nEvents,
+          std::vector<std::shared_ptr<FitParameter>> &coefficients) {
+  auto tree = std::make_shared<FunctionTree>(
+      "R", std::make_shared<Value<double>>(),
+      std::make_shared<AddAll>(ParType::DOUBLE));
+  tree->createNode("AbsSq", MDouble("", nEvents),
+                   std::make_shared<AbsSquare>(ParType::MDOUBLE), "R");
+  tree->createNode("Sum", std::make_shared<AddAll>(ParType::MCOMPLEX),
+                   "AbsSq");
+  for (size_t k = 0; k < nAmp; ++k) {
+    std::string n = std::to_string(k);
+    std::vector<std::complex<double>> f;
+    for (size_t i = 0; i < nEvents; ++i)
+      f.push_back(std::polar(1. + 1e-5 * i, 0.1 * k + 1e-4 * i));
+    coefficients.push_back(std::make_shared<FitParameter>("c_" + n, 1. + k));
+    coefficients.back()->fixParameter(false);
+    tree->createNode("Amp_" + n, MComplex("", nEvents),
+                     std::make_shared<MultAll>(ParType::MCOMPLEX), "Sum");
+    tree->createLeaf("c_" + n, coefficients.back(), "Amp_" + n);
+    tree->createLeaf(
+        "f_" + n,
+        std::make_shared<Value<std::vector<std::complex<double>>>>(f),
+        "Amp_" + n);
+  }
+  return tree;
+}
+
+/// Evaluate the tree \p nCalls times, each time after changing one of the
+/// coefficients. Returns the number of heap allocations.
+size_t evaluate(std::shared_ptr<FunctionTree> tree,
+                std::vector<std::shared_ptr<FitParameter>> &coefficients,
+                size_t nCalls) {
+  auto start = std::chrono::steady_clock::now();
+  NumAllocations = 0;
+  CountAllocations = true;
+  for (size_t i = 0; i < nCalls; ++i) {
+    auto &c = coefficients.at(i % coefficients.size());
+    c->setValue(c->value() + 0.1);
+    tree->parameter();
+  }
+  CountAllocations = false;
+  auto end = std::chrono::steady_clock::now();
+  LOG(INFO) << "Tree evaluation: "
+            << std::chrono::duration<double, std::micro>(end - start).count() /
+                   nCalls
+            << " us per call, " << NumAllocations << " allocations in "
+            << nCalls << " calls.";
+  return NumAllocations;
+}
+
+BOOST_AUTO_TEST_CASE(ZeroAllocations) {
+  ComPWA::Logging log("", "info");
+  ThreadPool::ScopedSettings restorePool;
+
+  // Make sure that allocations are counted
+  NumAllocations = 0;
+  CountAllocations = true;
+  auto tmp = std::make_shared<Value<double>>(1.);
+  CountAllocations = false;
+  BOOST_CHECK_EQUAL(NumAllocations, 1);
+
+  for (unsigned int nThreads : {1, 4}) {
+    ThreadPool::instance().setNumThreads(nThreads);
+    // Several chunks per node so that parallelFor() creates tasks
+    ThreadPool::instance().setGrainSize(4096);
+
+    std::vector<std::shared_ptr<FitParameter>> coefficients;
+    auto tree = buildTree(10, 50000, coefficients);
+
+    // Warm up: the first evaluation creates the input lists of all nodes and
+    // the output of the node without cache. The task queues of the pool grow
+    // to their final size.
+    tree->parameter();
+    evaluate(tree, coefficients, 10);
+    BOOST_CHECK_EQUAL(evaluate(tree, coefficients, 50), 0);
+
+    // Same for the execution plan of the compiled tree
+    tree->compile();
+    tree->parameter();
+    evaluate(tree, coefficients, 10);
+    BOOST_CHECK_EQUAL(evaluate(tree, coefficients, 50), 0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
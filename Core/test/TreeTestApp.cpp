@@ -27,6 +27,11 @@
 #include <algorithm>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <set>
+#include <numeric>
+#include <cmath>
+#include <complex>
 
 #include <boost/test/unit_test.hpp>
 
@@ -35,6 +40,7 @@
 #include "Core/FunctionTree.hpp"
 #include "Core/FitParameter.hpp"
 #include "Core/Value.hpp"
+#include "Core/ThreadPool.hpp"
 
 using namespace ComPWA;
 
@@ -151,4 +157,520 @@ BOOST_AUTO_TEST_CASE(MultiParameters) {
   LOG(INFO) << std::endl << myTreeMultD;
 }
 
+BOOST_AUTO_TEST_CASE(ParallelSubTrees) {
+  size_t nSubTrees = 20;
+  size_t nElements = 1000;
+
+  // Calculate R = Sum_i Sum[ a_i * x * s ] with s = b * c. The node s is
+  // shared by all subtrees.
+  std::vector<double> x;
+  for (unsigned int i = 0; i < nElements; i++)
+    x.push_back(0.001 * i);
+  auto parX = std::make_shared<Value<std::vector<double>>>("x", x);
+  auto parB = std::make_shared<FitParameter>("parB", 2.);
+  parB->fixParameter(false);
+  auto parC = std::make_shared<FitParameter>("parC", 3.);
+  parC->fixParameter(false);
+  std::vector<std::shared_ptr<FitParameter>> parA;
+
+  auto result = std::make_shared<Value<double>>();
+  auto myTree = std::make_shared<FunctionTree>(
+      "R", result, std::make_shared<AddAll>(ParType::DOUBLE));
+  auto shared = std::make_shared<TreeNode>(
+      "s", std::make_shared<Value<double>>(),
+      std::make_shared<MultAll>(ParType::DOUBLE), nullptr);
+  std::make_shared<TreeNode>("b", parB, nullptr, nullptr)->addParent(shared);
+  std::make_shared<TreeNode>("c", parC, nullptr, nullptr)->addParent(shared);
+  parB->Attach(shared->childNodes().at(0));
+  parC->Attach(shared->childNodes().at(1));
+
+  for (unsigned int i = 0; i < nSubTrees; i++) {
+    std::string n = std::to_string(i);
+    parA.push_back(std::make_shared<FitParameter>("parA_" + n, i + 1));
+    parA.back()->fixParameter(false);
+    myTree->createNode("sum_" + n, std::make_shared<Value<double>>(),
+                       std::make_shared<AddAll>(ParType::DOUBLE), "R");
+    myTree->createNode("ax_" + n, MDouble("", nElements),
+                       std::make_shared<MultAll>(ParType::MDOUBLE),
+                       "sum_" + n);
+    myTree->createLeaf("a_" + n, parA.back(), "ax_" + n);
+    myTree->createLeaf("x", parX, "ax_" + n);
+    shared->addParent(myTree->head()->findChildNode("ax_" + n));
+  }
+
+  auto expected = [&]() {
+    double sum = 0;
+    for (auto a : parA)
+      for (auto v : x)
+        sum += a->value() * v * parB->value() * parC->value();
+    return sum;
+  };
+
+  myTree->parameter();
+  double serial = result->value();
+  BOOST_CHECK_CLOSE(serial, expected(), 1e-10);
+
+  ThreadPool::ScopedSettings restorePool;
+  for (unsigned int nThreads : {1, 2, 4}) {
+    ThreadPool::instance().setNumThreads(nThreads);
+    myTree->setParallel(true);
+
+    // All subtrees are dirty
+    parC->setValue(parC->value() + 1);
+    myTree->parameter();
+    BOOST_CHECK_CLOSE(result->value(), expected(), 1e-10);
+
+    // Only some subtrees are dirty
+    parA.at(3)->setValue(parA.at(3)->value() + 1);
+    parA.at(7)->setValue(parA.at(7)->value() + 1);
+    myTree->parameter();
+    BOOST_CHECK_CLOSE(result->value(), expected(), 1e-10);
+
+    // Compare with serial evaluation
+    myTree->setParallel(false);
+    parB->setValue(parB->value() + 1);
+    myTree->parameter();
+    serial = result->value();
+    myTree->setParallel(true);
+    parB->setValue(parB->value() - 1);
+    parB->setValue(parB->value() + 1);
+    myTree->parameter();
+    BOOST_CHECK_EQUAL(result->value(), serial);
+  }
+  myTree->setParallel(false);
+}
+
+BOOST_AUTO_TEST_CASE(CompiledTree) {
+  std::vector<double> x;
+  for (unsigned int i = 0; i < 100; i++)
+    x.push_back(0.1 * i);
+  auto parX = std::make_shared<Value<std::vector<double>>>("x", x);
+  auto parA = std::make_shared<FitParameter>("parA", 2.);
+  parA->fixParameter(false);
+  auto parB = std::make_shared<FitParameter>("parB", 3.);
+  parB->fixParameter(false);
+
+  // Calculate R = Sum[ a * x ] + b * Sum[ x ]. Node ax is not cached.
+  auto result = std::make_shared<Value<double>>();
+  auto myTree = std::make_shared<FunctionTree>(
+      "R", result, std::make_shared<AddAll>(ParType::DOUBLE));
+  myTree->createNode("sumAX", std::make_shared<Value<double>>(),
+                     std::make_shared<AddAll>(ParType::DOUBLE), "R");
+  myTree->createNode("ax", std::make_shared<MultAll>(ParType::MDOUBLE),
+                     "sumAX");
+  myTree->createLeaf("a", parA, "ax");
+  myTree->createLeaf("x", parX, "ax");
+  myTree->createNode("bX", std::make_shared<Value<double>>(),
+                     std::make_shared<MultAll>(ParType::DOUBLE), "R");
+  myTree->createLeaf("b", parB, "bX");
+  myTree->createNode("sumX", std::make_shared<Value<double>>(),
+                     std::make_shared<AddAll>(ParType::DOUBLE), "bX");
+  myTree->createLeaf("x", parX, "sumX");
+
+  double sumX = std::accumulate(x.begin(), x.end(), 0.);
+  auto expected = [&]() { return (parA->value() + parB->value()) * sumX; };
+
+  myTree->compile();
+  auto res = std::dynamic_pointer_cast<Value<double>>(myTree->parameter());
+  BOOST_CHECK_CLOSE(res->value(), expected(), 1e-10);
+  BOOST_CHECK_EQUAL(res, result);
+
+  parA->setValue(5.);
+  BOOST_CHECK_CLOSE(result->value(), (2. + 3.) * sumX, 1e-10);
+  myTree->parameter();
+  BOOST_CHECK_CLOSE(result->value(), expected(), 1e-10);
+
+  parB->setValue(-1.);
+  myTree->parameter();
+  BOOST_CHECK_CLOSE(result->value(), expected(), 1e-10);
+
+  // The nodes of a compiled tree see the changes of its leafs as well
+  parB->setValue(4.);
+  auto head = std::dynamic_pointer_cast<Value<double>>(
+      myTree->head()->parameter());
+  BOOST_CHECK_CLOSE(head->value(), expected(), 1e-10);
+  myTree->parameter();
+  BOOST_CHECK_CLOSE(result->value(), expected(), 1e-10);
+
+  // A structural change invalidates the plan
+  auto parC = std::make_shared<FitParameter>("parC", 10.);
+  parC->fixParameter(false);
+  myTree->createLeaf("c", parC, "R");
+  myTree->parameter();
+  BOOST_CHECK_CLOSE(result->value(), expected() + parC->value(), 1e-10);
+  parC->setValue(20.);
+  myTree->parameter();
+  BOOST_CHECK_CLOSE(result->value(), expected() + parC->value(), 1e-10);
+
+  // Changes during compiled mode have to be seen after switching back
+  parA->setValue(1.);
+  myTree->parameter();
+  parB->setValue(7.);
+  myTree->decompile();
+  myTree->parameter();
+  BOOST_CHECK_CLOSE(result->value(), expected() + parC->value(), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(InPlaceOutput) {
+  auto a = std::make_shared<Value<std::vector<double>>>(
+      "a", std::vector<double>({1., 2., 3.}));
+  auto parB = std::make_shared<FitParameter>("parB", 2.);
+  parB->fixParameter(false);
+
+  // Strategies write into the existing output
+  auto result = MDouble("", 3);
+  auto data = result->values().data();
+  auto myTree = std::make_shared<FunctionTree>(
+      "R", result, std::make_shared<MultAll>(ParType::MDOUBLE));
+  myTree->createLeaf("a", a, "R");
+  myTree->createLeaf("b", parB, "R");
+  myTree->parameter();
+  BOOST_CHECK_EQUAL(result->values().at(2), 6.);
+  BOOST_CHECK_EQUAL(result->values().data(), data);
+
+  // Node without cache
+  myTree->createNode("absSq", std::make_shared<AbsSquare>(ParType::DOUBLE),
+                     "R");
+  myTree->createLeaf("c", std::make_shared<Value<double>>(3.), "absSq");
+  auto absSq = myTree->head()->findChildNode("absSq");
+  auto out = absSq->parameter();
+  BOOST_CHECK_EQUAL(std::dynamic_pointer_cast<Value<double>>(out)->value(), 9.);
+  myTree->parameter();
+  BOOST_CHECK_EQUAL(result->values().at(2), 54.);
+
+  // The size of an existing output is not changed
+  auto wrongSize = MDouble("", 2);
+  auto myTree2 = std::make_shared<FunctionTree>(
+      "R", wrongSize, std::make_shared<MultAll>(ParType::MDOUBLE));
+  myTree2->createLeaf("a", a, "R");
+  BOOST_CHECK_THROW(myTree2->parameter(), BadParameter);
+}
+
+/// MultAll that records the address of its output
+class RecordingMultAll : public MultAll {
+public:
+  RecordingMultAll(std::set<Parameter *> &outputs)
+      : MultAll(ParType::MDOUBLE), Outputs(outputs) {}
+
+  virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
+    MultAll::execute(paras, out);
+    std::lock_guard<std::mutex> lock(Mutex);
+    Outputs.insert(out.get());
+  }
+
+  std::set<Parameter *> &Outputs;
+  std::mutex Mutex;
+};
+
+BOOST_AUTO_TEST_CASE(UncachedNodes) {
+  size_t nSubTrees = 20;
+  size_t nElements = 1000;
+
+  // Calculate R = Sum_i Sum[ a_i * x * bx ] with bx = b * x. The nodes ax_i
+  // and the node bx, which is shared by all subtrees, are not cached.
+  std::vector<double> x;
+  for (unsigned int i = 0; i < nElements; i++)
+    x.push_back(0.001 * i);
+  auto parX = std::make_shared<Value<std::vector<double>>>("x", x);
+  auto parB = std::make_shared<FitParameter>("parB", 2.);
+  parB->fixParameter(false);
+  std::vector<std::shared_ptr<FitParameter>> parA;
+  std::set<Parameter *> outputs;
+
+  auto result = std::make_shared<Value<double>>();
+  auto myTree = std::make_shared<FunctionTree>(
+      "R", result, std::make_shared<AddAll>(ParType::DOUBLE));
+  auto shared = std::make_shared<TreeNode>(
+      "bx", std::make_shared<MultAll>(ParType::MDOUBLE), nullptr);
+  std::make_shared<TreeNode>("b", parB, nullptr, nullptr)->addParent(shared);
+  std::make_shared<TreeNode>("x", parX, nullptr, nullptr)->addParent(shared);
+  parB->Attach(shared->childNodes().at(0));
+
+  for (unsigned int i = 0; i < nSubTrees; i++) {
+    std::string n = std::to_string(i);
+    parA.push_back(std::make_shared<FitParameter>("parA_" + n, i + 1));
+    parA.back()->fixParameter(false);
+    myTree->createNode("sum_" + n, std::make_shared<Value<double>>(),
+                       std::make_shared<AddAll>(ParType::DOUBLE), "R");
+    myTree->createNode("ax_" + n, std::make_shared<RecordingMultAll>(outputs),
+                       "sum_" + n);
+    myTree->createLeaf("a_" + n, parA.back(), "ax_" + n);
+    myTree->createLeaf("x", parX, "ax_" + n);
+    shared->addParent(myTree->head()->findChildNode("ax_" + n));
+  }
+
+  auto expected = [&]() {
+    double sum = 0;
+    for (auto a : parA)
+      for (auto v : x)
+        sum += a->value() * v * parB->value() * v;
+    return sum;
+  };
+
+  // The nodes ax_i are calculated one after the other. After the first call
+  // they share their output.
+  myTree->parameter();
+  BOOST_CHECK_CLOSE(result->value(), expected(), 1e-10);
+  for (unsigned int k = 0; k < 2; ++k) {
+    outputs.clear();
+    parB->setValue(parB->value() + 1);
+    myTree->parameter();
+    BOOST_CHECK_CLOSE(result->value(), expected(), 1e-10);
+    BOOST_CHECK_EQUAL(outputs.size(), 1);
+  }
+
+  // In parallel mode each calculation of bx uses its own output
+  ThreadPool::ScopedSettings restorePool;
+  myTree->setParallel(true);
+  for (unsigned int nThreads : {2, 4}) {
+    ThreadPool::instance().setNumThreads(nThreads);
+    for (unsigned int k = 0; k < 5; ++k) {
+      parB->setValue(parB->value() + 1);
+      myTree->parameter();
+      BOOST_CHECK_CLOSE(result->value(), expected(), 1e-10);
+    }
+  }
+  myTree->setParallel(false);
+}
+
+/// RecordingMultAll that fails on request
+class FailingMultAll : public RecordingMultAll {
+public:
+  FailingMultAll(std::set<Parameter *> &outputs, bool &fail)
+      : RecordingMultAll(outputs), Fail(fail) {}
+
+  virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
+    if (Fail)
+      throw std::runtime_error("FailingMultAll::execute() | Failure");
+    RecordingMultAll::execute(paras, out);
+  }
+
+  bool &Fail;
+};
+
+BOOST_AUTO_TEST_CASE(UncachedHead) {
+  size_t nElements = 1000;
+
+  // Calculate R = a * x * ax with ax = a * x. R and ax are not cached.
+  std::vector<double> x;
+  for (unsigned int i = 0; i < nElements; i++)
+    x.push_back(0.001 * i);
+  auto parX = std::make_shared<Value<std::vector<double>>>("x", x);
+  auto parA = std::make_shared<FitParameter>("parA", 2.);
+  parA->fixParameter(false);
+  std::set<Parameter *> outputs;
+  bool fail = false;
+
+  auto myTree = std::make_shared<FunctionTree>(
+      "R", std::shared_ptr<Parameter>(),
+      std::make_shared<RecordingMultAll>(outputs));
+  myTree->createLeaf("a", parA, "R");
+  myTree->createLeaf("x", parX, "R");
+  myTree->createNode("ax", std::make_shared<FailingMultAll>(outputs, fail),
+                     "R");
+  myTree->createLeaf("a", parA, "ax");
+  myTree->createLeaf("x", parX, "ax");
+
+  auto check = [&](std::shared_ptr<Parameter> result) {
+    auto &values =
+        std::dynamic_pointer_cast<Value<std::vector<double>>>(result)
+            ->values();
+    double a = parA->value();
+    BOOST_CHECK_CLOSE(values.at(10), a * x.at(10) * a * x.at(10), 1e-10);
+  };
+
+  // The output of the head is given back on the next call. Also a failing
+  // calculation gives its outputs back.
+  auto first = myTree->parameter();
+  check(first);
+  for (unsigned int k = 0; k < 6; ++k) {
+    parA->setValue(parA->value() + 1);
+    fail = (k % 2);
+    if (fail) {
+      BOOST_CHECK_THROW(myTree->parameter(), std::runtime_error);
+      BOOST_CHECK_THROW(myTree->print(), std::runtime_error);
+    } else {
+      auto result = myTree->parameter();
+      check(result);
+      BOOST_CHECK_EQUAL(result, first);
+    }
+  }
+  BOOST_CHECK_EQUAL(outputs.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkedStrategies) {
+  size_t nElements = 1001;
+
+  // Calculate R = log( |a * c|^2 + b ) for multi values a, b and c
+  std::vector<double> a, b;
+  std::vector<std::complex<double>> c;
+  for (unsigned int i = 0; i < nElements; i++) {
+    a.push_back(1. + 0.01 * i);
+    b.push_back(0.5 + 0.5 * i);
+    c.push_back(std::complex<double>(0.1 * i, -0.2 * i));
+  }
+  auto parC = std::make_shared<FitParameter>("parC", 2.);
+  parC->fixParameter(false);
+
+  auto result = MDouble("", nElements);
+  auto myTree = std::make_shared<FunctionTree>(
+      "R", result, std::make_shared<LogOf>(ParType::MDOUBLE));
+  myTree->createNode("sum", MDouble("", nElements),
+                     std::make_shared<AddAll>(ParType::MDOUBLE), "R");
+  myTree->createNode("abs", MDouble("", nElements),
+                     std::make_shared<AbsSquare>(ParType::MDOUBLE), "sum");
+  myTree->createLeaf("b", std::make_shared<Value<std::vector<double>>>(b),
+                     "sum");
+  myTree->createNode("ac", MComplex("", nElements),
+                     std::make_shared<MultAll>(ParType::MCOMPLEX), "abs");
+  myTree->createLeaf("a", std::make_shared<Value<std::vector<double>>>(a),
+                     "ac");
+  myTree->createLeaf("c",
+                     std::make_shared<Value<std::vector<std::complex<double>>>>(
+                         c),
+                     "ac");
+  myTree->createLeaf("parC", parC, "ac");
+
+  auto &pool = ThreadPool::instance();
+  ThreadPool::ScopedSettings restorePool;
+  pool.setNumThreads(1);
+  myTree->parameter();
+  std::vector<double> serial = result->values();
+  for (unsigned int i = 0; i < nElements; i++)
+    BOOST_CHECK_CLOSE(serial.at(i),
+                      std::log(std::norm(a.at(i) * c.at(i) * 2.) + b.at(i)),
+                      1e-10);
+
+  pool.setGrainSize(7);
+  for (unsigned int nThreads : {1, 3, 8}) {
+    pool.setNumThreads(nThreads);
+    parC->setValue(3.);
+    parC->setValue(2.);
+    myTree->parameter();
+    BOOST_CHECK(result->values() == serial);
+  }
+}
+
+/// Strategy without derivatives: exp(b * x) for a double b and a multi
+/// double x
+class Exponential : public Strategy {
+public:
+  Exponential() : Strategy(ParType::MDOUBLE, "Exp"){};
+
+  virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
+    auto &x = paras.mDoubleValue(0)->values();
+    double b = paras.doubleParameter(0)->value();
+    auto &results = multiOutput<double>(out, x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+      results[i] = std::exp(b * x[i]);
+  }
+};
+
+BOOST_AUTO_TEST_CASE(Gradient) {
+  size_t nElements = 50;
+  std::vector<std::complex<double>> f1, f2;
+  std::vector<double> x, w;
+  for (size_t i = 0; i < nElements; i++) {
+    f1.push_back(std::polar(1. + 0.02 * i, 0.1 * i));
+    f2.push_back(std::polar(0.5 + 0.01 * i, -0.3 * i));
+    x.push_back(0.02 * i);
+    w.push_back(1. - 0.01 * i);
+  }
+  std::vector<std::shared_ptr<FitParameter>> pars;
+  for (auto v : {1.2, 0.3, 0.8, -0.5, 0.7, 4.0, 2.5, 9.}) {
+    pars.push_back(
+        std::make_shared<FitParameter>("p" + std::to_string(pars.size()), v));
+    pars.back()->fixParameter(false);
+  }
+  pars.back()->fixParameter(true);
+  // Parameter which is not part of the tree
+  pars.push_back(std::make_shared<FitParameter>("unused", 1.));
+  pars.back()->fixParameter(false);
+
+  // L = sqrt(p6) / p5 * p7 * Sum[ w * log |c1 f1 + conj(c2) f2 exp(p4 x)|^2 ]
+  // with c1 = polar(p0, p1) and c2 = polar(p2, p3)
+  auto myTree = std::make_shared<FunctionTree>(
+      "L", std::make_shared<Value<double>>(),
+      std::make_shared<MultAll>(ParType::DOUBLE));
+  myTree->createNode("sqrt", std::make_shared<Value<double>>(),
+                     std::make_shared<SquareRoot>(ParType::DOUBLE), "L");
+  myTree->createLeaf("p6", pars.at(6), "sqrt");
+  myTree->createNode("inv", std::make_shared<Value<double>>(),
+                     std::make_shared<Inverse>(ParType::DOUBLE), "L");
+  myTree->createLeaf("p5", pars.at(5), "inv");
+  myTree->createLeaf("p7", pars.at(7), "L");
+  myTree->createNode("sum", std::make_shared<Value<double>>(),
+                     std::make_shared<AddAll>(ParType::DOUBLE), "L");
+  myTree->createNode("wLog", MDouble("", nElements),
+                     std::make_shared<MultAll>(ParType::MDOUBLE), "sum");
+  myTree->createLeaf("w", std::make_shared<Value<std::vector<double>>>(w),
+                     "wLog");
+  myTree->createNode("log", MDouble("", nElements),
+                     std::make_shared<LogOf>(ParType::MDOUBLE), "wLog");
+  myTree->createNode("abs", std::make_shared<AbsSquare>(ParType::MDOUBLE),
+                     "log");
+  myTree->createNode("amp", std::make_shared<AddAll>(ParType::MCOMPLEX),
+                     "abs");
+  myTree->createNode("a1", MComplex("", nElements),
+                     std::make_shared<MultAll>(ParType::MCOMPLEX), "amp");
+  myTree->createNode("c1", std::make_shared<Value<std::complex<double>>>(),
+                     std::make_shared<Complexify>(ParType::COMPLEX), "a1");
+  myTree->createLeaf("p0", pars.at(0), "c1");
+  myTree->createLeaf("p1", pars.at(1), "c1");
+  myTree->createLeaf(
+      "f1", std::make_shared<Value<std::vector<std::complex<double>>>>(f1),
+      "a1");
+  myTree->createNode("a2", std::make_shared<MultAll>(ParType::MCOMPLEX),
+                     "amp");
+  myTree->createNode("conjC2", std::make_shared<Value<std::complex<double>>>(),
+                     std::make_shared<ComplexConjugate>(ParType::COMPLEX),
+                     "a2");
+  myTree->createNode("c2", std::make_shared<Value<std::complex<double>>>(),
+                     std::make_shared<Complexify>(ParType::COMPLEX), "conjC2");
+  myTree->createLeaf("p2", pars.at(2), "c2");
+  myTree->createLeaf("p3", pars.at(3), "c2");
+  myTree->createLeaf(
+      "f2", std::make_shared<Value<std::vector<std::complex<double>>>>(f2),
+      "a2");
+  myTree->createNode("exp", MDouble("", nElements),
+                     std::make_shared<Exponential>(), "a2");
+  myTree->createLeaf("x", std::make_shared<Value<std::vector<double>>>(x),
+                     "exp");
+  myTree->createLeaf("p4", pars.at(4), "exp");
+
+  auto value = [&]() {
+    return std::dynamic_pointer_cast<Value<double>>(myTree->parameter())
+        ->value();
+  };
+
+  // The second call of gradient() reuses the storage of the first call
+  for (bool compiled : {false, true}) {
+    if (compiled)
+      myTree->compile();
+    for (int call = 0; call < 2; ++call) {
+      pars.at(0)->setValue(pars.at(0)->value() + 0.1 * call);
+      double l = value();
+      auto grad = myTree->gradient(pars);
+      BOOST_CHECK_EQUAL(grad.size(), pars.size());
+      // The tree is not modified
+      BOOST_CHECK_EQUAL(value(), l);
+
+      for (size_t i = 0; i < pars.size(); ++i) {
+        if (pars.at(i)->isFixed() || pars.at(i)->name() == "unused") {
+          BOOST_CHECK_EQUAL(grad.at(i), 0.);
+          continue;
+        }
+        double v = pars.at(i)->value();
+        double h = 1e-6 * std::max(1., std::abs(v));
+        pars.at(i)->setValue(v + h);
+        double up = value();
+        pars.at(i)->setValue(v - h);
+        double down = value();
+        pars.at(i)->setValue(v);
+        BOOST_CHECK_CLOSE(grad.at(i), (up - down) / (2 * h), 1e-4);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -7,41 +7,256 @@
 // ANSI C headers
 #include "AsciiReader.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
-#include <fstream>
-#include <iostream>
-#include <sstream>
-#include <utility>
+#include <limits>
+#include <string>
+#include <vector>
 
 #include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "Core/ThreadPool.hpp"
 
 using namespace ComPWA::DataReader::AsciiReader;
 
-// Constructors and destructors
-AsciiReader::AsciiReader(const std::string inConfigFile, const int particles) {
+namespace {
+
+/// Number of bytes per range of the parallel parser
+const std::size_t RangeSize = 1 << 22;
+
+inline bool isSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' ||
+         c == '\v';
+}
 
-  std::ifstream currentStream;
-  currentStream.open(inConfigFile.c_str());
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
 
-  if (!currentStream)
-    throw BadConfig("Can not open " + inConfigFile);
+/// Find the next token in [\p p, \p end). On success \p p points to the
+/// first character of the token and \p tokenEnd behind its last character.
+inline bool nextToken(const char *&p, const char *end, const char *&tokenEnd) {
+  while (p < end && isSpace(*p))
+    ++p;
+  if (p == end)
+    return false;
+  tokenEnd = p;
+  while (tokenEnd < end && !isSpace(*tokenEnd))
+    ++tokenEnd;
+  return true;
+}
+
+/// Parse the token [\p begin, \p end) with strtod.
+bool parseSlow(const char *begin, const char *end, double &value) {
+  std::string token(begin, end);
+  char *last;
+  value = std::strtod(token.c_str(), &last);
+  return last == token.c_str() + token.size();
+}
 
-  while (!currentStream.eof()) {
-    double e, px, py, pz;
-    Event newEvent;
+/// Parse the token [\p begin, \p end). Decimal numbers with up to 19
+/// significant digits whose mantissa and power of ten are exactly
+/// representable as double are converted with a single correctly rounded
+/// multiplication or division. All other tokens are parsed by strtod,
+/// therefore the result is always identical to strtod.
+bool parseNumber(const char *begin, const char *end, double &value) {
+  static const double PowersOfTen[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const std::uint64_t MaxExactMantissa = std::uint64_t(1) << 53;
 
-    for (int parts = 0; parts < particles; parts++) {
-      currentStream >> px >> py >> pz >> e;
-      newEvent.addParticle(Particle(px, py, pz, e));
+  const char *p = begin;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+    negative = (*p++ == '-');
+
+  std::uint64_t mantissa = 0;
+  int exponent = 0, significantDigits = 0;
+  bool anyDigit = false, truncated = false;
+  for (; p < end && isDigit(*p); ++p) {
+    anyDigit = true;
+    if (significantDigits < 19) {
+      mantissa = 10 * mantissa + (*p - '0');
+      significantDigits += (mantissa != 0);
+    } else {
+      truncated = true;
     }
+  }
+  if (p < end && *p == '.') {
+    for (++p; p < end && isDigit(*p); ++p) {
+      anyDigit = true;
+      if (significantDigits < 19) {
+        mantissa = 10 * mantissa + (*p - '0');
+        significantDigits += (mantissa != 0);
+        exponent--;
+      } else {
+        truncated = true;
+      }
+    }
+  }
+  if (anyDigit && p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negativeExponent = false;
+    if (p < end && (*p == '-' || *p == '+'))
+      negativeExponent = (*p++ == '-');
+    if (p == end || !isDigit(*p))
+      return parseSlow(begin, end, value);
+    int e = 0;
+    for (; p < end && isDigit(*p); ++p)
+      e = std::min(10 * e + (*p - '0'), 100000);
+    exponent += negativeExponent ? -e : e;
+  }
+
+  if (!anyDigit || p != end || truncated || mantissa > MaxExactMantissa ||
+      exponent < -22 || exponent > 22)
+    return parseSlow(begin, end, value);
+
+  value = (double)mantissa;
+  if (exponent < 0)
+    value /= PowersOfTen[-exponent];
+  else
+    value *= PowersOfTen[exponent];
+  if (negative)
+    value = -value;
+  return true;
+}
+
+/// Columns of an EventCollection that are filled by the parser
+struct Columns {
+  Columns(ComPWA::EventCollection &events) {
+    for (std::size_t j = 0; j < events.numParticles(); ++j) {
+      Values.push_back(events.px(j));
+      Values.push_back(events.py(j));
+      Values.push_back(events.pz(j));
+      Values.push_back(events.e(j));
+    }
+  }
 
-    if (!currentStream.fail()) {
-      Events.push_back(newEvent);
-      // for ( parts = 0; parts < linesToSkip; parts++ )
-      //   currentStream >> px >> py >> pz >> e;
+  /// Store number \p i of the file
+  void set(std::size_t i, double value) {
+    Values[i % Values.size()][i / Values.size()] = value;
+  }
+
+  std::vector<double *> Values;
+};
+
+} // namespace
+
+AsciiEventStream::AsciiEventStream(const std::string &fileName,
+                                   std::size_t particles)
+    : File(fileName), Particles(particles), Position(0) {}
+
+void AsciiEventStream::rewind() { Position = 0; }
+
+bool AsciiEventStream::next(EventCollection &chunk, std::size_t maxEvents) {
+  if (chunk.numParticles() == Particles)
+    chunk.clear();
+  else
+    chunk = EventCollection(Particles);
+
+  const char *p = File.data() + Position;
+  const char *end = File.data() + File.size();
+  std::vector<double> p4(4 * Particles);
+  while (chunk.size() < maxEvents) {
+    const char *tokenEnd;
+    std::size_t k = 0;
+    for (; k < p4.size() && nextToken(p, end, tokenEnd); ++k) {
+      if (!parseNumber(p, tokenEnd, p4[k]))
+        break;
+      p = tokenEnd;
+    }
+    // Stop at the end of the file or at invalid input
+    if (k < p4.size()) {
+      p = end;
+      break;
     }
+
+    std::size_t evt = chunk.size();
+    chunk.resize(evt + 1);
+    for (std::size_t parts = 0; parts < Particles; parts++)
+      chunk.setParticle(evt, parts, p4[4 * parts], p4[4 * parts + 1],
+                        p4[4 * parts + 2], p4[4 * parts + 3]);
+  }
+  Position = p - File.data();
+  return !chunk.empty();
+}
+
+// Constructors and destructors
+AsciiReader::AsciiReader(const std::string inConfigFile, const int particles) {
+  ComPWA::MemoryMappedFile file(inConfigFile);
+  const char *data = file.data();
+  std::size_t size = file.size();
+
+  // Ranges start at whitespace so that no number is split
+  std::vector<std::size_t> bounds(1, 0);
+  for (std::size_t pos = RangeSize; pos < size; pos += RangeSize) {
+    pos = std::max(pos, bounds.back());
+    while (pos < size && !isSpace(data[pos]))
+      ++pos;
+    if (pos < size)
+      bounds.push_back(pos);
+  }
+  bounds.push_back(size);
+  std::size_t numRanges = bounds.size() - 1;
+
+  // Count the numbers in each range to obtain the index of the first
+  // number of each range
+  std::vector<std::size_t> offsets(numRanges + 1, 0);
+  auto &pool = ThreadPool::instance();
+  pool.parallelFor(numRanges,
+                   [&](std::size_t begin, std::size_t end) {
+                     for (std::size_t r = begin; r < end; ++r) {
+                       const char *p = data + bounds[r];
+                       const char *last = data + bounds[r + 1];
+                       const char *tokenEnd;
+                       std::size_t n = 0;
+                       for (; nextToken(p, last, tokenEnd); p = tokenEnd)
+                         ++n;
+                       offsets[r + 1] = n;
+                     }
+                   },
+                   1);
+  for (std::size_t r = 0; r < numRanges; ++r)
+    offsets[r + 1] += offsets[r];
+
+  // Parse the numbers into the columns. Incomplete events at the end are
+  // ignored.
+  std::size_t numbersPerEvent = 4 * particles;
+  std::size_t numEvents = offsets.back() / numbersPerEvent;
+  Events = EventCollection(particles);
+  Events.resize(numEvents);
+  Columns columns(Events);
+  std::size_t numNumbers = numEvents * numbersPerEvent;
+  std::vector<std::size_t> firstInvalid(numRanges, numNumbers);
+  pool.parallelFor(numRanges,
+                   [&](std::size_t begin, std::size_t end) {
+                     for (std::size_t r = begin; r < end; ++r) {
+                       const char *p = data + bounds[r];
+                       const char *last = data + bounds[r + 1];
+                       const char *tokenEnd;
+                       std::size_t i = offsets[r];
+                       for (; i < numNumbers && nextToken(p, last, tokenEnd);
+                            p = tokenEnd, ++i) {
+                         double value;
+                         if (!parseNumber(p, tokenEnd, value)) {
+                           firstInvalid[r] = i;
+                           break;
+                         }
+                         columns.set(i, value);
+                       }
+                     }
+                   },
+                   1);
+
+  // Reading stops at the first invalid number
+  std::size_t invalid =
+      *std::min_element(firstInvalid.begin(), firstInvalid.end());
+  if (invalid < numNumbers) {
+    LOG(ERROR) << "AsciiReader::AsciiReader() | Invalid number in "
+               << inConfigFile << ". Only the first "
+               << invalid / numbersPerEvent << " events are read.";
+    Events.resize(invalid / numbersPerEvent);
   }
-  currentStream.close();
 }
 
 AsciiReader::~AsciiReader() { Events.clear(); }
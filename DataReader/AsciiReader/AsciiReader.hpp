@@ -16,21 +16,52 @@
 
 // local headers
 #include "DataReader/Data.hpp"
+#include "DataReader/EventStream.hpp"
 #include "Core/Event.hpp"
 #include "Core/ParameterList.hpp"
 #include "Core/DataPoint.hpp"
+#include "Core/MemoryMappedFile.hpp"
 
 
 namespace ComPWA {
 namespace DataReader {
 namespace AsciiReader {
 
+///
+/// \class AsciiEventStream
+/// Reads an ASCII file in the format of AsciiReader in chunks of events.
+/// Only the current chunk is kept in memory. The file is memory-mapped and
+/// parsed sequentially.
+///
+class AsciiEventStream : public EventStream {
+
+public:
+  AsciiEventStream(const std::string &fileName, std::size_t particles);
+
+  virtual void rewind();
+
+  virtual bool next(EventCollection &chunk, std::size_t maxEvents);
+
+protected:
+  MemoryMappedFile File;
+
+  std::size_t Particles;
+
+  /// Offset of the next event in the file
+  std::size_t Position;
+};
+
 ///
 /// \class AsciiReader
 /// Reader for data in ASCII-Format. This class reads event-based data from
 /// ascii-files in the same syntax. as Pawian's epemEvtReader. It implements the
 /// interface of Data.hpp.
 ///
+/// The file is memory-mapped and split into ranges of whitespace separated
+/// numbers. The ranges are parsed in parallel on the ThreadPool. Each number
+/// is written directly to its event, therefore the order of the events is
+/// preserved. Reading stops at the first invalid number.
+///
 class AsciiReader : public Data {
 
 public:
@@ -0,0 +1,193 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the parallel ASCII reader.
+///
+
+#define BOOST_TEST_MODULE AsciiReader
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "Core/ThreadPool.hpp"
+#include "DataReader/AsciiReader/AsciiReader.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::DataReader::AsciiReader;
+
+BOOST_AUTO_TEST_SUITE(AsciiReaderTest);
+
+std::string tmpName() {
+  return "AsciiReaderTest-" + std::to_string(getpid());
+}
+
+/// Write numbers with different formats, four per line
+std::vector<std::string> writeNumbers(const std::string &fileName,
+                                      std::size_t n) {
+  const char *formats[] = {"%.17g", "%.6f", "%.3e", "%g", "%.20e", "%+.1f"};
+  std::vector<std::string> tokens;
+  std::ofstream out(fileName);
+  char buffer[64];
+  for (std::size_t i = 0; i < n; ++i) {
+    double x =
+        (i % 2 ? -1 : 1) * std::ldexp(1.0 + 0.37 * i, (int)(i % 61) - 30);
+    std::snprintf(buffer, sizeof(buffer), formats[i % 6], x);
+    tokens.push_back(buffer);
+    out << buffer << (i % 4 == 3 ? "\n" : "  ");
+  }
+  return tokens;
+}
+
+void checkBitwise(double a, const std::string &token) {
+  double b = std::strtod(token.c_str(), nullptr);
+  if (std::memcmp(&a, &b, sizeof(double)))
+    BOOST_ERROR("Token " + token + " parsed incorrectly");
+}
+
+BOOST_AUTO_TEST_CASE(ParseNumbers) {
+  ComPWA::Logging log("", "error");
+  std::string fileName = tmpName();
+  std::vector<std::string> tokens = writeNumbers(fileName, 4 * 30000);
+  // Special cases for the fast path
+  std::vector<std::string> special = {"0",
+                                      "-0.0",
+                                      "1e22",
+                                      "1e23",
+                                      "9007199254740993",
+                                      "123456789012345678901234",
+                                      "1.5E-7",
+                                      ".5",
+                                      "7.",
+                                      "4.9406564584124654e-324",
+                                      "1.7976931348623157e308",
+                                      "+3.25"};
+  {
+    std::ofstream out(fileName, std::ios::app);
+    for (auto &t : special) {
+      tokens.push_back(t);
+      out << t << "\t";
+    }
+  }
+
+  unsigned int numThreads = ThreadPool::instance().numThreads();
+  for (unsigned int threads : {1, 4}) {
+    ThreadPool::instance().setNumThreads(threads);
+    AsciiReader reader(fileName, 1);
+    const EventCollection &events = reader.events();
+    BOOST_REQUIRE_EQUAL(events.size(), tokens.size() / 4);
+    for (std::size_t i = 0; i < events.size(); ++i) {
+      checkBitwise(events.px(0)[i], tokens[4 * i]);
+      checkBitwise(events.py(0)[i], tokens[4 * i + 1]);
+      checkBitwise(events.pz(0)[i], tokens[4 * i + 2]);
+      checkBitwise(events.e(0)[i], tokens[4 * i + 3]);
+    }
+  }
+  ThreadPool::instance().setNumThreads(numThreads);
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(InvalidInput) {
+  ComPWA::Logging log("", "error");
+  std::string fileName = tmpName();
+  {
+    std::ofstream out(fileName);
+    for (int i = 0; i < 10; ++i)
+      out << "1 2 3 4\n5 6 7 8\n";
+    out << "1 2 3 4\n5 x 7 8\n1 2 3 4\n5 6 7 8\n";
+  }
+  AsciiReader reader(fileName, 2);
+  BOOST_CHECK_EQUAL(reader.numEvents(), 10);
+  BOOST_CHECK_EQUAL(reader.events().e(1)[9], 8.);
+
+  AsciiEventStream stream(fileName, 2);
+  EventCollection chunk;
+  std::size_t numRead = 0;
+  while (stream.next(chunk, 3))
+    numRead += chunk.size();
+  BOOST_CHECK_EQUAL(numRead, 10);
+
+  BOOST_CHECK_THROW(AsciiReader("AsciiReaderTest-missing", 2), BadConfig);
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(Stream) {
+  ComPWA::Logging log("", "error");
+  std::string fileName = tmpName();
+  writeNumbers(fileName, 3 * 4 * 1001);
+  AsciiReader reader(fileName, 3);
+  BOOST_REQUIRE_EQUAL(reader.numEvents(), 1001);
+
+  AsciiEventStream stream(fileName, 3);
+  EventCollection chunk, all;
+  for (int pass = 0; pass < 2; ++pass) {
+    all.clear();
+    stream.rewind();
+    while (stream.next(chunk, 64)) {
+      BOOST_CHECK(chunk.size() <= 64);
+      all.append(chunk);
+    }
+    BOOST_REQUIRE_EQUAL(all.size(), reader.numEvents());
+    for (std::size_t j = 0; j < 3; ++j) {
+      BOOST_CHECK(std::equal(all.px(j), all.px(j) + all.size(),
+                             reader.events().px(j)));
+      BOOST_CHECK(std::equal(all.e(j), all.e(j) + all.size(),
+                             reader.events().e(j)));
+    }
+  }
+  std::remove(fileName.c_str());
+}
+
+/// Throughput of the reader compared to reading with an istream
+BOOST_AUTO_TEST_CASE(Throughput) {
+  ComPWA::Logging log("", "info");
+  std::string fileName = tmpName();
+  std::vector<std::string> tokens = writeNumbers(fileName, 4 * 3 * 200000);
+  std::ifstream in(fileName, std::ios::ate);
+  double megaBytes = in.tellg() / 1e6;
+  in.close();
+
+  auto start = std::chrono::steady_clock::now();
+  std::ifstream stream(fileName);
+  std::vector<double> numbers;
+  numbers.reserve(tokens.size());
+  double x;
+  while (stream >> x)
+    numbers.push_back(x);
+  std::chrono::duration<double> baseline =
+      std::chrono::steady_clock::now() - start;
+  BOOST_CHECK_EQUAL(numbers.size(), tokens.size());
+
+  start = std::chrono::steady_clock::now();
+  AsciiReader reader(fileName, 3);
+  std::chrono::duration<double> parallel =
+      std::chrono::steady_clock::now() - start;
+  BOOST_CHECK_EQUAL(reader.numEvents(), tokens.size() / 12);
+  BOOST_CHECK_EQUAL(reader.events().pz(2)[reader.numEvents() - 1],
+                    numbers[numbers.size() - 2]);
+
+  LOG(INFO) << "AsciiReaderTest | " << megaBytes << " MB, istream: "
+            << megaBytes / baseline.count()
+            << " MB/s, AsciiReader: " << megaBytes / parallel.count()
+            << " MB/s with " << ThreadPool::instance().numThreads()
+            << " threads";
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
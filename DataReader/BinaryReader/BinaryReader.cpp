@@ -0,0 +1,222 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "DataReader/BinaryReader/BinaryReader.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::DataReader;
+
+namespace {
+
+/// Header of an event file
+struct Header {
+  char Magic[8];
+  std::uint64_t Version;
+  std::uint64_t NumEvents;
+  std::uint64_t NumParticles;
+  /// Test value to detect a different floating point format
+  double Check;
+  std::uint64_t Reserved[3];
+};
+
+/// Pid and charge of a final state particle
+struct ParticleHeader {
+  std::int32_t Pid;
+  std::int32_t Charge;
+};
+
+const char Magic[8] = {'C', 'o', 'm', 'P', 'W', 'A', 'E', 'V'};
+
+const std::uint64_t Version = 1;
+
+const double Check = 1.0 / 3.0;
+
+bool littleEndian() {
+  std::uint32_t one = 1;
+  char first;
+  std::memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+/// Size of a file with \p numEvents events of \p numParticles particles
+std::size_t fileSize(std::size_t numEvents, std::size_t numParticles) {
+  return sizeof(Header) + numParticles * sizeof(ParticleHeader) +
+         numEvents * ((4 * numParticles + 2) * sizeof(double) +
+                      sizeof(std::int32_t));
+}
+
+template <class T>
+void writeColumn(std::ofstream &out, const T *column, std::size_t n) {
+  out.write(reinterpret_cast<const char *>(column), n * sizeof(T));
+}
+
+} // namespace
+
+BinaryEventFile::BinaryEventFile(const std::string &fileName)
+    : File(fileName, true), NumEvents(0), NumParticles(0) {
+  if (!littleEndian())
+    throw BadConfig("BinaryEventFile::BinaryEventFile() | Event files can "
+                    "only be read on little-endian machines!");
+  if (File.size() < sizeof(Header))
+    throw BadConfig("BinaryEventFile::BinaryEventFile() | File " + fileName +
+                    " is too small!");
+  Header header;
+  std::memcpy(&header, File.data(), sizeof(Header));
+  if (std::memcmp(header.Magic, Magic, sizeof(Magic)) ||
+      header.Version != Version || header.Check != Check)
+    throw BadConfig("BinaryEventFile::BinaryEventFile() | File " + fileName +
+                    " is not a valid event file!");
+
+  NumEvents = header.NumEvents;
+  NumParticles = header.NumParticles;
+  if (File.size() != fileSize(NumEvents, NumParticles))
+    throw BadConfig("BinaryEventFile::BinaryEventFile() | Size of file " +
+                    fileName + " does not match its header!");
+}
+
+EventCollection::ExternalColumns
+BinaryEventFile::columns(std::shared_ptr<BinaryEventFile> file) {
+  std::size_t n = file->NumEvents;
+  char *data = file->File.data() + sizeof(Header);
+
+  EventCollection::ExternalColumns columns;
+  columns.NumEvents = n;
+  for (std::size_t j = 0; j < file->NumParticles; ++j) {
+    ParticleHeader particle;
+    std::memcpy(&particle, data, sizeof(ParticleHeader));
+    columns.Pid.push_back(particle.Pid);
+    columns.ParticleCharge.push_back(particle.Charge);
+    data += sizeof(ParticleHeader);
+  }
+  // The layout is fixed, therefore the columns are aligned
+  auto column = [&]() {
+    double *c = reinterpret_cast<double *>(data);
+    data += n * sizeof(double);
+    return c;
+  };
+  for (std::size_t j = 0; j < file->NumParticles; ++j) {
+    columns.Px.push_back(column());
+    columns.Py.push_back(column());
+    columns.Pz.push_back(column());
+    columns.E.push_back(column());
+  }
+  columns.Weights = column();
+  columns.Efficiencies = column();
+  columns.Charges = reinterpret_cast<int *>(data);
+  columns.Owner = file;
+  return columns;
+}
+
+void BinaryEventFile::write(const EventCollection &events,
+                            const std::string &fileName) {
+  if (!littleEndian())
+    throw BadConfig("BinaryEventFile::write() | Event files can only be "
+                    "written on little-endian machines!");
+
+  std::size_t n = events.size();
+  std::vector<ParticleHeader> particles(events.numParticles());
+  for (std::size_t j = 0; j < particles.size(); ++j) {
+    if (!n)
+      break;
+    particles[j].Pid = events.pid(0, j);
+    particles[j].Charge = events.particleCharge(0, j);
+    for (std::size_t i = 1; i < n; ++i)
+      if (events.pid(i, j) != particles[j].Pid ||
+          events.particleCharge(i, j) != particles[j].Charge)
+        throw BadParameter("BinaryEventFile::write() | Pid and charge of "
+                           "particle " +
+                           std::to_string(j) +
+                           " differ between events. This is not supported "
+                           "by the event format!");
+  }
+
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.Magic, Magic, sizeof(Magic));
+  header.Version = Version;
+  header.NumEvents = n;
+  header.NumParticles = events.numParticles();
+  header.Check = Check;
+
+  std::string tmpName = fileName + ".tmp" + std::to_string(getpid());
+  std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+  if (!out)
+    throw BadConfig("BinaryEventFile::write() | Can not open " + tmpName);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+  writeColumn(out, particles.data(), particles.size());
+  for (std::size_t j = 0; j < events.numParticles(); ++j) {
+    writeColumn(out, events.px(j), n);
+    writeColumn(out, events.py(j), n);
+    writeColumn(out, events.pz(j), n);
+    writeColumn(out, events.e(j), n);
+  }
+  writeColumn(out, events.weights(), n);
+  writeColumn(out, events.efficiencies(), n);
+  static_assert(sizeof(int) == sizeof(std::int32_t),
+                "Charges are stored as 32 bit integers!");
+  writeColumn(out, events.charges(), n);
+  out.close();
+  if (!out || std::rename(tmpName.c_str(), fileName.c_str())) {
+    std::remove(tmpName.c_str());
+    throw BadConfig("BinaryEventFile::write() | Can not write " + fileName);
+  }
+}
+
+BinaryReader::BinaryReader(const std::string &fileName) : Data(false) {
+  auto file = std::make_shared<BinaryEventFile>(fileName);
+  Events = EventCollection(BinaryEventFile::columns(file));
+  if (Events.size())
+    MaximumWeight = *std::max_element(Events.weights(),
+                                      Events.weights() + Events.size());
+  LOG(DEBUG) << "BinaryReader::BinaryReader() | Mapped " << Events.size()
+             << " events from " << fileName << ".";
+}
+
+void BinaryReader::writeData(std::string file, std::string trName) {
+  LOG(INFO) << "BinaryReader::writeData() | Writing current "
+               "sample of events to file "
+            << file;
+  BinaryEventFile::write(Events, file);
+}
+
+BinaryEventStream::BinaryEventStream(const std::string &fileName)
+    : Columns(BinaryEventFile::columns(
+          std::make_shared<BinaryEventFile>(fileName))),
+      Position(0) {}
+
+bool BinaryEventStream::next(EventCollection &chunk, std::size_t maxEvents) {
+  std::size_t numParticles = Columns.Px.size();
+  std::size_t end = std::min(Columns.NumEvents, Position + maxEvents);
+  if (chunk.numParticles() == numParticles)
+    chunk.clear();
+  else
+    chunk = EventCollection(numParticles);
+  chunk.resize(end - Position);
+
+  for (std::size_t i = 0; i < chunk.size(); ++i) {
+    std::size_t k = Position + i;
+    for (std::size_t j = 0; j < numParticles; ++j)
+      chunk.setParticle(i, j, Columns.Px[j][k], Columns.Py[j][k],
+                        Columns.Pz[j][k], Columns.E[j][k], Columns.Pid[j],
+                        Columns.ParticleCharge[j]);
+  }
+  std::copy(Columns.Weights + Position, Columns.Weights + end,
+            chunk.weights());
+  std::copy(Columns.Efficiencies + Position, Columns.Efficiencies + end,
+            chunk.efficiencies());
+  std::copy(Columns.Charges + Position, Columns.Charges + end,
+            chunk.charges());
+  Position = end;
+  return !chunk.empty();
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Reader and writer for the binary event format of ComPWA.
+///
+
+#ifndef _BINARYREADER_HPP_
+#define _BINARYREADER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Core/EventCollection.hpp"
+#include "Core/MemoryMappedFile.hpp"
+#include "DataReader/Data.hpp"
+#include "DataReader/EventStream.hpp"
+
+namespace ComPWA {
+namespace DataReader {
+
+///
+/// \class BinaryEventFile
+/// Memory-mapped event file in the binary format of ComPWA. All numbers are
+/// stored little-endian. The file consists of:
+///   - a header of 64 bytes: magic "ComPWAEV", format version, number of
+///     events, number of particles, the test value 1/3 (double) and
+///     24 reserved bytes,
+///   - pid and charge (two int32) of each final state particle,
+///   - the columns px, py, pz, E (double) of each particle,
+///   - the columns weight and efficiency (double) and charge (int32).
+///
+/// All columns are aligned to 8 bytes and can be used without copying. The
+/// file is mapped copy-on-write, the events can be modified in memory
+/// without changing the file.
+///
+class BinaryEventFile {
+public:
+  /// Map \p fileName. Throws BadConfig if the file is not a valid event
+  /// file or if the host is not little-endian.
+  BinaryEventFile(const std::string &fileName);
+
+  std::size_t numEvents() const { return NumEvents; }
+
+  std::size_t numParticles() const { return NumParticles; }
+
+  /// Columns of the file. The returned structure keeps \p file alive.
+  static EventCollection::ExternalColumns
+  columns(std::shared_ptr<BinaryEventFile> file);
+
+  /// Write \p events to \p fileName. The file is written to a temporary
+  /// file first and renamed afterwards. All events must have the same pid
+  /// and particle charge for each final state particle, otherwise
+  /// BadParameter is thrown.
+  static void write(const EventCollection &events, const std::string &fileName);
+
+private:
+  MemoryMappedFile File;
+
+  std::size_t NumEvents;
+
+  std::size_t NumParticles;
+};
+
+///
+/// \class BinaryReader
+/// Data class for the binary event format (see BinaryEventFile). The events
+/// are not copied when a file is read, the EventCollection refers to the
+/// memory-mapped file. Operations that add events copy the columns to
+/// memory.
+///
+class BinaryReader : public Data {
+
+public:
+  BinaryReader() {}
+
+  /// Map file \p fileName
+  BinaryReader(const std::string &fileName);
+
+  virtual ~BinaryReader() {}
+
+  virtual BinaryReader *clone() const { return new BinaryReader(*this); }
+
+  virtual BinaryReader *emptyClone() const { return new BinaryReader(); }
+
+  /// Write all events to \p file. The tree name is not used.
+  virtual void writeData(std::string file = "", std::string trName = "");
+};
+
+///
+/// \class BinaryEventStream
+/// Reads a binary event file in chunks (see EventStream). Only the pages of
+/// the current chunk are loaded from disk.
+///
+class BinaryEventStream : public EventStream {
+
+public:
+  BinaryEventStream(const std::string &fileName);
+
+  virtual void rewind() { Position = 0; }
+
+  virtual bool next(EventCollection &chunk, std::size_t maxEvents);
+
+protected:
+  /// Columns of the mapped file
+  EventCollection::ExternalColumns Columns;
+
+  /// Index of the next event
+  std::size_t Position;
+};
+
+} // namespace DataReader
+} // namespace ComPWA
+
+#endif
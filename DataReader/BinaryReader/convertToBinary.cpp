@@ -0,0 +1,77 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Conversion of ASCII and ROOT event files to the binary event format.
+///
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <boost/program_options.hpp>
+
+#include "Core/Logging.hpp"
+#include "DataReader/AsciiReader/AsciiReader.hpp"
+#include "DataReader/BinaryReader/BinaryReader.hpp"
+#ifdef COMPWA_WITH_ROOT
+#include "DataReader/RootReader/RootReader.hpp"
+#endif
+
+using namespace ComPWA;
+using namespace ComPWA::DataReader;
+
+namespace po = boost::program_options;
+
+int main(int argc, char **argv) {
+  po::options_description options("Convert an ASCII or ROOT event file to "
+                                  "the binary event format of ComPWA");
+  std::string input, output, treeName;
+  int particles;
+  options.add_options()("help,h", "produce help message")(
+      "input,i", po::value<std::string>(&input)->required(),
+      "input file, files ending with .root are read with RootReader, all "
+      "other files with AsciiReader")(
+      "output,o", po::value<std::string>(&output)->required(), "output file")(
+      "tree,t", po::value<std::string>(&treeName)->default_value("data"),
+      "name of the tree in the ROOT file")(
+      "particles,p", po::value<int>(&particles)->default_value(3),
+      "number of final state particles in the ASCII file");
+
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, options), vm);
+    if (vm.count("help")) {
+      std::cout << options << "\n";
+      return 0;
+    }
+    po::notify(vm);
+  } catch (po::error &ex) {
+    std::cerr << ex.what() << "\n" << options << "\n";
+    return 1;
+  }
+
+  Logging log("", "info");
+
+  std::shared_ptr<Data> sample;
+  bool root = input.size() > 5 && input.substr(input.size() - 5) == ".root";
+  if (root) {
+#ifdef COMPWA_WITH_ROOT
+    sample = std::make_shared<RootReader>(input, treeName);
+#else
+    LOG(ERROR) << "convertToBinary | ComPWA was built without ROOT. Can not "
+                  "read "
+               << input;
+    return 1;
+#endif
+  } else {
+    sample = std::make_shared<AsciiReader::AsciiReader>(input, particles);
+  }
+
+  BinaryEventFile::write(sample->events(), output);
+  LOG(INFO) << "convertToBinary | " << sample->numEvents()
+            << " events written to " << output << ".";
+  return 0;
+}
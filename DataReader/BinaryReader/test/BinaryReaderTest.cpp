@@ -0,0 +1,142 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the binary event format.
+///
+
+#define BOOST_TEST_MODULE BinaryReader
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <unistd.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "DataReader/BinaryReader/BinaryReader.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::DataReader;
+
+BOOST_AUTO_TEST_SUITE(BinaryReaderTest);
+
+std::shared_ptr<Data> sample(std::size_t n) {
+  auto data = std::make_shared<Data>();
+  for (std::size_t i = 0; i < n; ++i) {
+    Event ev;
+    ev.addParticle(Particle(0.01 * (i % 17), 0.1, 0.2 * i, 1.0 + i, 22, 0));
+    ev.addParticle(Particle(-0.1, 0.02 * (i % 11), 0.3, 1.5, 211, 1));
+    ev.addParticle(Particle(0.3, -0.2, 0.001 * i, 2.0, -211, -1));
+    ev.setWeight(0.5 + 0.1 * (i % 5));
+    ev.setEfficiency(0.9 - 0.01 * (i % 7));
+    ev.setCharge(i % 3 - 1);
+    data->add(ev);
+  }
+  return data;
+}
+
+void checkEqual(const EventCollection &a, const EventCollection &b) {
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  BOOST_REQUIRE_EQUAL(a.numParticles(), b.numParticles());
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    BOOST_CHECK_EQUAL(a.weight(i), b.weight(i));
+    BOOST_CHECK_EQUAL(a.efficiency(i), b.efficiency(i));
+    BOOST_CHECK_EQUAL(a.charge(i), b.charge(i));
+    for (std::size_t j = 0; j < a.numParticles(); ++j) {
+      BOOST_CHECK_EQUAL(a.px(j)[i], b.px(j)[i]);
+      BOOST_CHECK_EQUAL(a.py(j)[i], b.py(j)[i]);
+      BOOST_CHECK_EQUAL(a.pz(j)[i], b.pz(j)[i]);
+      BOOST_CHECK_EQUAL(a.e(j)[i], b.e(j)[i]);
+      BOOST_CHECK_EQUAL(a.pid(i, j), b.pid(i, j));
+      BOOST_CHECK_EQUAL(a.particleCharge(i, j), b.particleCharge(i, j));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(WriteReadCheck) {
+  ComPWA::Logging log("", "error");
+  std::string fileName = "BinaryReaderTest-" + std::to_string(getpid());
+  auto data = sample(1000);
+  data->events().setWeight(500, 2.5);
+  BinaryEventFile::write(data->events(), fileName);
+
+  BinaryReader reader(fileName);
+  BOOST_CHECK(reader.events().external());
+  BOOST_CHECK_EQUAL(reader.maximumWeight(), 2.5);
+  checkEqual(reader.events(), data->events());
+
+  // Modifications are not written to the file
+  reader.events().setWeight(3, 7.);
+  reader.events().px(1)[4] = 8.;
+  BinaryReader other(fileName);
+  BOOST_CHECK_EQUAL(reader.events().weight(3), 7.);
+  BOOST_CHECK_EQUAL(other.events().weight(3), data->events().weight(3));
+  BOOST_CHECK_EQUAL(other.events().px(1)[4], data->events().px(1)[4]);
+
+  // A copy owns its events
+  std::shared_ptr<Data> copy(other.clone());
+  BOOST_CHECK(!copy->events().external());
+  checkEqual(copy->events(), data->events());
+
+  // Adding events copies the columns
+  other.add(data->event(7));
+  BOOST_CHECK(!other.events().external());
+  BOOST_CHECK_EQUAL(other.numEvents(), 1001);
+  BOOST_CHECK_EQUAL(other.events().px(1)[4], data->events().px(1)[4]);
+  BOOST_CHECK_EQUAL(other.events().e(0)[1000], data->events().e(0)[7]);
+
+  // Selection of events works on the mapped columns
+  std::vector<char> mask(reader.numEvents(), 0);
+  mask[10] = mask[20] = 1;
+  reader.events().select(mask);
+  BOOST_CHECK(reader.events().external());
+  BOOST_REQUIRE_EQUAL(reader.numEvents(), 2);
+  BOOST_CHECK_EQUAL(reader.events().pz(0)[1], data->events().pz(0)[20]);
+
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(Stream) {
+  std::string fileName = "BinaryReaderTest-" + std::to_string(getpid());
+  auto data = sample(100);
+  BinaryEventFile::write(data->events(), fileName);
+
+  BinaryEventStream stream(fileName);
+  EventCollection chunk, all;
+  for (int pass = 0; pass < 2; ++pass) {
+    all.clear();
+    stream.rewind();
+    while (stream.next(chunk, 7)) {
+      BOOST_CHECK(chunk.size() <= 7);
+      all.append(chunk);
+    }
+    checkEqual(all, data->events());
+  }
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(InvalidInput) {
+  std::string fileName = "BinaryReaderTest-" + std::to_string(getpid());
+  auto data = sample(100);
+
+  // The pids of a particle have to be the same for all events
+  EventCollection events = data->events();
+  events.setParticle(3, 0, 0.1, 0.2, 0.3, 1.0, 111, 0);
+  BOOST_CHECK_THROW(BinaryEventFile::write(events, fileName), BadParameter);
+
+  BinaryEventFile::write(data->events(), fileName);
+  BOOST_CHECK_EQUAL(truncate(fileName.c_str(), 1000), 0);
+  BOOST_CHECK_THROW(BinaryReader reader(fileName), BadConfig);
+  BOOST_CHECK_THROW(BinaryReader reader("BinaryReaderTest-missing"),
+                    BadConfig);
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
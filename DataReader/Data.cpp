@@ -1,12 +1,16 @@
 // Copyright (c) 2015, 2017 The ComPWA Team.
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
+#include <algorithm>
+
 #include "DataReader/Data.hpp"
 
 using namespace ComPWA::DataReader;
 
 Data::Data(bool binning, unsigned int maxBins, double maxW)
-    : MaximumWeight(maxW), fBinned(binning), fmaxBins(maxBins) {}
+    : NumOutsidePhsp(0), Precision(DataPointSet::Precision::DOUBLE),
+      EventsKey(0), HasEventsKey(false), MaximumWeight(maxW), fBinned(binning),
+      fmaxBins(maxBins) {}
 
 void ComPWA::DataReader::rndReduceSet(std::shared_ptr<ComPWA::Kinematics> kin,
                                       unsigned int size,
@@ -44,29 +48,16 @@ void ComPWA::DataReader::rndReduceSet(std::shared_ptr<ComPWA::Kinematics> kin,
 
   /* 2nd method: events are added once only, but total size of sample varies
    * with sqrt(N) */
-  for (unsigned int i = 0; i < totalSize;
-       i++) { // count how many events are not within PHSP
-    ComPWA::DataPoint point;
-    try {
-      kin->convert(in1->event(i), point);
-    } catch (ComPWA::BeyondPhsp &ex) { // event outside phase, remove
-      newSize--;
-      continue;
-    }
-    //    dataPoint point(in1->getEvent(i));
-    //    if(!Kinematics::instance()->isWithinPhsp(point)) newSize--;
-  }
+  std::vector<std::vector<double>> values;
+  std::vector<char> mask;
+  kin->convert(in1->events(), 0, totalSize, values, mask);
+  // count how many events are within PHSP
+  newSize = std::count(mask.begin(), mask.end(), 1);
+
   double threshold = (double)size / newSize; // calculate threshold
   for (unsigned int i = 0; i < totalSize; i++) {
-    ComPWA::DataPoint point;
-    try {
-      kin->convert(in1->event(i), point);
-    } catch (ComPWA::BeyondPhsp &ex) { // event outside phase, remove
+    if (!mask[i]) // event outside phase, remove
       continue;
-    }
-    //    dataPoint point(in1->getEvent(i)); //use first sample for
-    // hit&miss
-    //    if(!Kinematics::instance()->isWithinPhsp(point)) continue;
     if (gen->uniform(0, 1) < threshold) {
       out1->add(in1->event(i));
       // write second sample if event from first sample were accepted
@@ -91,8 +82,8 @@ std::shared_ptr<Data> Data::rndSubSet(std::shared_ptr<Kinematics> kin,
 }
 
 void Data::resetWeights(double w) {
-  for (unsigned int i = 0; i < Events.size(); i++)
-    Events.at(i).setWeight(w);
+  Points.reset();
+  std::fill(Events.weights(), Events.weights() + Events.size(), w);
   MaximumWeight = w;
   return;
 }
@@ -100,61 +91,64 @@ void Data::resetWeights(double w) {
 double Data::maximumWeight() const { return MaximumWeight; }
 
 void Data::reduceToPhsp(std::shared_ptr<Kinematics> kin) {
-  std::vector<Event> tmp;
+  Points.reset();
   LOG(INFO) << "Data::reduceToPhsp() | "
                "Remove all events outside PHSP boundary from data sample.";
 
-  for (unsigned int evt = 0; evt < Events.size(); evt++) {
-    DataPoint point;
-    try {
-      kin->convert(Events.at(evt), point);
-    } catch (BeyondPhsp &ex) { // event outside phase, remove
-      continue;
-    }
-    tmp.push_back(Events.at(evt));
-  }
-  LOG(INFO) << "Data::reduceToPhsp() | " << tmp.size() << " from "
+  std::vector<EventColumn<double>> values;
+  EventColumn<char> mask;
+  convert(kin, values, mask);
+  std::vector<char> keep(mask.data(), mask.data() + mask.size());
+  std::size_t numKept = std::count(keep.begin(), keep.end(), 1);
+  LOG(INFO) << "Data::reduceToPhsp() | " << numKept << " from "
             << Events.size() << "("
-            << ((double)tmp.size()) / Events.size() * 100 << "%) were kept.";
-  Events = tmp;
+            << ((double)numKept) / Events.size() * 100 << "%) were kept.";
+  Events.select(keep);
+  HasEventsKey = false;
   return;
 }
 
 void Data::resetEfficiency(double e) {
-  for (unsigned int evt = 0; evt < Events.size(); evt++) {
-    Events.at(evt).setEfficiency(e);
-  }
+  Points.reset();
+  std::fill(Events.efficiencies(), Events.efficiencies() + Events.size(), e);
 }
 
 void Data::reduce(unsigned int newSize) {
+  Points.reset();
   if (newSize >= Events.size()) {
     LOG(ERROR)
         << "RooReader::reduce() requested size too large, cant reduce sample!";
     return;
   }
   Events.resize(newSize);
+  HasEventsKey = false;
 }
 
 void Data::setEfficiency(std::shared_ptr<Kinematics> kin,
                          std::shared_ptr<Efficiency> eff) {
+  Points.reset();
   for (unsigned int evt = 0; evt < Events.size(); evt++) {
     DataPoint point;
     try {
-      kin->convert(Events.at(evt), point);
+      kin->convert(Events, evt, point);
     } catch (BeyondPhsp &ex) { // event outside phase, remove
       continue;
     }
     //    dataPoint point(fEvents.at(evt));
     double val = eff->evaluate(point);
-    Events.at(evt).setEfficiency(val);
+    Events.setEfficiency(evt, val);
   }
 }
-void Data::clear() { Events.clear(); }
+void Data::clear() {
+  Events.clear();
+  Points.reset();
+  HasEventsKey = false;
+}
 
 bool Data::hasWeights() {
   bool has = 0;
   for (unsigned int evt = 0; evt < Events.size(); evt++) {
-    if (Events.at(evt).weight() != 1.) {
+    if (Events.weight(evt) != 1.) {
       has = 1;
       break;
     }
@@ -162,84 +156,69 @@ bool Data::hasWeights() {
   return has;
 }
 
-const ComPWA::ParameterList &
+ComPWA::ParameterList
 Data::dataList(std::shared_ptr<ComPWA::Kinematics> kin) {
-  // dataList already filled? return filled one
-  if (DataList.numParameters() != 0)
-    return DataList;
-
-  int size = kin->numVariables();
-  std::vector<std::vector<double>> data(size, std::vector<double>());
-  std::vector<double> eff;
-  eff.reserve(Events.size());
-  std::vector<double> weight;
-  weight.reserve(Events.size());
-
-  auto itr = Events.begin();
-  for (; itr != Events.end(); ++itr) {
-    DataPoint point;
-    try {
-      kin->convert(*itr, point);
-    } catch (BeyondPhsp &ex) {
-      continue;
-    }
-    eff.push_back(point.efficiency());
-    weight.push_back(point.weight());
-    for (int i = 0; i < size; ++i)
-      data.at(i).push_back(point.value(i));
-  }
+  return dataPoints(kin)->dataList();
+}
 
-  // Add data vector to ParameterList
-  for (auto i : data)
-    DataList.addValue(MDouble("", i));
-  // Adding efficiency at the end
-  DataList.addValue(MDouble("Efficiency", eff));
-  // Adding weight at the end
-  DataList.addValue(MDouble("Weight", weight));
+std::shared_ptr<ComPWA::DataPointSet>
+Data::dataPoints(std::shared_ptr<ComPWA::Kinematics> kin) {
+  if (Points && PointsKinematics == kin &&
+      Points->size() + NumOutsidePhsp == Events.size())
+    return Points;
 
-  return DataList;
+  std::vector<EventColumn<double>> values;
+  EventColumn<char> mask;
+  convert(kin, values, mask);
+  // Events outside the phase space are removed
+  Points = std::make_shared<DataPointSet>(std::move(values), mask,
+                                          Events.weights(),
+                                          Events.efficiencies(), Precision);
+  PointsKinematics = kin;
+  NumOutsidePhsp = Events.size() - Points->size();
+  return Points;
 }
 
-std::vector<ComPWA::DataPoint>
-Data::dataPoints(std::shared_ptr<ComPWA::Kinematics> kin) const {
-  std::vector<DataPoint> vecPoint;
-  for (int i = 0; i < Events.size(); i++) {
-    DataPoint point;
-    try {
-      kin->convert(Events.at(i), point);
-    } catch (BeyondPhsp &ex) { // event outside phase, remove
-      continue;
-    }
-    vecPoint.push_back(point);
-  }
-  return vecPoint;
+void Data::setPrecision(DataPointSet::Precision precision) {
+  // Users of the current set keep it
+  if (precision != Precision)
+    Points.reset();
+  Precision = precision;
 }
 
 void Data::setResolution(std::shared_ptr<Resolution> res) {
-  for (int i = 0; i < Events.size(); i++)
-    res->resolution(Events.at(i));
+  Points.reset();
+  for (std::size_t i = 0; i < Events.size(); i++) {
+    Event ev = Events.event(i);
+    res->resolution(ev);
+    Events.setEvent(i, ev);
+  }
+  HasEventsKey = false;
 }
 
 void Data::append(Data &otherSample) {
-  std::vector<Event> otherEvents = otherSample.events();
-  Events.insert(Events.end(), otherEvents.begin(), otherEvents.end());
+  Points.reset();
+  HasEventsKey = false;
+  Events.append(otherSample.events());
   if (otherSample.maximumWeight() > MaximumWeight)
     MaximumWeight = otherSample.maximumWeight();
   return;
 }
 
 void Data::applyCorrection(DataCorrection &corr) {
+  Points.reset();
   double sumWeightSq = 0;
-  for (int i = 0; i < Events.size(); i++) {
-    double w = corr.correction(Events.at(i));
+  for (std::size_t i = 0; i < Events.size(); i++) {
+    Event ev = Events.event(i);
+    double w = corr.correction(ev);
     if (w < 0)
       throw std::runtime_error("Data::applyCorrection() | "
                                "Negative weight!");
     sumWeightSq += w * w;
-    double oldW = Events.at(i).weight();
+    double oldW = Events.weight(i);
     if (w * oldW > MaximumWeight)
       MaximumWeight = w * oldW;
-    Events.at(i).setWeight(w * oldW);
+    Events.setWeight(i, w * oldW);
   }
   LOG(INFO) << "Data::applyCorrection() | "
                "Sample corrected! Sum of weights squared is "
@@ -258,7 +237,30 @@ const int Data::bin(const int i, double &m12, double &weight) {
 }
 
 void Data::add(const Event &evt) {
-  Events.push_back(evt);
+  Points.reset();
+  HasEventsKey = false;
+  Events.add(evt);
   if (evt.weight() > MaximumWeight)
     MaximumWeight = evt.weight();
 }
+
+void Data::convert(std::shared_ptr<Kinematics> kin,
+                   std::vector<EventColumn<double>> &values,
+                   EventColumn<char> &mask) const {
+  if (Cache) {
+    if (!HasEventsKey) {
+      EventsKey = VariableCache::key(Events);
+      HasEventsKey = true;
+    }
+    Cache->convert(Events, EventsKey, *kin, values, mask);
+    return;
+  }
+
+  std::vector<std::vector<double>> converted;
+  std::vector<char> convertedMask;
+  kin->convert(Events, 0, Events.size(), converted, convertedMask);
+  values.clear();
+  for (auto &column : converted)
+    values.push_back(EventColumn<double>(std::move(column)));
+  mask = EventColumn<char>(std::move(convertedMask));
+}
@@ -15,13 +15,16 @@
 #include <memory>
 
 #include "Core/Event.hpp"
+#include "Core/EventCollection.hpp"
 #include "Core/Efficiency.hpp"
 #include "Core/Kinematics.hpp"
 #include "Core/ParameterList.hpp"
 #include "Core/Generator.hpp"
 #include "Core/DataPoint.hpp"
+#include "Core/DataPointSet.hpp"
 #include "Core/Resolution.hpp"
 #include "DataReader/DataCorrection.hpp"
+#include "DataReader/VariableCache.hpp"
 
 namespace ComPWA {
 namespace DataReader {
@@ -32,6 +35,7 @@ namespace DataReader {
 /// any functionality for data read in and write out. Since this is in many cases
 /// not needed this class is not pure virtual. This functionality is
 /// implemented in derived classes (RootReader and AsciiReader).
+/// The events are stored in an EventCollection, i.e. column-wise.
 /// This class is also supposed to handle binned data but the implemenation of
 /// this functionality currently a bit deprecated.
 ///
@@ -53,19 +57,35 @@ public:
 
   virtual const std::size_t numEvents() const { return Events.size(); }
 
-  /// Get event by its position \p id.
-  virtual Event &event(const int id) { return Events.at(id); }
+  /// Get a copy of the event at position \p id.
+  /// Loops over large samples should use the columns of events() instead.
+  virtual Event event(const std::size_t id) const { return Events.event(id); }
 
-  /// Get a reference to the internal event storage.
-  virtual std::vector<Event> &events() { return Events; }
+  /// Get a reference to the internal event storage. The events may be
+  /// modified, therefore the hash of the events for the variable cache is
+  /// calculated again on the next conversion.
+  virtual EventCollection &events() {
+    HasEventsKey = false;
+    return Events;
+  }
 
-  /// Get 'horizontal' list of dataPoints. For each variable
-  /// (e.g. m23sq, m13sq ...) a MultiDouble is added to ParameterList.
-  /// This ParameterList is used to build the FunctionTree.
-  virtual const ParameterList &dataList(std::shared_ptr<Kinematics> kin);
+  virtual const EventCollection &events() const { return Events; }
 
-  /// Get 'vertical' list of dataPoints.
-  std::vector<DataPoint> dataPoints(std::shared_ptr<Kinematics> kin) const;
+  /// Get 'horizontal' list of dataPoints. For each variable
+  /// (e.g. m23sq, m13sq ...) a MultiDouble is added to ParameterList,
+  /// followed by the efficiencies and the weights. This ParameterList is
+  /// used to build the FunctionTree. The MultiDoubles are the columns of
+  /// dataPoints(), the sample is not copied. Throws BadParameter for single
+  /// precision (see setPrecision()).
+  virtual ParameterList dataList(std::shared_ptr<Kinematics> kin);
+
+  /// Get 'vertical' list of dataPoints. Events outside the phase space are
+  /// skipped, weights and efficiencies are taken from the events.
+  /// The set is created on the first call and shared by all later calls
+  /// with the same Kinematics until the sample is modified. Modifications of
+  /// the events via events() are not detected.
+  virtual std::shared_ptr<DataPointSet>
+  dataPoints(std::shared_ptr<Kinematics> kin);
 
   /// Apply a correction to the sample.
   /// E.g. correction for efficiency differences between data and Monte-Carlo.
@@ -84,6 +104,24 @@ public:
 
   void setResolution(std::shared_ptr<Resolution> res);
 
+  /// Use \p cache for the conversion of the sample to kinematic variables
+  /// in dataList(), dataPoints() and reduceToPhsp(). A null pointer disables
+  /// the cache.
+  virtual void setVariableCache(std::shared_ptr<VariableCache> cache) {
+    Cache = cache;
+  }
+
+  virtual std::shared_ptr<VariableCache> variableCache() const {
+    return Cache;
+  }
+
+  /// Storage precision of the variables in dataPoints(). Single precision
+  /// halves the memory of large phase space samples, see DataPointSet.
+  /// Single precision samples can not be used by the FunctionTree.
+  virtual void setPrecision(DataPointSet::Precision precision);
+
+  virtual DataPointSet::Precision precision() const { return Precision; }
+
   /// Set efficiency for each events.
   /// Since the efficiency is usually calculated in terms of phase-space variables
   /// we have to pass a Kinematics object.
@@ -121,11 +159,36 @@ public:
   virtual const int bin(const int, double &, double &);
 
 protected:
-  /// DataPoints are stored as 'horizontal' structure
-  ParameterList DataList;
+  /// Convert all events to columns of kinematic variables, see
+  /// Kinematics::convert(). The cache is used if it is set. In this case
+  /// the columns may be views of the cache file.
+  void convert(std::shared_ptr<Kinematics> kin,
+               std::vector<EventColumn<double>> &values,
+               EventColumn<char> &mask) const;
+
+  /// Converted sample, shared by dataList() and dataPoints()
+  std::shared_ptr<DataPointSet> Points;
+
+  /// Kinematics of Points
+  std::shared_ptr<Kinematics> PointsKinematics;
+
+  /// Number of events that are not part of Points
+  std::size_t NumOutsidePhsp;
+
+  /// Storage precision of Points
+  DataPointSet::Precision Precision;
+
+  /// Columnar storage of the events
+  EventCollection Events;
+
+  /// Cache of kinematic variables
+  std::shared_ptr<VariableCache> Cache;
+
+  /// Hash of the momenta of Events for the cache, see VariableCache::key().
+  /// Only valid if HasEventsKey is set.
+  mutable std::uint64_t EventsKey;
 
-  /// Vector of events
-  std::vector<Event> Events;
+  mutable bool HasEventsKey;
 
   /// Maximum weight of events
   double MaximumWeight;
@@ -0,0 +1,31 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+
+#include "Core/Exceptions.hpp"
+#include "DataReader/Data.hpp"
+#include "DataReader/EventStream.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::DataReader;
+
+DataEventStream::DataEventStream(std::shared_ptr<Data> data)
+    : Sample(data), Position(0) {
+  if (!Sample)
+    throw BadParameter("DataEventStream::DataEventStream() | No sample!");
+}
+
+bool DataEventStream::next(EventCollection &chunk, std::size_t maxEvents) {
+  const EventCollection &events = Sample->events();
+  std::size_t end = std::min(events.size(), Position + maxEvents);
+  // Keep the allocated memory of the chunk if possible
+  if (chunk.numParticles() == events.numParticles())
+    chunk.clear();
+  else
+    chunk = EventCollection(events.numParticles());
+  chunk.append(events, Position, end);
+  Position = end;
+  return !chunk.empty();
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Sequential access to event samples in chunks.
+///
+
+#ifndef DATAREADER_EVENTSTREAM_HPP_
+#define DATAREADER_EVENTSTREAM_HPP_
+
+#include <cstddef>
+#include <memory>
+
+#include "Core/EventCollection.hpp"
+
+namespace ComPWA {
+namespace DataReader {
+
+class Data;
+
+///
+/// \class EventStream
+/// Interface for reading a sample in chunks of events. Only the current
+/// chunk has to be kept in memory, therefore samples that are larger than
+/// the available memory can be processed (see e.g.
+/// Estimator::ChunkedMinLogLH). Implementations read from a file (e.g.
+/// AsciiReader::AsciiEventStream) or from a sample in memory
+/// (DataEventStream).
+///
+class EventStream {
+public:
+  virtual ~EventStream() {}
+
+  /// Restart the stream at the first event.
+  virtual void rewind() = 0;
+
+  /// Replace the content of \p chunk by the next (at most) \p maxEvents
+  /// events. Returns false and leaves \p chunk empty if the end of the
+  /// stream is reached.
+  virtual bool next(EventCollection &chunk, std::size_t maxEvents) = 0;
+};
+
+///
+/// \class DataEventStream
+/// EventStream over the events of a Data object.
+///
+class DataEventStream : public EventStream {
+public:
+  DataEventStream(std::shared_ptr<Data> data);
+
+  virtual void rewind() { Position = 0; }
+
+  virtual bool next(EventCollection &chunk, std::size_t maxEvents);
+
+protected:
+  std::shared_ptr<Data> Sample;
+
+  /// Index of the next event
+  std::size_t Position;
+};
+
+} // namespace DataReader
+} // namespace ComPWA
+
+#endif
@@ -2,43 +2,190 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "RVersion.h"
+#include "TBranch.h"
+#include "TDatabasePDG.h"
+#include "TObjArray.h"
 #include "TParticle.h"
 #include "TLorentzVector.h"
 #include "TParticlePDG.h"
+#include "TROOT.h"
 
+#include "Core/Exceptions.hpp"
 #include "Core/Kinematics.hpp"
 #include "Core/Generator.hpp"
 #include "Core/Logging.hpp"
 #include "Core/Properties.hpp"
+#include "Core/ThreadPool.hpp"
 #include "DataReader/RootReader/RootReader.hpp"
 
 namespace ComPWA {
 namespace DataReader {
 
-RootReader::RootReader() {}
+namespace {
 
-RootReader::RootReader(TTree *tr, int size) : Data(false) { read(tr, size); }
+/// Minimal number of entries that a thread reads. Each thread opens the file
+/// itself, which does not pay off for small ranges.
+const std::size_t MinEntriesPerThread = 50000;
 
-RootReader::RootReader(const std::string inRootFile,
-                       const std::string inTreeName, int size)
-    : Data(false) {
+/// Members of TParticle that are not needed to fill an EventCollection
+const char *UnusedParticleMembers[] = {
+    "fUniqueID", "fBits",       "fLineColor", "fLineStyle", "fLineWidth",
+    "fStatusCode", "fMother",   "fDaughter",  "fWeight",    "fCalcMass",
+    "fVx",       "fVy",         "fVz",        "fVt",        "fPolarTheta",
+    "fPolarPhi"};
+
+/// Append name and status of \p branches and their sub-branches to
+/// \p status. Branches are added before their sub-branches.
+void branchStatus(TTree *tree, TObjArray *branches,
+                  std::vector<std::pair<std::string, bool>> &status) {
+  if (!branches)
+    return;
+  for (Int_t i = 0; i < branches->GetEntriesFast(); ++i) {
+    auto branch = (TBranch *)branches->At(i);
+    if (!branch)
+      continue;
+    status.push_back(std::make_pair(std::string(branch->GetName()),
+                                    bool(tree->GetBranchStatus(
+                                        branch->GetName()))));
+    branchStatus(tree, branch->GetListOfBranches(), status);
+  }
+}
 
-  TFile *fFile = new TFile(inRootFile.c_str());
+///
+/// Reads entries of a TTree directly into the columns of an EventCollection.
+/// Only the branches that are needed are activated. The tree may belong to
+/// the caller, therefore the status of all branches is restored by the
+/// destructor.
+///
+class EntryReader {
+public:
+  EntryReader(TTree *tree)
+      : Tree(tree), Particles(new TClonesArray("TParticle")), Weight(1.),
+        Eff(1.), Charge(0) {
+    branchStatus(Tree, Tree->GetListOfBranches(), Status);
+    AutoDelete = Tree->GetBranch("Particles")->IsAutoDelete();
 
-  if (fFile->IsZombie())
+    Tree->SetBranchStatus("*", 0);
+    Tree->SetBranchStatus("Particles*", 1);
+    // The sub-branches of a split TClonesArray are named Particles.fPx etc.
+    for (auto member : UnusedParticleMembers) {
+      std::string name = std::string("Particles.") + member;
+      if (Tree->GetBranch(name.c_str()))
+        Tree->SetBranchStatus(name.c_str(), 0);
+    }
+    // The flavour branch is not used
+    for (auto branch : {"weight", "eff", "charge"})
+      Tree->SetBranchStatus(branch, 1);
+
+    Tree->GetBranch("Particles")->SetAutoDelete(false);
+    Tree->SetBranchAddress("Particles", &Particles);
+    Tree->SetBranchAddress("eff", &Eff);
+    Tree->SetBranchAddress("weight", &Weight);
+    Tree->SetBranchAddress("charge", &Charge);
+  }
+
+  ~EntryReader() {
+    Tree->ResetBranchAddresses();
+    Tree->GetBranch("Particles")->SetAutoDelete(AutoDelete);
+    // Branches are restored before their sub-branches, since the status of
+    // a branch is passed on to its sub-branches
+    for (auto const &branch : Status)
+      Tree->SetBranchStatus(branch.first.c_str(), branch.second);
+    delete Particles;
+  }
+
+  /// Number of particles in \p entry
+  std::size_t numParticles(Long64_t entry) {
+    Particles->Clear();
+    Tree->GetEntry(entry);
+    return Particles->GetEntriesFast();
+  }
+
+  /// Read \p entry into event \p i of \p events. Returns the event weight.
+  double read(Long64_t entry, EventCollection &events, std::size_t i) {
+    Particles->Clear();
+    Tree->GetEntry(entry);
+
+    if ((std::size_t)Particles->GetEntriesFast() != events.numParticles())
+      throw BadParameter("RootReader::read() | Entry " +
+                         std::to_string(entry) + " has " +
+                         std::to_string(Particles->GetEntriesFast()) +
+                         " particles but " +
+                         std::to_string(events.numParticles()) +
+                         " are expected!");
+
+    TLorentzVector p4;
+    for (std::size_t part = 0; part < events.numParticles(); part++) {
+      auto particle = (TParticle *)Particles->At(part);
+      if (!particle)
+        continue;
+      particle->Momentum(p4);
+      int charge = 0;
+      if (auto pdg = particle->GetPDG())
+        charge = pdg->Charge();
+      if (charge != 0)
+        charge /= std::fabs(charge);
+      events.setParticle(i, part, p4.X(), p4.Y(), p4.Z(), p4.E(),
+                         particle->GetPdgCode(), charge);
+    }
+    events.setWeight(i, Weight);
+    events.setCharge(i, Charge);
+    events.setEfficiency(i, Eff);
+    return Weight;
+  }
+
+private:
+  TTree *Tree;
+
+  TClonesArray *Particles;
+
+  double Weight;
+
+  double Eff;
+
+  int Charge;
+
+  /// Branch status of the tree before it was modified
+  std::vector<std::pair<std::string, bool>> Status;
+
+  bool AutoDelete;
+};
+
+/// Open \p treeName from \p fileName
+std::pair<std::unique_ptr<TFile>, TTree *> openTree(const std::string &fileName,
+                                                  const std::string &treeName) {
+  std::unique_ptr<TFile> file(TFile::Open(fileName.c_str()));
+  if (!file || file->IsZombie())
     throw std::runtime_error("RootReader::RootReader() | "
                              "Can't open data file: " +
-                             inRootFile);
-
-  TTree *fTree = (TTree *)fFile->Get(inTreeName.c_str());
+                             fileName);
 
-  if (!fTree)
-    throw std::runtime_error("RootReader::RootReader() | Tree \"" + inTreeName +
-                             "\" can not be opened from file " + inRootFile +
+  TTree *tree = (TTree *)file->Get(treeName.c_str());
+  if (!tree)
+    throw std::runtime_error("RootReader::RootReader() | Tree \"" + treeName +
+                             "\" can not be opened from file " + fileName +
                              "! ");
-  read(fTree, size);
+  return std::make_pair(std::move(file), tree);
+}
 
-  fFile->Close();
+} // namespace
+
+RootReader::RootReader() {}
+
+RootReader::RootReader(TTree *tr, int size) : Data(false) { read(tr, size); }
+
+RootReader::RootReader(const std::string inRootFile,
+                       const std::string inTreeName, int size)
+    : Data(false) {
+  read(inRootFile, inTreeName, size);
 }
 
 RootReader::~RootReader() {}
@@ -48,55 +195,72 @@ RootReader *RootReader::clone() const { return new RootReader(*this); }
 RootReader *RootReader::emptyClone() const { return new RootReader(); }
 
 void RootReader::read(TTree *fTree, double readSize) {
+  if (readSize <= 0 || readSize > fTree->GetEntries())
+    readSize = fTree->GetEntries();
+  Long64_t numEntries = readSize;
 
-  // TTree branch variables
-  TClonesArray *fParticles;
-  double feventWeight;
-  double feventEff;
-  int fCharge;
-  int fFlavour;
+  EntryReader reader(fTree);
+  Events = EventCollection(numEntries ? reader.numParticles(0) : 0);
+  Events.resize(numEntries);
+  for (Long64_t evt = 0; evt < numEntries; evt++) {
+    double weight = reader.read(evt, Events, evt);
+    if (weight > MaximumWeight)
+      MaximumWeight = weight;
+  } // end event loop
+}
 
-  fParticles = new TClonesArray("TParticle");
-  fTree->GetBranch("Particles")->SetAutoDelete(false);
-  fTree->SetBranchAddress("Particles", &fParticles);
-  fTree->SetBranchAddress("eff", &feventEff);
-  fTree->SetBranchAddress("weight", &feventWeight);
-  fTree->SetBranchAddress("charge", &fCharge);
-  fTree->SetBranchAddress("flavour", &fFlavour);
+void RootReader::read(const std::string &fileName, const std::string &treeName,
+                      double readSize) {
+  Long64_t numEntries;
+  std::size_t numParticles = 0;
+  {
+    auto tree = openTree(fileName, treeName);
+    if (readSize <= 0 || readSize > tree.second->GetEntries())
+      readSize = tree.second->GetEntries();
+    numEntries = readSize;
+    if (numEntries) {
+      EntryReader reader(tree.second);
+      numParticles = reader.numParticles(0);
+    }
+  }
 
-  if (readSize <= 0 || readSize > fTree->GetEntries())
-    readSize = fTree->GetEntries();
+  // Each thread opens the file and reads a contiguous range of entries into
+  // the preallocated columns. TTree objects can not be shared between
+  // threads.
+  std::size_t numThreads = ThreadPool::instance().numThreads();
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 8, 0)
+  if (numThreads > 1)
+    ROOT::EnableThreadSafety();
+#else
+  numThreads = 1;
+#endif
+  std::size_t n = numEntries;
+  std::size_t grain = std::max<std::size_t>(
+      MinEntriesPerThread, (n + numThreads - 1) / numThreads);
+  // The particle table is loaded on first use, which is not thread-safe
+  TDatabasePDG::Instance()->GetParticle(211);
 
-  for (unsigned int evt = 0; evt < readSize; evt++) {
-    Event tmp;
-    fParticles->Clear();
-    fTree->GetEntry(evt);
+  Events = EventCollection(numParticles);
+  Events.resize(n);
+  std::vector<double> maxWeights((n + grain - 1) / grain, 0.);
+  ThreadPool::instance().parallelFor(
+      n,
+      [&](std::size_t begin, std::size_t end) {
+        auto tree = openTree(fileName, treeName);
+        EntryReader reader(tree.second);
+        double &maxWeight = maxWeights[begin / grain];
+        for (std::size_t evt = begin; evt < end; evt++)
+          maxWeight = std::max(maxWeight, reader.read(evt, Events, evt));
+      },
+      grain);
 
-    // Get number of particle in TClonesrray
-    unsigned int nParts = fParticles->GetEntriesFast();
+  for (auto w : maxWeights)
+    if (w > MaximumWeight)
+      MaximumWeight = w;
 
-    TParticle *partN;
-    TLorentzVector inN;
-    for (unsigned int part = 0; part < nParts; part++) {
-      partN = 0;
-      partN = (TParticle *)fParticles->At(part);
-      if (!partN)
-        continue;
-      partN->Momentum(inN);
-      int charge = partN->GetPDG()->Charge();
-      if (charge != 0)
-        charge /= std::fabs(charge);
-      tmp.addParticle(Particle(inN.X(), inN.Y(), inN.Z(), inN.E(),
-                               partN->GetPdgCode(), charge));
-    } // particle loop
-    tmp.setWeight(feventWeight);
-    tmp.setCharge(fCharge);
-    tmp.setEfficiency(feventEff);
-
-    Events.push_back(tmp);
-    if (feventWeight > MaximumWeight)
-      MaximumWeight = feventWeight;
-  } // end event loop
+  LOG(DEBUG) << "RootReader::read() | Read " << numEntries
+             << " events from " << fileName << " using " << maxWeights.size()
+             << " ranges.";
 }
 
 void RootReader::writeData(std::string fileName, std::string treeName) {
@@ -118,7 +282,7 @@ void RootReader::writeData(std::string fileName, std::string treeName) {
   int fFlavour;
 
   TTree *fTree = new TTree(treeName.c_str(), treeName.c_str());
-  unsigned int numPart = Events.at(0).numParticles();
+  unsigned int numPart = Events.numParticles();
   fParticles = new TClonesArray("TParticle", numPart);
   fTree->Branch("Particles", &fParticles);
   fTree->Branch("weight", &feventWeight, "weight/D");
@@ -127,16 +291,16 @@ void RootReader::writeData(std::string fileName, std::string treeName) {
   fTree->Branch("flavour", &fFlavour, "flavour/I");
   TClonesArray &partArray = *fParticles;
 
-  auto it = Events.begin();
-  for (; it != Events.end(); ++it) {
+  for (std::size_t evt = 0; evt < Events.size(); ++evt) {
+    Event ev = Events.event(evt);
     fParticles->Clear();
-    feventWeight = (*it).weight();
-    fCharge = (*it).charge();
-    feventEff = (*it).efficiency();
+    feventWeight = ev.weight();
+    fCharge = ev.charge();
+    feventEff = ev.efficiency();
 
-    TLorentzVector motherMomentum(0, 0, 0, (*it).cmsEnergy());
+    TLorentzVector motherMomentum(0, 0, 0, ev.cmsEnergy());
     for (unsigned int i = 0; i < numPart; i++) {
-      Particle oldParticle = (*it).particle(i);
+      Particle oldParticle = ev.particle(i);
       TLorentzVector oldMomentum(oldParticle.px(), oldParticle.py(),
                                  oldParticle.pz(), oldParticle.e());
       new (partArray[i]) TParticle(oldParticle.pid(), 1, 0, 0, 0, 0,
@@ -35,6 +35,11 @@ namespace DataReader {
 /// This class reads event-based data from root-files. It implements the
 /// interface of Data.hpp.
 ///
+/// Files are read in parallel on the ThreadPool (requires ROOT 6.08 or
+/// newer). Each thread opens the file and reads a contiguous range of
+/// entries directly into the EventCollection. Only the branches that are
+/// needed to fill the events are read.
+///
 class RootReader : public Data {
 
 public:
@@ -63,9 +68,14 @@ public:
   virtual void writeData(std::string file = "", std::string trName = "");
 
 protected:
-  /// Open ROOT file and set branch addresses to TTree
+  /// Read \p readSize entries of \p tr (all if \p readSize is negative)
   void read(TTree* tr, double readSize = -1);
 
+  /// Read \p readSize entries of tree \p treeName in file \p fileName
+  /// (all if \p readSize is negative). The entries are read in parallel.
+  void read(const std::string &fileName, const std::string &treeName,
+            double readSize = -1);
+
 };
 
 } // namespace DataReader
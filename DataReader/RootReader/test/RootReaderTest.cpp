@@ -2,6 +2,8 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <string>
@@ -11,6 +13,7 @@
 #define BOOST_TEST_MODULE Number
 #include <boost/test/unit_test.hpp>
 
+#include "Core/ThreadPool.hpp"
 #include "DataReader/RootReader/RootReader.hpp"
 #include "Tools/Generate.hpp"
 #include "Tools/RootGenerator.hpp"
@@ -42,6 +45,57 @@ BOOST_AUTO_TEST_CASE(WriteReadCheck) {
   std::remove("RootReaderTest-output.root"); // delete file
 }
 
+/// Compare parallel and serial reading of a file and print the time that is
+/// needed by both. Larger files can be created with createRootTTree.C.
+BOOST_AUTO_TEST_CASE(ParallelRead) {
+  ComPWA::Logging log("", "info");
+
+  std::shared_ptr<ComPWA::Generator> gen(
+      new ComPWA::Tools::RootGenerator(1.864, 0.5, 0.5, 0.5, 173));
+  std::shared_ptr<ComPWA::DataReader::Data> sample(
+      new ComPWA::DataReader::RootReader());
+  ComPWA::Tools::generatePhsp(120000, gen, sample);
+  sample->writeData("RootReaderTest-parallel.root", "trtr");
+
+  auto &pool = ComPWA::ThreadPool::instance();
+  unsigned int numThreads = pool.numThreads();
+  std::vector<std::shared_ptr<RootReader>> samples;
+  for (unsigned int n : {1, 4}) {
+    pool.setNumThreads(n);
+    auto start = std::chrono::steady_clock::now();
+    samples.push_back(
+        std::make_shared<RootReader>("RootReaderTest-parallel.root", "trtr"));
+    std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+    LOG(INFO) << "RootReaderTest::ParallelRead() | " << n
+              << " thread(s): " << time.count() << " s";
+  }
+  pool.setNumThreads(numThreads);
+
+  const EventCollection &serial = samples.at(0)->events();
+  const EventCollection &parallel = samples.at(1)->events();
+  BOOST_REQUIRE_EQUAL(serial.size(), sample->numEvents());
+  BOOST_REQUIRE_EQUAL(parallel.size(), serial.size());
+  BOOST_REQUIRE_EQUAL(parallel.numParticles(), serial.numParticles());
+  BOOST_CHECK(std::equal(serial.weights(), serial.weights() + serial.size(),
+                         parallel.weights()));
+  BOOST_CHECK(std::equal(serial.efficiencies(),
+                         serial.efficiencies() + serial.size(),
+                         parallel.efficiencies()));
+  for (std::size_t j = 0; j < serial.numParticles(); ++j) {
+    BOOST_CHECK(std::equal(serial.px(j), serial.px(j) + serial.size(),
+                           parallel.px(j)));
+    BOOST_CHECK(std::equal(serial.e(j), serial.e(j) + serial.size(),
+                           parallel.e(j)));
+    BOOST_CHECK(std::equal(serial.px(j), serial.px(j) + serial.size(),
+                           sample->events().px(j)));
+  }
+  BOOST_CHECK_EQUAL(samples.at(1)->maximumWeight(),
+                    samples.at(0)->maximumWeight());
+
+  std::remove("RootReaderTest-parallel.root");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
 } // namespace DataReader
@@ -0,0 +1,262 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <unistd.h>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "Core/ThreadPool.hpp"
+#include "DataReader/VariableCache.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::DataReader;
+
+namespace {
+
+/// Header of a cache file. The size of the header is a multiple of 8 bytes
+/// so that the columns are aligned.
+struct Header {
+  char Magic[8];
+  std::uint64_t Version;
+  std::uint64_t Key;
+  std::uint64_t NumEvents;
+  std::uint64_t NumVariables;
+  /// Test value to detect files written on a machine with different byte
+  /// order or floating point format
+  double Check;
+  std::uint64_t Reserved[2];
+};
+
+const char Magic[8] = {'C', 'o', 'm', 'P', 'W', 'A', 'V', 'C'};
+
+const std::uint64_t Version = 1;
+
+const double Check = 1.0 / 3.0;
+
+/// Number of values per chunk of the parallel hash calculation
+const std::size_t HashChunkSize = 65536;
+
+std::uint64_t mix(std::uint64_t h, std::uint64_t w) {
+  h ^= w + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  return h * 0x100000001b3ULL;
+}
+
+std::uint64_t hashString(std::uint64_t h, const std::string &s) {
+  for (char c : s)
+    h = mix(h, static_cast<unsigned char>(c));
+  return h;
+}
+
+/// Hash of \p n doubles. Chunks are hashed in parallel and the hashes of the
+/// chunks are combined in a fixed order.
+std::uint64_t hashColumn(const double *values, std::size_t n) {
+  std::size_t nChunks = (n + HashChunkSize - 1) / HashChunkSize;
+  std::vector<std::uint64_t> chunkHashes(nChunks);
+  ThreadPool::instance().parallelFor(
+      n,
+      [&](std::size_t begin, std::size_t end) {
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        for (std::size_t i = begin; i < end; ++i) {
+          std::uint64_t w;
+          std::memcpy(&w, &values[i], sizeof(w));
+          h = mix(h, w);
+        }
+        chunkHashes[begin / HashChunkSize] = h;
+      },
+      HashChunkSize);
+
+  std::uint64_t h = mix(0xcbf29ce484222325ULL, n);
+  for (auto c : chunkHashes)
+    h = mix(h, c);
+  return h;
+}
+
+} // namespace
+
+CachedVariables::CachedVariables(const std::string &fileName)
+    : File(fileName, true), Key(0), NumEvents(0), NumVariables(0),
+      Columns(nullptr), Mask(nullptr) {
+  if (File.size() < sizeof(Header))
+    throw BadConfig("CachedVariables::CachedVariables() | File " + fileName +
+                    " is too small!");
+  Header header;
+  std::memcpy(&header, File.data(), sizeof(Header));
+  if (std::memcmp(header.Magic, Magic, sizeof(Magic)) ||
+      header.Version != Version || header.Check != Check)
+    throw BadConfig("CachedVariables::CachedVariables() | File " + fileName +
+                    " is not a valid cache file!");
+
+  Key = header.Key;
+  NumEvents = header.NumEvents;
+  NumVariables = header.NumVariables;
+  std::size_t expected = sizeof(Header) +
+                         NumVariables * NumEvents * sizeof(double) + NumEvents;
+  if (File.size() != expected)
+    throw BadConfig("CachedVariables::CachedVariables() | Size of file " +
+                    fileName + " does not match its header!");
+
+  Columns = reinterpret_cast<double *>(File.data() + sizeof(Header));
+  Mask = File.data() + sizeof(Header) +
+         NumVariables * NumEvents * sizeof(double);
+}
+
+EventColumn<double> CachedVariables::variable(std::size_t k) {
+  EventColumn<double> column;
+  column.setExternal(Columns + k * NumEvents, NumEvents, shared_from_this());
+  return column;
+}
+
+EventColumn<char> CachedVariables::maskColumn() {
+  EventColumn<char> column;
+  column.setExternal(Mask, NumEvents, shared_from_this());
+  return column;
+}
+
+void CachedVariables::write(const std::string &fileName, std::uint64_t key,
+                            const std::vector<std::vector<double>> &values,
+                            const std::vector<char> &mask) {
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.Magic, Magic, sizeof(Magic));
+  header.Version = Version;
+  header.Key = key;
+  header.NumEvents = mask.size();
+  header.NumVariables = values.size();
+  header.Check = Check;
+  for (auto const &v : values)
+    if (v.size() != mask.size())
+      throw BadParameter("CachedVariables::write() | Columns have different "
+                         "sizes!");
+
+  std::string tmpName = fileName + ".tmp" + std::to_string(getpid());
+  std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+  if (!out)
+    throw BadConfig("CachedVariables::write() | Can not open " + tmpName);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+  for (auto const &v : values)
+    out.write(reinterpret_cast<const char *>(v.data()),
+              v.size() * sizeof(double));
+  out.write(mask.data(), mask.size());
+  out.close();
+  if (!out || std::rename(tmpName.c_str(), fileName.c_str())) {
+    std::remove(tmpName.c_str());
+    throw BadConfig("CachedVariables::write() | Can not write " + fileName);
+  }
+}
+
+VariableCache::VariableCache(const std::string &directory)
+    : Directory(directory) {}
+
+std::uint64_t VariableCache::key(const EventCollection &events) {
+  std::uint64_t h = mix(0xcbf29ce484222325ULL, events.size());
+  h = mix(h, events.numParticles());
+  for (std::size_t j = 0; j < events.numParticles(); ++j) {
+    h = mix(h, hashColumn(events.px(j), events.size()));
+    h = mix(h, hashColumn(events.py(j), events.size()));
+    h = mix(h, hashColumn(events.pz(j), events.size()));
+    h = mix(h, hashColumn(events.e(j), events.size()));
+  }
+  return h;
+}
+
+std::uint64_t VariableCache::key(std::uint64_t eventsKey,
+                                 const Kinematics &kin) {
+  return mix(hashString(0xcbf29ce484222325ULL, kin.configuration()),
+             eventsKey);
+}
+
+std::string VariableCache::fileName(std::uint64_t key) const {
+  std::stringstream stream;
+  stream << Directory << "/ComPWA_Variables_" << std::hex << std::setfill('0')
+         << std::setw(16) << key << ".bin";
+  return stream.str();
+}
+
+std::shared_ptr<CachedVariables>
+VariableCache::load(const EventCollection &events,
+                    const Kinematics &kin) const {
+  return load(key(events, kin), events.size(), kin.numVariables());
+}
+
+std::shared_ptr<CachedVariables>
+VariableCache::load(std::uint64_t key, std::size_t numEvents,
+                    std::size_t numVariables) const {
+  std::string name = fileName(key);
+  if (access(name.c_str(), R_OK) != 0)
+    return std::shared_ptr<CachedVariables>();
+
+  std::shared_ptr<CachedVariables> cached;
+  try {
+    cached = std::make_shared<CachedVariables>(name);
+  } catch (BadConfig &ex) {
+    LOG(ERROR) << "VariableCache::load() | " << ex.what();
+    return std::shared_ptr<CachedVariables>();
+  }
+  if (cached->key() != key || cached->numEvents() != numEvents ||
+      cached->numVariables() != numVariables) {
+    LOG(ERROR) << "VariableCache::load() | Cache file " << name
+               << " does not match the sample!";
+    return std::shared_ptr<CachedVariables>();
+  }
+  return cached;
+}
+
+std::shared_ptr<CachedVariables>
+VariableCache::variables(const EventCollection &events,
+                         const Kinematics &kin) const {
+  std::uint64_t k = key(events, kin);
+  auto cached = load(k, events.size(), kin.numVariables());
+  if (cached)
+    return cached;
+
+  std::vector<std::vector<double>> values;
+  std::vector<char> mask;
+  kin.convert(events, 0, events.size(), values, mask);
+  try {
+    CachedVariables::write(fileName(k), k, values, mask);
+  } catch (BadConfig &ex) {
+    LOG(ERROR) << "VariableCache::variables() | " << ex.what();
+    return std::shared_ptr<CachedVariables>();
+  }
+  return load(k, events.size(), kin.numVariables());
+}
+
+void VariableCache::convert(const EventCollection &events,
+                            std::uint64_t eventsKey, const Kinematics &kin,
+                            std::vector<EventColumn<double>> &values,
+                            EventColumn<char> &mask) const {
+  std::uint64_t k = key(eventsKey, kin);
+  auto cached = load(k, events.size(), kin.numVariables());
+  values.clear();
+  if (cached) {
+    LOG(INFO) << "VariableCache::convert() | Reading variables of "
+              << events.size() << " events from cache.";
+    for (std::size_t i = 0; i < cached->numVariables(); ++i)
+      values.push_back(cached->variable(i));
+    mask = cached->maskColumn();
+    return;
+  }
+
+  std::vector<std::vector<double>> converted;
+  std::vector<char> convertedMask;
+  kin.convert(events, 0, events.size(), converted, convertedMask);
+  std::string name = fileName(k);
+  try {
+    CachedVariables::write(name, k, converted, convertedMask);
+    LOG(INFO) << "VariableCache::convert() | Variables of " << events.size()
+              << " events written to " << name << ".";
+  } catch (BadConfig &ex) {
+    // The result is correct even if the cache can not be written
+    LOG(ERROR) << "VariableCache::convert() | " << ex.what();
+  }
+  for (auto &column : converted)
+    values.push_back(EventColumn<double>(std::move(column)));
+  mask = EventColumn<char>(std::move(convertedMask));
+}
@@ -0,0 +1,157 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// On-disk cache of kinematic variables.
+///
+
+#ifndef DATAREADER_VARIABLECACHE_HPP_
+#define DATAREADER_VARIABLECACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/EventCollection.hpp"
+#include "Core/Kinematics.hpp"
+#include "Core/MemoryMappedFile.hpp"
+
+namespace ComPWA {
+namespace DataReader {
+
+///
+/// \class CachedVariables
+/// Memory-mapped cache file of kinematic variables. The file contains a
+/// header, one column of doubles per variable and the phase space mask (see
+/// Kinematics::convert()). The columns are accessed without copying. The file
+/// is mapped copy-on-write, modifications of the columns are not written to
+/// the file.
+///
+class CachedVariables
+    : public std::enable_shared_from_this<CachedVariables> {
+public:
+  /// Map \p fileName. Throws BadConfig if the file is not a valid cache file.
+  CachedVariables(const std::string &fileName);
+
+  /// Key of the cached sample, see VariableCache::key()
+  std::uint64_t key() const { return Key; }
+
+  std::size_t numEvents() const { return NumEvents; }
+
+  std::size_t numVariables() const { return NumVariables; }
+
+  /// Variable \p k of all events
+  const double *column(std::size_t k) const { return Columns + k * NumEvents; }
+
+  /// Phase space mask of all events
+  const char *mask() const { return Mask; }
+
+  /// View of variable \p k of all events. The view keeps the file mapped,
+  /// therefore the object has to be owned by a std::shared_ptr.
+  EventColumn<double> variable(std::size_t k);
+
+  /// View of the phase space mask, see variable()
+  EventColumn<char> maskColumn();
+
+  /// Write \p values and \p mask to \p fileName. The file is written to a
+  /// temporary file first and renamed afterwards, therefore other processes
+  /// never read an incomplete file.
+  static void write(const std::string &fileName, std::uint64_t key,
+                    const std::vector<std::vector<double>> &values,
+                    const std::vector<char> &mask);
+
+private:
+  MemoryMappedFile File;
+
+  std::uint64_t Key;
+
+  std::size_t NumEvents;
+
+  std::size_t NumVariables;
+
+  double *Columns;
+
+  char *Mask;
+};
+
+///
+/// \class VariableCache
+/// Cache of converted kinematic variables in a directory. The conversion of
+/// large samples to kinematic variables takes a long time and has to be
+/// repeated at each start of a fit. The cache stores the converted variables
+/// in one file per sample. The files are identified by a hash of the
+/// momenta of the sample and of the Kinematics::configuration(). A repeated
+/// conversion of the same sample with the same kinematics reads the
+/// variables from the memory-mapped file.
+///
+class VariableCache {
+public:
+  /// Cache files are stored in \p directory, which has to exist.
+  VariableCache(const std::string &directory);
+
+  virtual ~VariableCache() {}
+
+  /// Hash of the four momenta of \p events. The hash is calculated in
+  /// parallel, the result does not depend on the number of threads.
+  static std::uint64_t key(const EventCollection &events);
+
+  /// Key of a sample with hash \p eventsKey (see above) and the
+  /// configuration of \p kin
+  static std::uint64_t key(std::uint64_t eventsKey, const Kinematics &kin);
+
+  /// Key of \p events and the configuration of \p kin
+  static std::uint64_t key(const EventCollection &events,
+                           const Kinematics &kin) {
+    return key(key(events), kin);
+  }
+
+  /// Name of the cache file for \p key
+  virtual std::string fileName(std::uint64_t key) const;
+
+  /// Load the variables of \p events from the cache. A null pointer is
+  /// returned if no valid cache file exists.
+  virtual std::shared_ptr<CachedVariables> load(const EventCollection &events,
+                                                const Kinematics &kin) const;
+
+  /// Mapped cache file of \p events. If no file exists, the events are
+  /// converted and written to the cache first. A null pointer is returned if
+  /// the file can not be written.
+  virtual std::shared_ptr<CachedVariables>
+  variables(const EventCollection &events, const Kinematics &kin) const;
+
+  /// Convert all \p events to \p values and \p mask (see
+  /// Kinematics::convert()). If a cache file exists, \p values and \p mask
+  /// are views of the mapped file and nothing is copied. Otherwise the events
+  /// are converted and the result is stored in the cache.
+  virtual void convert(const EventCollection &events, const Kinematics &kin,
+                       std::vector<EventColumn<double>> &values,
+                       EventColumn<char> &mask) const {
+    convert(events, key(events), kin, values, mask);
+  }
+
+  /// Same as above for events with a known hash \p eventsKey, see key().
+  /// Users that convert the same sample several times store the hash so that
+  /// the events are hashed only once.
+  virtual void convert(const EventCollection &events, std::uint64_t eventsKey,
+                       const Kinematics &kin,
+                       std::vector<EventColumn<double>> &values,
+                       EventColumn<char> &mask) const;
+
+protected:
+  /// Load the cache file for \p key. A null pointer is returned if the file
+  /// does not exist or does not match \p numEvents and \p numVariables.
+  virtual std::shared_ptr<CachedVariables>
+  load(std::uint64_t key, std::size_t numEvents,
+       std::size_t numVariables) const;
+
+  std::string Directory;
+};
+
+} // namespace DataReader
+} // namespace ComPWA
+
+#endif
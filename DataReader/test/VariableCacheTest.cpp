@@ -0,0 +1,206 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the on-disk cache of kinematic variables.
+///
+
+#define BOOST_TEST_MODULE DataReader
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Kinematics.hpp"
+#include "Core/Logging.hpp"
+#include "DataReader/Data.hpp"
+#include "DataReader/VariableCache.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::DataReader;
+
+BOOST_AUTO_TEST_SUITE(VariableCacheTest);
+
+/// Invariant masses squared of the particle pairs (0,1) and (1,2). Counts the
+/// number of sample conversions.
+class PairKinematics : public Kinematics {
+public:
+  PairKinematics(double maxMassSq)
+      : Kinematics({0}, {1, 2, 3}), MaxMassSq(maxMassSq), NumConversions(0) {
+    VariableNames = {"mSq01", "mSq12"};
+  }
+
+  using Kinematics::convert;
+
+  void convert(const Event &ev, DataPoint &point) const {
+    double mSq01 =
+        (ev.particle(0).fourMomentum() + ev.particle(1).fourMomentum())
+            .invMassSq();
+    double mSq12 =
+        (ev.particle(1).fourMomentum() + ev.particle(2).fourMomentum())
+            .invMassSq();
+    if (mSq01 > MaxMassSq)
+      throw BeyondPhsp("PairKinematics::convert() | Beyond phsp!");
+    point.values().push_back(mSq01);
+    point.values().push_back(mSq12);
+  }
+
+  void convert(const EventCollection &events, std::size_t begin,
+               std::size_t end, std::vector<std::vector<double>> &values,
+               std::vector<char> &mask) const {
+    ++NumConversions;
+    Kinematics::convert(events, begin, end, values, mask);
+  }
+
+  std::string configuration() const {
+    return Kinematics::configuration() + std::to_string(MaxMassSq);
+  }
+
+  bool isWithinPhsp(const DataPoint &point) const { return true; }
+
+  unsigned int getDataID(const SubSystem &sys) const { return 0; }
+
+  double MaxMassSq;
+
+  mutable int NumConversions;
+
+protected:
+  double calculatePhspVolume() const { return 1.; }
+};
+
+std::shared_ptr<Data> sample(std::size_t n) {
+  auto data = std::make_shared<Data>();
+  for (std::size_t i = 0; i < n; ++i) {
+    Event ev;
+    ev.addParticle(Particle(0.01 * (i % 17), 0.1, 0.2, 1.0));
+    ev.addParticle(Particle(-0.1, 0.02 * (i % 11), 0.3, 1.5));
+    ev.addParticle(Particle(0.3, -0.2, 0.001 * i, 2.0));
+    data->add(ev);
+  }
+  return data;
+}
+
+struct TemporaryDirectory {
+  TemporaryDirectory() {
+    char name[] = "VariableCacheTest-XXXXXX";
+    if (!mkdtemp(name))
+      throw std::runtime_error("Can not create temporary directory!");
+    Name = name;
+  }
+  ~TemporaryDirectory() {
+    std::system(("rm -rf " + Name).c_str());
+  }
+  std::string Name;
+};
+
+BOOST_AUTO_TEST_CASE(CacheHit) {
+  ComPWA::Logging log("", "info");
+  TemporaryDirectory dir;
+  auto cache = std::make_shared<VariableCache>(dir.Name);
+  auto kin = std::make_shared<PairKinematics>(5.95);
+
+  auto reference = sample(10000);
+  const DataPointSet &refPoints = *reference->dataPoints(kin);
+  BOOST_CHECK_EQUAL(kin->NumConversions, 1);
+  BOOST_CHECK(refPoints.size() < reference->numEvents());
+
+  auto data = sample(10000);
+  data->setVariableCache(cache);
+  auto points = data->dataPoints(kin);
+  BOOST_CHECK_EQUAL(kin->NumConversions, 2);
+  std::string file = cache->fileName(VariableCache::key(data->events(), *kin));
+  BOOST_CHECK_EQUAL(access(file.c_str(), R_OK), 0);
+
+  // The second sample is read from the cache
+  auto other = sample(10000);
+  other->setVariableCache(cache);
+  const DataPointSet &cachedPoints = *other->dataPoints(kin);
+  ParameterList list = other->dataList(kin);
+  BOOST_CHECK_EQUAL(kin->NumConversions, 2);
+  // Both layouts share the same storage
+  BOOST_CHECK_EQUAL(list.mDoubleValue(0)->values().data(),
+                    cachedPoints.column(0));
+  BOOST_CHECK_EQUAL(other->dataPoints(kin).get(), &cachedPoints);
+  BOOST_REQUIRE_EQUAL(cachedPoints.size(), refPoints.size());
+  for (std::size_t i = 0; i < refPoints.size(); ++i) {
+    BOOST_CHECK(cachedPoints[i].values() == refPoints[i].values());
+    BOOST_CHECK_EQUAL(list.mDoubleValue(0)->values().at(i),
+                      refPoints[i].value(0));
+  }
+
+  auto mapped = cache->load(other->events(), *kin);
+  BOOST_REQUIRE(mapped);
+  BOOST_CHECK_EQUAL(mapped->numEvents(), 10000);
+  BOOST_CHECK_EQUAL(mapped->numVariables(), 2);
+
+  // Different momenta or kinematics result in a different key
+  std::uint64_t key = VariableCache::key(other->events(), *kin);
+  other->events().px(1)[5000] += 1e-12;
+  BOOST_CHECK(VariableCache::key(other->events(), *kin) != key);
+  BOOST_CHECK(!cache->load(other->events(), *kin));
+  PairKinematics kin2(6.);
+  BOOST_CHECK(VariableCache::key(data->events(), kin2) != key);
+}
+
+/// Compare the columns \p a and mask \p aMask with \p b and \p bMask
+void checkEqual(const std::vector<EventColumn<double>> &a,
+                const EventColumn<char> &aMask,
+                const std::vector<EventColumn<double>> &b,
+                const EventColumn<char> &bMask) {
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  BOOST_REQUIRE_EQUAL(aMask.size(), bMask.size());
+  for (std::size_t i = 0; i < aMask.size(); ++i)
+    BOOST_CHECK_EQUAL(aMask[i], bMask[i]);
+  for (std::size_t k = 0; k < a.size(); ++k) {
+    BOOST_REQUIRE_EQUAL(a[k].size(), b[k].size());
+    for (std::size_t i = 0; i < a[k].size(); ++i)
+      BOOST_CHECK_EQUAL(a[k][i], b[k][i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(InvalidFile) {
+  TemporaryDirectory dir;
+  VariableCache cache(dir.Name);
+  PairKinematics kin(5.95);
+  auto data = sample(1000);
+
+  std::vector<EventColumn<double>> values, cached;
+  EventColumn<char> mask, cachedMask;
+  cache.convert(data->events(), kin, values, mask);
+  BOOST_CHECK_EQUAL(kin.NumConversions, 1);
+  BOOST_CHECK(!mask.external());
+
+  // Truncated file is ignored and replaced
+  std::string file = cache.fileName(VariableCache::key(data->events(), kin));
+  BOOST_CHECK_EQUAL(truncate(file.c_str(), 100), 0);
+  BOOST_CHECK(!cache.load(data->events(), kin));
+  BOOST_CHECK_THROW(CachedVariables c(file), BadConfig);
+  cache.convert(data->events(), kin, cached, cachedMask);
+  BOOST_CHECK_EQUAL(kin.NumConversions, 2);
+  checkEqual(cached, cachedMask, values, mask);
+
+  // The columns are views of the cache file
+  std::uint64_t eventsKey = VariableCache::key(data->events());
+  cache.convert(data->events(), eventsKey, kin, cached, cachedMask);
+  BOOST_CHECK_EQUAL(kin.NumConversions, 2);
+  BOOST_CHECK(cachedMask.external());
+  for (auto const &column : cached)
+    BOOST_CHECK(column.external());
+  checkEqual(cached, cachedMask, values, mask);
+
+  // The views keep the file mapped
+  BOOST_CHECK_EQUAL(std::remove(file.c_str()), 0);
+  checkEqual(cached, cachedMask, values, mask);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
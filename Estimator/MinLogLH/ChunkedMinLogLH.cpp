@@ -0,0 +1,239 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Core/AmpIntensity.hpp"
+#include "Core/Exceptions.hpp"
+#include "Core/FunctionTree.hpp"
+#include "Core/Kinematics.hpp"
+#include "Core/Logging.hpp"
+#include "Core/Summation.hpp"
+#include "DataReader/EventStream.hpp"
+#include "DataReader/VariableCache.hpp"
+#include "Estimator/MinLogLH/ChunkedMinLogLH.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Estimator;
+
+ChunkedMinLogLH::ChunkedMinLogLH(
+    std::shared_ptr<Kinematics> kin, std::shared_ptr<AmpIntensity> intens,
+    std::shared_ptr<DataReader::EventStream> data,
+    std::shared_ptr<DataReader::EventStream> phsp, std::size_t chunkSize)
+    : Kin(kin), Intens(intens), DataStream(data), PhspStream(phsp),
+      ChunkSize(chunkSize), NumCalls(0), NumEvents(0), SumOfWeights(0),
+      Normalization(1), NumPoints(0) {
+  if (!Kin || !Intens || !DataStream || !PhspStream)
+    throw BadParameter("ChunkedMinLogLH::ChunkedMinLogLH() | Kinematics, "
+                       "AmpIntensity and both event streams are required!");
+  setChunkSize(chunkSize);
+  Points = DataPointSet(Kin->numVariables());
+}
+
+void ChunkedMinLogLH::setChunkSize(std::size_t n) {
+  if (!n)
+    throw BadParameter("ChunkedMinLogLH::setChunkSize() | Chunk size has to "
+                       "be larger than zero!");
+  if (n != ChunkSize) {
+    DataChunks.clear();
+    PhspChunks.clear();
+    // The normalization sample and the tree depend on the chunk size
+    Points.clear();
+    NormPoints = DataPointSet();
+    IntensTree.reset();
+  }
+  ChunkSize = n;
+}
+
+double ChunkedMinLogLH::controlParameter(ParameterList &minPar) {
+  double sumLog = sum(*DataStream, DataChunks, true, NumEvents, SumOfWeights);
+  if (!NumEvents)
+    throw std::runtime_error("ChunkedMinLogLH::controlParameter() | Data "
+                             "stream contains no events within the phase "
+                             "space!");
+
+  std::size_t numPhsp;
+  double sumPhspWeights;
+  double sumPhsp =
+      sum(*PhspStream, PhspChunks, false, numPhsp, sumPhspWeights);
+  if (!numPhsp)
+    throw std::runtime_error("ChunkedMinLogLH::controlParameter() | Phase "
+                             "space stream contains no events within the "
+                             "phase space!");
+  Normalization = Kin->phspVolume() * sumPhsp / sumPhspWeights;
+
+  if (!NumCalls)
+    LOG(INFO) << "ChunkedMinLogLH::controlParameter() | Size of data sample = "
+              << NumEvents << " ( Sum of weights = " << SumOfWeights
+              << " ), size of phase space sample = " << numPhsp << ".";
+
+  double lh = (-1) * ((double)NumEvents) / SumOfWeights * sumLog +
+              NumEvents * std::log(Normalization);
+  NumCalls++;
+  return lh; // return -logLH
+}
+
+std::shared_ptr<FunctionTree> ChunkedMinLogLH::tree() {
+  if (!Intens->hasTree())
+    throw std::runtime_error("ChunkedMinLogLH::tree() | AmpIntensity does "
+                             "not provide a FunctionTree!");
+  if (!IntensTree) {
+    if (Points.empty())
+      Points.resize(ChunkSize);
+    iniTree();
+  }
+  return IntensTree;
+}
+
+void ChunkedMinLogLH::iniTree() {
+  LOG(DEBUG) << "ChunkedMinLogLH::iniTree() | Constructing FunctionTree for "
+             << Points.size() << " events!";
+  // The tree is first built while the data stream is read, the phase space
+  // stream is rewound before it is read
+  if (NormPoints.empty()) {
+    EventCollection first;
+    PhspStream->rewind();
+    PhspStream->next(first, ChunkSize);
+    std::vector<std::vector<double>> converted;
+    std::vector<char> mask;
+    Kin->convert(first, 0, first.size(), converted, mask);
+    NormPoints = DataPointSet(std::move(converted), mask, first.weights(),
+                              first.efficiencies());
+    if (NormPoints.empty())
+      throw std::runtime_error("ChunkedMinLogLH::iniTree() | First chunk of "
+                               "the phase space stream contains no events "
+                               "within the phase space!");
+  }
+  ParameterList normList = NormPoints.dataList();
+  IntensTree = Intens->tree(Kin, Points.dataList(), normList, normList,
+                            Kin->numVariables());
+  if (!IntensTree)
+    throw std::runtime_error("ChunkedMinLogLH::iniTree() | AmpIntensity does "
+                             "not provide a FunctionTree!");
+}
+
+double ChunkedMinLogLH::sum(
+    DataReader::EventStream &stream,
+    std::vector<std::shared_ptr<DataReader::CachedVariables>> &chunks,
+    bool logarithm, std::size_t &numEvents, double &sumOfWeights) {
+  // Partial sums of the chunks. They are combined at the end so that the
+  // result does not depend on the order of the additions within a chunk.
+  std::vector<double> sums, weights;
+  numEvents = 0;
+
+  stream.rewind();
+  for (std::size_t index = 0; stream.next(Chunk, ChunkSize); ++index) {
+    convertChunk(chunks, index);
+    if (!NumPoints)
+      continue;
+    numEvents += NumPoints;
+    const double *w = Points.weights();
+    const double *eff = Points.efficiencies();
+    weights.push_back(
+        Summation::sum<double>(NumPoints, [&](std::size_t i) { return w[i]; }));
+
+    if (Intens->hasTree()) {
+      if (!IntensTree)
+        iniTree();
+      auto values = std::dynamic_pointer_cast<Value<std::vector<double>>>(
+          IntensTree->parameter());
+      const double *t = values->values().data();
+      if (logarithm) {
+        sums.push_back(Summation::sum<double>(NumPoints, [&](std::size_t i) {
+          return std::log(t[i]) * w[i];
+        }));
+      } else {
+        sums.push_back(Summation::sum<double>(
+            NumPoints, [&](std::size_t i) { return t[i] * w[i] * eff[i]; }));
+      }
+      continue;
+    }
+
+    // The AmpIntensity updates its normalization on the first call. Further
+    // calls do not modify it and can be done in parallel.
+    Intens->intensity(Points.front());
+    if (logarithm) {
+      sums.push_back(Summation::sum<double>(NumPoints, [&](std::size_t i) {
+        return std::log(Intens->intensity(Points[i])) * w[i];
+      }));
+    } else {
+      sums.push_back(Summation::sum<double>(NumPoints, [&](std::size_t i) {
+        return Intens->intensity(Points[i]) * w[i] * eff[i];
+      }));
+    }
+  }
+  sumOfWeights = Summation::sum(weights);
+  return Summation::sum(sums);
+}
+
+void ChunkedMinLogLH::convertChunk(
+    std::vector<std::shared_ptr<DataReader::CachedVariables>> &chunks,
+    std::size_t index) {
+  if (Cache) {
+    if (chunks.size() <= index)
+      chunks.resize(index + 1);
+    auto &cached = chunks.at(index);
+    if (!cached || cached->numEvents() != Chunk.size())
+      cached = Cache->variables(Chunk, *Kin);
+    if (cached) {
+      std::vector<EventColumn<double>> values;
+      std::vector<const double *> columns;
+      for (std::size_t k = 0; k < cached->numVariables(); ++k)
+        values.push_back(cached->variable(k));
+      for (auto &column : values)
+        columns.push_back(column.data());
+      fillPoints(columns, cached->mask());
+      return;
+    }
+  }
+
+  std::vector<std::vector<double>> converted;
+  std::vector<char> mask;
+  Kin->convert(Chunk, 0, Chunk.size(), converted, mask);
+  std::vector<const double *> columns;
+  for (auto &column : converted)
+    columns.push_back(column.data());
+  fillPoints(columns, mask.data());
+}
+
+void ChunkedMinLogLH::fillPoints(const std::vector<const double *> &columns,
+                                 const char *mask) {
+  if (columns.size() != Points.numVariables())
+    throw BadParameter("ChunkedMinLogLH::fillPoints() | Number of variables "
+                       "does not match!");
+  if (Chunk.size() > Points.size()) {
+    Points.resize(Chunk.size());
+    IntensTree.reset();
+  }
+
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < Chunk.size(); ++i)
+    n += (mask[i] != 0);
+  NumPoints = n;
+
+  double *w = Points.weights();
+  double *eff = Points.efficiencies();
+  for (std::size_t k = 0; k < columns.size(); ++k) {
+    double *values = Points.column(k);
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < Chunk.size(); ++i)
+      if (mask[i])
+        values[j++] = columns[k][i];
+    // The points behind the events of the chunk are evaluated by the tree
+    // but not summed. They are set to a valid event.
+    std::fill(values + j, values + Points.size(), n ? values[0] : 0.);
+  }
+  std::size_t j = 0;
+  for (std::size_t i = 0; i < Chunk.size(); ++i) {
+    if (!mask[i])
+      continue;
+    w[j] = Chunk.weights()[i];
+    eff[j++] = Chunk.efficiencies()[i];
+  }
+  std::fill(w + j, w + Points.size(), 0.);
+  std::fill(eff + j, eff + Points.size(), 0.);
+  Points.modified();
+}
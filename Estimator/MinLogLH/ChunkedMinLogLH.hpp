@@ -0,0 +1,206 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Out-of-core negative log likelihood estimator.
+///
+
+#ifndef _CHUNKEDMINLOGLH_HPP
+#define _CHUNKEDMINLOGLH_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Core/DataPoint.hpp"
+#include "Core/DataPointSet.hpp"
+#include "Core/Estimator.hpp"
+#include "Core/EventCollection.hpp"
+
+namespace ComPWA {
+
+namespace DataReader {
+class CachedVariables;
+class EventStream;
+class VariableCache;
+}
+
+class AmpIntensity;
+class Kinematics;
+
+namespace Estimator {
+
+///
+/// \class ChunkedMinLogLH
+/// Negative log likelihood for samples that do not fit into memory. In
+/// contrast to MinLogLH the data and phase space samples are not stored.
+/// They are read from an DataReader::EventStream in chunks of a fixed number
+/// of events at each evaluation. Only one chunk is kept in memory at a time.
+///
+/// \par Log likelihood
+/// The AmpIntensity is normalized by the estimator:
+/// \f[
+///    -log \mathcal{L} = - \frac{N}{\sum_{ev} w_{ev}} \sum_{ev} w_{ev}
+///    \log T(ev) + N \log I, \quad
+///    I = V \frac{\sum_{ph} w_{ph} \epsilon_{ph} T(ph)}{\sum_{ph} w_{ph}}.
+/// \f]
+/// The sums over \f$ev\f$ and \f$ph\f$ run over the events of the data and
+/// the phase space stream that are within the phase space, \f$V\f$ is the
+/// phase space volume and \f$\epsilon\f$ the efficiency of the phase
+/// space events. The AmpIntensity should therefore be set up without phase
+/// space sample (see AmpIntensity::setPhspSample()). For an internally
+/// normalized AmpIntensity \f$I\f$ is a constant and does not change the
+/// minimum.
+///
+/// \par FunctionTree
+/// If the AmpIntensity provides a FunctionTree, the intensity of each chunk
+/// is evaluated by a tree (see tree()). The tree is built once and bound
+/// to a DataPointSet of chunk size. The set is refilled in place for each
+/// chunk of both streams and announces the new contents to the tree (see
+/// DataPointSet::modified()). Since the size of the tree is fixed, the
+/// set is padded with copies of the first event of the chunk, which are
+/// not summed. The tree of the AmpIntensity normalizes its components with
+/// the first chunk of the phase space stream, which is kept in memory in
+/// addition. Otherwise the AmpIntensity is evaluated per event. Per event
+/// quantities that an AmpIntensity stores per sample (e.g. by
+/// HelicityDecay::evaluateNoNorm()) are recalculated for each chunk in this
+/// case.
+///
+/// \par Multithreading
+/// The chunks are processed one after another. Conversion and evaluation
+/// of a chunk run in parallel on the ThreadPool. The sums of the chunks
+/// are calculated and combined via Summation::sum(), therefore the result
+/// depends on the chunk size but not on the number of threads.
+///
+/// \par Kinematic variables
+/// The events of each chunk are converted to kinematic variables at each
+/// evaluation. If a DataReader::VariableCache is set, the variables of each
+/// chunk are converted and written to the cache once. The estimator keeps
+/// the cache files of the chunks of both streams mapped. Later evaluations
+/// use the mapped variables and neither hash nor convert the chunks again.
+/// The streams must therefore not change between evaluations.
+///
+class ChunkedMinLogLH : public ComPWA::IEstimator {
+
+public:
+  ChunkedMinLogLH(std::shared_ptr<ComPWA::Kinematics> kin,
+                  std::shared_ptr<ComPWA::AmpIntensity> intens,
+                  std::shared_ptr<ComPWA::DataReader::EventStream> data,
+                  std::shared_ptr<ComPWA::DataReader::EventStream> phsp,
+                  std::size_t chunkSize = 1 << 20);
+
+  virtual ~ChunkedMinLogLH() {}
+
+  /// Value of the negative log likelihood. Both streams are read once.
+  virtual double controlParameter(ComPWA::ParameterList &par);
+
+  /// FunctionTree of the intensity of the events of the current chunk. A
+  /// tree that is built before the first evaluation is bound to a set of
+  /// chunkSize() events. Throws std::runtime_error if the AmpIntensity does
+  /// not provide a FunctionTree.
+  virtual std::shared_ptr<ComPWA::FunctionTree> tree();
+
+  /// Number of likelihood evaluations
+  virtual int status() const { return NumCalls; }
+
+  /// Number of events per chunk
+  virtual std::size_t chunkSize() const { return ChunkSize; }
+
+  virtual void setChunkSize(std::size_t n);
+
+  /// Read the kinematic variables of the chunks from \p cache. Chunks that
+  /// were already mapped are released.
+  virtual void
+  setVariableCache(std::shared_ptr<ComPWA::DataReader::VariableCache> cache) {
+    Cache = cache;
+    DataChunks.clear();
+    PhspChunks.clear();
+  }
+
+  /// Number of data events within the phase space. Available after the
+  /// first evaluation.
+  virtual std::size_t numEvents() const { return NumEvents; }
+
+  /// Sum of weights of the data events within the phase space. Available
+  /// after the first evaluation.
+  virtual double sumOfWeights() const { return SumOfWeights; }
+
+  /// Normalization integral I of the last evaluation
+  virtual double normalization() const { return Normalization; }
+
+protected:
+  /// Read \p stream in chunks and sum \f$w_{ev} \log T(ev)\f$ (\p logarithm
+  /// is true) or \f$w_{ev} \epsilon_{ev} T(ev)\f$. The number of events and
+  /// the sum of weights are stored in \p numEvents and \p sumOfWeights.
+  /// \p chunks are the cache files of the chunks of the stream.
+  virtual double sum(ComPWA::DataReader::EventStream &stream,
+                     std::vector<std::shared_ptr<DataReader::CachedVariables>>
+                         &chunks,
+                     bool logarithm, std::size_t &numEvents,
+                     double &sumOfWeights);
+
+  /// Convert the events of Chunk to the DataPoints of the chunk. Events
+  /// outside the phase space are skipped. If the cache is used, the cache
+  /// file of chunk \p index is taken from \p chunks or added to it.
+  virtual void
+  convertChunk(std::vector<std::shared_ptr<DataReader::CachedVariables>> &chunks,
+               std::size_t index);
+
+  /// Refill Points in place with the events of Chunk for which \p mask is
+  /// not zero. \p columns are the kinematic variables of Chunk. Points is
+  /// enlarged if the chunk does not fit, the tree is rebuilt in this case.
+  virtual void fillPoints(const std::vector<const double *> &columns,
+                          const char *mask);
+
+  /// Build the FunctionTree of the intensity of Points. The first chunk of
+  /// the phase space stream is read to NormPoints if necessary.
+  virtual void iniTree();
+
+  std::shared_ptr<ComPWA::Kinematics> Kin;
+
+  std::shared_ptr<ComPWA::AmpIntensity> Intens;
+
+  std::shared_ptr<ComPWA::DataReader::EventStream> DataStream;
+
+  std::shared_ptr<ComPWA::DataReader::EventStream> PhspStream;
+
+  std::shared_ptr<ComPWA::DataReader::VariableCache> Cache;
+
+  std::size_t ChunkSize;
+
+  int NumCalls;
+
+  std::size_t NumEvents;
+
+  double SumOfWeights;
+
+  double Normalization;
+
+  /// Cache files of the chunks of the data and the phase space stream
+  std::vector<std::shared_ptr<DataReader::CachedVariables>> DataChunks;
+
+  std::vector<std::shared_ptr<DataReader::CachedVariables>> PhspChunks;
+
+  /// Events of the current chunk. The collection is reused for all chunks.
+  ComPWA::EventCollection Chunk;
+
+  /// Variables of the current chunk. The set is reused for all chunks, the
+  /// first NumPoints points are the events within the phase space.
+  ComPWA::DataPointSet Points;
+
+  std::size_t NumPoints;
+
+  /// First chunk of the phase space stream, normalization sample of the
+  /// FunctionTree of the AmpIntensity
+  ComPWA::DataPointSet NormPoints;
+
+  /// FunctionTree of the intensity of Points
+  std::shared_ptr<ComPWA::FunctionTree> IntensTree;
+};
+
+} // namespace Estimator
+} // namespace ComPWA
+
+#endif
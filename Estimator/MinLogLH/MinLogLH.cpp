@@ -11,6 +11,7 @@
 #include "Core/FunctionTree.hpp"
 #include "Core/Kinematics.hpp"
 #include "Core/FitResult.hpp"
+#include "Core/Summation.hpp"
 
 using namespace ComPWA;
 using namespace ComPWA::Estimator;
@@ -25,7 +26,7 @@ MinLogLH::MinLogLH(std::shared_ptr<Kinematics> kin,
       _dataSample(data), PhspSample(phspSample), PhspAcceptedSample(accSample),
       PhspAcceptedSampleEff(1.0) {
 
-  int size = _dataSample->numEvents();
+  std::size_t size = _dataSample->numEvents();
 
   // use the full sample of both are zero
   if (!_nEvents && !_firstEvent) {
@@ -37,23 +38,26 @@ MinLogLH::MinLogLH(std::shared_ptr<Kinematics> kin,
   if (_firstEvent + _nEvents > size)
     _nEvents = size - _firstEvent;
 
-  // Get data as ParameterList
-  _dataSampleList = _dataSample->dataList(_kin);
-  PhspSampleList = PhspSample->dataList(_kin);
-  if (PhspAcceptedSample)
-    PhspAcceptedSampleList = PhspAcceptedSample->dataList(_kin);
-  else
-    PhspAcceptedSampleList = PhspSample->dataList(_kin);
-
-  // Calculation sum of weights of data sample
-  _sumOfWeights = 0;
-  for (unsigned int evt = _firstEvent; evt < _nEvents + _firstEvent; evt++) {
-    Event ev(_dataSample->event(evt));
-    _sumOfWeights += ev.weight();
+  // The samples are converted once and shared with the Data objects. The
+  // 'horizontal' lists refer to the same storage.
+  const EventCollection &events = _dataSample->events();
+  if (_firstEvent == 0 && _nEvents == size) {
+    DataPoints = _dataSample->dataPoints(_kin);
+  } else {
+    std::vector<std::vector<double>> values;
+    std::vector<char> mask;
+    _kin->convert(events, _firstEvent, _firstEvent + _nEvents, values, mask);
+    DataPoints = std::make_shared<DataPointSet>(
+        std::move(values), mask, events.weights() + _firstEvent,
+        events.efficiencies() + _firstEvent);
   }
+  // Calculation sum of weights of data sample
+  _sumOfWeights = Summation::sum<double>(
+      DataPoints->size(),
+      [&](std::size_t evt) { return DataPoints->weight(evt); });
 
-  LOG(INFO) << "MinLogLH::Init() |  Size of data sample = " << _nEvents
-            << " ( Sum of weights = " << _sumOfWeights << " ).";
+  LOG(INFO) << "MinLogLH::Init() |  Size of data sample = "
+            << DataPoints->size() << " ( Sum of weights = " << _sumOfWeights << " ).";
 
   _nCalls = 0; // member of ControlParameter
 
@@ -64,15 +68,17 @@ double MinLogLH::controlParameter(ParameterList &minPar) {
   double lh = 0;
   if (!_tree) {
     // Calculate \Sum_{ev} log()
-    double sumLog = 0;
-    // loop over data sample
-    for (unsigned int evt = _firstEvent; evt < _nEvents + _firstEvent; evt++) {
-      DataPoint point;
-      _kin->convert(_dataSample->event(evt), point);
-      double val = _intens->intensity(point);
-      sumLog += std::log(val) * point.weight();
-    }
-    lh = (-1) * ((double)_nEvents) / _sumOfWeights * sumLog;
+    // The AmpIntensity updates its normalization on the first call. Further
+    // calls do not modify it and can be done in parallel.
+    if (DataPoints->size())
+      _intens->intensity(DataPoints->front());
+
+    double sumLog =
+        Summation::sum<double>(DataPoints->size(), [&](std::size_t evt) {
+          const DataPoint &point = (*DataPoints)[evt];
+          return std::log(_intens->intensity(point)) * point.weight();
+        });
+    lh = (-1) * ((double)DataPoints->size()) / _sumOfWeights * sumLog;
   } else {
     auto logLH = std::dynamic_pointer_cast<Value<double>>(_tree->parameter());
     lh = logLH->value();
@@ -81,6 +87,13 @@ double MinLogLH::controlParameter(ParameterList &minPar) {
   return lh; // return -logLH
 }
 
+std::vector<double> MinLogLH::gradient(ParameterList &par) {
+  if (!_tree)
+    throw std::runtime_error("MinLogLH::gradient() | Gradient is only "
+                             "available if the FunctionTree is used!");
+  return _tree->gradient(par.doubleParameters());
+}
+
 void MinLogLH::UseFunctionTree(bool onoff) {
   if (onoff && _tree)
     return;     // Tree already exists
@@ -116,6 +129,14 @@ void MinLogLH::IniLHtree() {
     throw std::runtime_error("MinLogLH::IniLHtree() |  AmpIntensity does not "
                              "provide a FunctionTree!");
 
+  // The 'horizontal' lists require samples in double precision
+  _dataSampleList = DataPoints->dataList();
+  PhspSampleList = PhspSample->dataList(_kin);
+  if (PhspAcceptedSample)
+    PhspAcceptedSampleList = PhspAcceptedSample->dataList(_kin);
+  else
+    PhspAcceptedSampleList = PhspSample->dataList(_kin);
+
   _tree = std::make_shared<FunctionTree>(
       "LH", std::make_shared<Value<double>>(),
       std::make_shared<MultAll>(ParType::DOUBLE));
@@ -13,6 +13,8 @@
 #include <memory>
 #include <string>
 
+#include "Core/DataPoint.hpp"
+#include "Core/DataPointSet.hpp"
 #include "Core/Estimator.hpp"
 
 namespace ComPWA {
@@ -54,6 +56,14 @@ namespace Estimator {
 /// provided to which the efficiency is applied. That means that accSample
 /// has passed reconstruction and selection.
 ///
+/// \par Multithreading
+/// If no FunctionTree is used, the events are processed in parallel on the
+/// ThreadPool. The sum over events is calculated via Summation::sum().
+/// Therefore, the result does not depend on the number of threads and the
+/// summation algorithm can be selected at runtime. AmpIntensity::intensity() is called
+/// for the first event before the parallel loop so that the AmpIntensity can
+/// update its cached normalization.
+///
 class MinLogLH : public ComPWA::IEstimator {
 
 public:
@@ -70,6 +80,13 @@ public:
   /// Value of minimum log likelhood function.
   virtual double controlParameter(ComPWA::ParameterList &par);
 
+  /// The gradient is available if the FunctionTree is used
+  virtual bool hasGradient() const { return bool(_tree); }
+
+  /// Derivatives of the minimum log likelihood function. The derivatives are
+  /// calculated via FunctionTree::gradient().
+  virtual std::vector<double> gradient(ComPWA::ParameterList &par);
+
   /// Trigger the use of a FunctionTree.
   /// If no tree is provided by the AmpIntensity implementation an exception
   /// is thrown.
@@ -109,9 +126,13 @@ protected:
   /// Data sample
   std::shared_ptr<ComPWA::DataReader::Data> _dataSample;
 
-  /// _dataSample stored 'horizontally' as ParameterList
+  /// DataPoints stored 'horizontally' as ParameterList
   ParameterList _dataSampleList;
 
+  /// Events [_firstEvent, _firstEvent + _nEvents) of _dataSample within the
+  /// phase space. The whole sample is shared with _dataSample.
+  std::shared_ptr<ComPWA::DataPointSet> DataPoints;
+
   /// Sum of weights in _dataSample
   double _sumOfWeights;
 
@@ -0,0 +1,377 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the out-of-core log likelihood.
+///
+
+#define BOOST_TEST_MODULE Estimator
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/AmpIntensity.hpp"
+#include "Core/Exceptions.hpp"
+#include "Core/FitParameter.hpp"
+#include "Core/FunctionTree.hpp"
+#include "Core/Functions.hpp"
+#include "Core/Kinematics.hpp"
+#include "Core/Logging.hpp"
+#include "Core/ThreadPool.hpp"
+#include "DataReader/AsciiReader/AsciiReader.hpp"
+#include "DataReader/Data.hpp"
+#include "DataReader/EventStream.hpp"
+#include "DataReader/VariableCache.hpp"
+#include "Estimator/MinLogLH/ChunkedMinLogLH.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::DataReader;
+using namespace ComPWA::Estimator;
+
+BOOST_AUTO_TEST_SUITE(EstimatorTest);
+
+/// Invariant mass squared of the particle pair (0,1). Events with a mass
+/// above MaxMassSq are outside the phase space.
+class PairKinematics : public Kinematics {
+public:
+  PairKinematics(double maxMassSq)
+      : Kinematics({0}, {1, 2}), MaxMassSq(maxMassSq), NumConversions(0) {
+    VariableNames = {"mSq01"};
+  }
+
+  using Kinematics::convert;
+
+  void convert(const Event &ev, DataPoint &point) const {
+    ++NumConversions;
+    double mSq =
+        (ev.particle(0).fourMomentum() + ev.particle(1).fourMomentum())
+            .invMassSq();
+    if (mSq > MaxMassSq)
+      throw BeyondPhsp("PairKinematics::convert() | Beyond phsp!");
+    point.values().push_back(mSq);
+  }
+
+  bool isWithinPhsp(const DataPoint &point) const { return true; }
+
+  unsigned int getDataID(const SubSystem &sys) const { return 0; }
+
+  double MaxMassSq;
+
+  /// Number of converted events
+  mutable std::atomic<std::size_t> NumConversions;
+
+protected:
+  double calculatePhspVolume() const { return 2.5; }
+};
+
+/// Linear intensity 1 + Slope * mSq01 without normalization
+class SlopeIntensity : public AmpIntensity {
+public:
+  SlopeIntensity(double slope) : Slope(slope) {}
+
+  AmpIntensity *clone(std::string newName = "") const {
+    return new SlopeIntensity(*this);
+  }
+
+  boost::property_tree::ptree save() const {
+    return boost::property_tree::ptree();
+  }
+
+  double intensity(const DataPoint &point) const {
+    return 1 + Slope * point.value(0);
+  }
+
+  void parameters(ParameterList &list) {}
+
+  void updateParameters(const ParameterList &list) {}
+
+  void setPhspSample(std::shared_ptr<DataPointSet> phspSample,
+                     std::shared_ptr<DataPointSet> toySample) {}
+
+  std::shared_ptr<AmpIntensity> component(std::string name) {
+    return std::shared_ptr<AmpIntensity>();
+  }
+
+  std::shared_ptr<FunctionTree> tree(std::shared_ptr<Kinematics> kin,
+                                     const ParameterList &sample,
+                                     const ParameterList &phspSample,
+                                     const ParameterList &toySample,
+                                     unsigned int nEvtVar,
+                                     std::string suffix = "") {
+    return std::shared_ptr<FunctionTree>();
+  }
+
+  double Slope;
+};
+
+/// Intensity mSq01 + Quadratic * mSq01^2 with a FunctionTree
+class TreeIntensity : public SlopeIntensity {
+public:
+  TreeIntensity(double quadratic)
+      : SlopeIntensity(0.),
+        Quadratic(std::make_shared<FitParameter>("Quadratic", quadratic)) {
+    Quadratic->fixParameter(false);
+  }
+
+  AmpIntensity *clone(std::string newName = "") const {
+    return new TreeIntensity(*this);
+  }
+
+  double intensity(const DataPoint &point) const {
+    double x = point.value(0);
+    return x + Quadratic->value() * x * x;
+  }
+
+  bool hasTree() const { return true; }
+
+  std::shared_ptr<FunctionTree> tree(std::shared_ptr<Kinematics> kin,
+                                     const ParameterList &sample,
+                                     const ParameterList &phspSample,
+                                     const ParameterList &toySample,
+                                     unsigned int nEvtVar,
+                                     std::string suffix = "") {
+    std::size_t n = sample.mDoubleValue(0)->values().size();
+    auto tr = std::make_shared<FunctionTree>(
+        "Intensity", MDouble("", n), std::make_shared<AddAll>(ParType::MDOUBLE));
+    tr->createLeaf("mSq01", sample.mDoubleValue(0), "Intensity");
+    tr->createNode("QuadraticTerm", MDouble("", n),
+                   std::make_shared<MultAll>(ParType::MDOUBLE), "Intensity");
+    tr->createLeaf("Quadratic", Quadratic, "QuadraticTerm");
+    tr->createLeaf("mSq01_a", sample.mDoubleValue(0), "QuadraticTerm");
+    tr->createLeaf("mSq01_b", sample.mDoubleValue(0), "QuadraticTerm");
+    return tr;
+  }
+
+  std::shared_ptr<FitParameter> Quadratic;
+};
+
+std::shared_ptr<Data> sample(std::size_t n, std::size_t seed) {
+  auto data = std::make_shared<Data>();
+  for (std::size_t i = 0; i < n; ++i) {
+    std::size_t j = i + seed;
+    Event ev;
+    ev.addParticle(Particle(0.01 * (j % 17), 0.1, 0.02 * (j % 13), 1.0));
+    ev.addParticle(Particle(-0.1, 0.02 * (j % 11), 0.3, 1.5));
+    ev.setWeight(0.5 + 0.25 * (j % 3));
+    ev.setEfficiency(0.8 + 0.01 * (j % 7));
+    data->add(ev);
+  }
+  return data;
+}
+
+/// Direct calculation of the log likelihood from the complete samples
+double reference(const Kinematics &kin, const AmpIntensity &intens,
+                 const Data &data, const Data &phsp) {
+  double n = 0, sumW = 0, sumLog = 0;
+  for (std::size_t i = 0; i < data.numEvents(); ++i) {
+    DataPoint point;
+    try {
+      kin.convert(data.event(i), point);
+    } catch (BeyondPhsp &ex) {
+      continue;
+    }
+    double w = data.events().weight(i);
+    n += 1;
+    sumW += w;
+    sumLog += w * std::log(intens.intensity(point));
+  }
+  double sumPhspW = 0, sumPhsp = 0;
+  for (std::size_t i = 0; i < phsp.numEvents(); ++i) {
+    DataPoint point;
+    try {
+      kin.convert(phsp.event(i), point);
+    } catch (BeyondPhsp &ex) {
+      continue;
+    }
+    double w = phsp.events().weight(i);
+    sumPhspW += w;
+    sumPhsp += w * phsp.events().efficiency(i) * intens.intensity(point);
+  }
+  return -n / sumW * sumLog +
+         n * std::log(kin.phspVolume() * sumPhsp / sumPhspW);
+}
+
+BOOST_AUTO_TEST_CASE(CompareToReference) {
+  ComPWA::Logging log("", "error");
+  auto kin = std::make_shared<PairKinematics>(5.95);
+  auto intens = std::make_shared<SlopeIntensity>(0.3);
+  auto data = sample(5000, 0);
+  auto phsp = sample(20000, 3);
+  double ref = reference(*kin, *intens, *data, *phsp);
+
+  ChunkedMinLogLH lh(kin, intens, std::make_shared<DataEventStream>(data),
+                     std::make_shared<DataEventStream>(phsp), 777);
+  ParameterList par;
+  double value = lh.controlParameter(par);
+  BOOST_CHECK_CLOSE(value, ref, 1e-9);
+  BOOST_CHECK(lh.numEvents() > 0 && lh.numEvents() < data->numEvents());
+
+  // The stream is read again at each evaluation
+  BOOST_CHECK_EQUAL(lh.controlParameter(par), value);
+  BOOST_CHECK_EQUAL(lh.status(), 2);
+
+  // Independent of the chunk size up to rounding
+  lh.setChunkSize(1 << 20);
+  BOOST_CHECK_CLOSE(lh.controlParameter(par), ref, 1e-9);
+  BOOST_CHECK_THROW(lh.setChunkSize(0), BadParameter);
+
+  // Identical for any number of threads
+  lh.setChunkSize(777);
+  unsigned int numThreads = ThreadPool::instance().numThreads();
+  for (unsigned int n : {1, 3, 8}) {
+    ThreadPool::instance().setNumThreads(n);
+    BOOST_CHECK_EQUAL(lh.controlParameter(par), value);
+  }
+  ThreadPool::instance().setNumThreads(numThreads);
+
+  // The likelihood changes with the model
+  intens->Slope = 0.5;
+  BOOST_CHECK_CLOSE(lh.controlParameter(par),
+                    reference(*kin, *intens, *data, *phsp), 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(FunctionTreePerChunk) {
+  ComPWA::Logging log("", "error");
+  auto kin = std::make_shared<PairKinematics>(5.95);
+  auto intens = std::make_shared<TreeIntensity>(0.3);
+  auto data = sample(3000, 0);
+  auto phsp = sample(8000, 3);
+
+  ChunkedMinLogLH lh(kin, intens, std::make_shared<DataEventStream>(data),
+                     std::make_shared<DataEventStream>(phsp), 777);
+  ParameterList par;
+  double value = lh.controlParameter(par);
+  BOOST_CHECK_CLOSE(value, reference(*kin, *intens, *data, *phsp), 1e-9);
+
+  // The tree is bound to a set of chunk size, which is refilled for each
+  // chunk of both streams
+  auto tr = lh.tree();
+  auto values = std::dynamic_pointer_cast<Value<std::vector<double>>>(
+      tr->parameter());
+  BOOST_REQUIRE(values);
+  BOOST_CHECK_EQUAL(values->values().size(), 777);
+  BOOST_CHECK_EQUAL(lh.controlParameter(par), value);
+  BOOST_CHECK_EQUAL(lh.tree().get(), tr.get());
+
+  // Changes of the parameters are propagated to the tree
+  intens->Quadratic->setValue(0.5);
+  value = lh.controlParameter(par);
+  BOOST_CHECK_CLOSE(value, reference(*kin, *intens, *data, *phsp), 1e-9);
+  BOOST_CHECK_EQUAL(lh.tree().get(), tr.get());
+
+  unsigned int numThreads = ThreadPool::instance().numThreads();
+  for (unsigned int n : {1, 3, 8}) {
+    ThreadPool::instance().setNumThreads(n);
+    BOOST_CHECK_EQUAL(lh.controlParameter(par), value);
+  }
+  ThreadPool::instance().setNumThreads(numThreads);
+
+  // Independent of the chunk size up to rounding, the tree is rebuilt
+  lh.setChunkSize(1 << 20);
+  BOOST_CHECK_CLOSE(lh.controlParameter(par), value, 1e-9);
+  BOOST_CHECK(lh.tree().get() != tr.get());
+
+  ChunkedMinLogLH noTree(kin, std::make_shared<SlopeIntensity>(0.3),
+                         std::make_shared<DataEventStream>(data),
+                         std::make_shared<DataEventStream>(phsp), 777);
+  BOOST_CHECK_THROW(noTree.tree(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(CachedChunks) {
+  ComPWA::Logging log("", "error");
+  auto kin = std::make_shared<PairKinematics>(5.95);
+  auto intens = std::make_shared<SlopeIntensity>(0.3);
+  auto data = sample(2000, 0);
+  auto phsp = sample(5000, 3);
+  double ref = reference(*kin, *intens, *data, *phsp);
+
+  std::string dir = "ChunkedMinLogLHTest-Cache-" + std::to_string(getpid());
+  BOOST_REQUIRE_EQUAL(mkdir(dir.c_str(), 0700), 0);
+  auto cache = std::make_shared<VariableCache>(dir);
+
+  ChunkedMinLogLH lh(kin, intens, std::make_shared<DataEventStream>(data),
+                     std::make_shared<DataEventStream>(phsp), 1000);
+  lh.setVariableCache(cache);
+  ParameterList par;
+  kin->NumConversions = 0;
+  double value = lh.controlParameter(par);
+  BOOST_CHECK_CLOSE(value, ref, 1e-9);
+  BOOST_CHECK_EQUAL(kin->NumConversions, 7000);
+
+  // One file per chunk is written on the first evaluation. Later
+  // evaluations use the mapped files, they neither convert the chunks nor
+  // look up the files again.
+  EventCollection chunk;
+  for (auto s : {data, phsp}) {
+    DataEventStream stream(s);
+    while (stream.next(chunk, 1000)) {
+      std::string file = cache->fileName(VariableCache::key(chunk, *kin));
+      BOOST_CHECK_EQUAL(std::remove(file.c_str()), 0);
+    }
+  }
+  BOOST_CHECK_EQUAL(lh.controlParameter(par), value);
+  BOOST_CHECK_EQUAL(kin->NumConversions, 7000);
+  BOOST_CHECK_EQUAL(rmdir(dir.c_str()), 0);
+
+  // Without cache the chunks are converted at each evaluation
+  lh.setVariableCache(std::shared_ptr<VariableCache>());
+  BOOST_CHECK_EQUAL(lh.controlParameter(par), value);
+  BOOST_CHECK_EQUAL(kin->NumConversions, 14000);
+}
+
+BOOST_AUTO_TEST_CASE(AsciiStream) {
+  ComPWA::Logging log("", "error");
+  auto kin = std::make_shared<PairKinematics>(5.95);
+  auto intens = std::make_shared<SlopeIntensity>(0.3);
+  auto data = sample(1000, 0);
+  auto phsp = sample(3000, 3);
+  // Weights and efficiencies are not stored in ASCII files
+  for (auto s : {data, phsp}) {
+    for (std::size_t i = 0; i < s->numEvents(); ++i) {
+      s->events().setWeight(i, 1.);
+      s->events().setEfficiency(i, 1.);
+    }
+  }
+
+  std::string fileName = "ChunkedMinLogLHTest-" + std::to_string(getpid());
+  std::ofstream out(fileName);
+  out.precision(std::numeric_limits<double>::max_digits10);
+  const EventCollection &events = phsp->events();
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    for (std::size_t j = 0; j < events.numParticles(); ++j)
+      out << events.px(j)[i] << " " << events.py(j)[i] << " "
+          << events.pz(j)[i] << " " << events.e(j)[i] << "\n";
+  }
+  out.close();
+
+  auto stream = std::make_shared<AsciiReader::AsciiEventStream>(fileName, 2);
+  EventCollection chunk;
+  std::size_t numRead = 0;
+  while (stream->next(chunk, 101)) {
+    BOOST_CHECK(chunk.size() <= 101);
+    numRead += chunk.size();
+  }
+  BOOST_CHECK_EQUAL(numRead, phsp->numEvents());
+
+  ChunkedMinLogLH lh(kin, intens, std::make_shared<DataEventStream>(data),
+                     stream, 101);
+  ParameterList par;
+  BOOST_CHECK_CLOSE(lh.controlParameter(par),
+                    reference(*kin, *intens, *data, *phsp), 1e-9);
+  std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,124 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Amplitude model and particle list of the Benchmark executables.
+///
+
+#ifndef BENCHMARKMODEL_HPP_
+#define BENCHMARKMODEL_HPP_
+
+#include <string>
+
+// We define an intensity model using a raw string literal. Currently, this is
+// just a toy model without any physical meaning.
+// (comments within the string are ignored!). This is convenient since we
+// do not have to configure the build system to copy input files somewhere.
+// In practise you may want to use a normal XML input file instead.
+std::string amplitudeModel = R"####(
+<Intensity Class='Incoherent' Name="jpsiGammaPiPi_inc">
+  <Intensity Class='Coherent' Name="jpsiGammaPiPi">
+    <Amplitude Class="SequentialPartialAmplitude" Name="f2(1270)">
+      <Parameter Class='Double' Type="Magnitude"  Name="Magnitude_f2">
+        <Value>1.0</Value>
+        <Min>-1.0</Min>
+        <Max>2.0</Max>
+        <Fix>false</Fix>
+      </Parameter>
+      <Parameter Class='Double' Type="Phase" Name="Phase_f2">
+        <Value>0.0</Value>
+        <Min>-100</Min>
+        <Max>100</Max>
+        <Fix>false</Fix>
+      </Parameter>
+      <PartialAmplitude Class="HelicityDecay" Name="f2ToPiPi">
+        <DecayParticle Name="f2(1270)" Helicity="0"/>
+        <RecoilSystem FinalState="0" />
+        <DecayProducts>
+          <Particle Name="pi0" FinalState="1"  Helicity="0"/>
+          <Particle Name="pi0" FinalState="2"  Helicity="0"/>
+        </DecayProducts>
+      </PartialAmplitude>
+    </Amplitude>
+    <Amplitude Class="SequentialPartialAmplitude" Name="myAmp">
+      <Parameter Class='Double' Type="Magnitude"  Name="Magnitude_my">
+        <Value>1.0</Value>
+        <Min>-1.0</Min>
+        <Max>2.0</Max>
+        <Fix>true</Fix>
+      </Parameter>
+      <Parameter Class='Double' Type="Phase" Name="Phase_my`">
+        <Value>0.0</Value>
+        <Min>-100</Min>
+        <Max>100</Max>
+        <Fix>true</Fix>
+      </Parameter>
+      <PartialAmplitude Class="HelicityDecay" Name="MyResToPiPi">
+        <DecayParticle Name="myRes" Helicity="0"/>
+        <RecoilSystem FinalState="0" />
+        <DecayProducts>
+          <Particle Name="pi0" FinalState="1"  Helicity="0"/>
+          <Particle Name="pi0" FinalState="2"  Helicity="0"/>
+        </DecayProducts>
+      </PartialAmplitude>
+    </Amplitude>
+  </Intensity>
+</Intensity>
+)####";
+
+std::string myParticles = R"####(
+<ParticleList>
+  <Particle Name="f2(1270)">
+    <Pid>225</Pid>
+    <Parameter Class='Double' Type="Mass" Name="Mass_f2(1270)">
+      <Value>1.2755</Value>
+      <Error>8.0E-04</Error>
+      <Min>0.1</Min>
+      <Max>2.0</Max>
+      <Fix>false</Fix>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="2"/>
+    <QuantumNumber Class="Int" Type="Charge" Value="0"/>
+    <QuantumNumber Class="Int" Type="Parity" Value="+1"/>
+    <QuantumNumber Class="Int" Type="Cparity" Value="+1"/>
+    <DecayInfo Type="relativisticBreitWigner">
+      <FormFactor Type="0" />
+      <Parameter Class='Double' Type="Width" Name="Width_f2(1270)">
+        <Value>0.1867</Value>
+      </Parameter>
+      <Parameter Class='Double' Type="MesonRadius" Name="Radius_rho">
+        <Value>2.5</Value>
+        <Fix>true</Fix>
+      </Parameter>
+    </DecayInfo>
+  </Particle>
+  <Particle Name="myRes">
+    <Pid>999999</Pid>
+    <Parameter Class='Double' Type="Mass" Name="Mass_myRes">
+      <Value>2.0</Value>
+      <Error>8.0E-04</Error>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="1"/>
+    <QuantumNumber Class="Int" Type="Charge" Value="0"/>
+    <QuantumNumber Class="Int" Type="Parity" Value="+1"/>
+    <QuantumNumber Class="Int" Type="Cparity" Value="+1"/>
+    <DecayInfo Type="relativisticBreitWigner">
+      <FormFactor Type="0" />
+      <Parameter Class='Double' Type="Width" Name="Width_myRes">
+        <Value>1.0</Value>
+        <Min>0.1</Min>
+        <Max>1.0</Max>
+        <Fix>false</Fix>
+      </Parameter>
+      <Parameter Class='Double' Type="MesonRadius" Name="Radius_myRes">
+        <Value>2.5</Value>
+        <Fix>true</Fix>
+      </Parameter>
+    </DecayInfo>
+  </Particle>
+</ParticleList>
+)####";
+
+#endif
@@ -204,7 +204,7 @@ int main(int argc, char **argv) {
   // Pass phsp sample to intensity for normalization.
   // Convert to dataPoints first.
   auto phspPoints =
-      std::make_shared<std::vector<DataPoint>>(phspSample->dataPoints(kin));
+      phspSample->dataPoints(kin);
   intens->setPhspSample(phspPoints, phspPoints);
 
   //---------------------------------------------------
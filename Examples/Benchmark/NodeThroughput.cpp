@@ -0,0 +1,276 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Throughput of single FunctionTree nodes and of the amplitude evaluation
+/// per event. The correctness of the nodes is checked by the unit tests.
+///
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/DataPointSet.hpp"
+#include "Core/FitParameter.hpp"
+#include "Core/Logging.hpp"
+#include "Core/ParameterList.hpp"
+#include "Core/Properties.hpp"
+#include "Core/Spin.hpp"
+#include "Core/SubSystem.hpp"
+#include "Core/Value.hpp"
+#include "Physics/DecayDynamics/AmpFlatteRes.hpp"
+#include "Physics/DecayDynamics/RelativisticBreitWigner.hpp"
+#include "Physics/DecayDynamics/Utils/Faddeeva.hh"
+#include "Physics/DecayDynamics/Utils/WeidemanFaddeeva.hpp"
+#include "Physics/HelicityFormalism/AmpWignerD.hpp"
+#include "Physics/HelicityFormalism/HelicityDecay.hpp"
+
+#include "NodeThroughput.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Physics::DecayDynamics;
+using namespace ComPWA::Physics::HelicityFormalism;
+
+const double MassPi0 = 0.1349766;
+
+/// BreitWignerStrategy of f2(1270) -> pi0 pi0 compared to
+/// RelativisticBreitWigner::dynamicalFunction()
+void breitWigner(std::size_t n) {
+  auto mass = std::make_shared<FitParameter>("Mass", 1.2755);
+  auto width = std::make_shared<FitParameter>("Width", 0.1867);
+  auto radius = std::make_shared<FitParameter>("Radius", 2.5);
+  auto data = massSqSample(n, 4 * MassPi0 * MassPi0, 4.0);
+  ParameterList paras;
+  for (auto p : {mass, width, radius}) {
+    p->fixParameter(false);
+    paras.addParameter(p);
+  }
+  paras.addValue(std::make_shared<Value<double>>("L", 2));
+  paras.addValue(
+      std::make_shared<Value<double>>("FormFactorType", BlattWeisskopf));
+  paras.addValue(std::make_shared<Value<double>>("MassA", MassPi0));
+  paras.addValue(std::make_shared<Value<double>>("MassB", MassPi0));
+  paras.addValue(data);
+
+  BreitWignerStrategy strat;
+  // Only the mass and the width change during a typical fit
+  nodeThroughput(
+      "RelativisticBreitWigner", strat, paras, n,
+      [&](std::size_t i) {
+        return RelativisticBreitWigner::dynamicalFunction(
+            data->values()[i], mass->value(), MassPi0, MassPi0, width->value(),
+            2, radius->value(), BlattWeisskopf);
+      },
+      [&](int k) { width->setValue(0.18 + 0.001 * k); });
+}
+
+const std::string F2Particles = R"####(
+<ParticleList>
+  <Particle Name='pi0'>
+    <Pid>111</Pid>
+    <Parameter Class='Double' Type='Mass' Name='Mass_pi0'>
+      <Value>0.1349766</Value>
+      <Fix>true</Fix>
+    </Parameter>
+    <QuantumNumber Class='Spin' Type='Spin' Value='0'/>
+    <QuantumNumber Class='Int' Type='Charge' Value='0'/>
+    <QuantumNumber Class='Int' Type='Parity' Value='-1'/>
+    <QuantumNumber Class='Int' Type='Cparity' Value='1'/>
+  </Particle>
+  <Particle Name='f2(1270)'>
+    <Pid>225</Pid>
+    <Parameter Class='Double' Type='Mass' Name='Mass_f2(1270)'>
+      <Value>1.2755</Value>
+      <Fix>true</Fix>
+    </Parameter>
+    <QuantumNumber Class='Spin' Type='Spin' Value='2'/>
+    <QuantumNumber Class='Int' Type='Charge' Value='0'/>
+    <QuantumNumber Class='Int' Type='Parity' Value='1'/>
+    <QuantumNumber Class='Int' Type='Cparity' Value='1'/>
+    <DecayInfo Type='relativisticBreitWigner'>
+      <FormFactor Type='1' />
+      <Parameter Class='Double' Type='Width' Name='Width_f2(1270)'>
+        <Value>0.1867</Value>
+        <Fix>true</Fix>
+      </Parameter>
+      <Parameter Class='Double' Type='MesonRadius' Name='Radius_f2(1270)'>
+        <Value>1.5</Value>
+        <Fix>true</Fix>
+      </Parameter>
+    </DecayInfo>
+  </Particle>
+</ParticleList>
+)####";
+
+/// HelicityDecay::evaluateNoNorm() for the views of a DataPointSet: first
+/// evaluation of the sample and further evaluations with the values that
+/// are stored per event
+void eventCache(std::size_t n) {
+  auto partL = std::make_shared<PartList>();
+  ReadParticles(partL, F2Particles);
+  auto breitWigner = std::make_shared<RelativisticBreitWigner>(
+      "f2(1270)", std::make_pair("pi0", "pi0"), partL);
+  breitWigner->SetOrbitalAngularMomentum(2);
+  Physics::HelicityFormalism::HelicityDecay decay(0, SubSystem({{0}, {1}}, {2}, {}));
+  decay.setMagnitudeParameter(std::make_shared<FitParameter>("Mag", 2.0));
+  decay.setPhaseParameter(std::make_shared<FitParameter>("Phase", 0.3));
+  decay.setWignerD(std::make_shared<AmpWignerD>(Spin(2), Spin(1), Spin(0)));
+  decay.setDynamicalFunction(breitWigner);
+
+  std::vector<std::vector<double>> columns(3, std::vector<double>(n));
+  double min = 4 * MassPi0 * MassPi0;
+  for (std::size_t i = 0; i < n; ++i) {
+    columns[0][i] = min + (4.0 - min) * (i + 0.5) / n;
+    columns[1][i] = std::cos(0.37 * i);
+    columns[2][i] = std::fmod(1.3 * i, 2 * M_PI);
+  }
+  DataPointSet set(std::move(columns), std::vector<char>(n, 1));
+
+  std::complex<double> sumFirst, sumCached;
+  double first = seconds([&]() {
+    for (const auto &point : set)
+      sumFirst += decay.evaluateNoNorm(point);
+  });
+  double cached = seconds([&]() {
+    for (const auto &point : set)
+      sumCached += decay.evaluateNoNorm(point);
+  });
+
+  std::cout << "HelicityDecay: first evaluation: " << n / first
+            << " events/s, stored values: " << n / cached
+            << " events/s (deviation of the sums "
+            << std::abs(sumCached - sumFirst) << ")" << std::endl;
+}
+
+/// FlatteStrategy of f0(980) with the channels pi pi, K K and eta eta
+/// compared to AmpFlatteRes::dynamicalFunction()
+void flatte(std::size_t n) {
+  const std::vector<double> masses = {0.13957018, 0.13957018, 0.493677,
+                                      0.493677,   0.547862,   0.547862};
+  auto mass = std::make_shared<FitParameter>("Mass", 0.965);
+  auto radius = std::make_shared<FitParameter>("Radius", 1.5);
+  std::vector<std::shared_ptr<FitParameter>> g = {
+      std::make_shared<FitParameter>("g_0", 0.165),
+      std::make_shared<FitParameter>("g_1", 0.695),
+      std::make_shared<FitParameter>("g_2", 0.3)};
+  auto data = massSqSample(n, 4 * masses[0] * masses[0], 4.0);
+  ParameterList paras;
+  mass->fixParameter(false);
+  paras.addParameter(mass);
+  for (unsigned int i = 0; i < 3; ++i) {
+    g[i]->fixParameter(false);
+    paras.addValue(std::make_shared<Value<double>>("massA", masses[2 * i]));
+    paras.addValue(
+        std::make_shared<Value<double>>("massB", masses[2 * i + 1]));
+    paras.addParameter(g[i]);
+  }
+  radius->fixParameter(false);
+  paras.addValue(std::make_shared<Value<double>>("L", 0));
+  paras.addParameter(radius);
+  paras.addValue(
+      std::make_shared<Value<double>>("FormFactorType", BlattWeisskopf));
+  paras.addValue(std::make_shared<Value<double>>("MassA", masses[0]));
+  paras.addValue(std::make_shared<Value<double>>("MassB", masses[1]));
+  paras.addValue(data);
+
+  FlatteStrategy strat;
+  // Only the mass and the couplings change during a typical fit
+  nodeThroughput(
+      "AmpFlatteRes", strat, paras, n,
+      [&](std::size_t i) {
+        return AmpFlatteRes::dynamicalFunction(
+            data->values()[i], mass->value(), masses[0], masses[1],
+            g[0]->value(), masses[2], masses[3], g[1]->value(), masses[4],
+            masses[5], g[2]->value(), 0, radius->value(), BlattWeisskopf);
+      },
+      [&](int k) { g[1]->setValue(0.6 + 0.01 * k); });
+}
+
+/// WignerDStrategy of d^3_{1,-1} with the closed form compared to the
+/// general function
+void wignerD(std::size_t n) {
+  auto data = MDouble("cosTheta", n);
+  for (std::size_t i = 0; i < n; ++i)
+    data->values()[i] = -1.0 + 2.0 * i / (n - 1);
+  ParameterList paras;
+  paras.addValue(std::make_shared<Value<double>>("spin", 3.));
+  paras.addValue(std::make_shared<Value<double>>("m", 1.));
+  paras.addValue(std::make_shared<Value<double>>("n", -1.));
+  paras.addValue(data);
+
+  WignerDStrategy general("general");
+  std::shared_ptr<Parameter> outGeneral;
+  double timeGeneral =
+      seconds([&]() { general.execute(paras, outGeneral); });
+
+  WignerDStrategy closedForm(
+      "closedForm",
+      std::make_shared<const WignerdPolynomial>(Spin(3), Spin(1), Spin(-1)));
+  std::shared_ptr<Parameter> outClosedForm;
+  double timeClosedForm =
+      seconds([&]() { closedForm.execute(paras, outClosedForm); });
+
+  auto &a = std::static_pointer_cast<Value<std::vector<double>>>(outGeneral)
+                ->values();
+  auto &b = std::static_pointer_cast<Value<std::vector<double>>>(outClosedForm)
+                ->values();
+  double maxDev = 0;
+  for (std::size_t i = 0; i < n; ++i)
+    maxDev = std::max(maxDev, std::fabs(a.at(i) - b.at(i)));
+
+  std::cout << "WignerD: general: " << n / timeGeneral
+            << " events/s, closed form: " << n / timeClosedForm
+            << " events/s (maximal deviation " << maxDev << ")" << std::endl;
+}
+
+/// Batch Faddeeva function of the Voigtian node compared to Faddeeva::w()
+void faddeeva(std::size_t n) {
+  std::vector<double> x(n), re(n), im(n);
+  for (std::size_t i = 0; i < n; ++i)
+    x[i] = -100. + 200. * (i + 0.5) / n;
+  double y = 0.5;
+
+  double sumExact = 0;
+  double timeExact = seconds([&]() {
+    for (double xv : x)
+      sumExact += Faddeeva::w(std::complex<double>(xv, y), 1e-13).real();
+  });
+
+  WeidemanFaddeeva batch(32);
+  double sumBatch = 0;
+  double timeBatch = seconds([&]() {
+    batch.w(x.data(), y, re.data(), im.data(), n);
+    for (double r : re)
+      sumBatch += r;
+  });
+
+  std::cout << "Faddeeva: Faddeeva::w(): " << n / timeExact
+            << " values/s, WeidemanFaddeeva (32 terms): " << n / timeBatch
+            << " values/s (relative deviation of the sum of Re w(z) "
+            << std::fabs(sumBatch / sumExact - 1) << ")" << std::endl;
+}
+
+///
+/// Usage: NodeThroughput [number of events]
+///
+int main(int argc, char **argv) {
+  std::size_t n = (argc > 1 ? std::atol(argv[1]) : 1000000);
+
+  Logging log("nodethroughput.log", "error");
+
+  std::cout << "Events: " << n << std::endl;
+  breitWigner(n);
+  flatte(n);
+  wignerD(n);
+  faddeeva(n);
+  eventCache(n);
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Timing helpers of the NodeThroughput executable.
+///
+
+#ifndef NODETHROUGHPUT_HPP_
+#define NODETHROUGHPUT_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/Functions.hpp"
+#include "Core/ParameterList.hpp"
+#include "Core/Value.hpp"
+
+/// Wall time of \p function() in seconds
+template <class Function> double seconds(Function function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+/// \p n invariant masses squared, evenly spaced between \p min and \p max
+inline std::shared_ptr<ComPWA::Value<std::vector<double>>>
+massSqSample(std::size_t n, double min, double max) {
+  auto data = ComPWA::MDouble("mSq", n);
+  for (std::size_t i = 0; i < n; ++i)
+    data->values()[i] = min + (max - min) * (i + 0.5) / n;
+  return data;
+}
+
+///
+/// Events per second of a FunctionTree node of a dynamical function that
+/// caches per-event quantities. The node \p strat is executed once with
+/// \p paras (first execution) and \p numCalls times after \p update(k)
+/// changed a fit parameter (cached). The results are compared to
+/// \p reference(i), the dynamical function of event i evaluated with the
+/// final parameters.
+///
+template <class Reference, class Update>
+void nodeThroughput(const std::string &name, ComPWA::Strategy &strat,
+                    ComPWA::ParameterList &paras, std::size_t n,
+                    Reference reference, Update update, int numCalls = 10) {
+  std::shared_ptr<ComPWA::Parameter> out;
+  double first = seconds([&]() { strat.execute(paras, out); });
+  double cached = seconds([&]() {
+                    for (int k = 0; k < numCalls; ++k) {
+                      update(k);
+                      strat.execute(paras, out);
+                    }
+                  }) /
+                  numCalls;
+
+  std::vector<std::complex<double>> expected(n);
+  double single = seconds([&]() {
+    for (std::size_t i = 0; i < n; ++i)
+      expected[i] = reference(i);
+  });
+
+  auto &results =
+      std::static_pointer_cast<ComPWA::Value<std::vector<std::complex<double>>>>(
+          out)
+          ->values();
+  double maxDev = 0;
+  for (std::size_t i = 0; i < n; ++i)
+    maxDev = std::max(maxDev, std::abs(results.at(i) - expected[i]));
+
+  std::cout << name << ": dynamicalFunction(): " << n / single
+            << " events/s, first execution: " << n / first
+            << " events/s, cached: " << n / cached
+            << " events/s (maximal deviation " << maxDev << ")"
+            << std::endl;
+}
+
+#endif
@@ -0,0 +1,170 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Validation of the single precision storage of phase space samples.
+///
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include "Core/DataPointSet.hpp"
+#include "Core/Logging.hpp"
+#include "Core/Properties.hpp"
+#include "Physics/ParticleList.hpp"
+#include "Physics/HelicityFormalism/HelicityKinematics.hpp"
+#include "Physics/IncoherentIntensity.hpp"
+#include "Tools/RootGenerator.hpp"
+#include "Tools/Generate.hpp"
+#include "Tools/ParameterTools.hpp"
+
+#include "Estimator/MinLogLH/MinLogLH.hpp"
+#include "Optimizer/Minuit2/MinuitIF.hpp"
+
+#include "BenchmarkModel.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::DataReader;
+using ComPWA::Physics::HelicityFormalism::HelicityKinematics;
+using ComPWA::Physics::IncoherentIntensity;
+using ComPWA::Optimizer::Minuit2::MinuitResult;
+
+/// Result of a fit with one storage precision of the phase space sample
+struct PrecisionResult {
+  double StartLH;
+  double FinalLH;
+  std::vector<double> Values;
+  std::vector<double> Errors;
+  double PhspMemory;
+  long long Time;
+};
+
+PrecisionResult fit(std::shared_ptr<HelicityKinematics> kin,
+                    std::shared_ptr<IncoherentIntensity> intens,
+                    std::shared_ptr<Data> sample,
+                    std::shared_ptr<Data> phspSample, ParameterList &fitPar,
+                    const std::vector<double> &startValues,
+                    DataPointSet::Precision precision) {
+  PrecisionResult res;
+  // The FitParameters are shared with the intensity
+  for (std::size_t i = 0; i < startValues.size(); ++i)
+    fitPar.doubleParameter(i)->setValue(startValues[i]);
+
+  phspSample->setPrecision(precision);
+  auto phspPoints = phspSample->dataPoints(kin);
+  intens->setPhspSample(phspPoints, phspPoints);
+
+  // The FunctionTree requires double columns. Both fits evaluate the
+  // intensity via views of the sets, they only differ in the precision.
+  auto esti = std::make_shared<Estimator::MinLogLH>(
+      kin, intens, sample, phspSample, phspSample, 0, 0);
+  esti->UseFunctionTree(false);
+  res.StartLH = esti->controlParameter(fitPar);
+  res.PhspMemory = phspPoints->memory() / 1e6;
+
+  auto start = std::chrono::steady_clock::now();
+  Optimizer::Minuit2::MinuitIF minuitif(esti, fitPar);
+  auto result = std::dynamic_pointer_cast<MinuitResult>(minuitif.exec(fitPar));
+  res.Time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - start)
+                 .count();
+  res.FinalLH = result->finalLH();
+
+  for (auto p : fitPar.doubleParameters()) {
+    res.Values.push_back(p->value());
+    res.Errors.push_back(p->isFixed() ? 0. : p->error().first);
+  }
+  return res;
+}
+
+///
+/// Fit of the Benchmark model with the phase space sample stored in double
+/// and in single precision. The shift of -log L at the start values and at
+/// the minimum and the shift of the fit parameters (in units of their
+/// uncertainty) are reported.
+///
+/// Usage: PrecisionCheck [number of phase space events] [number of events]
+///
+int main(int argc, char **argv) {
+  std::size_t numPhsp = (argc > 1 ? std::atol(argv[1]) : 300000);
+  std::size_t numEvents = (argc > 2 ? std::atol(argv[2]) : 1000);
+
+  Logging log("precisioncheck.log", "error");
+
+  auto partL = std::make_shared<ComPWA::PartList>();
+  ReadParticles(partL, defaultParticleList);
+  ReadParticles(partL, myParticles);
+
+  std::vector<pid> initialState = {443};
+  std::vector<pid> finalState = {22, 111, 111};
+  auto kin =
+      std::make_shared<HelicityKinematics>(partL, initialState, finalState);
+
+  auto gen = std::make_shared<ComPWA::Tools::RootGenerator>(partL, kin, 12345);
+  std::shared_ptr<Data> phspSample(new Data());
+  ComPWA::Tools::generatePhsp(numPhsp, gen, phspSample);
+
+  std::stringstream modelStream;
+  modelStream << amplitudeModel;
+  boost::property_tree::ptree modelTree;
+  boost::property_tree::xml_parser::read_xml(modelStream, modelTree);
+  auto intens = std::make_shared<IncoherentIntensity>(
+      partL, kin, modelTree.get_child("Intensity"));
+
+  auto phspPoints = phspSample->dataPoints(kin);
+  intens->setPhspSample(phspPoints, phspPoints);
+
+  std::shared_ptr<Data> sample(new Data());
+  ComPWA::Tools::generate(numEvents, kin, gen, intens, sample, phspSample,
+                          phspSample);
+
+  ParameterList fitPar;
+  intens->parameters(fitPar);
+  setErrorOnParameterList(fitPar, 0.05, false);
+  std::vector<double> startValues;
+  for (auto p : fitPar.doubleParameters())
+    startValues.push_back(p->value());
+
+  PrecisionResult dbl = fit(kin, intens, sample, phspSample, fitPar,
+                            startValues, DataPointSet::Precision::DOUBLE);
+  PrecisionResult flt = fit(kin, intens, sample, phspSample, fitPar,
+                            startValues, DataPointSet::Precision::FLOAT);
+
+  std::cout << std::setprecision(10);
+  std::cout << "Phase space events: " << phspPoints->size()
+            << ", events: " << sample->numEvents() << std::endl;
+  std::cout << "Phase space variables [MB]: double " << dbl.PhspMemory
+            << ", float " << flt.PhspMemory << std::endl;
+  std::cout << "Minimization [ms]: double " << dbl.Time << ", float "
+            << flt.Time << std::endl;
+  std::cout << "-log L at start: double " << dbl.StartLH << ", float "
+            << flt.StartLH << ", shift " << flt.StartLH - dbl.StartLH
+            << std::endl;
+  std::cout << "-log L at minimum: double " << dbl.FinalLH << ", float "
+            << flt.FinalLH << ", shift " << flt.FinalLH - dbl.FinalLH
+            << std::endl;
+  std::cout << "Fit parameters (double, float, shift, shift/error):"
+            << std::endl;
+  for (std::size_t i = 0; i < fitPar.doubleParameters().size(); ++i) {
+    auto p = fitPar.doubleParameter(i);
+    if (p->isFixed())
+      continue;
+    double shift = flt.Values[i] - dbl.Values[i];
+    std::cout << "  " << std::setw(20) << std::left << p->name() << " "
+              << dbl.Values[i] << " " << flt.Values[i] << " " << shift << " "
+              << (dbl.Errors[i] > 0 ? shift / dbl.Errors[i] : 0.) << std::endl;
+  }
+  return 0;
+}
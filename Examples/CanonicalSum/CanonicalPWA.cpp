@@ -308,8 +308,7 @@ int main(int argc, char **argv) {
   ComPWA::Tools::generatePhsp(ampMcPrecision, gen, toySample);
   // set efficiency values for each event
   toySample->setEfficiency(fitModelKin, unitEff);
-  auto toyPoints = std::make_shared<std::vector<DataPoint>>(
-      toySample->dataPoints(fitModelKin));
+  auto toyPoints = toySample->dataPoints(fitModelKin);
   std::cout << " generate toySample ok " << std::endl;
 
   // Read Phase space sample which is used in PWA fit for xs section
@@ -328,8 +327,7 @@ int main(int argc, char **argv) {
   }
   phspSample->reduceToPhsp(fitModelKin);
   phspSample->setEfficiency(fitModelKin, unitEff);
-  auto phspPoints = std::make_shared<std::vector<DataPoint>>(
-      phspSample->dataPoints(fitModelKin));
+  auto phspPoints = phspSample->dataPoints(fitModelKin);
   std::cout << " phspsample ok" << std::endl;
 
   //
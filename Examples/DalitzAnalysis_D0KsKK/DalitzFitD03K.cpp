@@ -391,21 +391,17 @@ int main(int argc, char **argv) {
     phspData = toyPhspData;
   
   // Setting samples for normalization
-  auto toyPoints = std::make_shared<std::vector<DataPoint>>(
-      toyPhspData->dataPoints(trueModelKin));
+  auto toyPoints = toyPhspData->dataPoints(trueModelKin);
   auto phspPoints = toyPoints;
   if (phspData) {
-    auto phspPoints = std::make_shared<std::vector<DataPoint>>(
-        phspData->dataPoints(trueModelKin));
+    auto phspPoints = phspData->dataPoints(trueModelKin);
   }
   trueIntens->setPhspSample(phspPoints, toyPoints);
 
-  toyPoints = std::make_shared<std::vector<DataPoint>>(
-      toyPhspData->dataPoints(fitModelKin));
+  toyPoints = toyPhspData->dataPoints(fitModelKin);
   phspPoints = toyPoints;
   if (phspData) {
-    auto phspPoints = std::make_shared<std::vector<DataPoint>>(
-        phspData->dataPoints(fitModelKin));
+    auto phspPoints = phspData->dataPoints(fitModelKin);
   }
   intens->setPhspSample(phspPoints, toyPoints);
 
@@ -235,7 +235,7 @@ int main(int argc, char **argv) {
   // Pass phsp sample to intensity for normalization.
   // Convert to dataPoints first.
   auto phspPoints =
-      std::make_shared<std::vector<DataPoint>>(phspSample->dataPoints(kin));
+      phspSample->dataPoints(kin);
   intens->setPhspSample(phspPoints, phspPoints);
 
   //---------------------------------------------------
@@ -249,7 +249,7 @@ int main(int argc, char **argv) {
   // Pass phsp sample to intensity for normalization.
   // Convert to dataPoints first.
   auto phspPointsB =
-      std::make_shared<std::vector<DataPoint>>(phspSample->dataPoints(kinB));
+      phspSample->dataPoints(kinB);
   intensB->setPhspSample(phspPointsB, phspPointsB);
 
   //---------------------------------------------------
@@ -247,7 +247,7 @@ struct energyPar {
   std::shared_ptr<ComPWA::DataReader::Data> _data;
   std::shared_ptr<ComPWA::DataReader::Data> _mcSample;
   std::shared_ptr<ComPWA::DataReader::Data> _mcSampleTrue;
-  std::shared_ptr<std::vector<ComPWA::DataPoint>> _mcPoints;
+  std::shared_ptr<ComPWA::DataPointSet> _mcPoints;
   std::shared_ptr<ComPWA::Efficiency> _eff;
   std::shared_ptr<ComPWA::Estimator::MinLogLH> _minLH;
   std::shared_ptr<RootPlot> _pl;
@@ -310,8 +310,7 @@ int main(int argc, char **argv) {
 
   // We need to call this after the construction of the amplitude since
   // the variables are calculated that are needed by the amplitude
-  sqrtS4230._mcPoints = std::make_shared<std::vector<DataPoint>>(
-      sqrtS4230._mcSample->dataPoints(sqrtS4230._kin));
+  sqrtS4230._mcPoints = sqrtS4230._mcSample->dataPoints(sqrtS4230._kin);
   sqrtS4230._amp->setPhspSample(sqrtS4230._mcPoints, sqrtS4230._mcPoints);
 
   ComPWA::Tools::generate(sqrtS4230._nEvents, sqrtS4230._kin, sqrtS4230._gen,
@@ -354,8 +353,7 @@ int main(int argc, char **argv) {
 
   // We need to call this after the construction of the amplitude since
   // the variables are calculated that are needed by the amplitude
-  sqrtS4260._mcPoints = std::make_shared<std::vector<DataPoint>>(
-      sqrtS4260._mcSample->dataPoints(sqrtS4260._kin));
+  sqrtS4260._mcPoints = sqrtS4260._mcSample->dataPoints(sqrtS4260._kin);
   sqrtS4260._amp->setPhspSample(sqrtS4260._mcPoints, sqrtS4260._mcPoints);
 
   ComPWA::Tools::generate(sqrtS4260._nEvents, sqrtS4260._kin, sqrtS4260._gen,
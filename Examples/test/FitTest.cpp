@@ -196,7 +196,7 @@ BOOST_AUTO_TEST_CASE(HelicityDalitzFit){
 	  // Pass phsp sample to intensity for normalization.
 	  // Convert to dataPoints first.
 	  auto phspPoints =
-	      std::make_shared<std::vector<DataPoint>>(phspSample->dataPoints(kin));
+	      phspSample->dataPoints(kin);
 	  intens->setPhspSample(phspPoints, phspPoints);
 
 	  //---------------------------------------------------
@@ -26,6 +26,39 @@ MinuitFcn::MinuitFcn(std::shared_ptr<ComPWA::IEstimator> myData,
 MinuitFcn::~MinuitFcn() {}
 
 double MinuitFcn::operator()(const std::vector<double> &x) const {
+  std::string paramOut = setParameters(x);
+
+  // Start timing
+  clock_t begin = clock();
+  double result = _myDataPtr->controlParameter(_parList);
+  double sec = double(clock() - begin) / CLOCKS_PER_SEC;
+
+  LOG(INFO) << "MinuitFcn: -log(L) = " << std::setprecision(10) << result
+            << std::setprecision(4) << " Time: " << sec << "s"
+            << " nCalls: " << _myDataPtr->status();
+  LOG(DEBUG) << "Parameters: " << paramOut;
+
+  return result;
+}
+
+std::vector<double> MinuitFcn::Gradient(const std::vector<double> &x) const {
+  std::string paramOut = setParameters(x);
+
+  clock_t begin = clock();
+  std::vector<double> result = _myDataPtr->gradient(_parList);
+  double sec = double(clock() - begin) / CLOCKS_PER_SEC;
+  if (result.size() != x.size())
+    throw std::runtime_error("MinuitFcn::Gradient() | Size of gradient does "
+                             "not match the number of parameters!");
+
+  LOG(INFO) << "MinuitFcn: gradient of -log(L) Time: " << std::setprecision(4)
+            << sec << "s";
+  LOG(DEBUG) << "Parameters: " << paramOut;
+
+  return result;
+}
+
+std::string MinuitFcn::setParameters(const std::vector<double> &x) const {
   std::ostringstream paramOut;
 
   size_t pos = 0;
@@ -41,18 +74,7 @@ double MinuitFcn::operator()(const std::vector<double> &x) const {
   assert(x.size() == pos && "MinuitFcn::operator() | Number is (internal) "
                             "Minuit parameters and number of ComPWA "
                             "parameters does not match!");
-
-  // Start timing
-  clock_t begin = clock();
-  double result = _myDataPtr->controlParameter(_parList);
-  double sec = double(clock() - begin) / CLOCKS_PER_SEC;
-
-  LOG(INFO) << "MinuitFcn: -log(L) = " << std::setprecision(10) << result
-            << std::setprecision(4) << " Time: " << sec << "s"
-            << " nCalls: " << _myDataPtr->status();
-  LOG(DEBUG) << "Parameters: " << paramOut.str();
-
-  return result;
+  return paramOut.str();
 }
 
 double MinuitFcn::Up() const {
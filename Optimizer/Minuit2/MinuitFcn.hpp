@@ -18,7 +18,7 @@
 #include "Core/Estimator.hpp"
 #include "Core/ParameterList.hpp"
 
-#include "Minuit2/FCNBase.h"
+#include "Minuit2/FCNGradientBase.h"
 
 namespace ROOT {
 namespace Minuit2 {
@@ -26,9 +26,12 @@ namespace Minuit2 {
 ///
 /// \class MinuitFcn
 /// Minuit2 function to be optimized based on the Minuit2 FcnBase. This class
-/// uses the ControlParameter interface for the optimization.
+/// uses the ControlParameter interface for the optimization. If the estimator
+/// provides a gradient (see IEstimator::hasGradient()), it is passed to
+/// Minuit2 via FCNGradientBase. Otherwise the function has to be passed to
+/// Minuit2 as FCNBase so that the gradient is calculated numerically.
 ///
-class MinuitFcn : public FCNBase {
+class MinuitFcn : public FCNGradientBase {
 
 public:
   MinuitFcn(std::shared_ptr<ComPWA::IEstimator> theData,
@@ -37,6 +40,13 @@ public:
 
   double operator()(const std::vector<double> &x) const;
 
+  /// Derivatives of the estimator with respect to the parameters \p x
+  std::vector<double> Gradient(const std::vector<double> &x) const;
+
+  /// The gradient is not compared to a numerical calculation at the start
+  /// of the minimization.
+  bool CheckGradient() const { return false; }
+
   double Up() const;
 
   inline void setNameID(const unsigned int id, const std::string &name) {
@@ -56,6 +66,10 @@ public:
   };
 
 private:
+  /// Set the free parameters of _parList to \p x. Returns the parameters
+  /// for logging.
+  std::string setParameters(const std::vector<double> &x) const;
+
   //// pointer to the ControlParameter (e.g. Estimator)
   std::shared_ptr<ComPWA::IEstimator> _myDataPtr;
   
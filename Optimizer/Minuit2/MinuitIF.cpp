@@ -123,8 +123,16 @@ std::shared_ptr<ComPWA::FitResult> MinuitIF::exec(ParameterList &list) {
   LOG(DEBUG) << "Hesse step tolerance: " << strat.HessianStepTolerance();
   LOG(DEBUG) << "Hesse G2 tolerance: " << strat.HessianG2Tolerance();
 
-  // MIGRAD
-  MnMigrad migrad(Function, upar, strat);
+  // MIGRAD. Analytic derivatives are used if the estimator provides them.
+  std::shared_ptr<MnMigrad> migradPtr;
+  if (Estimator->hasGradient()) {
+    LOG(INFO) << "MinuitIF::exec() | Using analytic gradient.";
+    migradPtr = std::make_shared<MnMigrad>(Function, upar, strat);
+  } else {
+    migradPtr = std::make_shared<MnMigrad>(
+        static_cast<const FCNBase &>(Function), upar, strat);
+  }
+  MnMigrad &migrad = *migradPtr;
   double maxfcn = 0.0;
   double tolerance = 0.1;
 
@@ -12,11 +12,13 @@
 
 #include <vector>
 #include <memory>
+#include <stdexcept>
 #include <math.h>
 
 #include "Core/ParameterList.hpp"
 #include "Core/FunctionTree.hpp"
 #include "Core/DataPoint.hpp"
+#include "Core/DataPointSet.hpp"
 #include "Core/Kinematics.hpp"
 
 namespace ComPWA {
@@ -114,7 +116,7 @@ public:
   /// We use the phase space sample to calculate the normalization. The sample
   /// should be without efficiency applied.
   virtual void
-  setPhspSample(std::shared_ptr<std::vector<ComPWA::DataPoint>> phspSample) = 0;
+  setPhspSample(std::shared_ptr<ComPWA::DataPointSet> phspSample) = 0;
 
   //=========== FUNCTIONTREE =================
 
@@ -125,6 +127,36 @@ public:
                                              const ParameterList &toySample,
                                              std::string suffix) = 0;
 
+  /// Does the amplitude provide shapeTree()?
+  virtual bool hasShapeTree() const { return false; }
+
+  /// FunctionTree of the amplitude without its coefficient, i.e. without
+  /// magnitude, phase and prefactor. Only available if hasShapeTree() is true.
+  virtual std::shared_ptr<FunctionTree>
+  shapeTree(std::shared_ptr<Kinematics> kin, const ParameterList &sample,
+            const ParameterList &toySample, std::string suffix) {
+    throw std::runtime_error("Amplitude::shapeTree() | Amplitude " + name() +
+                             " does not provide a shape tree!");
+  }
+
+  /// FunctionTree of the coefficient (magnitude, phase and prefactor) of the
+  /// amplitude.
+  virtual std::shared_ptr<FunctionTree> coefficientTree(std::string suffix) {
+    std::string nodeName = "Coefficient(" + name() + ")" + suffix;
+    auto tr = std::make_shared<FunctionTree>(
+        nodeName, std::make_shared<Value<std::complex<double>>>(),
+        std::make_shared<MultAll>(ParType::COMPLEX));
+    tr->createNode("Strength(" + name() + ")" + suffix,
+                   std::make_shared<Value<std::complex<double>>>(),
+                   std::make_shared<Complexify>(ParType::COMPLEX), nodeName);
+    tr->createLeaf(Magnitude->name(), Magnitude,
+                   "Strength(" + name() + ")" + suffix);
+    tr->createLeaf(Phase->name(), Phase, "Strength(" + name() + ")" + suffix);
+    tr->createLeaf("PreFactor(" + name() + ")" + suffix, preFactor(),
+                   nodeName);
+    return tr;
+  }
+
 protected:
   std::string Name;
 
@@ -8,6 +8,7 @@
 
 #include "Core/Efficiency.hpp"
 #include "Physics/CoherentIntensity.hpp"
+#include "Physics/InterferenceMatrix.hpp"
 #include "Tools/Integration.hpp"
 
 using namespace ComPWA;
@@ -16,7 +17,8 @@ using namespace ComPWA::Physics::HelicityFormalism;
 
 CoherentIntensity::CoherentIntensity(std::shared_ptr<ComPWA::PartList> partL,
                   std::shared_ptr<ComPWA::Kinematics> kin,
-                  const boost::property_tree::ptree &pt) : PhspVolume(1.0) {
+                  const boost::property_tree::ptree &pt)
+    : PhspVolume(1.0), UseInterferenceMatrix(false) {
   load(partL, kin, pt);
 }
 
@@ -37,6 +39,7 @@ void CoherentIntensity::load(std::shared_ptr<PartList> partL,
                     "not containt a configuration for an "
                     "CoherentIntensity!");
   Name = (pt.get<std::string>("<xmlattr>.Name"));
+  UseInterferenceMatrix = pt.get<bool>("<xmlattr>.InterferenceMatrix", false);
   Strength = std::make_shared<ComPWA::FitParameter>("Strength_"+Name, 1.0);
   setPhspVolume(kin->phspVolume());
   
@@ -56,9 +59,20 @@ void CoherentIntensity::load(std::shared_ptr<PartList> partL,
   }
 }
 
+bool CoherentIntensity::useInterferenceMatrix() const {
+  if (!UseInterferenceMatrix)
+    return false;
+  for (auto i : Amplitudes)
+    if (!i->hasShapeTree())
+      return false;
+  return true;
+}
+
 boost::property_tree::ptree CoherentIntensity::save() const {
   boost::property_tree::ptree pt;
   pt.put<std::string>("<xmlattr>.Name", name());
+  if (UseInterferenceMatrix)
+    pt.put<bool>("<xmlattr>.InterferenceMatrix", true);
   pt.add_child("Parameter", Strength->save());
   pt.put("Parameter.<xmlattr>.Type", "Strength");
 
@@ -140,6 +154,51 @@ CoherentIntensity::tree(std::shared_ptr<Kinematics> kin,
   return tr;
 }
 
+std::shared_ptr<ComPWA::FunctionTree>
+CoherentIntensity::interferenceTree(std::shared_ptr<Kinematics> kin,
+                                    const ComPWA::ParameterList &phspSample,
+                                    std::string suffix) {
+
+  // Efficiency values are stored on the next to last element of the
+  // ParameterList
+  std::shared_ptr<Value<std::vector<double>>> eff =
+      phspSample.mDoubleValues().end()[-2];
+  // Weights are stored on the last element of the ParameterList
+  std::shared_ptr<Value<std::vector<double>>> weightPhsp =
+      phspSample.mDoubleValues().end()[-1];
+
+  auto matrix = std::make_shared<InterferenceMatrix>(Amplitudes.size());
+
+  std::string headName = "InterferenceIntegral(" + name() + ")" + suffix;
+  auto tr = std::make_shared<FunctionTree>(
+      headName, std::make_shared<Value<double>>(),
+      std::make_shared<MultAll>(ParType::DOUBLE));
+  tr->createLeaf("Strength", Strength, headName);
+  tr->createNode("QuadraticForm", std::make_shared<Value<double>>(),
+                 std::make_shared<InterferenceIntegral>(matrix), headName);
+
+  // The coefficients have to be inserted in the order of the amplitudes
+  for (size_t k = 0; k < Amplitudes.size(); ++k) {
+    auto amp = Amplitudes.at(k);
+    tr->insertTree(amp->coefficientTree(suffix), "QuadraticForm");
+
+    std::string shapeName = "InterferenceShape(" + amp->name() + ")" + suffix;
+    tr->createNode(shapeName, std::make_shared<Value<double>>(),
+                   std::make_shared<InterferenceShape>(matrix, k),
+                   "QuadraticForm");
+    tr->createLeaf("Efficiency", eff, shapeName);
+    tr->createLeaf("EventWeight", weightPhsp, shapeName);
+
+    auto shapeTree = amp->shapeTree(kin, phspSample, phspSample, suffix);
+    if (!shapeTree->sanityCheck())
+      throw std::runtime_error("CoherentIntensity::interferenceTree() | "
+                               "Shape tree didn't pass sanity check!");
+    tr->insertTree(shapeTree, shapeName);
+  }
+
+  return tr;
+}
+
 void CoherentIntensity::parameters(ComPWA::ParameterList &list) {
   Strength = list.addUniqueParameter(Strength);
   for (auto i : Amplitudes) {
@@ -26,7 +26,8 @@ public:
           std::shared_ptr<FitParameter>(new FitParameter("", 1.0)),
       std::shared_ptr<Efficiency> eff =
           std::shared_ptr<Efficiency>(new UnitEfficiency))
-      : AmpIntensity(name, strength, eff), PhspVolume(1.0){};
+      : AmpIntensity(name, strength, eff), PhspVolume(1.0),
+        UseInterferenceMatrix(false){};
 
   CoherentIntensity(std::shared_ptr<PartList> partL,
                     std::shared_ptr<Kinematics> kin,
@@ -89,8 +90,8 @@ public:
     /// the maximum of the amplitude. In case that the efficiency is already
     /// applied to the sample set fEff to false.
     void setPhspSample(
-        std::shared_ptr<std::vector<ComPWA::DataPoint>> phspSample,
-        std::shared_ptr<std::vector<ComPWA::DataPoint>> toySample) {
+        std::shared_ptr<ComPWA::DataPointSet> phspSample,
+        std::shared_ptr<ComPWA::DataPointSet> toySample) {
       PhspSample = phspSample;
 
       for (auto i : Amplitudes)
@@ -111,13 +112,37 @@ public:
         const ComPWA::ParameterList &toySample, unsigned int nEvtVar,
         std::string suffix = "");
 
+    /// Calculate the normalization via a matrix of interference integrals
+    /// (see InterferenceMatrix). A change of magnitudes or phases of the
+    /// amplitudes does not require an evaluation of the amplitudes on the
+    /// phase space sample.
+    virtual void setUseInterferenceMatrix(bool b) {
+      UseInterferenceMatrix = b;
+    }
+
+    /// The interference matrix is used if it was requested and all amplitudes
+    /// provide a shape tree (see Amplitude::hasShapeTree()).
+    virtual bool useInterferenceMatrix() const;
+
+    /// Tree for the weighted sum of the intensity over \p phspSample. The
+    /// efficiency and the event weights are expected to be the next to last
+    /// and the last multi double value of \p phspSample. The sum is calculated
+    /// via an InterferenceMatrix. Its rows are updated only if the shape of the
+    /// corresponding amplitude changes.
+    virtual std::shared_ptr<ComPWA::FunctionTree>
+    interferenceTree(std::shared_ptr<Kinematics> kin,
+                     const ComPWA::ParameterList &phspSample,
+                     std::string suffix = "");
+
   protected:
     /// Phase space sample to calculate the normalization and maximum value.
-    std::shared_ptr<std::vector<ComPWA::DataPoint>> PhspSample;
+    std::shared_ptr<ComPWA::DataPointSet> PhspSample;
 
     double PhspVolume;
 
     std::vector<std::shared_ptr<ComPWA::Physics::Amplitude>> Amplitudes;
+
+    bool UseInterferenceMatrix;
 };
 
 } // namespace Physics
@@ -5,6 +5,7 @@
 #include <cmath>
 //#include <math.h>
 #include "Core/Value.hpp"
+#include "Core/ThreadPool.hpp"
 #include "Physics/DecayDynamics/AmpFlatteRes.hpp"
 #include <limits>
 
@@ -193,7 +194,7 @@ AmpFlatteRes::tree(const ParameterList &sample, int pos, std::string suffix) {
   size_t sampleSize = sample.mDoubleValue(pos)->values().size();
   auto tr = std::make_shared<FunctionTree>(
       "Flatte" + suffix, MComplex("", sampleSize),
-      std::make_shared<FlatteStrategy>(""));
+      std::make_shared<FlatteStrategy>(name()));
 
   tr->createLeaf("Mass", Mass, "Flatte" + suffix);
   for (int i = 0; i < Couplings.size(); i++) {
@@ -223,7 +224,7 @@ void FlatteStrategy::execute(ParameterList &paras,
 
 #ifndef NDEBUG
   // Check parameter type
-  if (checkType != out->type())
+  if (out && checkType != out->type())
     throw(WrongParType("FlatteStrategy::execute() | "
                        "Output parameter is of type " +
                        std::string(ParNames[out->type()]) +
@@ -278,41 +279,157 @@ void FlatteStrategy::execute(ParameterList &paras,
                        std::to_string(check_nMComplex) + " expected."));
 #endif
 
-  size_t n = paras.mDoubleValue(0)->values().size();
-  if (!out)
-    out = MComplex("", n);
+  auto sample = paras.mDoubleValue(0);
+  auto &data = sample->values();
+  size_t n = data.size();
+  auto &results = multiOutput<std::complex<double>>(out, n);
+
+  // Get parameters from ParameterList:
+  // We use the same order of the parameters as was used during tree
+  // construction.
+  double mR = paras.doubleParameter(0)->value();
+  std::vector<double> masses(2 * NumChannels);
+  std::vector<double> g(NumChannels);
+  for (unsigned int i = 0; i < NumChannels; ++i) {
+    masses[2 * i] = paras.doubleValue(2 * i)->value();
+    masses[2 * i + 1] = paras.doubleValue(2 * i + 1)->value();
+    g[i] = paras.doubleParameter(i + 1)->value();
+  }
+  // Generally we need to add a factor q^{2J+1} to each channel term.
+  // But since Flatte resonances are usually J=0 we neglect it here.
+  unsigned int orbitL = paras.doubleValue(6)->value();
+  double d = paras.doubleParameter(4)->value();
+  formFactorType ffType = formFactorType(paras.doubleValue(7)->value());
+
+  // The signal channel and the first hidden channel are always included
+  std::vector<bool> active(NumChannels, true);
+  active[2] = (g[2] != 0.0);
+
+  if (sample->generation() != CachedGeneration || n != RhoRe[0].size() ||
+      masses != CachedMasses || active != Active)
+    updateSample(*sample, masses, active);
+  if (orbitL != CachedL || d != CachedRadius || ffType != CachedFFType)
+    updateBarrier(data, orbitL, d, ffType);
+
+  // Width of each channel without the event dependent factors, see
+  // flatteCouplingTerm()
+  double k[NumChannels];
+  const double *tRe[NumChannels], *tIm[NumChannels];
+  unsigned int numActive = 0;
+  try {
+    for (unsigned int i = 0; i < NumChannels; ++i) {
+      if (!Active[i])
+        continue;
+      double ma = masses[2 * i], mb = masses[2 * i + 1];
+      std::complex<double> qR = qValue(mR, ma, mb);
+      double ffR = FormFactor(qR, orbitL, d, ffType);
+      std::complex<double> vtx(1, 0);
+      if (orbitL > 0 || ffType == formFactorType::CrystalBarrel)
+        vtx = ffR * std::pow(qR, orbitL);
+      k[numActive] = std::norm(vtx) * g[i] * g[i] / (mR * ffR * ffR);
+      tRe[numActive] = TermRe[i].data();
+      tIm[numActive] = TermIm[i].data();
+      numActive++;
+    }
+  } catch (std::exception &ex) {
+    LOG(ERROR) << "FlatteStrategy::execute() | " << ex.what();
+    throw(std::runtime_error("FlatteStrategy::execute() | "
+                             "Evaluation of dynamic function failed!"));
+  }
 
-  auto par =
-      std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out);
-  auto &results = par->values(); // reference
+  double mSqR = mR * mR, gA = g[0];
+  const double *s = data.data();
+  std::complex<double> *res = results.data();
+  ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+    for (size_t ele = begin; ele < end; ele++) {
+      // sqrt(s) * sum of the channel terms
+      double wRe = 0, wIm = 0;
+      for (unsigned int i = 0; i < numActive; ++i) {
+        wRe += k[i] * tRe[i][ele];
+        wIm += k[i] * tIm[i][ele];
+      }
+      // denominator (mR^2 - s) - i * sqrt(s) * sum of the channel terms
+      double dRe = mSqR - s[ele] + wIm;
+      double dIm = -wRe;
+      double norm = dRe * dRe + dIm * dIm;
+      res[ele] = std::complex<double>(gA * dRe / norm, -gA * dIm / norm);
+    }
+  });
+}
 
-  // calc function for each point
-  for (size_t ele = 0; ele < n; ele++) {
-    try {
-      // Generally we need to add a factor q^{2J+1} to each channel term.
-      // But since Flatte resonances are usually J=0 we neglect it here.
-      results.at(ele) = AmpFlatteRes::dynamicalFunction(
-          paras.mDoubleValue(0)->values().at(ele),
-          paras.doubleParameter(0)->value(), // mass
-          paras.doubleValue(0)->value(),     // g1_massA
-          paras.doubleValue(1)->value(),     // g1_massB
-          paras.doubleParameter(1)->value(), // g1
-          paras.doubleValue(2)->value(),     // g2_massA
-          paras.doubleValue(3)->value(),     // g2_massB
-          paras.doubleParameter(2)->value(), // g2
-          paras.doubleValue(4)->value(),     // g3_massA
-          paras.doubleValue(5)->value(),     // g3_massB
-          paras.doubleParameter(3)->value(), // g3
-          paras.doubleValue(6)->value(),     // OrbitalAngularMomentum
-          paras.doubleParameter(4)->value(), // mesonRadius
-          formFactorType(paras.doubleValue(7)->value()) // ffType
-          );
-    } catch (std::exception &ex) {
-      LOG(ERROR) << "FlatteStrategy::execute() | " << ex.what();
-      throw(std::runtime_error("FlatteStrategy::execute() | "
-                               "Evaluation of dynamic function failed!"));
+void FlatteStrategy::updateSample(Value<std::vector<double>> &sample,
+                                  const std::vector<double> &masses,
+                                  const std::vector<bool> &active) {
+  auto &data = sample.values();
+  size_t n = data.size();
+  for (unsigned int i = 0; i < NumChannels; ++i) {
+    if (active[i]) {
+      RhoRe[i].resize(n);
+      RhoIm[i].resize(n);
+    } else {
+      // Columns of inactive channels are released
+      std::vector<double>().swap(RhoRe[i]);
+      std::vector<double>().swap(RhoIm[i]);
+      std::vector<double>().swap(TermRe[i]);
+      std::vector<double>().swap(TermIm[i]);
+    }
+  }
+  ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+    for (unsigned int i = 0; i < NumChannels; ++i) {
+      if (!active[i])
+        continue;
+      double ma = masses[2 * i], mb = masses[2 * i + 1];
+      for (size_t ele = begin; ele < end; ele++) {
+        double sqrtS = std::sqrt(data[ele]);
+        std::complex<double> rho;
+        try {
+          rho = sqrtS * phspFactor(sqrtS, ma, mb);
+        } catch (std::exception &ex) {
+          LOG(ERROR) << "FlatteStrategy::updateSample() | " << ex.what();
+          throw(std::runtime_error("FlatteStrategy::execute() | "
+                                   "Evaluation of dynamic function failed!"));
+        }
+        RhoRe[i][ele] = rho.real();
+        RhoIm[i][ele] = rho.imag();
+      }
     }
+  });
+  CachedGeneration = sample.generation();
+  CachedMasses = masses;
+  Active = active;
+  // The channel columns depend on the sample as well
+  CachedRadius = std::numeric_limits<double>::quiet_NaN();
+}
+
+void FlatteStrategy::updateBarrier(const std::vector<double> &data,
+                                   unsigned int L, double mesonRadius,
+                                   formFactorType ffType) {
+  size_t n = data.size();
+  for (unsigned int i = 0; i < NumChannels; ++i) {
+    if (!Active[i])
+      continue;
+    TermRe[i].resize(n);
+    TermIm[i].resize(n);
   }
+  ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+    for (unsigned int i = 0; i < NumChannels; ++i) {
+      if (!Active[i])
+        continue;
+      double ma = CachedMasses[2 * i], mb = CachedMasses[2 * i + 1];
+      for (size_t ele = begin; ele < end; ele++) {
+        double ff = 1.0;
+        if (ffType != noFormFactor) {
+          double sqrtS = std::sqrt(data[ele]);
+          ff = FormFactor(sqrtS, ma, mb, L, mesonRadius, ffType);
+        }
+        TermRe[i][ele] = ff * ff * RhoRe[i][ele];
+        TermIm[i][ele] = ff * ff * RhoIm[i][ele];
+      }
+    }
+  });
+  CachedL = L;
+  CachedRadius = mesonRadius;
+  CachedFFType = ffType;
 }
 
 void AmpFlatteRes::SetCouplings(std::vector<Coupling> vC) {
@@ -16,6 +16,7 @@
 
 #include <vector>
 #include <cmath>
+#include <limits>
 #include "Physics/DecayDynamics/AbstractDynamicalFunction.hpp"
 #include "Physics/DecayDynamics/FormFactor.hpp"
 #include "Physics/DecayDynamics/Coupling.hpp"
@@ -156,10 +157,31 @@ private:
   double Current_g, Current_gHidden, Current_gHidden2;
 };
 
+///
+/// \class FlatteStrategy
+/// FunctionTree node of AmpFlatteRes. The phase space factors rho_i(s) of
+/// the channels depend only on the masses of the final state particles.
+/// They are calculated once per channel for all events and kept until the
+/// sample or the masses change. Together with the barrier factors, which
+/// are kept as long as the meson radius does not change, they form one
+/// column per channel. The coupled denominator is then evaluated over the
+/// whole sample in a loop over arrays of doubles. As in
+/// AmpFlatteRes::dynamicalFunction() the third channel is taken into
+/// account only if its coupling is non-zero.
+/// The sample is identified by its generation (see Value::generation()).
+/// Changes of the sample in place have to be announced via Value::modified().
+///
 class FlatteStrategy : public Strategy {
 public:
-  FlatteStrategy(const std::string resonanceName)
-      : Strategy(ParType::MCOMPLEX), name(resonanceName) {}
+  /// Number of channels of AmpFlatteRes
+  static const unsigned int NumChannels = 3;
+
+  FlatteStrategy(const std::string resonanceName = "")
+      : Strategy(ParType::MCOMPLEX), name(resonanceName), CachedGeneration(0),
+        CachedL(0), CachedRadius(std::numeric_limits<double>::quiet_NaN()),
+        CachedFFType(noFormFactor), CachedMasses(2 * NumChannels, 0.0),
+        Active(NumChannels, false), RhoRe(NumChannels), RhoIm(NumChannels),
+        TermRe(NumChannels), TermIm(NumChannels) {}
 
   virtual const std::string to_str() const {
     return ("flatte amplitude of " + name);
@@ -169,7 +191,41 @@ public:
                        std::shared_ptr<Parameter> &out);
 
 protected:
+  /// Calculate sqrt(s) * rho_i(s) of the \p active channels for the events
+  /// in \p sample. \p masses contains the final state masses of all
+  /// channels.
+  void updateSample(Value<std::vector<double>> &sample,
+                    const std::vector<double> &masses,
+                    const std::vector<bool> &active);
+
+  /// Calculate the channel columns sqrt(s) * rho_i(s) * F_i(s)^2
+  void updateBarrier(const std::vector<double> &data, unsigned int L,
+                     double mesonRadius, formFactorType ffType);
+
   std::string name;
+
+  /// Sample of the cached quantities
+  std::uint64_t CachedGeneration;
+
+  /// Orbital angular momentum, meson radius and form factor type of the
+  /// channel columns
+  unsigned int CachedL;
+  double CachedRadius;
+  formFactorType CachedFFType;
+
+  /// Final state masses of the channels
+  std::vector<double> CachedMasses;
+
+  /// Channels with cached columns
+  std::vector<bool> Active;
+
+  /// sqrt(s) * rho_i(s) for each channel, real and imaginary part
+  std::vector<std::vector<double>> RhoRe;
+  std::vector<std::vector<double>> RhoIm;
+
+  /// sqrt(s) * rho_i(s) * F_i(s)^2 for each channel, real and imaginary part
+  std::vector<std::vector<double>> TermRe;
+  std::vector<std::vector<double>> TermIm;
 };
 
 } // ns::DecayDynamics
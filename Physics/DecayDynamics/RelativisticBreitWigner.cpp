@@ -11,6 +11,7 @@
 
 #include "Physics/HelicityFormalism/HelicityKinematics.hpp"
 #include "Physics/DecayDynamics/RelativisticBreitWigner.hpp"
+#include "Core/ThreadPool.hpp"
 #include "Physics/DecayDynamics/Coupling.hpp"
 
 using namespace ComPWA::Physics::DecayDynamics;
@@ -180,7 +181,7 @@ void BreitWignerStrategy::execute(ParameterList &paras,
 
 #ifndef NDEBUG
   // Check parameter type
-  if (checkType != out->type())
+  if (out && checkType != out->type())
     throw(WrongParType("BreitWignerStrat::execute() | "
                        "Output parameter is of type " +
                        std::string(ParNames[out->type()]) +
@@ -235,12 +236,10 @@ void BreitWignerStrategy::execute(ParameterList &paras,
                        std::to_string(check_nMComplex) + " expected."));
 #endif
 
-  size_t n = paras.mDoubleValue(0)->values().size();
-  if (!out)
-    out = MComplex("", n);
-  auto par =
-      std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out);
-  auto &results = par->values(); // reference
+  auto sample = paras.mDoubleValue(0);
+  auto &data = sample->values();
+  size_t n = data.size();
+  auto &results = multiOutput<std::complex<double>>(out, n);
 
   // Get parameters from ParameterList:
   // We use the same order of the parameters as was used during tree
@@ -253,18 +252,113 @@ void BreitWignerStrategy::execute(ParameterList &paras,
   double ma = paras.doubleValue(2)->value();
   double mb = paras.doubleValue(3)->value();
 
-  // calc function for each point
-  for (unsigned int ele = 0; ele < n; ele++) {
-    try {
-      results.at(ele) = RelativisticBreitWigner::dynamicalFunction(
-          paras.mDoubleValue(0)->values().at(ele), m0, ma, mb, Gamma0, orbitL,
-          d, ffType);
-    } catch (std::exception &ex) {
-      LOG(ERROR) << "BreitWignerStrategy::execute() | " << ex.what();
-      throw(std::runtime_error("BreitWignerStrategy::execute() | "
-                               "Evaluation of dynamic function failed!"));
+  if (sample->generation() != CachedGeneration || n != RhoPowRe.size() ||
+      ma != CachedMa || mb != CachedMb || orbitL != CachedL)
+    updateSample(*sample, ma, mb, orbitL);
+  if (d != CachedRadius || ffType != CachedFFType)
+    updateBarrier(data, d, ffType);
+
+  // Quantities at the resonance position, see
+  // RelativisticBreitWigner::dynamicalFunction()
+  std::complex<double> rhoR = phspFactor(m0, ma, mb);
+  double ffR = FormFactor(m0, ma, mb, orbitL, d, ffType);
+  std::complex<double> gammaA(1, 0);
+  if (orbitL > 0)
+    gammaA = ffR * std::pow(qValue(m0, ma, mb), orbitL);
+  // Coupling without the phase space factor at sqrt(s)
+  std::complex<double> c = std::complex<double>(std::sqrt(m0 * Gamma0), 0) /
+                           gammaA;
+  // Width times damping without the event dependent factors
+  std::complex<double> k = m0 / rhoR;
+  std::complex<double> kPow = k;
+  for (unsigned int i = 0; i < 2 * orbitL; ++i)
+    kPow *= k;
+  kPow *= Gamma0 / ffR;
+
+  double mSqR = m0 * m0, cRe = c.real(), cIm = c.imag();
+  double kRe = kPow.real(), kIm = kPow.imag();
+  const double *s = data.data();
+  const double *pRe = RhoPowRe.data(), *pIm = RhoPowIm.data();
+  const double *iRe = InvSqrtRhoRe.data(), *iIm = InvSqrtRhoIm.data();
+  const double *f = SqrtSBarrier.data();
+  std::complex<double> *res = results.data();
+  ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+    for (size_t ele = begin; ele < end; ele++) {
+      // sqrt(s) * width * damping
+      double wRe = f[ele] * (kRe * pRe[ele] - kIm * pIm[ele]);
+      double wIm = f[ele] * (kRe * pIm[ele] + kIm * pRe[ele]);
+      // denominator (mR^2 - s) - i * sqrt(s) * width * damping
+      double dRe = mSqR - s[ele] + wIm;
+      double dIm = -wRe;
+      // coupling to the final state
+      double gRe = cRe * iRe[ele] - cIm * iIm[ele];
+      double gIm = cRe * iIm[ele] + cIm * iRe[ele];
+      double norm = dRe * dRe + dIm * dIm;
+      res[ele] = std::complex<double>((gRe * dRe + gIm * dIm) / norm,
+                                      (gIm * dRe - gRe * dIm) / norm);
     }
-  }
+  });
+}
+
+void BreitWignerStrategy::updateSample(Value<std::vector<double>> &sample,
+                                       double ma, double mb, unsigned int L) {
+  auto &data = sample.values();
+  size_t n = data.size();
+  RhoPowRe.resize(n);
+  RhoPowIm.resize(n);
+  InvSqrtRhoRe.resize(n);
+  InvSqrtRhoIm.resize(n);
+  ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+    for (size_t ele = begin; ele < end; ele++) {
+      double sqrtS = std::sqrt(data[ele]);
+      std::complex<double> rho;
+      try {
+        rho = phspFactor(sqrtS, ma, mb);
+      } catch (std::exception &ex) {
+        LOG(ERROR) << "BreitWignerStrategy::updateSample() | " << ex.what();
+        throw(std::runtime_error("BreitWignerStrategy::execute() | "
+                                 "Evaluation of dynamic function failed!"));
+      }
+      // Events exactly at the phase space boundary have a zero amplitude
+      if (rho == std::complex<double>(0, 0)) {
+        RhoPowRe[ele] = RhoPowIm[ele] = 0;
+        InvSqrtRhoRe[ele] = InvSqrtRhoIm[ele] = 0;
+        continue;
+      }
+      std::complex<double> u = rho / sqrtS;
+      std::complex<double> uPow = u;
+      for (unsigned int i = 0; i < 2 * L; ++i)
+        uPow *= u;
+      std::complex<double> inv = 1.0 / std::sqrt(rho);
+      RhoPowRe[ele] = uPow.real();
+      RhoPowIm[ele] = uPow.imag();
+      InvSqrtRhoRe[ele] = inv.real();
+      InvSqrtRhoIm[ele] = inv.imag();
+    }
+  });
+  CachedGeneration = sample.generation();
+  CachedMa = ma;
+  CachedMb = mb;
+  CachedL = L;
+  // The barrier factors depend on the sample as well
+  CachedRadius = std::numeric_limits<double>::quiet_NaN();
+}
+
+void BreitWignerStrategy::updateBarrier(const std::vector<double> &data,
+                                        double mesonRadius,
+                                        formFactorType ffType) {
+  size_t n = data.size();
+  SqrtSBarrier.resize(n);
+  ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+    for (size_t ele = begin; ele < end; ele++) {
+      double sqrtS = std::sqrt(data[ele]);
+      SqrtSBarrier[ele] =
+          sqrtS *
+          FormFactor(sqrtS, CachedMa, CachedMb, CachedL, mesonRadius, ffType);
+    }
+  });
+  CachedRadius = mesonRadius;
+  CachedFFType = ffType;
 }
 
 void RelativisticBreitWigner::parameters(ParameterList &list) {
@@ -5,6 +5,7 @@
 #ifndef PHYSICS_DECAYDYNAMICS_RELATIVISTICBREITWIGNER_HPP_
 #define PHYSICS_DECAYDYNAMICS_RELATIVISTICBREITWIGNER_HPP_
 
+#include <limits>
 #include <vector>
 #include <memory>
 #include <boost/property_tree/ptree.hpp>
@@ -135,10 +136,22 @@ private:
   double CurrentWidth;
 };
 
+/// \class BreitWignerStrategy
+/// FunctionTree node of RelativisticBreitWigner. The quantities that do not
+/// depend on the fit parameters (phase space factor and break-up momentum
+/// of each event) are calculated on the first execution and kept until the
+/// sample changes. The barrier factors of the events are kept as long as
+/// the meson radius does not change. The remaining evaluation is a simple
+/// loop over arrays of doubles which the compiler can vectorise.
+/// The sample is identified by its generation (see Value::generation()).
+/// Changes of the sample in place have to be announced via Value::modified().
 class BreitWignerStrategy : public ComPWA::Strategy {
 public:
   BreitWignerStrategy(std::string namee = "")
-      : ComPWA::Strategy(ParType::MCOMPLEX), name(namee) {}
+      : ComPWA::Strategy(ParType::MCOMPLEX), name(namee), CachedGeneration(0),
+        CachedMa(0), CachedMb(0), CachedL(0),
+        CachedRadius(std::numeric_limits<double>::quiet_NaN()),
+        CachedFFType(noFormFactor) {}
 
   virtual const std::string to_str() const {
     return ("relativistic BreitWigner of " + name);
@@ -148,7 +161,38 @@ public:
                        std::shared_ptr<ComPWA::Parameter> &out);
 
 protected:
+  /// Calculate the parameter independent quantities of the events in
+  /// \p sample
+  void updateSample(ComPWA::Value<std::vector<double>> &sample, double ma,
+                    double mb, unsigned int L);
+
+  /// Calculate sqrt(s) times the barrier factor for each event
+  void updateBarrier(const std::vector<double> &data, double mesonRadius,
+                     formFactorType ffType);
+
   std::string name;
+
+  /// Sample of the cached quantities
+  std::uint64_t CachedGeneration;
+  double CachedMa;
+  double CachedMb;
+  unsigned int CachedL;
+
+  /// Meson radius and form factor type of SqrtSBarrier
+  double CachedRadius;
+  formFactorType CachedFFType;
+
+  /// (rho(s) / sqrt(s))^(2L+1), real and imaginary part
+  std::vector<double> RhoPowRe;
+  std::vector<double> RhoPowIm;
+
+  /// 1 / sqrt(rho(s)), real and imaginary part. Zero for events at the
+  /// threshold.
+  std::vector<double> InvSqrtRhoRe;
+  std::vector<double> InvSqrtRhoIm;
+
+  /// sqrt(s) * F(sqrt(s))
+  std::vector<double> SqrtSBarrier;
 };
 
 } // namespace DecayDynamics
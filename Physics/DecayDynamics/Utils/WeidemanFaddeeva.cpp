@@ -0,0 +1,117 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+
+#include "Core/Exceptions.hpp"
+#include "Physics/DecayDynamics/Utils/WeidemanFaddeeva.hpp"
+
+namespace ComPWA {
+namespace Physics {
+namespace DecayDynamics {
+
+namespace {
+/// Number of arguments that are processed together
+const std::size_t BlockSize = 64;
+}
+
+WeidemanFaddeeva::WeidemanFaddeeva(unsigned int numTerms) {
+  if (numTerms == 0)
+    throw BadParameter("WeidemanFaddeeva::WeidemanFaddeeva() | At least "
+                       "one term is required!");
+  int N = numTerms;
+  int M = 2 * N;
+  int M2 = 2 * M;
+  L = std::sqrt(N / std::sqrt(2.0));
+
+  // f(t) = exp(-t^2) (L^2 + t^2) at t = L tan(theta / 2) on M2 equidistant
+  // angles theta = k pi / M, k = -M...M-1. The sample at theta = -pi is zero.
+  // The samples are stored in the order of the discrete Fourier transform,
+  // i.e. starting at theta = 0.
+  std::vector<double> f(M2, 0.0);
+  for (int k = -M + 1; k < M; ++k) {
+    double t = L * std::tan(0.5 * k * M_PI / M);
+    f[(k + M2) % M2] = std::exp(-t * t) * (L * L + t * t);
+  }
+
+  // The coefficients are the real parts of the Fourier coefficients 1...N
+  Coefficients.resize(N);
+  for (int m = 1; m <= N; ++m) {
+    double sum = 0;
+    for (int i = 0; i < M2; ++i)
+      sum += f[i] * std::cos(2 * M_PI * ((double)m * i / M2));
+    Coefficients[N - m] = sum / M2;
+  }
+}
+
+std::complex<double> WeidemanFaddeeva::w(std::complex<double> z) const {
+  double x = z.real(), re, im;
+  w(&x, z.imag(), &re, &im, 1);
+  return std::complex<double>(re, im);
+}
+
+void WeidemanFaddeeva::w(const double *x, double y, double *re, double *im,
+                         std::size_t n) const {
+  if (y < 0) {
+    // Reflection into the upper half plane
+    for (std::size_t i = 0; i < n; ++i) {
+      double mx = -x[i];
+      w(&mx, -y, re + i, im + i, 1);
+      std::complex<double> z(x[i], y);
+      std::complex<double> res =
+          2.0 * std::exp(-z * z) - std::complex<double>(re[i], im[i]);
+      re[i] = res.real();
+      im[i] = res.imag();
+    }
+    return;
+  }
+
+  const double invSqrtPi = 1.0 / std::sqrt(M_PI);
+  const double *a = Coefficients.data();
+  std::size_t numTerms = Coefficients.size();
+  double zRe[BlockSize], zIm[BlockSize], pRe[BlockSize], pIm[BlockSize];
+  double dRe[BlockSize], dIm[BlockSize];
+
+  for (std::size_t begin = 0; begin < n; begin += BlockSize) {
+    std::size_t m = std::min(BlockSize, n - begin);
+    const double *xb = x + begin;
+
+    // d = 1 / (L - iz) and Z = (L + iz) / (L - iz) with z = x + iy
+    for (std::size_t i = 0; i < m; ++i) {
+      double denRe = L + y, denIm = -xb[i];
+      double norm = 1.0 / (denRe * denRe + denIm * denIm);
+      dRe[i] = denRe * norm;
+      dIm[i] = -denIm * norm;
+      double numRe = L - y, numIm = xb[i];
+      zRe[i] = numRe * dRe[i] - numIm * dIm[i];
+      zIm[i] = numRe * dIm[i] + numIm * dRe[i];
+      pRe[i] = a[0];
+      pIm[i] = 0.0;
+    }
+
+    // Horner scheme, term by term for the whole block
+    for (std::size_t k = 1; k < numTerms; ++k) {
+      double ak = a[k];
+      for (std::size_t i = 0; i < m; ++i) {
+        double tRe = pRe[i] * zRe[i] - pIm[i] * zIm[i] + ak;
+        double tIm = pRe[i] * zIm[i] + pIm[i] * zRe[i];
+        pRe[i] = tRe;
+        pIm[i] = tIm;
+      }
+    }
+
+    // w = (2 p d + 1 / sqrt(pi)) d
+    for (std::size_t i = 0; i < m; ++i) {
+      double qRe = 2 * (pRe[i] * dRe[i] - pIm[i] * dIm[i]) + invSqrtPi;
+      double qIm = 2 * (pRe[i] * dIm[i] + pIm[i] * dRe[i]);
+      re[begin + i] = qRe * dRe[i] - qIm * dIm[i];
+      im[begin + i] = qRe * dIm[i] + qIm * dRe[i];
+    }
+  }
+}
+
+} // namespace DecayDynamics
+} // namespace Physics
+} // namespace ComPWA
@@ -0,0 +1,65 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Rational approximation of the Faddeeva function for batches of arguments.
+///
+
+#ifndef WEIDEMAN_FADDEEVA_HPP_
+#define WEIDEMAN_FADDEEVA_HPP_
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace ComPWA {
+namespace Physics {
+namespace DecayDynamics {
+
+///
+/// \class WeidemanFaddeeva
+/// Faddeeva function w(z) = exp(-z^2) erfc(-iz) in the upper half plane
+/// via the rational approximation of J.A.C. Weideman, SIAM J. Numer. Anal.
+/// 31 (1994) 1497:
+///   w(z) = 2 p(Z) / (L - iz)^2 + 1 / (sqrt(pi) (L - iz)),
+///   Z = (L + iz) / (L - iz),
+/// with a polynomial p of degree N-1 and L = sqrt(N / sqrt(2)). The
+/// coefficients of p are calculated once in the constructor. The accuracy
+/// is selected via the number of terms N. Compared to Faddeeva::w() the
+/// maximal relative deviation of w(z) for |Re z| < 100 and
+/// 1e-4 < Im z < 10 is about 4e-7 (N = 16), 4e-10 (N = 24) and 4e-13
+/// (N = 32). The relative deviation of Re w(z) is larger where Re w(z) is
+/// small (large |Re z|, small Im z): 2e-2, 3e-5 and 3e-8.
+///
+/// The batch evaluation has no branches and processes blocks of arguments
+/// term by term, so that the loops over the arguments can be vectorised.
+/// Arguments in the lower half plane are reflected via
+/// w(z) = 2 exp(-z^2) - w(-z).
+///
+class WeidemanFaddeeva {
+public:
+  WeidemanFaddeeva(unsigned int numTerms = 32);
+
+  unsigned int numTerms() const { return Coefficients.size(); }
+
+  std::complex<double> w(std::complex<double> z) const;
+
+  /// w(x[i] + i y) for \p n values \p x. Real and imaginary part of the
+  /// result are stored in \p re and \p im.
+  void w(const double *x, double y, double *re, double *im,
+         std::size_t n) const;
+
+protected:
+  /// Coefficients of p, highest degree first
+  std::vector<double> Coefficients;
+
+  double L;
+};
+
+} // namespace DecayDynamics
+} // namespace Physics
+} // namespace ComPWA
+
+#endif
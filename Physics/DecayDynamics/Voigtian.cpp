@@ -2,6 +2,7 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 #include <iterator>
@@ -12,12 +13,14 @@
 #include "Physics/HelicityFormalism/HelicityKinematics.hpp"
 #include "Physics/DecayDynamics/Voigtian.hpp"
 #include "Physics/DecayDynamics/Coupling.hpp"
+#include "Core/ThreadPool.hpp"
 
 using namespace ComPWA::Physics::DecayDynamics;
 
 Voigtian::Voigtian(std::string name,
                    std::pair<std::string, std::string> daughters,
-                   std::shared_ptr<ComPWA::PartList> partL) {
+                   std::shared_ptr<ComPWA::PartList> partL)
+    : FaddeevaTerms(32) {
 
   LOG(TRACE) << "Voigtian::Factory() | Construction of " << name << ".";
   setName(name);
@@ -143,9 +146,13 @@ Voigtian::tree(const ParameterList &sample, int pos, std::string suffix) {
 
   size_t sampleSize = sample.mDoubleValue(pos)->values().size();
 
+  std::shared_ptr<const WeidemanFaddeeva> faddeeva;
+  if (FaddeevaTerms)
+    faddeeva = std::make_shared<const WeidemanFaddeeva>(FaddeevaTerms);
+
   auto tr = std::make_shared<FunctionTree>(
       "Voigtian" + suffix, MComplex("", sampleSize),
-      std::make_shared<VoigtianStrategy>());
+      std::make_shared<VoigtianStrategy>("", faddeeva));
 
   tr->createLeaf("Mass", Mass, "Voigtian" + suffix);
   tr->createLeaf("Width", Width, "Voigtian" + suffix);
@@ -163,7 +170,7 @@ void VoigtianStrategy::execute(ParameterList &paras,
 
 #ifndef NDEBUG
   // Check parameter type
-  if (checkType != out->type())
+  if (out && checkType != out->type())
     throw(WrongParType("VoigtianStrat::execute() | "
                        "Output parameter is of type " +
                        std::string(ParNames[out->type()]) +
@@ -221,11 +228,7 @@ void VoigtianStrategy::execute(ParameterList &paras,
 #endif
 
   size_t n = paras.mDoubleValue(0)->values().size();
-  if (!out)
-    out = MComplex("", n);
-  auto par =
-      std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out);
-  auto &results = par->values(); // reference
+  auto &results = multiOutput<std::complex<double>>(out, n);
 
   // Get parameters from ParameterList:
   // We use the same order of the parameters as was used during tree
@@ -234,17 +237,47 @@ void VoigtianStrategy::execute(ParameterList &paras,
   double Gamma0 = paras.doubleParameter(1)->value();
   double sigma = paras.doubleValue(0)->value();
 
-  // calc function for each point
-  for (unsigned int ele = 0; ele < n; ele++) {
-    try {
-      results.at(ele) = Voigtian::dynamicalFunction(
-          paras.mDoubleValue(0)->values().at(ele), m0, Gamma0, sigma);
-    } catch (std::exception &ex) {
-      LOG(ERROR) << "VoigtianStrategy::execute() | " << ex.what();
-      throw(std::runtime_error("VoigtianStrategy::execute() | "
-                               "Evaluation of dynamic function failed!"));
-    }
+  auto &data = paras.mDoubleValue(0)->values();
+  if (!Faddeeva) {
+    ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+      for (size_t ele = begin; ele < end; ele++) {
+        try {
+          results[ele] =
+              Voigtian::dynamicalFunction(data[ele], m0, Gamma0, sigma);
+        } catch (std::exception &ex) {
+          LOG(ERROR) << "VoigtianStrategy::execute() | " << ex.what();
+          throw(std::runtime_error("VoigtianStrategy::execute() | "
+                                   "Evaluation of dynamic function failed!"));
+        }
+      }
+    });
+    return;
   }
+
+  // Same calculation as Voigtian::dynamicalFunction() for blocks of events
+  const size_t blockSize = 256;
+  double c = 1.0 / (std::sqrt(2.0) * sigma);
+  double a = c * 0.5 * Gamma0;
+  double halfWidth = 0.5 * Gamma0;
+  double norm = c / std::sqrt(M_PI);
+  ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+    double argu[blockSize], u[blockSize], wRe[blockSize], wIm[blockSize];
+    for (size_t first = begin; first < end; first += blockSize) {
+      size_t m = std::min(blockSize, end - first);
+      for (size_t i = 0; i < m; ++i) {
+        argu[i] = std::sqrt(data[first + i]) - m0;
+        u[i] = c * argu[i];
+      }
+      Faddeeva->w(u, a, wRe, wIm, m);
+      for (size_t i = 0; i < m; ++i) {
+        // sqrt(pi) * sqrt(Voigt profile) with the phase of the Breit-Wigner
+        double scale = std::sqrt(M_PI * norm * wRe[i] /
+                                 (argu[i] * argu[i] + halfWidth * halfWidth));
+        results[first + i] =
+            std::complex<double>(scale * argu[i], -scale * halfWidth);
+      }
+    }
+  });
 }
 
 void Voigtian::parameters(ParameterList &list) {
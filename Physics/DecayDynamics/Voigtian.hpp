@@ -23,6 +23,7 @@
 #include "Physics/DecayDynamics/AbstractDynamicalFunction.hpp"
 #include "Physics/HelicityFormalism/AmpWignerD.hpp"
 #include "Physics/DecayDynamics/Utils/Faddeeva.hh"
+#include "Physics/DecayDynamics/Utils/WeidemanFaddeeva.hpp"
 
 namespace ComPWA {
 namespace Physics {
@@ -41,6 +42,8 @@ class HelicityDecay;
 /// In the calculation of voigt function, a Faddeeva Package is used to calculate w(z).
 /// ref: http://ab-initio.mit.edu/wiki/index.php/Faddeeva_Package
 ///      this page is a package for computation of w(z)
+/// The FunctionTree uses the rational approximation WeidemanFaddeeva for the
+/// whole sample instead, its accuracy is set via SetFaddeevaTerms().
 ///
 class Voigtian
     : public ComPWA::Physics::DecayDynamics::AbstractDynamicalFunction {
@@ -112,6 +115,13 @@ public:
 
   double GetSigma() const { return Sigma; }
 
+  /// Number of terms of the approximation of w(z) in the FunctionTree, see
+  /// WeidemanFaddeeva. Zero selects Faddeeva::w() with a relative
+  /// tolerance of 1e-13 for each event.
+  void SetFaddeevaTerms(unsigned int n) { FaddeevaTerms = n; }
+
+  unsigned int GetFaddeevaTerms() const { return FaddeevaTerms; }
+
   virtual void parameters(ComPWA::ParameterList &list);
 
   virtual void parametersFast(std::vector<double> &list) const {
@@ -142,15 +152,24 @@ protected:
   /// resolution: the width of gaussian function which is used to represent the resolution of mass spectrum
   double Sigma;
 
+  /// Number of terms of the approximation of w(z) in the FunctionTree
+  unsigned int FaddeevaTerms;
+
 private:
   /// Temporary values (used to trigger recalculation of normalization)
   double CurrentWidth;
 };
 
+/// FunctionTree node of Voigtian. If \p faddeeva is given, w(z) is
+/// evaluated for the whole sample via the batch function of
+/// WeidemanFaddeeva, otherwise via Faddeeva::w() for each event.
 class VoigtianStrategy : public ComPWA::Strategy {
 public:
-  VoigtianStrategy(std::string sname = "")
-    : ComPWA::Strategy(ParType::MCOMPLEX), name(sname) {}
+  VoigtianStrategy(std::string sname = "",
+                   std::shared_ptr<const WeidemanFaddeeva> faddeeva =
+                       std::shared_ptr<const WeidemanFaddeeva>())
+      : ComPWA::Strategy(ParType::MCOMPLEX), name(sname), Faddeeva(faddeeva) {
+  }
   
   virtual const std::string to_str() const {
     return ("Voigtian Function of " + name);
@@ -161,6 +180,8 @@ public:
 
 protected:
   std::string name;
+
+  std::shared_ptr<const WeidemanFaddeeva> Faddeeva;
 };
 
 } // namespace DecayDynamics
@@ -0,0 +1,127 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the FunctionTree node of RelativisticBreitWigner.
+///
+
+#define BOOST_TEST_MODULE DecayDynamics
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/FitParameter.hpp"
+#include "Core/Logging.hpp"
+#include "Core/ParameterList.hpp"
+#include "Core/Value.hpp"
+#include "Physics/DecayDynamics/RelativisticBreitWigner.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Physics::DecayDynamics;
+
+BOOST_AUTO_TEST_SUITE(BreitWignerTest);
+
+const double MassA = 0.1349766;
+const double MassB = 0.1349766;
+
+/// Parameters in the order of RelativisticBreitWigner::tree()
+struct BreitWignerInput {
+  BreitWignerInput(std::shared_ptr<Value<std::vector<double>>> data,
+                   unsigned int L, formFactorType ffType)
+      : Mass(std::make_shared<FitParameter>("Mass", 1.2755)),
+        Width(std::make_shared<FitParameter>("Width", 0.1867)),
+        Radius(std::make_shared<FitParameter>("Radius", 2.5)) {
+    Mass->fixParameter(false);
+    Width->fixParameter(false);
+    Radius->fixParameter(false);
+    Paras.addParameter(Mass);
+    Paras.addParameter(Width);
+    Paras.addParameter(Radius);
+    Paras.addValue(std::make_shared<Value<double>>("L", L));
+    Paras.addValue(std::make_shared<Value<double>>("FormFactorType", ffType));
+    Paras.addValue(std::make_shared<Value<double>>("MassA", MassA));
+    Paras.addValue(std::make_shared<Value<double>>("MassB", MassB));
+    Paras.addValue(data);
+  }
+
+  std::shared_ptr<FitParameter> Mass;
+  std::shared_ptr<FitParameter> Width;
+  std::shared_ptr<FitParameter> Radius;
+  ParameterList Paras;
+};
+
+/// Invariant masses squared between the threshold and 4 GeV^2
+std::shared_ptr<Value<std::vector<double>>> sample(std::size_t n) {
+  double min = (MassA + MassB) * (MassA + MassB);
+  auto data = MDouble("mSq", n);
+  for (std::size_t i = 0; i < n; ++i)
+    data->values()[i] = min + (4.0 - min) * (i + 0.5) / n;
+  return data;
+}
+
+void checkAgainstDynamicalFunction(const BreitWignerInput &in,
+                                   const std::vector<double> &data,
+                                   std::shared_ptr<Parameter> out,
+                                   unsigned int L, formFactorType ffType) {
+  auto &results =
+      std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out)
+          ->values();
+  BOOST_REQUIRE_EQUAL(results.size(), data.size());
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    std::complex<double> expected = RelativisticBreitWigner::dynamicalFunction(
+        data[i], in.Mass->value(), MassA, MassB, in.Width->value(), L,
+        in.Radius->value(), ffType);
+    BOOST_CHECK_SMALL(std::abs(results[i] - expected),
+                      1e-10 * std::abs(expected) + 1e-14);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Consistency) {
+  ComPWA::Logging log("", "error");
+  auto data = sample(1000);
+  for (unsigned int L = 0; L < 4; ++L) {
+    for (auto ffType : {noFormFactor, BlattWeisskopf}) {
+      BreitWignerInput in(data, L, ffType);
+      BreitWignerStrategy strat;
+      std::shared_ptr<Parameter> out;
+      strat.execute(in.Paras, out);
+      checkAgainstDynamicalFunction(in, data->values(), out, L, ffType);
+
+      // Cached quantities are updated if parameters change
+      in.Mass->setValue(1.5);
+      in.Width->setValue(0.3);
+      in.Radius->setValue(1.5);
+      strat.execute(in.Paras, out);
+      checkAgainstDynamicalFunction(in, data->values(), out, L, ffType);
+    }
+  }
+
+  // ... and if the sample changes
+  BreitWignerInput in(data, 2, BlattWeisskopf);
+  BreitWignerStrategy strat;
+  std::shared_ptr<Parameter> out;
+  strat.execute(in.Paras, out);
+  auto other = sample(1000);
+  for (auto &x : other->values())
+    x *= 0.5;
+  BreitWignerInput otherIn(other, 2, BlattWeisskopf);
+  strat.execute(otherIn.Paras, out);
+  checkAgainstDynamicalFunction(otherIn, other->values(), out, 2,
+                                BlattWeisskopf);
+
+  // ... and if the sample is modified in place
+  for (auto &x : other->values())
+    x *= 1.5;
+  other->modified();
+  strat.execute(otherIn.Paras, out);
+  checkAgainstDynamicalFunction(otherIn, other->values(), out, 2,
+                                BlattWeisskopf);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
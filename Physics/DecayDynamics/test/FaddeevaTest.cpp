@@ -0,0 +1,119 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Accuracy of the batch Faddeeva function compared to Faddeeva::w(), and
+/// test of the FunctionTree node of Voigtian.
+///
+
+#define BOOST_TEST_MODULE DecayDynamics
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/FitParameter.hpp"
+#include "Core/Logging.hpp"
+#include "Core/ParameterList.hpp"
+#include "Core/Value.hpp"
+#include "Physics/DecayDynamics/Utils/Faddeeva.hh"
+#include "Physics/DecayDynamics/Utils/WeidemanFaddeeva.hpp"
+#include "Physics/DecayDynamics/Voigtian.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Physics::DecayDynamics;
+
+BOOST_AUTO_TEST_SUITE(FaddeevaTest);
+
+std::vector<double> realParts() {
+  std::vector<double> x;
+  for (double v = -100; v <= 100; v += 0.0137)
+    x.push_back(v);
+  return x;
+}
+
+/// Maximal relative deviation of w(z) and of Re w(z) from Faddeeva::w()
+BOOST_AUTO_TEST_CASE(Accuracy) {
+  ComPWA::Logging log("", "info");
+  std::vector<double> x = realParts();
+  std::vector<double> re(x.size()), im(x.size());
+  // Upper limits of the deviations for 16, 24 and 32 terms
+  std::vector<unsigned int> numTerms = {16, 24, 32};
+  std::vector<double> maxDevW = {1e-6, 1e-9, 1e-12};
+  std::vector<double> maxDevRe = {5e-2, 1e-4, 1e-7};
+  for (std::size_t t = 0; t < numTerms.size(); ++t) {
+    WeidemanFaddeeva faddeeva(numTerms[t]);
+    double devW = 0, devRe = 0;
+    for (double y : {1e-4, 1e-3, 1e-2, 0.1, 0.5, 1., 3., 10.}) {
+      faddeeva.w(x.data(), y, re.data(), im.data(), x.size());
+      for (std::size_t i = 0; i < x.size(); ++i) {
+        std::complex<double> exact =
+            Faddeeva::w(std::complex<double>(x[i], y), 1e-13);
+        std::complex<double> approx(re[i], im[i]);
+        devW = std::max(devW, std::abs(approx - exact) / std::abs(exact));
+        devRe = std::max(devRe, std::fabs(re[i] - exact.real()) /
+                                    std::fabs(exact.real()));
+        BOOST_CHECK_EQUAL(faddeeva.w(std::complex<double>(x[i], y)),
+                          approx);
+      }
+    }
+    LOG(INFO) << "FaddeevaTest | " << numTerms[t]
+              << " terms: maximal relative deviation of w(z): " << devW
+              << ", of Re w(z): " << devRe;
+    BOOST_CHECK_SMALL(devW, maxDevW[t]);
+    BOOST_CHECK_SMALL(devRe, maxDevRe[t]);
+  }
+
+  // Lower half plane
+  WeidemanFaddeeva faddeeva;
+  for (double xv : {-3., 0.2, 5.}) {
+    std::complex<double> z(xv, -0.7);
+    std::complex<double> exact = Faddeeva::w(z, 1e-13);
+    BOOST_CHECK_SMALL(std::abs(faddeeva.w(z) - exact) / std::abs(exact),
+                      1e-11);
+  }
+}
+
+/// The Voigtian node with the batch Faddeeva function compared to
+/// Voigtian::dynamicalFunction()
+BOOST_AUTO_TEST_CASE(VoigtianNode) {
+  ComPWA::Logging log("", "error");
+  double m0 = 0.98, width = 0.05, sigma = 0.006;
+  auto mass = std::make_shared<FitParameter>("Mass", m0);
+  auto gamma = std::make_shared<FitParameter>("Width", width);
+  auto data = MDouble("mSq", 5000);
+  for (std::size_t i = 0; i < data->values().size(); ++i)
+    data->values()[i] = 0.1 + 1.9 * i / 5000.;
+  ParameterList paras;
+  paras.addParameter(mass);
+  paras.addParameter(gamma);
+  paras.addValue(std::make_shared<Value<double>>("Sigma", sigma));
+  paras.addValue(data);
+
+  for (unsigned int numTerms : {0, 32}) {
+    std::shared_ptr<const WeidemanFaddeeva> faddeeva;
+    if (numTerms)
+      faddeeva = std::make_shared<const WeidemanFaddeeva>(numTerms);
+    VoigtianStrategy strat("", faddeeva);
+    std::shared_ptr<Parameter> out;
+    strat.execute(paras, out);
+    auto &results =
+        std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(
+            out)->values();
+    BOOST_REQUIRE_EQUAL(results.size(), data->values().size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      std::complex<double> expected =
+          Voigtian::dynamicalFunction(data->values()[i], m0, width, sigma);
+      BOOST_CHECK_SMALL(std::abs(results[i] - expected),
+                        1e-7 * std::abs(expected));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
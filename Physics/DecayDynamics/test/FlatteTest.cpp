@@ -0,0 +1,218 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the FunctionTree node of AmpFlatteRes.
+///
+
+#define BOOST_TEST_MODULE DecayDynamics
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/FitParameter.hpp"
+#include "Core/Logging.hpp"
+#include "Core/ParameterList.hpp"
+#include "Core/Value.hpp"
+#include "Physics/DecayDynamics/AmpFlatteRes.hpp"
+#include "Physics/DecayDynamics/RelativisticBreitWigner.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Physics::DecayDynamics;
+
+BOOST_AUTO_TEST_SUITE(FlatteTest);
+
+/// Final state masses of the channels pi pi, K K and eta eta
+const std::vector<double> Masses = {0.13957018, 0.13957018, 0.493677,
+                                    0.493677,   0.547862,   0.547862};
+
+/// Parameters in the order of AmpFlatteRes::tree()
+struct FlatteInput {
+  FlatteInput(std::shared_ptr<Value<std::vector<double>>> data, unsigned int L,
+              formFactorType ffType, double g3)
+      : Mass(std::make_shared<FitParameter>("Mass", 0.965)),
+        Radius(std::make_shared<FitParameter>("Radius", 1.5)) {
+    std::vector<double> g = {0.165, 0.695, g3};
+    Mass->fixParameter(false);
+    Radius->fixParameter(false);
+    Paras.addParameter(Mass);
+    for (unsigned int i = 0; i < 3; ++i) {
+      Couplings.push_back(
+          std::make_shared<FitParameter>("g_" + std::to_string(i), g[i]));
+      Couplings.back()->fixParameter(false);
+      Paras.addValue(std::make_shared<Value<double>>("massA", Masses[2 * i]));
+      Paras.addValue(
+          std::make_shared<Value<double>>("massB", Masses[2 * i + 1]));
+      Paras.addParameter(Couplings.back());
+    }
+    Paras.addValue(std::make_shared<Value<double>>("L", L));
+    Paras.addParameter(Radius);
+    Paras.addValue(std::make_shared<Value<double>>("FormFactorType", ffType));
+    Paras.addValue(std::make_shared<Value<double>>("MassA", Masses[0]));
+    Paras.addValue(std::make_shared<Value<double>>("MassB", Masses[1]));
+    Paras.addValue(data);
+  }
+
+  std::shared_ptr<FitParameter> Mass;
+  std::vector<std::shared_ptr<FitParameter>> Couplings;
+  std::shared_ptr<FitParameter> Radius;
+  ParameterList Paras;
+};
+
+/// Invariant masses squared between the pi pi threshold and 4 GeV^2
+std::shared_ptr<Value<std::vector<double>>> sample(std::size_t n) {
+  double min = (Masses[0] + Masses[1]) * (Masses[0] + Masses[1]);
+  auto data = MDouble("mSq", n);
+  for (std::size_t i = 0; i < n; ++i)
+    data->values()[i] = min + (4.0 - min) * (i + 0.5) / n;
+  return data;
+}
+
+void checkAgainstDynamicalFunction(const FlatteInput &in,
+                                   const std::vector<double> &data,
+                                   std::shared_ptr<Parameter> out,
+                                   unsigned int L, formFactorType ffType) {
+  auto &results =
+      std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out)
+          ->values();
+  BOOST_REQUIRE_EQUAL(results.size(), data.size());
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    std::complex<double> expected = AmpFlatteRes::dynamicalFunction(
+        data[i], in.Mass->value(), Masses[0], Masses[1],
+        in.Couplings[0]->value(), Masses[2], Masses[3],
+        in.Couplings[1]->value(), Masses[4], Masses[5],
+        in.Couplings[2]->value(), L, in.Radius->value(), ffType);
+    BOOST_CHECK_SMALL(std::abs(results[i] - expected),
+                      1e-10 * std::abs(expected) + 1e-14);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Consistency) {
+  ComPWA::Logging log("", "error");
+  auto data = sample(1000);
+  for (unsigned int L = 0; L < 2; ++L) {
+    for (auto ffType : {noFormFactor, BlattWeisskopf}) {
+      for (double g3 : {0.0, 0.3}) {
+        FlatteInput in(data, L, ffType, g3);
+        FlatteStrategy strat;
+        std::shared_ptr<Parameter> out;
+        strat.execute(in.Paras, out);
+        checkAgainstDynamicalFunction(in, data->values(), out, L, ffType);
+
+        // Cached quantities are updated if parameters change
+        in.Mass->setValue(1.01);
+        in.Couplings[1]->setValue(0.5);
+        in.Radius->setValue(2.5);
+        strat.execute(in.Paras, out);
+        checkAgainstDynamicalFunction(in, data->values(), out, L, ffType);
+
+        // ... also if the third channel is switched on or off
+        in.Couplings[2]->setValue(g3 == 0.0 ? 0.2 : 0.0);
+        strat.execute(in.Paras, out);
+        checkAgainstDynamicalFunction(in, data->values(), out, L, ffType);
+      }
+    }
+  }
+
+  // ... and if the sample changes
+  FlatteInput in(data, 0, BlattWeisskopf, 0.3);
+  FlatteStrategy strat;
+  std::shared_ptr<Parameter> out;
+  strat.execute(in.Paras, out);
+  auto other = sample(1000);
+  for (auto &x : other->values())
+    x *= 0.5;
+  FlatteInput otherIn(other, 0, BlattWeisskopf, 0.3);
+  strat.execute(otherIn.Paras, out);
+  checkAgainstDynamicalFunction(otherIn, other->values(), out, 0,
+                                BlattWeisskopf);
+
+  // ... and if the sample is modified in place
+  for (auto &x : other->values())
+    x *= 1.5;
+  other->modified();
+  strat.execute(otherIn.Paras, out);
+  checkAgainstDynamicalFunction(otherIn, other->values(), out, 0,
+                                BlattWeisskopf);
+}
+
+BOOST_AUTO_TEST_CASE(CoupledChannelThreshold) {
+  ComPWA::Logging log("", "error");
+  // Invariant masses squared around the K K threshold
+  double threshold = (Masses[2] + Masses[3]) * (Masses[2] + Masses[3]);
+  auto data = MDouble("mSq", 200);
+  for (std::size_t i = 0; i < 200; ++i)
+    data->values()[i] = threshold * (0.9 + 0.2 * (i + 0.5) / 200);
+
+  FlatteInput in(data, 0, noFormFactor, 0.0);
+  FlatteStrategy strat;
+  std::shared_ptr<Parameter> out;
+  strat.execute(in.Paras, out);
+  auto coupled =
+      std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out)
+          ->values();
+  double gKK = in.Couplings[1]->value();
+  in.Couplings[1]->setValue(0.0);
+  strat.execute(in.Paras, out);
+  auto &single =
+      std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out)
+          ->values();
+  BOOST_CHECK_GT(gKK, 0.0);
+
+  // Contribution of the K K channel to the denominator g_pipi / A(s). Below
+  // its threshold the channel only shifts the mass, above the threshold it
+  // contributes to the width.
+  double gA = in.Couplings[0]->value();
+  for (std::size_t i = 0; i < data->values().size(); ++i) {
+    std::complex<double> diff = gA / coupled[i] - gA / single[i];
+    BOOST_CHECK_GT(std::abs(diff), 0.0);
+    if (data->values()[i] < threshold)
+      BOOST_CHECK_SMALL(diff.imag(), 1e-10 * std::abs(diff));
+    else
+      BOOST_CHECK_LT(diff.imag(), -1e-10 * std::abs(diff));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SingleChannelLimit) {
+  ComPWA::Logging log("", "error");
+  // Without the hidden channels the magnitude of the Flatte amplitude at the
+  // resonance position is equal to the one of the Breit-Wigner amplitude
+  // with the width that corresponds to the coupling of the signal channel.
+  // The phases differ since the phase space factor of the Flatte width is
+  // complex.
+  for (unsigned int L = 0; L < 3; ++L) {
+    for (auto ffType : {noFormFactor, BlattWeisskopf}) {
+      auto data = MDouble("mSq", 1);
+      FlatteInput in(data, L, ffType, 0.0);
+      in.Couplings[1]->setValue(0.0);
+      double mR = in.Mass->value();
+      data->values()[0] = mR * mR;
+
+      FlatteStrategy strat;
+      std::shared_ptr<Parameter> out;
+      strat.execute(in.Paras, out);
+      auto result =
+          std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(
+              out)
+              ->values()
+              .at(0);
+
+      double width =
+          std::abs(couplingToWidth(mR, mR, in.Couplings[0]->value(), Masses[0],
+                                   Masses[1], L, in.Radius->value(), ffType));
+      std::complex<double> expected =
+          RelativisticBreitWigner::dynamicalFunction(
+              mR * mR, mR, Masses[0], Masses[1], width, L, in.Radius->value(),
+              ffType);
+      BOOST_CHECK_CLOSE(std::abs(result), std::abs(expected), 1e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();
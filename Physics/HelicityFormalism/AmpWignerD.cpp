@@ -2,7 +2,11 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include "Core/Exceptions.hpp"
+#include "Core/ThreadPool.hpp"
 #include "qft++/WignerD.h"
 #include "Physics/HelicityFormalism/AmpWignerD.hpp"
 
@@ -11,6 +15,164 @@ namespace ComPWA {
 namespace Physics {
 namespace HelicityFormalism {
 
+namespace {
+
+double factorial(int n) {
+  double f = 1;
+  for (int i = 2; i <= n; ++i)
+    f *= i;
+  return f;
+}
+
+/// Coefficients of ((1+x)/2)^a * ((1-x)/2)^b, lowest degree first
+std::vector<double> halfAnglePolynomial(int a, int b) {
+  std::vector<double> p(1, 1.0);
+  for (int i = 0; i < a + b; ++i) {
+    double c1 = (i < a ? 0.5 : -0.5);
+    std::vector<double> q(p.size() + 1, 0.0);
+    for (std::size_t k = 0; k < p.size(); ++k) {
+      q[k] += 0.5 * p[k];
+      q[k + 1] += c1 * p[k];
+    }
+    p.swap(q);
+  }
+  return p;
+}
+
+template <int Prefactor> double prefactor(double x);
+
+template <> inline double prefactor<0>(double x) { return 1.0; }
+
+template <> inline double prefactor<1>(double x) {
+  return std::sqrt(0.5 * (1 + x));
+}
+
+template <> inline double prefactor<2>(double x) {
+  return std::sqrt(0.5 * (1 - x));
+}
+
+template <> inline double prefactor<3>(double x) {
+  return 0.5 * std::sqrt((1 - x) * (1 + x));
+}
+
+/// Horner scheme with a fixed degree, the loops over the coefficients are
+/// unrolled and the loop over the events can be vectorised.
+template <int Degree, int Prefactor>
+void wignerdKernel(const double *coefficients, const double *cosTheta,
+                   double *out, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    double x = cosTheta[i];
+    double p = coefficients[0];
+    for (int k = 1; k <= Degree; ++k)
+      p = p * x + coefficients[k];
+    out[i] = p * prefactor<Prefactor>(x);
+  }
+}
+
+template <int Degree> WignerdPolynomial::Kernel selectKernel(int prefactor) {
+  switch (prefactor) {
+  case 0:
+    return &wignerdKernel<Degree, 0>;
+  case 1:
+    return &wignerdKernel<Degree, 1>;
+  case 2:
+    return &wignerdKernel<Degree, 2>;
+  default:
+    return &wignerdKernel<Degree, 3>;
+  }
+}
+
+WignerdPolynomial::Kernel selectKernel(int degree, int prefactor) {
+  switch (degree) {
+  case 0:
+    return selectKernel<0>(prefactor);
+  case 1:
+    return selectKernel<1>(prefactor);
+  case 2:
+    return selectKernel<2>(prefactor);
+  case 3:
+    return selectKernel<3>(prefactor);
+  case 4:
+    return selectKernel<4>(prefactor);
+  default:
+    throw BadParameter("WignerdPolynomial | Degree " + std::to_string(degree) +
+                       " is not supported!");
+  }
+}
+
+} // namespace
+
+WignerdPolynomial::WignerdPolynomial(ComPWA::Spin J, ComPWA::Spin mu,
+                                     ComPWA::Spin muPrime)
+    : Coefficients(1, 0.0), Prefactor(0) {
+  if (!isSupported(J))
+    throw BadParameter("WignerdPolynomial::WignerdPolynomial() | Spin " +
+                       std::to_string((double)J) + " is not supported!");
+
+  // Same conventions as QFT::Wigner_d(), for 0 <= theta <= pi
+  int twoJ = std::lround(2 * (double)J);
+  int M = std::lround(2 * (double)mu);
+  int N = std::lround(2 * (double)muPrime);
+  if (std::abs(M) > twoJ || std::abs(N) > twoJ || (twoJ + M) % 2 ||
+      (twoJ + N) % 2) {
+    BatchKernel = selectKernel(0, 0);
+    return;
+  }
+
+  int m_p_n = (M + N) / 2;
+  int j_p_m = (twoJ + M) / 2;
+  int j_m_m = (twoJ - M) / 2;
+  int j_p_n = (twoJ + N) / 2;
+  int j_m_n = (twoJ - N) / 2;
+  double norm = 2 * (double)J + 1;
+  double constTerm = (j_p_m % 2 ? -1.0 : 1.0) *
+                     std::sqrt(factorial(j_p_m) * factorial(j_m_m) *
+                               factorial(j_p_n) * factorial(j_m_n)) *
+                     norm;
+
+  // The powers of cos(theta/2) have the same parity for all terms
+  int ec = std::abs(m_p_n) % 2;
+  int es = (twoJ - ec) % 2;
+  Prefactor = ec + 2 * es;
+  int degree = (twoJ - ec - es) / 2;
+
+  std::vector<double> poly(degree + 1, 0.0);
+  for (int k = std::max(0, m_p_n); k <= std::min(j_p_m, j_p_n); ++k) {
+    int powCos = 2 * k - m_p_n;
+    int powSin = twoJ + m_p_n - 2 * k;
+    double c = constTerm * (k % 2 ? -1.0 : 1.0) /
+               (factorial(k) * factorial(j_p_m - k) * factorial(j_p_n - k) *
+                factorial(k - m_p_n));
+    auto term = halfAnglePolynomial((powCos - ec) / 2, (powSin - es) / 2);
+    for (std::size_t i = 0; i < term.size(); ++i)
+      poly[i] += c * term[i];
+  }
+  Coefficients.assign(poly.rbegin(), poly.rend());
+  BatchKernel = selectKernel(degree, Prefactor);
+}
+
+bool WignerdPolynomial::isSupported(ComPWA::Spin J) {
+  return std::lround(2 * (double)J) <= MaxTwoJ;
+}
+
+double WignerdPolynomial::evaluate(double cosTheta) const {
+  double result;
+  evaluate(&cosTheta, &result, 1);
+  return result;
+}
+
+void WignerdPolynomial::evaluate(const double *cosTheta, double *out,
+                                 std::size_t n) const {
+  bool outOfRange = false;
+  for (std::size_t i = 0; i < n; ++i)
+    outOfRange |= (cosTheta[i] > 1 || cosTheta[i] < -1);
+  if (outOfRange)
+    throw std::runtime_error(
+        "WignerdPolynomial::evaluate() | "
+        "scattering angle out of range! Datapoint beyond phsp?");
+  BatchKernel(Coefficients.data(), cosTheta, out, n);
+}
+
 AmpWignerD::AmpWignerD(ComPWA::Spin spin, ComPWA::Spin mu, ComPWA::Spin muPrime)
     : J(spin), Mu(mu), MuPrime(muPrime) {}
 
@@ -78,9 +240,14 @@ std::shared_ptr<FunctionTree> AmpWignerD::tree(const ParameterList &sample,
     return std::make_shared<FunctionTree>("WignerD" + suffix,
                                           MInteger("", n, 1));
 
+  // The closed form is selected once for the whole sample
+  std::shared_ptr<const WignerdPolynomial> polynomial;
+  if (WignerdPolynomial::isSupported(J))
+    polynomial = std::make_shared<const WignerdPolynomial>(J, Mu, MuPrime);
+
   auto tr = std::make_shared<FunctionTree>(
       "WignerD" + suffix, MDouble("", n),
-      std::make_shared<WignerDStrategy>("WignerD" + suffix));
+      std::make_shared<WignerDStrategy>("WignerD" + suffix, polynomial));
 
   tr->createLeaf("spin", (double)J, "WignerD" + suffix); // spin
   tr->createLeaf("m", (double)Mu, "WignerD" + suffix);      // OutSpin 1
@@ -111,21 +278,35 @@ void WignerDStrategy::execute(ParameterList &paras,
   auto data = paras.mDoubleValue(0);
 
   size_t n = data->values().size();
-  if (!out)
-    out = MDouble("", n);
-  auto par = std::static_pointer_cast<Value<std::vector<double>>>(out);
-  auto &results = par->values(); // reference
-
-  for (unsigned int ele = 0; ele < n; ele++) {
-    try {
-      results.at(ele) = AmpWignerD::dynamicalFunction(
-          J, mu, muPrime, data->values().at(ele));
-    } catch (std::exception &ex) {
-      LOG(ERROR) << "WignerDStrategy::execute() | " << ex.what();
-      throw std::runtime_error("WignerDStrategy::execute() | "
-                               "Evaluation of dynamical function failed!");
-    }
-  } // end element loop
+  auto &results = multiOutput<double>(out, n);
+
+  auto &cosTheta = data->values();
+  if (Polynomial) {
+    ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+      try {
+        Polynomial->evaluate(cosTheta.data() + begin, results.data() + begin,
+                             end - begin);
+      } catch (std::exception &ex) {
+        LOG(ERROR) << "WignerDStrategy::execute() | " << ex.what();
+        throw std::runtime_error("WignerDStrategy::execute() | "
+                                 "Evaluation of dynamical function failed!");
+      }
+    });
+    return;
+  }
+
+  ThreadPool::instance().parallelFor(n, [&](size_t begin, size_t end) {
+    for (size_t ele = begin; ele < end; ele++) {
+      try {
+        results.at(ele) =
+            AmpWignerD::dynamicalFunction(J, mu, muPrime, cosTheta.at(ele));
+      } catch (std::exception &ex) {
+        LOG(ERROR) << "WignerDStrategy::execute() | " << ex.what();
+        throw std::runtime_error("WignerDStrategy::execute() | "
+                                 "Evaluation of dynamical function failed!");
+      }
+    } // end element loop
+  });
 }
 
 } // ns::HelicityFormalism
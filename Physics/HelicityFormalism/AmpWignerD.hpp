@@ -27,6 +27,48 @@ namespace ComPWA {
 namespace Physics {
 namespace HelicityFormalism {
 
+///
+/// \class WignerdPolynomial
+/// Wigner d-function d^J_{mu,mu'}(theta), multiplied by (2J+1) as in
+/// AmpWignerD::dynamicalFunction(), as a closed-form function of
+/// x = cos(theta) for J <= 4. With cos(theta/2) = sqrt((1+x)/2) and
+/// sin(theta/2) = sqrt((1-x)/2) the d-function is a polynomial in x
+/// times one of 1, cos(theta/2), sin(theta/2) or sin(theta)/2. The
+/// coefficients are calculated once in the constructor, the evaluation
+/// uses a kernel that is specialised at compile time for the degree and
+/// the prefactor. Neither acos() nor the factorial sum is evaluated per
+/// event.
+///
+class WignerdPolynomial {
+public:
+  /// Largest 2J that is supported
+  static const int MaxTwoJ = 8;
+
+  /// Throws BadParameter if J is larger than MaxTwoJ / 2.
+  WignerdPolynomial(ComPWA::Spin J, ComPWA::Spin mu, ComPWA::Spin muPrime);
+
+  static bool isSupported(ComPWA::Spin J);
+
+  double evaluate(double cosTheta) const;
+
+  /// Evaluate for the \p n values \p cosTheta. Throws std::runtime_error if
+  /// a value is outside [-1, 1].
+  void evaluate(const double *cosTheta, double *out, std::size_t n) const;
+
+  /// Kernel for a batch of events
+  typedef void (*Kernel)(const double *coefficients, const double *cosTheta,
+                         double *out, std::size_t n);
+
+protected:
+  /// Coefficients of the polynomial, highest degree first
+  std::vector<double> Coefficients;
+
+  /// 0: 1, 1: cos(theta/2), 2: sin(theta/2), 3: sin(theta)/2
+  int Prefactor;
+
+  Kernel BatchKernel;
+};
+
 ///
 /// \class AmpWignerD
 /// Angular distribution based on WignerD functions
@@ -73,10 +115,16 @@ protected:
   ComPWA::Spin MuPrime;
 };
 
+/// FunctionTree node of AmpWignerD. If a WignerdPolynomial is given it is
+/// used for the whole sample, otherwise the d-function is evaluated for each
+/// event via AmpWignerD::dynamicalFunction().
 class WignerDStrategy : public Strategy {
 public:
-  WignerDStrategy(const std::string resonanceName)
-      : Strategy(ParType::MDOUBLE), name(resonanceName) {}
+  WignerDStrategy(const std::string resonanceName,
+                  std::shared_ptr<const WignerdPolynomial> polynomial =
+                      std::shared_ptr<const WignerdPolynomial>())
+      : Strategy(ParType::MDOUBLE), name(resonanceName),
+        Polynomial(polynomial) {}
 
   virtual const std::string to_str() const { return ("WignerD of " + name); }
 
@@ -85,6 +133,8 @@ public:
 
 protected:
   std::string name;
+
+  std::shared_ptr<const WignerdPolynomial> Polynomial;
 };
 
 } // namespace AmplitudeSum
@@ -2,6 +2,8 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <cmath>
+#include <limits>
 #include <sstream>
 
 #include "Physics/DecayDynamics/AmpFlatteRes.hpp"
@@ -19,7 +21,7 @@ namespace HelicityFormalism {
 HelicityDecay::HelicityDecay(std::shared_ptr<PartList> partL,
                              std::shared_ptr<Kinematics> kin,
                              const boost::property_tree::ptree &pt)
-    : SubSys(pt) {
+    : SubSys(pt), CacheDynamics(false) {
   load(partL, kin, pt);
 }
 
@@ -141,6 +143,7 @@ void HelicityDecay::load(std::shared_ptr<PartList> partL,
     AngularDist = std::make_shared<AmpWignerD>(ComPWA::Spin(0), ComPWA::Spin(0),
                                                ComPWA::Spin(0));
   }
+  updateDynamicsParameters();
 }
 
 boost::property_tree::ptree HelicityDecay::save() const {
@@ -252,6 +255,9 @@ HelicityDecay::tree(std::shared_ptr<Kinematics> kin,
 void HelicityDecay::parameters(ParameterList &list) {
   PartialAmplitude::parameters(list);
   DynamicFcn->parameters(list);
+  // The parameters of the dynamical function may have been replaced by
+  // parameters of the same name in the list
+  updateDynamicsParameters();
 }
 
 void HelicityDecay::updateParameters(const ParameterList &list) {
@@ -261,6 +267,156 @@ void HelicityDecay::updateParameters(const ParameterList &list) {
   return;
 }
 
+std::complex<double> HelicityDecay::evaluateNoNorm(const DataPoint &point) const {
+  std::complex<double> result = coefficient();
+
+  EventCache::Column *column = Cache.find(point);
+  if (!column && point.sample())
+    column = addCacheColumn(point);
+  if (!column) {
+    result *= AngularDist->evaluate(point, DataPosition + 1, DataPosition + 2);
+    result *= DynamicFcn->evaluate(point, DataPosition);
+    assert(!std::isnan(result.real()) && !std::isnan(result.imag()));
+    return result;
+  }
+
+  // The stored values of the dynamical function are used as long as its
+  // parameters do not change
+  bool dynamics = column->DynamicsValid.load(std::memory_order_relaxed);
+  if (dynamics) {
+    for (std::size_t k = 0; k < DynamicsParameters.size(); ++k) {
+      if (DynamicsParameters[k]->value() != column->Parameters[k]) {
+        dynamics = false;
+        column->DynamicsValid.store(false, std::memory_order_relaxed);
+        break;
+      }
+    }
+  }
+
+  std::size_t i = point.index();
+  std::atomic<char> &state = column->State[i];
+  if (state.load(std::memory_order_acquire) == EventCache::Filled) {
+    result *= column->Angular[i];
+    result *= dynamics ? column->Dynamics[i]
+                       : DynamicFcn->evaluate(point, DataPosition);
+  } else {
+    double angular =
+        AngularDist->evaluate(point, DataPosition + 1, DataPosition + 2);
+    std::complex<double> dyn = DynamicFcn->evaluate(point, DataPosition);
+    // If another thread is storing the entries of this event we do not wait
+    char empty = EventCache::Empty;
+    if (state.compare_exchange_strong(empty, EventCache::Writing,
+                                      std::memory_order_acquire)) {
+      column->Angular[i] = angular;
+      if (dynamics)
+        column->Dynamics[i] = dyn;
+      state.store(EventCache::Filled, std::memory_order_release);
+    }
+    result *= angular;
+    result *= dyn;
+  }
+
+  assert(!std::isnan(result.real()) && !std::isnan(result.imag()));
+  return result;
+}
+
+void HelicityDecay::updateDynamicsParameters() {
+  Cache.clear();
+  DynamicsParameters.clear();
+  CacheDynamics = false;
+  if (!DynamicFcn)
+    return;
+  // The list is empty, so that the parameters of the dynamical function are
+  // not replaced
+  ParameterList list;
+  try {
+    DynamicFcn->parameters(list);
+  } catch (BadParameter &ex) {
+    LOG(DEBUG) << "HelicityDecay::updateDynamicsParameters() | Values of the "
+                  "dynamical function are not stored: "
+               << ex.what();
+    return;
+  }
+  DynamicsParameters = list.doubleParameters();
+  CacheDynamics = true;
+}
+
+HelicityDecay::EventCache::Column *
+HelicityDecay::addCacheColumn(const DataPoint &point) const {
+  // Only the values of dynamical functions without free parameters are
+  // stored
+  bool dynamics = CacheDynamics;
+  for (auto p : DynamicsParameters)
+    dynamics = dynamics && p->isFixed();
+
+  std::unique_ptr<EventCache::Column> column(new EventCache::Column(
+      point.sample(), point.sampleSize(), dynamics));
+  if (dynamics)
+    for (auto p : DynamicsParameters)
+      column->Parameters.push_back(p->value());
+  return Cache.add(std::move(column));
+}
+
+HelicityDecay::EventCache::Column::Column(std::uint64_t sample,
+                                          std::size_t size, bool dynamics)
+    : Sample(sample), Size(size), State(size), Angular(size),
+      Dynamics(dynamics ? size : 0), DynamicsValid(dynamics), LastUse(0) {}
+
+HelicityDecay::EventCache::EventCache() : Clock(0) {
+  for (auto &slot : Slots)
+    slot.store(nullptr);
+}
+
+HelicityDecay::EventCache::Column *
+HelicityDecay::EventCache::find(const DataPoint &point) {
+  std::uint64_t sample = point.sample();
+  if (!sample)
+    return nullptr;
+  std::size_t size = point.sampleSize();
+  for (auto &slot : Slots) {
+    Column *column = slot.load(std::memory_order_acquire);
+    if (!column || column->Sample != sample || column->Size != size)
+      continue;
+    // The clock only changes if a sample is added, so that the column is
+    // written once per added sample and not for every event
+    std::uint64_t now = Clock.load(std::memory_order_relaxed);
+    if (column->LastUse.load(std::memory_order_relaxed) != now)
+      column->LastUse.store(now, std::memory_order_relaxed);
+    return column;
+  }
+  return nullptr;
+}
+
+HelicityDecay::EventCache::Column *
+HelicityDecay::EventCache::add(std::unique_ptr<Column> column) {
+  std::lock_guard<std::mutex> lock(Mutex);
+  // Use an empty slot or replace the least recently used column
+  unsigned int k = 0;
+  for (unsigned int j = 0; j < MaxSamples; ++j) {
+    Column *c = Columns[j].get();
+    if (c && c->Sample == column->Sample && c->Size == column->Size)
+      return c;
+    if (!Columns[k])
+      continue;
+    if (!c || c->LastUse.load(std::memory_order_relaxed) <
+                  Columns[k]->LastUse.load(std::memory_order_relaxed))
+      k = j;
+  }
+  Slots[k].store(nullptr, std::memory_order_relaxed);
+  column->LastUse.store(++Clock, std::memory_order_relaxed);
+  Columns[k] = std::move(column);
+  Slots[k].store(Columns[k].get(), std::memory_order_release);
+  return Columns[k].get();
+}
+
+void HelicityDecay::EventCache::clear() {
+  std::lock_guard<std::mutex> lock(Mutex);
+  for (auto &slot : Slots)
+    slot.store(nullptr);
+  for (auto &column : Columns)
+    column.reset();
+}
+
 } // namespace HelicityFormalism
 } // namespace Physics
 } // namespace ComPWA
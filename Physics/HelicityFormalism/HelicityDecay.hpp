@@ -10,8 +10,12 @@
 #ifndef HelicityDecay_HPP_
 #define HelicityDecay_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <boost/property_tree/ptree.hpp>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "Physics/DecayDynamics/AbstractDynamicalFunction.hpp"
 #include "Physics/HelicityFormalism/AmpWignerD.hpp"
@@ -35,7 +39,7 @@ public:
                 const boost::property_tree::ptree &pt);
 
   HelicityDecay(int dataPos, const SubSystem &sys)
-      : DataPosition(dataPos), SubSys(sys){};
+      : DataPosition(dataPos), SubSys(sys), CacheDynamics(false){};
 
   virtual HelicityDecay *clone(std::string newName = "") const {
     auto tmp = new HelicityDecay(*this);
@@ -56,15 +60,23 @@ public:
 
   virtual double normalization() const;
 
-  /// Evaluate function without normalization
-  std::complex<double> evaluateNoNorm(const DataPoint &point) const {
-    std::complex<double> result = coefficient();
-    result *= AngularDist->evaluate(point, DataPosition + 1, DataPosition + 2);
-    result *= DynamicFcn->evaluate(point, DataPosition);
-
-    assert(!std::isnan(result.real()) && !std::isnan(result.imag()));
-    return result;
-  };
+  /// Evaluate function without normalization.
+  /// If \p point is a view of a sample (see DataPoint::sample()) the
+  /// angular distribution is stored per event on first use and reused
+  /// afterwards. The same is done for the dynamical function if all its
+  /// parameters are fixed. As long as its parameters do not change the
+  /// stored values are used. The entries of up to EventCache::MaxSamples
+  /// samples are kept, the least recently used sample is dropped if a
+  /// further one is evaluated. Samples are identified by
+  /// DataPoint::sample(), which changes if a DataPointSet is modified.
+  /// Values that are modified in place via DataPointSet::column() require
+  /// clearCache(). The events of a sample can be evaluated in parallel,
+  /// different samples must not be evaluated at the same time.
+  std::complex<double> evaluateNoNorm(const DataPoint &point) const;
+
+  /// Release the stored values of all samples. Must not be called during an
+  /// evaluation.
+  void clearCache() { Cache.clear(); }
 
   virtual void parameters(ParameterList &list);
 
@@ -83,6 +95,7 @@ public:
   void setWignerD(
       std::shared_ptr<ComPWA::Physics::HelicityFormalism::AmpWignerD> w) {
     AngularDist = w;
+    Cache.clear();
   }
 
   std::shared_ptr<ComPWA::Physics::DecayDynamics::AbstractDynamicalFunction>
@@ -94,10 +107,14 @@ public:
       std::shared_ptr<ComPWA::Physics::DecayDynamics::AbstractDynamicalFunction>
           f) {
     DynamicFcn = f;
+    updateDynamicsParameters();
   }
 
   /// Set position of variables within dataPoint
-  virtual void setDataPosition(int pos) { DataPosition = pos; }
+  virtual void setDataPosition(int pos) {
+    DataPosition = pos;
+    Cache.clear();
+  }
 
   /// Get position of variables within dataPoint
   virtual int dataPosition() const { return DataPosition; }
@@ -128,6 +145,102 @@ protected:
   std::pair<std::string, std::string> DecayProducts;
 
   std::pair<ComPWA::Spin, ComPWA::Spin> DecayHelicities;
+
+  ///
+  /// \class EventCache
+  /// Parameter independent factors of the events of up to MaxSamples
+  /// samples. The entries of a sample are allocated on first use and filled
+  /// event by event. If all slots are used, the column of the least
+  /// recently used sample is released when a further sample is added.
+  /// Lookups do not lock, so that the events of a sample can be evaluated in
+  /// parallel. Since adding a sample may release the column of another one,
+  /// lookups of different samples must not run concurrently. A copy of an
+  /// EventCache is empty.
+  ///
+  class EventCache {
+  public:
+    static const unsigned int MaxSamples = 4;
+
+    /// State of the entries of an event
+    enum EventState : char { Empty = 0, Writing, Filled };
+
+    struct Column {
+      Column(std::uint64_t sample, std::size_t size, bool dynamics);
+
+      /// Identity of the sample, see DataPoint::sample()
+      std::uint64_t Sample;
+
+      std::size_t Size;
+
+      /// EventState of each event. The thread that changes it from Empty to
+      /// Writing stores the entries of the event and then sets it to Filled
+      /// (release). The entries are read only after Filled was loaded
+      /// (acquire).
+      std::vector<std::atomic<char>> State;
+
+      std::vector<double> Angular;
+
+      /// Dynamical function of each event, empty if it is not stored
+      std::vector<std::complex<double>> Dynamics;
+
+      /// Parameters of the dynamical function the entries of Dynamics
+      /// belong to
+      std::vector<double> Parameters;
+
+      /// False as soon as the parameters differ from Parameters. The
+      /// entries of Dynamics are not used afterwards.
+      std::atomic<bool> DynamicsValid;
+
+      /// Value of EventCache::Clock at the last lookup
+      std::atomic<std::uint64_t> LastUse;
+    };
+
+    EventCache();
+
+    EventCache(const EventCache &other) : EventCache() {}
+
+    EventCache &operator=(const EventCache &other) {
+      clear();
+      return *this;
+    }
+
+    /// Column of the sample of \p point. Null if \p point is not a view
+    /// or if the sample was not added.
+    Column *find(const DataPoint &point);
+
+    /// Add \p column unless a column of the same sample exists. Returns the
+    /// column of the sample.
+    Column *add(std::unique_ptr<Column> column);
+
+    void clear();
+
+  protected:
+    std::atomic<Column *> Slots[MaxSamples];
+
+    /// Owner of the columns in Slots
+    std::unique_ptr<Column> Columns[MaxSamples];
+
+    /// Incremented each time a column is added. The column with the
+    /// smallest LastUse is released first.
+    std::atomic<std::uint64_t> Clock;
+
+    std::mutex Mutex;
+  };
+
+  /// Store the parameters of the dynamical function and clear the cache
+  void updateDynamicsParameters();
+
+  /// Create the cache column of the sample of \p point
+  EventCache::Column *addCacheColumn(const DataPoint &point) const;
+
+  mutable EventCache Cache;
+
+  /// Parameters of the dynamical function
+  std::vector<std::shared_ptr<FitParameter>> DynamicsParameters;
+
+  /// Can values of the dynamical function be stored? False if its parameters
+  /// are not known.
+  bool CacheDynamics;
 };
 
 } // namespace HelicityFormalism
@@ -4,21 +4,66 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <numeric>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 
 #include "qft++/Vector4.h"
 
 #include "Core/DataPoint.hpp"
+#include "Core/Exceptions.hpp"
 #include "Core/Event.hpp"
+#include "Core/EventCollection.hpp"
 #include "Core/Particle.hpp"
 #include "Core/Properties.hpp"
+#include "Core/ThreadPool.hpp"
 #include "Physics/HelicityFormalism/HelicityKinematics.hpp"
 
 namespace ComPWA {
 namespace Physics {
 namespace HelicityFormalism {
 
+namespace {
+/// Number of events that are converted in parallel (grain size of the
+/// ThreadPool)
+const std::size_t ChunkSize = 4096;
+
+/// Number of events that are processed together by convertBlock()
+const std::size_t BlockSize = 256;
+
+/// Momentum components of a block of events
+struct MomentumBlock {
+  double X[BlockSize], Y[BlockSize], Z[BlockSize], E[BlockSize];
+};
+
+/// Sum of the four momenta of the particles at positions \p slots for the
+/// events [\p first, \p first + \p n)
+void sumMomenta(const EventCollection &events,
+                const std::vector<unsigned int> &slots, std::size_t first,
+                std::size_t n, MomentumBlock &p) {
+  for (std::size_t k = 0; k < n; ++k) {
+    p.X[k] = 0.;
+    p.Y[k] = 0.;
+    p.Z[k] = 0.;
+    p.E[k] = 0.;
+  }
+  for (auto s : slots) {
+    const double *px = events.px(s) + first;
+    const double *py = events.py(s) + first;
+    const double *pz = events.pz(s) + first;
+    const double *e = events.e(s) + first;
+    for (std::size_t k = 0; k < n; ++k) {
+      p.X[k] += px[k];
+      p.Y[k] += py[k];
+      p.Z[k] += pz[k];
+      p.E[k] += e[k];
+    }
+  }
+}
+} // namespace
+
 HelicityKinematics::HelicityKinematics(std::shared_ptr<PartList> partL,
                                        std::vector<pid> initialState,
                                        std::vector<pid> finalState,
@@ -259,18 +304,19 @@ double HelicityKinematics::helicityAngle(double M, double m, double m2,
   return cosAngle;
 }
 
-void HelicityKinematics::convert(const Event &event, DataPoint &point,
-                                 const SubSystem &sys,
-                                 const std::pair<double, double> limits) const {
+template <class Momenta>
+void HelicityKinematics::convertSubSystem(
+    const Momenta &p4, DataPoint &point, const SubSystem &sys,
+    const std::pair<double, double> limits) const {
   FourMomentum FinalA, FinalB;
   for (auto s : sys.getFinalStates().at(0)) {
     unsigned int index = convertFinalStateIDToPositionIndex(s);
-    FinalA += event.particle(index).fourMomentum();
+    FinalA += p4(index);
   }
 
   for (auto s : sys.getFinalStates().at(1)) {
     unsigned int index = convertFinalStateIDToPositionIndex(s);
-    FinalB += event.particle(index).fourMomentum();
+    FinalB += p4(index);
   }
 
   // Four momentum of the decaying resonance
@@ -309,7 +355,7 @@ void HelicityKinematics::convert(const Event &event, DataPoint &point,
     FourMomentum TempRecoil;
     for (auto s : RecoilState) {
       unsigned int index = convertFinalStateIDToPositionIndex(s);
-      TempRecoil += event.particle(index).fourMomentum();
+      TempRecoil += p4(index);
     }
     QFT::Vector4<double> Recoil(TempRecoil);
     Recoil.Boost(DecayingState);
@@ -324,7 +370,7 @@ void HelicityKinematics::convert(const Event &event, DataPoint &point,
       FourMomentum TempParentRecoil;
       for (auto s : ParentRecoilState) {
         unsigned int index = convertFinalStateIDToPositionIndex(s);
-        TempParentRecoil += event.particle(index).fourMomentum();
+        TempParentRecoil += p4(index);
       }
       ParentRecoil = TempParentRecoil;
     } else {
@@ -357,6 +403,205 @@ void HelicityKinematics::convert(const Event &event, DataPoint &point,
   point.values().push_back(phi);
 }
 
+void HelicityKinematics::convert(const Event &event, DataPoint &point,
+                                 const SubSystem &sys,
+                                 const std::pair<double, double> limits) const {
+  convertSubSystem(
+      [&event](unsigned int index) {
+        return event.particle(index).fourMomentum();
+      },
+      point, sys, limits);
+}
+
+void HelicityKinematics::convert(const EventCollection &events, std::size_t i,
+                                 DataPoint &point) const {
+  assert(Subsystems.size() == InvMassBounds.size());
+
+  if (!Subsystems.size()) {
+    LOG(ERROR) << "HelicityKinematics::convert() | No variabels were "
+                  "requested before. Therefore this function is doing nothing!";
+  }
+  auto p4 = [&events, i](unsigned int index) {
+    return events.fourMomentum(i, index);
+  };
+  for (unsigned int j = 0; j < Subsystems.size(); j++)
+    convertSubSystem(p4, point, Subsystems.at(j), InvMassBounds.at(j));
+}
+
+void HelicityKinematics::convert(const EventCollection &events,
+                                 std::size_t begin, std::size_t end,
+                                 std::vector<std::vector<double>> &values,
+                                 std::vector<char> &mask) const {
+  assert(Subsystems.size() == InvMassBounds.size());
+  if (begin > end || end > events.size())
+    throw BadParameter("HelicityKinematics::convert() | Range [" +
+                       std::to_string(begin) + ", " + std::to_string(end) +
+                       ") exceeds the number of events (" +
+                       std::to_string(events.size()) + ")!");
+
+  std::size_t n = end - begin;
+  values.resize(numVariables());
+  for (auto &v : values)
+    v.resize(n);
+  mask.assign(n, 1);
+
+  ThreadPool::instance().parallelFor(
+      n,
+      [&](std::size_t first, std::size_t last) {
+        for (std::size_t b = first; b < last; b += BlockSize) {
+          std::size_t size = std::min(BlockSize, last - b);
+          for (std::size_t j = 0; j < Subsystems.size(); ++j)
+            convertBlock(events, begin + b, size, Subsystems[j],
+                         InvMassBounds[j], &values[3 * j][b],
+                         &values[3 * j + 1][b], &values[3 * j + 2][b],
+                         &mask[b]);
+        }
+      },
+      ChunkSize);
+}
+
+void HelicityKinematics::convertBlock(const EventCollection &events,
+                                      std::size_t first, std::size_t n,
+                                      const SubSystem &sys,
+                                      const std::pair<double, double> &limits,
+                                      double *mSq, double *cosTheta,
+                                      double *phi, char *mask) const {
+  assert(n <= BlockSize);
+  MomentumBlock A, B, Recoil, ParentRecoil;
+  sumMomenta(events, convertFinalStateIDToPositionIndex(
+                         sys.getFinalStates().at(0)),
+             first, n, A);
+  sumMomenta(events, convertFinalStateIDToPositionIndex(
+                         sys.getFinalStates().at(1)),
+             first, n, B);
+  bool hasRecoil = sys.getRecoilState().size() > 0;
+  sumMomenta(events, convertFinalStateIDToPositionIndex(sys.getRecoilState()),
+             first, n, Recoil);
+  // In case there is no parent recoil, it is artificially along z
+  if (sys.getParentRecoilState().size() > 0)
+    sumMomenta(events,
+               convertFinalStateIDToPositionIndex(sys.getParentRecoilState()),
+               first, n, ParentRecoil);
+  else
+    for (std::size_t k = 0; k < n; ++k) {
+      ParentRecoil.X[k] = 0.;
+      ParentRecoil.Y[k] = 0.;
+      ParentRecoil.Z[k] = 1.;
+      ParentRecoil.E[k] = 0.;
+    }
+
+  // The steps are the same as in the conversion of a single event (see
+  // above). Boosts and rotations are written out explicitly, the sine and
+  // cosine of the rotation angles are calculated from the components of the
+  // momenta.
+  for (std::size_t k = 0; k < n; ++k) {
+    // Four momentum of the decaying resonance
+    double sx = A.X[k] + B.X[k];
+    double sy = A.Y[k] + B.Y[k];
+    double sz = A.Z[k] + B.Z[k];
+    double se = A.E[k] + B.E[k];
+    double m2 = -(sx * sx + sy * sy + sz * sz - se * se);
+
+    // We allow for a deviation from the limits of 10 times the numerical
+    // precision
+    bool inside = (m2 > limits.first || ComPWA::equal(m2, limits.first, 10)) &&
+                  (m2 < limits.second || ComPWA::equal(m2, limits.second, 10));
+    m2 = std::min(std::max(m2, limits.first), limits.second);
+
+    // Boost into the rest system of the decaying state
+    double bx = -sx / se, by = -sy / se, bz = -sz / se;
+    double gamma = 1.0 / std::sqrt(1.0 - bx * bx - by * by - bz * bz);
+    double gamFact = (gamma * gamma) / (gamma + 1.0);
+
+    double bp = bx * A.X[k] + by * A.Y[k] + bz * A.Z[k];
+    double dx = gamma * bx * A.E[k] + A.X[k] + gamFact * bx * bp;
+    double dy = gamma * by * A.E[k] + A.Y[k] + gamFact * by * bp;
+    double dz = gamma * bz * A.E[k] + A.Z[k] + gamFact * bz * bp;
+
+    if (hasRecoil) {
+      bp = bx * Recoil.X[k] + by * Recoil.Y[k] + bz * Recoil.Z[k];
+      double rx = gamma * bx * Recoil.E[k] + Recoil.X[k] + gamFact * bx * bp;
+      double ry = gamma * by * Recoil.E[k] + Recoil.Y[k] + gamFact * by * bp;
+      double rz = gamma * bz * Recoil.E[k] + Recoil.Z[k] + gamFact * bz * bp;
+
+      bp = bx * ParentRecoil.X[k] + by * ParentRecoil.Y[k] +
+           bz * ParentRecoil.Z[k];
+      double px = gamma * bx * ParentRecoil.E[k] + ParentRecoil.X[k] +
+                  gamFact * bx * bp;
+      double py = gamma * by * ParentRecoil.E[k] + ParentRecoil.Y[k] +
+                  gamFact * by * bp;
+      double pz = gamma * bz * ParentRecoil.E[k] + ParentRecoil.Z[k] +
+                  gamFact * bz * bp;
+
+      // Rotate so that the recoil moves in the negative z-axis direction:
+      // RotateZ(-phi) followed by RotateY(pi - theta) of the recoil
+      double rho = std::sqrt(rx * rx + ry * ry);
+      double r = std::sqrt(rho * rho + rz * rz);
+      double cosZ = rho > 0 ? rx / rho : 1.;
+      double sinZ = rho > 0 ? -ry / rho : 0.;
+      double cosY = r > 0 ? -rz / r : 0.;
+      double sinY = r > 0 ? rho / r : 1.;
+
+      double x = cosZ * dx - sinZ * dy;
+      double y = sinZ * dx + cosZ * dy;
+      dx = cosY * x + sinY * dz;
+      dy = y;
+      dz = -sinY * x + cosY * dz;
+
+      x = cosZ * px - sinZ * py;
+      y = sinZ * px + cosZ * py;
+      px = cosY * x + sinY * pz;
+      py = y;
+
+      // Rotate around the z-axis so that the parent recoil lies in the x-z
+      // plane: RotateZ(pi - phi) of the parent recoil
+      rho = std::sqrt(px * px + py * py);
+      cosZ = rho > 0 ? -px / rho : -1.;
+      sinZ = rho > 0 ? py / rho : 0.;
+      x = cosZ * dx - sinZ * dy;
+      dy = sinZ * dx + cosZ * dy;
+      dx = x;
+    }
+
+    double c = dz / std::sqrt(dx * dx + dy * dy + dz * dz);
+    double p = std::atan2(dy, dx);
+
+    // Check if values are within allowed range. NaN fails all comparisons.
+    inside = inside && c <= 1 && c >= -1 && p <= M_PI && p >= -M_PI;
+
+    mSq[k] = m2;
+    cosTheta[k] = c;
+    phi[k] = p;
+    mask[k] = mask[k] && inside;
+  }
+}
+
+std::string HelicityKinematics::configuration() const {
+  std::stringstream stream;
+  stream << Kinematics::configuration();
+  // Bounds are written with full precision
+  stream.precision(std::numeric_limits<double>::max_digits10);
+  for (unsigned int i = 0; i < Subsystems.size(); ++i) {
+    auto const &sys = Subsystems.at(i);
+    stream << "SubSystem:";
+    for (auto const &j : sys.getFinalStates()) {
+      stream << " (";
+      for (auto k : j)
+        stream << " " << k;
+      stream << " )";
+    }
+    stream << " Recoil:";
+    for (auto k : sys.getRecoilState())
+      stream << " " << k;
+    stream << " ParentRecoil:";
+    for (auto k : sys.getParentRecoilState())
+      stream << " " << k;
+    stream << " Bounds: " << InvMassBounds.at(i).first << " "
+           << InvMassBounds.at(i).second << "\n";
+  }
+  return stream.str();
+}
+
 const std::pair<double, double> &
 HelicityKinematics::invMassBounds(const SubSystem &sys) const {
   return invMassBounds(getDataID(sys));
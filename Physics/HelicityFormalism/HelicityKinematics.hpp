@@ -109,6 +109,25 @@ public:
   /// the variables are calculated that are used by the model.
   void convert(const Event &event, DataPoint &point) const;
 
+  /// Fill \p point from event \p i of \p events. The four momenta are read
+  /// directly from the columns of \p events.
+  void convert(const EventCollection &events, std::size_t i,
+               DataPoint &point) const;
+
+  /// Convert the events [\p begin, \p end) of \p events to columns of
+  /// (\f$m^2, cos\Theta, \phi\f$) for each SubSystem. The layout of
+  /// \p values is the same as for a DataPoint. Instead of throwing a
+  /// BeyondPhsp exception, events outside the phase space are marked by a
+  /// zero in \p mask.
+  ///
+  /// The momenta are read directly from the columns of \p events. The
+  /// events are split into chunks that are converted in parallel on the
+  /// ThreadPool, within a chunk blocks of events are processed by loops
+  /// without function calls so that the compiler can vectorise them.
+  void convert(const EventCollection &events, std::size_t begin,
+               std::size_t end, std::vector<std::vector<double>> &values,
+               std::vector<char> &mask) const;
+
   /// Fill \p point with variables for \p sys.
   /// The triple (\f$m^2, cos\Theta, \phi\f$) is added to dataPoint for
   /// SubSystem \p sys. Invariant mass limits of the SubSystem can be given via
@@ -161,6 +180,10 @@ public:
   /// Get SubSystem from \p pos in list
   virtual std::vector<SubSystem> subSystems() const { return Subsystems; }
 
+  /// Configuration of the base class extended by the final states, recoil
+  /// and parent recoil of each SubSystem and its invariant mass bounds.
+  virtual std::string configuration() const;
+
   /// Get number of variables that are added to dataPoint
   virtual size_t numVariables() const { return Subsystems.size() * 3; }
 
@@ -192,6 +215,22 @@ protected:
   std::pair<double, double> calculateInvMassBounds(const SubSystem &sys) const;
 
 private:
+  /// Calculate (\f$m^2, cos\Theta, \phi\f$) for \p sys and add them to
+  /// \p point. \p p4(index) returns the four momentum of the final state
+  /// particle at position \p index.
+  template <class Momenta>
+  void convertSubSystem(const Momenta &p4, DataPoint &point,
+                        const SubSystem &sys,
+                        const std::pair<double, double> limits) const;
+
+  /// Convert \p n events starting with event \p first of \p events for
+  /// \p sys. The results are written to \p mSq, \p cosTheta and \p phi,
+  /// \p mask is set to zero for events outside the phase space.
+  void convertBlock(const EventCollection &events, std::size_t first,
+                    std::size_t n, const SubSystem &sys,
+                    const std::pair<double, double> &limits, double *mSq,
+                    double *cosTheta, double *phi, char *mask) const;
+
   virtual unsigned int
   convertFinalStateIDToPositionIndex(unsigned int fs_id) const;
   virtual std::vector<unsigned int> convertFinalStateIDToPositionIndex(
@@ -157,9 +157,9 @@ BOOST_AUTO_TEST_CASE(PartialAmplitudeTreeConcordance) {
   ComPWA::Tools::generatePhsp(20000, gen, toySample);
 
   auto phspSample =
-      std::make_shared<std::vector<DataPoint>>(sample->dataPoints(kin));
+      sample->dataPoints(kin);
   auto toyPhspSample =
-      std::make_shared<std::vector<DataPoint>>(toySample->dataPoints(kin));
+      toySample->dataPoints(kin);
   helDecay->setPhspSample(toyPhspSample);
 
   ComPWA::ParameterList sampleList(sample->dataList(kin));
@@ -322,7 +322,7 @@ BOOST_AUTO_TEST_CASE(IncoherentTreeConcordance) {
   ComPWA::Tools::generatePhsp(20000, gen, toySample);
 
   auto vToySample =
-      std::make_shared<std::vector<DataPoint>>(toySample->dataPoints(kin));
+      toySample->dataPoints(kin);
   intens->setPhspSample(vToySample, vToySample);
 
   ComPWA::ParameterList sampleList(sample->dataList(kin));
@@ -409,9 +409,9 @@ BOOST_AUTO_TEST_CASE(SeqPartialAmplitudeTreeConcordance) {
   ComPWA::Tools::generatePhsp(20000, gen, toySample);
 
   auto phspSample =
-      std::make_shared<std::vector<DataPoint>>(sample->dataPoints(kin));
+      sample->dataPoints(kin);
   auto toyPhspSample =
-      std::make_shared<std::vector<DataPoint>>(toySample->dataPoints(kin));
+      toySample->dataPoints(kin);
   seqAmp->setPhspSample(toyPhspSample);
 
   ComPWA::ParameterList sampleList(sample->dataList(kin));
@@ -0,0 +1,165 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the conversion of a whole sample to columns of helicity variables.
+/// The result is compared to the conversion event by event.
+///
+
+#define BOOST_TEST_MODULE HelicityFormalism
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "Core/EventCollection.hpp"
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "Core/Properties.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Physics/HelicityFormalism/HelicityKinematics.hpp"
+#include "Physics/HelicityFormalism/test/AmpModelTest.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Physics::HelicityFormalism;
+
+BOOST_AUTO_TEST_SUITE(HelicityFormalism);
+
+/// Boost \p p from the rest frame of \p parent to the frame of \p parent.
+FourMomentum boost(const FourMomentum &p, const FourMomentum &parent) {
+  double bx = parent.px() / parent.e(), by = parent.py() / parent.e(),
+         bz = parent.pz() / parent.e();
+  double b2 = bx * bx + by * by + bz * bz;
+  double gamma = 1. / std::sqrt(1. - b2);
+  double bp = bx * p.px() + by * p.py() + bz * p.pz();
+  double f = b2 > 0 ? (gamma - 1.) * bp / b2 + gamma * p.e() : 0.;
+  return FourMomentum(p.px() + f * bx, p.py() + f * by, p.pz() + f * bz,
+                      gamma * (p.e() + bp));
+}
+
+/// Two-body decay of \p parent with random direction of the daughters
+std::pair<FourMomentum, FourMomentum> decay(const FourMomentum &parent,
+                                            double m1, double m2,
+                                            std::mt19937 &gen) {
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  double M = parent.invMass();
+  double q = std::sqrt((M * M - (m1 + m2) * (m1 + m2)) *
+                       (M * M - (m1 - m2) * (m1 - m2))) /
+             (2. * M);
+  double cosTheta = 2. * uniform(gen) - 1.;
+  double sinTheta = std::sqrt(1. - cosTheta * cosTheta);
+  double phi = 2. * M_PI * uniform(gen);
+  FourMomentum p1(q * sinTheta * std::cos(phi), q * sinTheta * std::sin(phi),
+                  q * cosTheta, std::sqrt(q * q + m1 * m1));
+  FourMomentum p2(-p1.px(), -p1.py(), -p1.pz(), std::sqrt(q * q + m2 * m2));
+  return std::make_pair(boost(p1, parent), boost(p2, parent));
+}
+
+/// J/psi -> gamma pi0 pi0 pi0 via sequential two-body decays. Some events
+/// are moved outside the phase space.
+EventCollection generate(std::size_t n, double sqrtS, double mPi0) {
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  EventCollection events(4);
+  events.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    double m123 = 3 * mPi0 + (sqrtS - 3 * mPi0) * uniform(gen);
+    double m23 = 2 * mPi0 + (m123 - 3 * mPi0) * uniform(gen);
+    auto a = decay(FourMomentum(0., 0., 0., sqrtS), 0., m123, gen);
+    auto b = decay(a.second, mPi0, m23, gen);
+    auto c = decay(b.second, mPi0, mPi0, gen);
+
+    Event ev;
+    ev.addParticle(Particle(a.first.value(), 22));
+    ev.addParticle(Particle(b.first.value(), 111));
+    ev.addParticle(Particle(c.first.value(), 111));
+    ev.addParticle(Particle(c.second.value(), 111));
+    if (i % 97 == 0) {
+      // Beyond the upper mass limit of all subsystems containing the photon
+      Particle p = ev.particle(0);
+      ev.particles().at(0).e(p.e() * 3.);
+    }
+    events.add(ev);
+  }
+  return events;
+}
+
+BOOST_AUTO_TEST_CASE(BatchConversion) {
+  ComPWA::Logging log("", "info");
+  auto &pool = ThreadPool::instance();
+  unsigned int threads = pool.numThreads();
+
+  boost::property_tree::ptree tr;
+  std::stringstream modelStream;
+  modelStream << HelicityTestParticles;
+  boost::property_tree::xml_parser::read_xml(modelStream, tr);
+  auto partL = std::make_shared<ComPWA::PartList>();
+  ReadParticles(partL, tr);
+
+  double sqrtS = FindParticle(partL, 443).GetMass();
+  double mPi0 = FindParticle(partL, 111).GetMass();
+  auto kin = std::make_shared<HelicityKinematics>(
+      partL, std::vector<pid>{443}, std::vector<pid>{22, 111, 111, 111},
+      FourMomentum(0., 0., 0., sqrtS));
+  kin->addSubSystem({0}, {1, 2, 3}, {}, {});
+  kin->addSubSystem({1}, {2, 3}, {0}, {});
+  kin->addSubSystem({2}, {3}, {1}, {0});
+  kin->addSubSystem({0}, {2}, {1, 3}, {});
+
+  auto events = generate(20011, sqrtS, mPi0);
+
+  std::vector<std::vector<double>> values;
+  std::vector<char> mask;
+  kin->convert(events, 0, events.size(), values, mask);
+  BOOST_CHECK_EQUAL(values.size(), kin->numVariables());
+  BOOST_CHECK_EQUAL(mask.size(), events.size());
+
+  std::size_t numOutside = 0;
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    DataPoint point;
+    try {
+      kin->convert(events, i, point);
+    } catch (BeyondPhsp &ex) {
+      BOOST_CHECK_EQUAL(mask[i], 0);
+      ++numOutside;
+      continue;
+    }
+    BOOST_CHECK_EQUAL(mask[i], 1);
+    for (std::size_t k = 0; k < values.size(); ++k)
+      BOOST_CHECK_SMALL(values[k][i] - point.value(k), 1e-9);
+  }
+  BOOST_CHECK_EQUAL(numOutside, (events.size() + 96) / 97);
+
+  // The result does not depend on the number of threads and the range
+  for (unsigned int n : {1, 3, 8}) {
+    pool.setNumThreads(n);
+    std::vector<std::vector<double>> v;
+    std::vector<char> m;
+    kin->convert(events, 0, events.size(), v, m);
+    BOOST_CHECK(v == values);
+    BOOST_CHECK(m == mask);
+  }
+  pool.setNumThreads(threads);
+
+  std::vector<std::vector<double>> part;
+  std::vector<char> partMask;
+  kin->convert(events, 1000, 5300, part, partMask);
+  BOOST_CHECK_EQUAL(partMask.size(), 4300);
+  for (std::size_t k = 0; k < values.size(); ++k)
+    for (std::size_t i = 0; i < partMask.size(); ++i)
+      if (partMask[i])
+        BOOST_CHECK_EQUAL(part[k][i], values[k][1000 + i]);
+
+  BOOST_CHECK_THROW(kin->convert(events, 10, events.size() + 1, part, partMask),
+                    BadParameter);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,180 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the values that HelicityDecay::evaluateNoNorm() stores per event.
+/// The results for views of a DataPointSet are compared to the evaluation of
+/// DataPoints that own their values.
+///
+
+#define BOOST_TEST_MODULE HelicityFormalism
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/DataPointSet.hpp"
+#include "Core/FitParameter.hpp"
+#include "Core/Logging.hpp"
+#include "Core/Properties.hpp"
+#include "Core/SubSystem.hpp"
+#include "Physics/DecayDynamics/RelativisticBreitWigner.hpp"
+#include "Physics/HelicityFormalism/AmpWignerD.hpp"
+#include "Physics/HelicityFormalism/HelicityDecay.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Physics::HelicityFormalism;
+using ComPWA::Physics::DecayDynamics::RelativisticBreitWigner;
+
+BOOST_AUTO_TEST_SUITE(HelicityFormalism);
+
+const std::string TestParticles = R"####(
+<ParticleList>
+  <Particle Name='pi0'>
+    <Pid>111</Pid>
+    <Parameter Class='Double' Type='Mass' Name='Mass_pi0'>
+      <Value>0.1349766</Value>
+      <Fix>true</Fix>
+    </Parameter>
+    <QuantumNumber Class='Spin' Type='Spin' Value='0'/>
+    <QuantumNumber Class='Int' Type='Charge' Value='0'/>
+    <QuantumNumber Class='Int' Type='Parity' Value='-1'/>
+    <QuantumNumber Class='Int' Type='Cparity' Value='1'/>
+  </Particle>
+  <Particle Name='f2(1270)'>
+    <Pid>225</Pid>
+    <Parameter Class='Double' Type='Mass' Name='Mass_f2(1270)'>
+      <Value>1.2755</Value>
+      <Fix>true</Fix>
+    </Parameter>
+    <QuantumNumber Class='Spin' Type='Spin' Value='2'/>
+    <QuantumNumber Class='Int' Type='Charge' Value='0'/>
+    <QuantumNumber Class='Int' Type='Parity' Value='1'/>
+    <QuantumNumber Class='Int' Type='Cparity' Value='1'/>
+    <DecayInfo Type='relativisticBreitWigner'>
+      <FormFactor Type='1' />
+      <Parameter Class='Double' Type='Width' Name='Width_f2(1270)'>
+        <Value>0.1867</Value>
+        <Fix>true</Fix>
+      </Parameter>
+      <Parameter Class='Double' Type='MesonRadius' Name='Radius_f2(1270)'>
+        <Value>1.5</Value>
+        <Fix>true</Fix>
+      </Parameter>
+    </DecayInfo>
+  </Particle>
+</ParticleList>
+)####";
+
+struct TestDecay {
+  TestDecay() : Decay(0, SubSystem({{0}, {1}}, {2}, {})) {
+    auto partL = std::make_shared<PartList>();
+    ReadParticles(partL, TestParticles);
+    BreitWigner = std::make_shared<RelativisticBreitWigner>(
+        "f2(1270)", std::make_pair("pi0", "pi0"), partL);
+    BreitWigner->SetOrbitalAngularMomentum(2);
+    Decay.setMagnitudeParameter(std::make_shared<FitParameter>("Mag", 2.0));
+    Decay.setPhaseParameter(std::make_shared<FitParameter>("Phase", 0.3));
+    Decay.setWignerD(std::make_shared<AmpWignerD>(Spin(2), Spin(1), Spin(0)));
+    Decay.setDynamicalFunction(BreitWigner);
+  }
+
+  std::shared_ptr<RelativisticBreitWigner> BreitWigner;
+  HelicityDecay Decay;
+};
+
+/// Invariant mass squared, cosTheta and phi of \p n events. The angles
+/// depend on \p shift.
+DataPointSet sample(std::size_t n, double shift = 0.) {
+  std::vector<std::vector<double>> columns(3, std::vector<double>(n));
+  double min = 4 * 0.1349766 * 0.1349766;
+  for (std::size_t i = 0; i < n; ++i) {
+    columns[0][i] = min + (4.0 - min) * (i + 0.5) / n;
+    columns[1][i] = std::cos(0.37 * i + shift);
+    columns[2][i] = std::fmod(1.3 * i + shift, 2 * M_PI);
+  }
+  return DataPointSet(std::move(columns), std::vector<char>(n, 1));
+}
+
+/// Compare the evaluation of the views of \p set with the evaluation of
+/// DataPoints that own their values
+void checkSample(const HelicityDecay &decay, const DataPointSet &set) {
+  for (std::size_t i = 0; i < set.size(); ++i) {
+    DataPoint view = set[i];
+    DataPoint owned = view;
+    owned.values();
+    BOOST_REQUIRE(!owned.isView());
+    std::complex<double> expected = decay.evaluateNoNorm(owned);
+    BOOST_CHECK_SMALL(std::abs(decay.evaluateNoNorm(view) - expected),
+                      1e-14 * std::abs(expected));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(EventCacheConsistency) {
+  ComPWA::Logging log("", "error");
+  TestDecay t;
+  DataPointSet set = sample(1000);
+  BOOST_CHECK(set[0].isView() && set[0].sample() == set[5].sample());
+  BOOST_CHECK_EQUAL(set[5].index(), 5);
+  BOOST_CHECK_EQUAL(set[5].sampleSize(), 1000);
+
+  // First evaluation fills the cache, the second one uses it
+  checkSample(t.Decay, set);
+  checkSample(t.Decay, set);
+
+  // Parameters of the amplitude and of the dynamical function change
+  t.Decay.magnitudeParameter()->fixParameter(false);
+  t.Decay.setMagnitude(1.5);
+  t.BreitWigner->GetWidthParameter()->fixParameter(false);
+  t.BreitWigner->SetWidth(0.2);
+  checkSample(t.Decay, set);
+  t.BreitWigner->SetWidth(0.25);
+  checkSample(t.Decay, set);
+
+  // The values of the dynamical function are not stored if it has free
+  // parameters
+  t.Decay.clearCache();
+  checkSample(t.Decay, set);
+  t.BreitWigner->SetWidth(0.3);
+  checkSample(t.Decay, set);
+
+  // Modification of values in place changes the identity of the sample
+  auto id = set[0].sample();
+  set.setValue(7, 0, 1.1);
+  BOOST_CHECK(set[0].sample() != id);
+  checkSample(t.Decay, set);
+  set.setValue(8, 1, -0.3);
+  checkSample(t.Decay, set);
+
+  // A copy is a different sample, also if it reuses the memory of a
+  // sample that was evaluated before
+  DataPointSet copy(set);
+  BOOST_CHECK(copy[0].sample() != set[0].sample());
+  for (unsigned int k = 0; k < 3; ++k) {
+    DataPointSet other = sample(1000, 0.1 * k);
+    checkSample(t.Decay, other);
+  }
+
+  // More samples than slots (four), the least recently used one is
+  // replaced
+  std::vector<DataPointSet> others;
+  for (unsigned int k = 0; k < 5; ++k)
+    others.push_back(sample(100 + k));
+  for (const auto &other : others)
+    checkSample(t.Decay, other);
+  for (const auto &other : others)
+    checkSample(t.Decay, other);
+  checkSample(t.Decay, others.back());
+  checkSample(t.Decay, others.front());
+
+  // A copy starts with an empty cache
+  HelicityDecay decayCopy(t.Decay);
+  checkSample(decayCopy, set);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
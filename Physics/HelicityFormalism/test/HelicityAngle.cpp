@@ -130,7 +130,8 @@ BOOST_AUTO_TEST_CASE(HelicityAngleTest) {
   SubSystem sys23_CP(kin->subSystem(pos_sys23_CP));
 
   LOG(INFO) << "Loop over phsp events....";
-  for (auto i : sample->events()) {
+  for (std::size_t evt = 0; evt < sample->numEvents(); ++evt) {
+    Event i = sample->event(evt);
     // Calculate masses from FourMomentum to make sure that the correct masses
     // are used for the calculation of the helicity angle
     //    BOOST_CHECK_EQUAL((float)m1,
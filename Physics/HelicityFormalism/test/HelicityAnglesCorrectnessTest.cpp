@@ -209,7 +209,8 @@ BOOST_AUTO_TEST_CASE(HelicityAnglesCorrectnessTest) {
   Vector4<double> top_vec4(0, 0, 0, 1);
 
   LOG(INFO) << "Loop over phsp events and comparison of angles....";
-  for (auto ev : sample->events()) {
+  for (std::size_t evt = 0; evt < sample->numEvents(); ++evt) {
+    Event ev = sample->event(evt);
     DataPoint compwa_point;
     kin->convert(ev, compwa_point);
 
@@ -0,0 +1,162 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the normalization via a matrix of interference integrals. The
+/// result of the InterferenceIntegral tree is compared to the direct
+/// calculation of the weighted sum of the coherent intensity.
+///
+
+#define BOOST_TEST_MODULE HelicityFormalism
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/FitParameter.hpp"
+#include "Core/FunctionTree.hpp"
+#include "Core/Logging.hpp"
+#include "Core/Value.hpp"
+#include "Physics/InterferenceMatrix.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Physics;
+
+BOOST_AUTO_TEST_SUITE(HelicityFormalism);
+
+struct TestModel {
+  std::vector<std::shared_ptr<FitParameter>> Magnitudes, Phases, Shapes;
+  std::vector<std::vector<std::complex<double>>> Values;
+  std::vector<double> Weights;
+  std::shared_ptr<InterferenceMatrix> Matrix;
+  std::shared_ptr<FunctionTree> Tree;
+
+  /// Sum_e w_e |Sum_k c_k s_k f_k(e)|^2 with shape parameters s_k
+  double reference() const {
+    double sum = 0.;
+    for (size_t e = 0; e < Weights.size(); ++e) {
+      std::complex<double> a(0., 0.);
+      for (size_t k = 0; k < Values.size(); ++k)
+        a += std::polar(Magnitudes[k]->value(), Phases[k]->value()) *
+             Shapes[k]->value() * Values[k][e];
+      sum += Weights[e] * std::norm(a);
+    }
+    return sum;
+  }
+};
+
+/// Model with \p nAmp amplitudes and event weights 0.5 + \p slope * e
+TestModel buildModel(size_t nAmp, size_t nEvents, double slope = 0.001) {
+  TestModel m;
+  for (size_t e = 0; e < nEvents; ++e)
+    m.Weights.push_back(0.5 + slope * e);
+
+  m.Matrix = std::make_shared<InterferenceMatrix>(nAmp);
+  m.Tree = std::make_shared<FunctionTree>(
+      "Integral", std::make_shared<Value<double>>(),
+      std::make_shared<InterferenceIntegral>(m.Matrix));
+  auto weights = std::make_shared<Value<std::vector<double>>>(m.Weights);
+
+  for (size_t k = 0; k < nAmp; ++k) {
+    std::string n = std::to_string(k);
+    m.Magnitudes.push_back(
+        std::make_shared<FitParameter>("Magnitude_" + n, 1. + 0.1 * k));
+    m.Phases.push_back(std::make_shared<FitParameter>("Phase_" + n, 0.2 * k));
+    m.Shapes.push_back(std::make_shared<FitParameter>("Shape_" + n, 1.));
+    std::vector<std::complex<double>> f;
+    for (size_t e = 0; e < nEvents; ++e)
+      f.push_back(std::polar(1. + 0.01 * k * e, 0.3 * k + 0.002 * e));
+    m.Values.push_back(f);
+
+    m.Tree->createNode("Coefficient_" + n,
+                       std::make_shared<Value<std::complex<double>>>(),
+                       std::make_shared<Complexify>(ParType::COMPLEX),
+                       "Integral");
+    m.Tree->createLeaf("Magnitude_" + n, m.Magnitudes.back(),
+                       "Coefficient_" + n);
+    m.Tree->createLeaf("Phase_" + n, m.Phases.back(), "Coefficient_" + n);
+
+    m.Tree->createNode("InterferenceShape_" + n,
+                       std::make_shared<Value<double>>(),
+                       std::make_shared<InterferenceShape>(m.Matrix, k),
+                       "Integral");
+    m.Tree->createLeaf("Weights", weights, "InterferenceShape_" + n);
+    m.Tree->createNode("Shape_" + n, MComplex("", nEvents),
+                       std::make_shared<MultAll>(ParType::MCOMPLEX),
+                       "InterferenceShape_" + n);
+    m.Tree->createLeaf("f_" + n,
+                       std::make_shared<Value<std::vector<std::complex<double>>>>(f),
+                       "Shape_" + n);
+    m.Tree->createLeaf("s_" + n, m.Shapes.back(), "Shape_" + n);
+  }
+  for (auto p : m.Magnitudes)
+    p->fixParameter(false);
+  for (auto p : m.Phases)
+    p->fixParameter(false);
+  for (auto p : m.Shapes)
+    p->fixParameter(false);
+  return m;
+}
+
+double evaluate(TestModel &m) {
+  return std::dynamic_pointer_cast<Value<double>>(m.Tree->parameter())
+      ->value();
+}
+
+BOOST_AUTO_TEST_CASE(QuadraticForm) {
+  ComPWA::Logging log("", "info");
+
+  auto m = buildModel(4, 1001);
+  double ref = m.reference();
+  BOOST_CHECK_CLOSE(evaluate(m), ref, 1e-10);
+  BOOST_CHECK_EQUAL(m.Matrix->numRowUpdates(), 4);
+
+  // The matrix is hermitian
+  for (size_t i = 0; i < 4; ++i)
+    for (size_t j = 0; j < 4; ++j)
+      BOOST_CHECK_SMALL(std::abs(m.Matrix->element(i, j) -
+                                 std::conj(m.Matrix->element(j, i))),
+                        1e-9);
+
+  // A change of a coefficient does not update the matrix
+  m.Magnitudes.at(1)->setValue(2.5);
+  m.Phases.at(3)->setValue(-1.1);
+  BOOST_CHECK_CLOSE(evaluate(m), m.reference(), 1e-10);
+  BOOST_CHECK_EQUAL(m.Matrix->numRowUpdates(), 4);
+
+  // A change of a shape updates a single row
+  m.Shapes.at(2)->setValue(0.7);
+  BOOST_CHECK_CLOSE(evaluate(m), m.reference(), 1e-10);
+  BOOST_CHECK_EQUAL(m.Matrix->numRowUpdates(), 5);
+
+  m.Shapes.at(0)->setValue(1.3);
+  m.Shapes.at(3)->setValue(0.4);
+  BOOST_CHECK_CLOSE(evaluate(m), m.reference(), 1e-10);
+  BOOST_CHECK_EQUAL(m.Matrix->numRowUpdates(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(NegativeWeights) {
+  ComPWA::Logging log("", "info");
+
+  // Weights between 0.5 and -0.5, e.g. sWeights
+  auto m = buildModel(3, 1001, -0.001);
+  BOOST_CHECK_CLOSE(evaluate(m), m.reference(), 1e-9);
+  for (size_t i = 0; i < 3; ++i) {
+    double diag = 0., scale = 0.;
+    for (size_t e = 0; e < m.Weights.size(); ++e) {
+      diag += m.Weights[e] * std::norm(m.Values[i][e]);
+      scale += std::abs(m.Weights[e]) * std::norm(m.Values[i][e]);
+    }
+    BOOST_CHECK_SMALL(m.Matrix->diagonal(i) - diag, 1e-12 * scale);
+  }
+
+  m.Shapes.at(1)->setValue(0.6);
+  BOOST_CHECK_CLOSE(evaluate(m), m.reference(), 1e-9);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,95 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Test of the closed-form Wigner d-functions. The results are compared to
+/// AmpWignerD::dynamicalFunction() for all spins up to 4.
+///
+
+#define BOOST_TEST_MODULE HelicityFormalism
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "Core/Spin.hpp"
+#include "Core/Value.hpp"
+#include "Physics/HelicityFormalism/AmpWignerD.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Physics::HelicityFormalism;
+
+BOOST_AUTO_TEST_SUITE(HelicityFormalism);
+
+std::vector<double> cosThetaValues(std::size_t n) {
+  std::vector<double> x(n);
+  for (std::size_t i = 0; i < n; ++i)
+    x[i] = -1.0 + 2.0 * i / (n - 1);
+  return x;
+}
+
+BOOST_AUTO_TEST_CASE(WignerdConsistency) {
+  ComPWA::Logging log("", "error");
+  std::vector<double> x = cosThetaValues(201);
+  std::vector<double> out(x.size());
+  for (int twoJ = 0; twoJ <= WignerdPolynomial::MaxTwoJ; ++twoJ) {
+    Spin J(0.5 * twoJ);
+    for (int M = -twoJ; M <= twoJ; M += 2) {
+      for (int N = -twoJ; N <= twoJ; N += 2) {
+        Spin mu(0.5 * M), muPrime(0.5 * N);
+        WignerdPolynomial poly(J, mu, muPrime);
+        poly.evaluate(x.data(), out.data(), x.size());
+        for (std::size_t i = 0; i < x.size(); ++i) {
+          double expected =
+              AmpWignerD::dynamicalFunction(J, mu, muPrime, x[i]);
+          BOOST_CHECK_SMALL(out[i] - expected, 1e-12 * (twoJ + 1));
+          BOOST_CHECK_EQUAL(poly.evaluate(x[i]), out[i]);
+        }
+      }
+    }
+  }
+
+  WignerdPolynomial poly(Spin(2), Spin(1), Spin(0));
+  BOOST_CHECK_THROW(poly.evaluate(1.0 + 1e-9), std::runtime_error);
+  BOOST_CHECK(!WignerdPolynomial::isSupported(Spin(5)));
+  BOOST_CHECK_THROW(WignerdPolynomial(Spin(5), Spin(0), Spin(0)),
+                    BadParameter);
+}
+
+/// The tree node with the closed form compared to the general function
+BOOST_AUTO_TEST_CASE(WignerDStrategyConsistency) {
+  ComPWA::Logging log("", "error");
+  auto data = MDouble("cosTheta", cosThetaValues(10001));
+  ParameterList paras;
+  paras.addValue(std::make_shared<Value<double>>("spin", 3.));
+  paras.addValue(std::make_shared<Value<double>>("m", 1.));
+  paras.addValue(std::make_shared<Value<double>>("n", -1.));
+  paras.addValue(data);
+
+  WignerDStrategy general("general");
+  std::shared_ptr<Parameter> outGeneral;
+  general.execute(paras, outGeneral);
+
+  WignerDStrategy closedForm(
+      "closedForm",
+      std::make_shared<const WignerdPolynomial>(Spin(3), Spin(1), Spin(-1)));
+  std::shared_ptr<Parameter> outClosedForm;
+  closedForm.execute(paras, outClosedForm);
+
+  auto &a = std::static_pointer_cast<Value<std::vector<double>>>(outGeneral)
+                ->values();
+  auto &b = std::static_pointer_cast<Value<std::vector<double>>>(outClosedForm)
+                ->values();
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  for (std::size_t i = 0; i < a.size(); ++i)
+    BOOST_CHECK_SMALL(a[i] - b[i], 1e-11);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
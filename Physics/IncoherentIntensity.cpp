@@ -66,6 +66,8 @@ double IncoherentIntensity::intensity(const ComPWA::DataPoint &point) const {
     normValues = std::vector<double>(Intensities.size());
 
   double result = 0;
+  bool modified = (Intensities.size() != Parameters.size() ||
+                   Intensities.size() != NormalizationValues.size());
   for (int i = 0; i < Intensities.size(); i++) {
     std::vector<double> params;
     Intensities.at(i)->parametersFast(params);
@@ -73,12 +75,18 @@ double IncoherentIntensity::intensity(const ComPWA::DataPoint &point) const {
       parameters.at(i) = params;
       normValues.at(i) =
           1 / (Tools::Integral(Intensities.at(i), PhspSample, PhspVolume));
+      modified = true;
     }
     result += Intensities.at(i)->intensity(point) * normValues.at(i);
   }
 
-  const_cast<std::vector<std::vector<double>> &>(Parameters) = parameters;
-  const_cast<std::vector<double> &>(NormalizationValues) = normValues;
+  // Only write if the normalization was recalculated. Otherwise, the
+  // function does not modify the object and can be called from several
+  // threads.
+  if (modified) {
+    const_cast<std::vector<std::vector<double>> &>(Parameters) = parameters;
+    const_cast<std::vector<double> &>(NormalizationValues) = normValues;
+  }
 
   assert(!std::isnan(result) &&
          "IncoherentIntensity::Intensity() | Result is NaN!");
@@ -178,16 +186,25 @@ IncoherentIntensity::tree(std::shared_ptr<Kinematics> kin,
     normTree->createLeaf("PhspVolume", kin->phspVolume(), "Integral");
     normTree->createLeaf("InverseSampleWeights", 1 / ((double)sumWeights),
                          "Integral");
-    normTree->createNode("Sum",
-                         std::shared_ptr<Strategy>(new AddAll(ParType::DOUBLE)),
-                         "Integral");
-    normTree->createNode("IntensityWeighted", MDouble("", phspSize),
-                         std::make_shared<MultAll>(ParType::MDOUBLE), "Sum");
-    normTree->createLeaf("Efficiency", eff, "IntensityWeighted");
-    normTree->createLeaf("EventWeight", weightPhsp, "IntensityWeighted");
-    normTree->insertTree(
-        i->tree(kin, phspSample, phspSample, toySample, nEvtVar),
-        "IntensityWeighted");
+
+    // A change of the coefficients does not require a re-evaluation of
+    // the phase space sample if interference integrals are used.
+    auto coherent = std::dynamic_pointer_cast<CoherentIntensity>(i);
+    if (coherent && coherent->useInterferenceMatrix()) {
+      normTree->insertTree(coherent->interferenceTree(kin, phspSample),
+                           "Integral");
+    } else {
+      normTree->createNode(
+          "Sum", std::shared_ptr<Strategy>(new AddAll(ParType::DOUBLE)),
+          "Integral");
+      normTree->createNode("IntensityWeighted", MDouble("", phspSize),
+                           std::make_shared<MultAll>(ParType::MDOUBLE), "Sum");
+      normTree->createLeaf("Efficiency", eff, "IntensityWeighted");
+      normTree->createLeaf("EventWeight", weightPhsp, "IntensityWeighted");
+      normTree->insertTree(
+          i->tree(kin, phspSample, phspSample, toySample, nEvtVar),
+          "IntensityWeighted");
+    }
 
     // Construct tree and add normalization tree
     auto intensTree = i->tree(kin, sample, phspSample, toySample, nEvtVar);
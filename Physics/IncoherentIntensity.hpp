@@ -80,8 +80,8 @@ public:
   /// the maximum of the amplitude. In case that the efficiency is already
   /// applied to the sample set fEff to false.
   virtual void
-  setPhspSample(std::shared_ptr<std::vector<ComPWA::DataPoint>> phspSample,
-                std::shared_ptr<std::vector<ComPWA::DataPoint>> toySample) {
+  setPhspSample(std::shared_ptr<ComPWA::DataPointSet> phspSample,
+                std::shared_ptr<ComPWA::DataPointSet> toySample) {
     PhspSample = phspSample;
     for (auto i : Intensities) {
       i->setPhspSample(phspSample, toySample);
@@ -105,7 +105,7 @@ public:
 
 protected:
   /// Phase space sample to calculate the normalization and maximum value.
-  std::shared_ptr<std::vector<ComPWA::DataPoint>> PhspSample;
+  std::shared_ptr<ComPWA::DataPointSet> PhspSample;
 
   double PhspVolume;
 
@@ -0,0 +1,172 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "Core/ThreadPool.hpp"
+#include "Physics/InterferenceMatrix.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Physics;
+
+void InterferenceMatrix::setShape(std::size_t i,
+                                  const std::complex<double> *values,
+                                  const double *weights, std::size_t n) {
+  const double *w = setWeights(weights, n);
+  auto &shape = Shapes.at(i);
+  shape.resize(n);
+  ThreadPool::instance().parallelFor(n, [&](std::size_t begin,
+                                            std::size_t end) {
+    for (std::size_t e = begin; e < end; ++e) {
+      shape.Re[e] = values[e].real();
+      shape.Im[e] = values[e].imag();
+    }
+  });
+  if (w)
+    Matrix.at(i * size() + i) = Kernels::sumConjugateProduct(
+        shape.Re.data(), shape.Im.data(), shape.Re.data(), shape.Im.data(), w,
+        n);
+  else
+    Matrix.at(i * size() + i) = Kernels::sumConjugateProduct(
+        shape.Re.data(), shape.Im.data(), shape.Re.data(), shape.Im.data(), n);
+  Modified.at(i) = true;
+}
+
+const double *InterferenceMatrix::setWeights(const double *weights,
+                                             std::size_t n) {
+  std::lock_guard<std::mutex> lock(WeightsMutex);
+  if (!weights) {
+    if (!Weights.empty()) {
+      Weights.clear();
+      std::fill(Modified.begin(), Modified.end(), true);
+    }
+    return nullptr;
+  }
+  if (Weights.size() != n ||
+      !std::equal(Weights.begin(), Weights.end(), weights)) {
+    Weights.assign(weights, weights + n);
+    std::fill(Modified.begin(), Modified.end(), true);
+  }
+  return Weights.data();
+}
+
+void InterferenceMatrix::update() {
+  std::size_t n = size();
+
+  // Elements that need to be recalculated. Elements between two modified
+  // shapes are calculated only once.
+  std::vector<std::pair<std::size_t, std::size_t>> elements;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (!Modified.at(i))
+      continue;
+    ++NumRowUpdates;
+    for (std::size_t j = 0; j < n; ++j)
+      if (!Modified.at(j) || j >= i)
+        elements.push_back(std::make_pair(i, j));
+  }
+  if (elements.empty())
+    return;
+
+  for (std::size_t i = 0; i < n; ++i)
+    if (Shapes.at(i).size() != Shapes.at(0).size())
+      throw BadParameter("InterferenceMatrix::update() | Shapes have "
+                         "different number of events!");
+  const double *w = (Weights.empty() ? nullptr : Weights.data());
+
+  ThreadPool::instance().parallelFor(
+      elements.size(),
+      [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+          std::size_t i = elements[k].first, j = elements[k].second;
+          const auto &a = Shapes[i];
+          const auto &b = Shapes[j];
+          std::complex<double> m =
+              w ? Kernels::sumConjugateProduct(a.Re.data(), a.Im.data(),
+                                               b.Re.data(), b.Im.data(), w,
+                                               a.size())
+                : Kernels::sumConjugateProduct(a.Re.data(), a.Im.data(),
+                                               b.Re.data(), b.Im.data(),
+                                               a.size());
+          Matrix[i * n + j] = m;
+          Matrix[j * n + i] = std::conj(m);
+        }
+      },
+      1);
+
+  std::fill(Modified.begin(), Modified.end(), false);
+}
+
+std::complex<double> InterferenceMatrix::element(std::size_t i,
+                                                 std::size_t j) {
+  update();
+  return Matrix.at(i * size() + j);
+}
+
+double InterferenceMatrix::integral(
+    const std::vector<std::complex<double>> &coefficients) {
+  std::size_t n = size();
+  if (coefficients.size() != n)
+    throw BadParameter("InterferenceMatrix::integral() | Number of "
+                       "coefficients (" +
+                       std::to_string(coefficients.size()) +
+                       ") does not match the number of amplitudes (" +
+                       std::to_string(n) + ")!");
+  update();
+
+  // c^dagger M c = Sum_i |c_i|^2 M_ii + 2 Re Sum_{i<j} c_i c_j^* M_ij
+  double result = 0.;
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::complex<double> *row = &Matrix[i * n];
+    result += std::norm(coefficients[i]) * row[i].real();
+    std::complex<double> offDiag(0., 0.);
+    for (std::size_t j = i + 1; j < n; ++j)
+      offDiag += std::conj(coefficients[j]) * row[j];
+    result += 2. * (coefficients[i] * offDiag).real();
+  }
+  return result;
+}
+
+void InterferenceShape::execute(ParameterList &paras,
+                                std::shared_ptr<Parameter> &out) {
+  if (out && checkType != out->type())
+    throw BadParameter("InterferenceShape::execute() | Parameter type "
+                       "mismatch!");
+  if (paras.mComplexValues().size() != 1)
+    throw BadParameter("InterferenceShape::execute() | Expecting exactly one "
+                       "multi complex value!");
+
+  auto &shape = paras.mComplexValue(0)->values();
+  std::size_t n = shape.size();
+
+  const double *weights = nullptr;
+  if (paras.mDoubleValues().size()) {
+    Weights.assign(n, 1.0);
+    for (auto w : paras.mDoubleValues()) {
+      if (w->values().size() != n)
+        throw BadParameter("InterferenceShape::execute() | Size of multi "
+                           "double value does not match!");
+      for (std::size_t e = 0; e < n; ++e)
+        Weights[e] *= w->values()[e];
+    }
+    weights = Weights.data();
+  }
+
+  Matrix->setShape(Index, shape.data(), weights, n);
+  singleOutput<double>(out) = Matrix->diagonal(Index);
+}
+
+void InterferenceIntegral::execute(ParameterList &paras,
+                                   std::shared_ptr<Parameter> &out) {
+  if (out && checkType != out->type())
+    throw BadParameter("InterferenceIntegral::execute() | Parameter type "
+                       "mismatch!");
+
+  Coefficients.clear();
+  for (auto c : paras.complexValues())
+    Coefficients.push_back(c->value());
+
+  singleOutput<double>(out) = Matrix->integral(Coefficients);
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2017 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Interference integrals of a coherent sum of amplitudes.
+///
+
+#ifndef PHYSICS_INTERFERENCEMATRIX_HPP_
+#define PHYSICS_INTERFERENCEMATRIX_HPP_
+
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Core/ComplexKernels.hpp"
+#include "Core/Functions.hpp"
+
+namespace ComPWA {
+namespace Physics {
+
+///
+/// \class InterferenceMatrix
+/// Matrix of interference integrals
+/// \f[
+///   M_{ij} = \sum_e w_e B_i(e) B_j^*(e)
+/// \f]
+/// of the amplitude shapes \f$B_i\f$ over a sample of events with weights
+/// \f$w_e\f$. The weights can be negative (e.g. sWeights). The sum over events of the coherent intensity
+/// \f$|\sum_i c_i B_i|^2\f$ is given by the quadratic form \f$c^\dagger M c\f$.
+/// It is evaluated in O(n^2) for new coefficients \f$c_i\f$. If the shape of an
+/// amplitude changes, only the corresponding row and column of M are
+/// recalculated.
+///
+class InterferenceMatrix {
+public:
+  InterferenceMatrix(std::size_t n)
+      : Shapes(n), Modified(n, true), Matrix(n * n), NumRowUpdates(0){};
+
+  virtual ~InterferenceMatrix(){};
+
+  /// Number of amplitudes
+  virtual std::size_t size() const { return Shapes.size(); }
+
+  /// Set the shape of amplitude \p i. \p values contains the shape for each
+  /// of the \p n events. The event weights \p weights can be a null pointer.
+  /// All shapes have to be set with the same weights. If the weights change,
+  /// all elements of the matrix are recalculated. Shapes of different
+  /// amplitudes can be set concurrently.
+  virtual void setShape(std::size_t i, const std::complex<double> *values,
+                        const double *weights, std::size_t n);
+
+  /// Element M_ij
+  virtual std::complex<double> element(std::size_t i, std::size_t j);
+
+  /// Diagonal element M_ii. It is calculated by setShape() and does not
+  /// require an update of the matrix.
+  virtual double diagonal(std::size_t i) const {
+    return Matrix.at(i * size() + i).real();
+  }
+
+  /// Quadratic form c^dagger M c for the \p coefficients c_i
+  virtual double integral(const std::vector<std::complex<double>> &coefficients);
+
+  /// Number of rows that have been recalculated so far
+  virtual std::size_t numRowUpdates() const { return NumRowUpdates; }
+
+protected:
+  /// Recalculate rows and columns of modified shapes
+  virtual void update();
+
+  /// Store \p weights of \p n events. Returns the stored weights or a null
+  /// pointer for events without weights.
+  virtual const double *setWeights(const double *weights, std::size_t n);
+
+  std::vector<ComPWA::Kernels::SplitComplex> Shapes;
+
+  /// Event weights, empty for events without weights
+  std::vector<double> Weights;
+
+  std::mutex WeightsMutex;
+
+  /// Shapes that were set since the last update. Different shapes can be set
+  /// concurrently, therefore we do not use std::vector<bool>.
+  std::vector<char> Modified;
+
+  /// Row-major storage of M
+  std::vector<std::complex<double>> Matrix;
+
+  std::size_t NumRowUpdates;
+};
+
+///
+/// \class InterferenceShape
+/// Strategy that passes the shape of amplitude \p index to an
+/// InterferenceMatrix. The input is a single multi complex value (the shape)
+/// and any number of multi double values whose product is used as event
+/// weight. The output is the diagonal element M_ii.
+///
+class InterferenceShape : public ComPWA::Strategy {
+public:
+  InterferenceShape(std::shared_ptr<InterferenceMatrix> matrix,
+                    std::size_t index)
+      : Strategy(ParType::DOUBLE, "InterferenceShape"), Matrix(matrix),
+        Index(index){};
+
+  virtual ~InterferenceShape(){};
+
+  virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+protected:
+  std::shared_ptr<InterferenceMatrix> Matrix;
+
+  std::size_t Index;
+
+  /// Product of the event weights
+  std::vector<double> Weights;
+};
+
+///
+/// \class InterferenceIntegral
+/// Strategy that evaluates the quadratic form c^dagger M c of an
+/// InterferenceMatrix. The coefficients c_i are the complex input values in
+/// the order of the amplitudes. Double values are ignored. They are used to
+/// connect the node to the InterferenceShape nodes of the amplitudes.
+///
+class InterferenceIntegral : public ComPWA::Strategy {
+public:
+  InterferenceIntegral(std::shared_ptr<InterferenceMatrix> matrix)
+      : Strategy(ParType::DOUBLE, "InterferenceIntegral"), Matrix(matrix){};
+
+  virtual ~InterferenceIntegral(){};
+
+  virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+protected:
+  std::shared_ptr<InterferenceMatrix> Matrix;
+
+  std::vector<std::complex<double>> Coefficients;
+};
+
+} // namespace Physics
+} // namespace ComPWA
+
+#endif
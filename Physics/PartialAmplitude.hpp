@@ -16,6 +16,7 @@
 #include "Core/FitParameter.hpp"
 #include "Core/FitParameter.hpp"
 #include "Core/DataPoint.hpp"
+#include "Core/DataPointSet.hpp"
 #include "Core/FunctionTree.hpp"
 #include "Core/Kinematics.hpp"
 
@@ -128,7 +129,7 @@ public:
   /// We use the phase space sample to calculate the normalization. The sample
   /// should be without efficiency applied.
   virtual void
-  setPhspSample(std::shared_ptr<std::vector<ComPWA::DataPoint>> phspSample) {
+  setPhspSample(std::shared_ptr<ComPWA::DataPointSet> phspSample) {
     PhspSample = phspSample;
   };
 
@@ -149,7 +150,7 @@ protected:
   std::complex<double> PreFactor;
 
   /// Phsp sample for numerical integration
-  std::shared_ptr<std::vector<ComPWA::DataPoint>> PhspSample;
+  std::shared_ptr<ComPWA::DataPointSet> PhspSample;
 
   /// The phase-space volume is needed for proper normalization of the
   /// PartialAmplitude
@@ -165,7 +166,7 @@ protected:
     }
 
     double sumIntens = 0;
-    for (auto i : *PhspSample.get()) {
+    for (const auto &i : *PhspSample.get()) {
       sumIntens += std::norm(evaluateNoNorm(i));
     }
 
@@ -134,6 +134,28 @@ std::shared_ptr<ComPWA::FunctionTree> SequentialPartialAmplitude::tree(
   return tr;
 }
 
+std::shared_ptr<ComPWA::FunctionTree> SequentialPartialAmplitude::shapeTree(
+    std::shared_ptr<Kinematics> kin, const ParameterList &sample,
+    const ParameterList &toySample, std::string suffix) {
+
+  size_t n = sample.mDoubleValue(0)->values().size();
+
+  auto tr = std::make_shared<FunctionTree>(
+      "Shape(" + name() + ")" + suffix, MComplex("", n),
+      std::make_shared<MultAll>(ParType::MCOMPLEX));
+
+  for (auto i : PartialAmplitudes) {
+    std::shared_ptr<FunctionTree> resTree = i->tree(kin, sample, toySample, "");
+    if (!resTree->sanityCheck())
+      throw std::runtime_error("SequentialPartialAmplitude::shapeTree() | "
+                               "Amplitude tree didn't pass sanity check!");
+    resTree->parameter();
+    tr->insertTree(resTree, "Shape(" + name() + ")" + suffix);
+  }
+
+  return tr;
+}
+
 void SequentialPartialAmplitude::parameters(ParameterList &list) {
   Amplitude::parameters(list);
   for (auto i : PartialAmplitudes) {
@@ -78,7 +78,7 @@ public:
   /// We use the phase space sample to calculate the normalization. The sample
   /// should be without efficiency applied.
   virtual void
-  setPhspSample(std::shared_ptr<std::vector<ComPWA::DataPoint>> phspSample) {
+  setPhspSample(std::shared_ptr<ComPWA::DataPointSet> phspSample) {
     for (auto i : PartialAmplitudes)
       i->setPhspSample(phspSample);
   }
@@ -90,6 +90,12 @@ public:
                                              const ParameterList &toySample,
                                              std::string suffix = "");
 
+  virtual bool hasShapeTree() const { return true; }
+
+  virtual std::shared_ptr<FunctionTree>
+  shapeTree(std::shared_ptr<Kinematics> kin, const ParameterList &sample,
+            const ParameterList &toySample, std::string suffix = "");
+
 protected:
   std::vector<std::shared_ptr<ComPWA::Physics::PartialAmplitude>>
       PartialAmplitudes;
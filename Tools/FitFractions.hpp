@@ -119,7 +119,7 @@ inline void multivariateGaussian(const gsl_rng *rnd, const int vecSize,
 inline ComPWA::FitParameter
 CalculateFitFraction(std::shared_ptr<ComPWA::Kinematics> kin,
                      std::shared_ptr<ComPWA::AmpIntensity> intens,
-                     std::shared_ptr<std::vector<DataPoint>> sample,
+                     std::shared_ptr<DataPointSet> sample,
                      const std::pair<std::string, std::string> def) {
 
   double phspVolume = kin->phspVolume();
@@ -159,7 +159,7 @@ CalculateFitFraction(std::shared_ptr<ComPWA::Kinematics> kin,
 inline ComPWA::ParameterList
 CalculateFitFractions(std::shared_ptr<ComPWA::Kinematics> kin,
                       std::shared_ptr<ComPWA::AmpIntensity> intens,
-                      std::shared_ptr<std::vector<DataPoint>> sample,
+                      std::shared_ptr<DataPointSet> sample,
                       std::vector<std::pair<std::string, std::string>> defs) {
   ComPWA::ParameterList ffList;
   for (auto i : defs) {
@@ -180,7 +180,7 @@ inline void CalcFractionError(
     ParameterList &parameters, std::vector<std::vector<double>> covariance,
     ParameterList &ffList, std::shared_ptr<ComPWA::Kinematics> kin,
     std::shared_ptr<AmpIntensity> intens,
-    std::shared_ptr<std::vector<DataPoint>> sample, int nSets,
+    std::shared_ptr<DataPointSet> sample, int nSets,
     std::vector<std::pair<std::string, std::string>> defs) {
   LOG(INFO)
       << "CalcFractionError() | Calculating errors of fit fractions using "
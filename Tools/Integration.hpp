@@ -73,7 +73,7 @@ protected:
 };
 
 inline double Integral(std::shared_ptr<const AmpIntensity> intens,
-                       std::vector<DataPoint> &sample,
+                       const DataPointSet &sample,
                        double phspVolume = 1.0) {
 
   if (!sample.size()) {
@@ -82,7 +82,8 @@ inline double Integral(std::shared_ptr<const AmpIntensity> intens,
     return 1.0;
   }
   double sumIntens = 0;
-  for (auto i : sample)
+  // The points are views of the sample, nothing is copied
+  for (const auto &i : sample)
     sumIntens += intens->intensity(i);
 
   double integral = (sumIntens * phspVolume / sample.size());
@@ -92,13 +93,13 @@ inline double Integral(std::shared_ptr<const AmpIntensity> intens,
 }
 
 inline double Integral(std::shared_ptr<const AmpIntensity> intens,
-                       std::shared_ptr<std::vector<DataPoint>> sample,
+                       std::shared_ptr<DataPointSet> sample,
                        double phspVolume = 1.0) {
   return Integral(intens, *sample.get(), phspVolume);
 }
 
 inline double Maximum(std::shared_ptr<AmpIntensity> intens,
-                      std::shared_ptr<std::vector<DataPoint>> sample) {
+                      std::shared_ptr<DataPointSet> sample) {
 
   if (!sample->size()) {
     LOG(DEBUG)
@@ -107,7 +108,7 @@ inline double Maximum(std::shared_ptr<AmpIntensity> intens,
   }
 
   double max = 0;
-  for (auto i : *sample.get()) {
+  for (const auto &i : *sample.get()) {
     double val = intens->intensity(i);
     if (val > max)
       max = val;
@@ -126,10 +127,10 @@ inline double Maximum(std::shared_ptr<Kinematics> kin,
     return 1.0;
   }
 
-  auto data = sample->dataPoints(kin);
+  const DataPointSet &data = *sample->dataPoints(kin);
   double max = 0;
   DataPoint maxPoint;
-  for (auto i : data) {
+  for (const auto &i : data) {
     double val = intens->intensity(i);
     if (val > max) {
       maxPoint = i;
@@ -70,14 +70,11 @@ createIntens(std::string modelStr, std::shared_ptr<ComPWA::PartList> partL,
   // Setting phsp samples. The true sample does not include detector efficiency
   // and is needed to calculate the normalization of components.
   if (phspSample == truePhspSample) {
-    auto phspPoints = std::make_shared<std::vector<ComPWA::DataPoint>>(
-        phspSample->dataPoints(kin));
+    auto phspPoints = phspSample->dataPoints(kin);
     intens->setPhspSample(phspPoints, phspPoints);
   } else {
-    auto truePhspPoints = std::make_shared<std::vector<ComPWA::DataPoint>>(
-        truePhspSample->dataPoints(kin));
-    auto phspPoints = std::make_shared<std::vector<ComPWA::DataPoint>>(
-        phspSample->dataPoints(kin));
+    auto truePhspPoints = truePhspSample->dataPoints(kin);
+    auto phspPoints = phspSample->dataPoints(kin);
     intens->setPhspSample(phspPoints, truePhspPoints);
   }
   return intens;
@@ -89,16 +86,16 @@ public:
   DataPoints(std::shared_ptr<ComPWA::DataReader::Data> data,
              std::shared_ptr<ComPWA::Kinematics> kin)
       : nEvents(data->numEvents()), nVars(0) {
-    std::vector<ComPWA::DataPoint> dataVec = data->dataPoints(kin);
-    nVars = dataVec[0].size();
+    const ComPWA::DataPointSet &dataVec = *data->dataPoints(kin);
+    nVars = dataVec.numVariables();
     rawEvtData = new double[nEvents * (nVars + 2)]; // vars + weight +
                                                     // efficiency
-    for (unsigned int i = 0; i < data->numEvents(); i++) {
-      for (unsigned int j = 0; j < dataVec[i].size(); j++) {
-        rawEvtData[nVars * i + j] = dataVec[i].values()[j];
+    for (unsigned int i = 0; i < dataVec.size(); i++) {
+      for (unsigned int j = 0; j < nVars; j++) {
+        rawEvtData[nVars * i + j] = dataVec.value(i, j);
       }
-      rawEvtData[nVars * i + dataVec[i].size()] = dataVec[i].weight();
-      rawEvtData[nVars * i + dataVec[i].size() + 1] = dataVec[i].efficiency();
+      rawEvtData[nVars * i + nVars] = dataVec.weight(i);
+      rawEvtData[nVars * i + nVars + 1] = dataVec.efficiency(i);
     }
   }
   double *getRawEvtData() { return rawEvtData; }
@@ -429,8 +426,7 @@ PYBIND11_MODULE(pycompwa, m) {
            std::shared_ptr<ComPWA::AmpIntensity> intens,
            std::shared_ptr<ComPWA::DataReader::Data> toyPhspSample,
            std::vector<std::pair<std::string, std::string>> components) {
-          auto toyPhspPoints = std::make_shared<std::vector<ComPWA::DataPoint>>(
-              toyPhspSample->dataPoints(kin));
+          auto toyPhspPoints = toyPhspSample->dataPoints(kin);
           return ComPWA::Tools::CalculateFitFractions(
               kin, intens, toyPhspPoints, components);
         },
@@ -452,8 +448,7 @@ PYBIND11_MODULE(pycompwa, m) {
         auto resultM =
             std::dynamic_pointer_cast<ComPWA::Optimizer::Minuit2::MinuitResult>(
                 fitResult);
-        auto phspPoints = std::make_shared<std::vector<ComPWA::DataPoint>>(
-            phspSample->dataPoints(kin));
+        auto phspPoints = phspSample->dataPoints(kin);
         for (auto i : components)
           std::cout << i.first << " " << i.second << std::endl;
         ComPWA::Tools::CalcFractionError(
@@ -37,16 +37,16 @@ public:
   virtual ~RootPlot() {}
 
   void setDataSample(std::shared_ptr<ComPWA::DataReader::Data> sample) {
-    DataSample = sample->dataPoints(Kin);
+    DataSample = *sample->dataPoints(Kin);
   }
 
   void setPhspSample(std::shared_ptr<ComPWA::DataReader::Data> sample) {
-    PhspSample = sample->dataPoints(Kin);
+    PhspSample = *sample->dataPoints(Kin);
   }
 
-  void setDataSample(std::vector<DataPoint> &points) { DataSample = points; }
+  void setDataSample(const DataPointSet &points) { DataSample = points; }
 
-  void setPhspSample(std::vector<DataPoint> &points) { PhspSample = points; }
+  void setPhspSample(const DataPointSet &points) { PhspSample = points; }
 
   void setIntensity(std::shared_ptr<ComPWA::AmpIntensity> intens);
   
@@ -92,9 +92,9 @@ protected:
   
   std::vector<std::string> ComponentNames;
 
-  std::vector<DataPoint> DataSample;
+  DataPointSet DataSample;
   
-  std::vector<DataPoint> PhspSample;
+  DataPointSet PhspSample;
 };
 } // ns::Tools
 } // ns::ComPWA